@@ -3,6 +3,19 @@
 #include "Board/ChessPieces.h"
 #include "Board/Types.h"
 #include "Framework/Delegate.h"
+#include "Rules/Position.h"
+#include "Engine/OpeningBook.h"
+#include "Engine/OpeningExplorer.h"
+#include "Engine/Engine.h"
+#include "Engine/MateSolver.h"
+#include "Engine/UciEngine.h"
+#include "Engine/SpscQueue.h"
+#include "Engine/Syzygy.h"
+#include "Match/ChessClock.h"
+#include "IO/PgnWriter.h"
+#include "IO/Replay.h"
+#include "IO/GameJournal.h"
+#include <future>
 
 namespace we
 {
@@ -28,6 +41,7 @@ namespace we
     {
     public:
         Board(World* OwningWorld, const std::string& TexturePath = "/board.png");
+        virtual ~Board();
 
         virtual void BeginPlay() override;
         virtual void Tick(float DeltaTime) override;
@@ -37,7 +51,20 @@ namespace we
         Delegate<> OnStalemate;
         Delegate<> OnDraw;
         Delegate<EPlayerTurn, sf::Vector2i> OnPromotionRequested;
+        Delegate<std::string> OnBookHintChanged;
+        Delegate<EPlayerTurn> OnTablebaseWin;
+        Delegate<std::string> OnAnalysisChanged;
+        Delegate<std::string> OnClockChanged;
+        Delegate<EPlayerTurn> OnTimeForfeit;
+        Delegate<std::string> OnReviewChanged;
+        Delegate<std::string> OnExplorerChanged;
+        Delegate<bool> OnRecoveryAvailable;
         void ApplyPromotionChoice(EChessPieceType PromotionType, sf::Vector2i PromotionSquare);
+        void SetAnalysisMode(bool bEnabled);
+        bool IsAnalysing() const { return bAnalysisMode; }
+        void ExportPgn();                           // Queues the game so far; finished games are exported by themselves
+        void RecoverGame();                         // Resumes the unfinished game found in the autosave journal
+        const Position& GetGamePosition() const { return GamePosition; }
 
     private:
         // ----------------------------------------------------
@@ -68,6 +95,7 @@ namespace we
         // ----------------------------------------------------
         void InitializeBoard();
         void ClearBoard();
+        void RemovePieces();
         EChessColor GetPieceColor(int value);
         EChessPieceType GetPieceType(int value);
         EPlayerTurn CurrentTurn = EPlayerTurn::White;
@@ -140,6 +168,128 @@ namespace we
         bool IsKingMoveValid(shared<ChessPiece> Board[GridSize][GridSize], shared<ChessPiece> Piece, sf::Vector2i From, sf::Vector2i To) const;
         bool IsPawnMoveValid(shared<ChessPiece> Board[GridSize][GridSize], shared<ChessPiece> Piece, sf::Vector2i From, sf::Vector2i To) const;
 
+        // ----------------------------------------------------
+        // Rules Mirror & Opening Book
+        // ----------------------------------------------------
+        Position GamePosition;
+        OpeningBook Book;
+        OpeningExplorer Explorer;                   // Built from game archives by chess_explorer
+        static constexpr int ExplorerLineCount = 4;
+        sf::Vector2i PendingPromotionFrom{ -1, -1 };
+        Square GridToSquare(const sf::Vector2i& GridPos) const;
+        void SyncGamePosition(const sf::Vector2i& From, const sf::Vector2i& To, EChessPieceType PromotionType = EChessPieceType::Queen);
+        void UpdateBookHint();
+        void UpdateExplorer();
+
+        // ----------------------------------------------------
+        // Game Record (formatted and written off the game thread)
+        // ----------------------------------------------------
+        static constexpr const char* LastGameReplayFile = "last_game.replay";
+        Replay GameReplay;
+        std::future<bool> ReplaySave;
+        List<std::int32_t> GameMoveClocksMs;        // Mover's time left after each move
+        std::string GameResult = "*";
+        std::string GameTermination;
+        PgnWriter GameRecorder;
+        void FinishGame(const char* Result, const char* Termination);
+        static const char* WinFor(EPlayerTurn Winner) { return Winner == EPlayerTurn::White ? "1-0" : "0-1"; }
+
+        // ----------------------------------------------------
+        // Autosave (every move is journalled; an unfinished game is offered on launch)
+        // ----------------------------------------------------
+        static constexpr const char* AutosaveJournalFile = "autosave.journal";
+        GameJournal Journal;
+        JournalRecovery PendingRecovery;
+        bool bRecoveryOffered = false;
+        void SetRecoveryOffered(bool bOffered);
+
+        // ----------------------------------------------------
+        // Replay Review (seeks run in the rules core; the pieces are respawned once per seek)
+        // ----------------------------------------------------
+        enum EReviewKey { ReviewBack = 1, ReviewForward = 2, ReviewStart = 4, ReviewEnd = 8 };
+        ReplayCursor ReviewCursor{ GameReplay };
+        int ReviewPly = -1;                         // Shown ply once the game is over
+        int ReviewKeysLastFrame = 0;
+        void LoadReview(const std::string& Path);
+        void HandleReviewInput();
+        void SeekReview(int Ply);
+        void SyncPiecesToPosition();
+
+        // ----------------------------------------------------
+        // Tablebase Adjudication (probes run off the game thread)
+        // ----------------------------------------------------
+        struct TablebaseVerdict
+        {
+            HashKey Key = 0;
+            bool bFound = false;
+            Syzygy::EWdlScore Wdl = Syzygy::WdlDraw;
+        };
+        std::future<int> TablebaseLoad;             // The opponent's tablebases, which adjudication borrows
+        std::future<TablebaseVerdict> Adjudication;
+        bool bAdjudicationPending = false;
+        void UpdateAdjudication();
+
+        // ----------------------------------------------------
+        // Engine Opponent & Pondering
+        // ----------------------------------------------------
+        bool bPlayAgainstEngine = true;             // Off for a hot-seat game (--hotseat)
+        static constexpr EPlayerTurn EngineSide = EPlayerTurn::Black;
+        Nnue::Network OpponentNetwork;              // From <assets>/nnue when one is there; outlives Opponent
+        Engine Opponent;
+        UciEngine ExternalOpponent;                 // Replaces Opponent when the game is started with --engine
+        bool bUseExternalEngine = false;
+        we::Move LastGameMove;
+        we::Move PonderMove;
+        bool bEngineThinking = false;
+        bool IsEngineTurn() const { return bPlayAgainstEngine && !bAnalysisMode && CurrentTurn == EngineSide; }
+        sf::Vector2i SquareToGrid(Square Sq) const;
+        void StartEngineTurn();
+        void UpdateEngine();
+        void PlayEngineMove(we::Move EngineMove);
+        SearchLimits MakeEngineLimits() const;
+
+        // Whichever engine plays; none of these wait on an external one
+        void LaunchExternalEngine(const std::string& Path);
+        void StartOpponent(const Position& Pos, const SearchLimits& Limits);
+        void StopOpponent();
+        bool IsOpponentSearching() const { return bUseExternalEngine ? ExternalOpponent.IsSearching() : Opponent.IsSearching(); }
+        bool IsOpponentPondering() const { return bUseExternalEngine ? ExternalOpponent.IsPondering() : Opponent.IsPondering(); }
+        SearchResult GetOpponentResult() const { return bUseExternalEngine ? ExternalOpponent.GetLastResult() : Opponent.GetLastResult(); }
+
+        // ----------------------------------------------------
+        // Game Clock (the engine budgets its searches against it)
+        // ----------------------------------------------------
+        static constexpr std::int64_t ClockBaseMs = 5 * 60 * 1000;
+        static constexpr std::int64_t ClockIncrementMs = 3000;
+        ChessClock GameClock;
+        bool bClockPaused = false;                  // Stopped for analysis, resumed after it
+        std::string ClockText;
+        static EColor ToColor(EPlayerTurn Turn) { return Turn == EPlayerTurn::White ? White : Black; }
+        void UpdateClock();
+
+        // ----------------------------------------------------
+        // Analysis Mode (lines cross from the search thread through a lock-free queue)
+        // ----------------------------------------------------
+        struct AnalysisUpdate
+        {
+            std::uint32_t Generation = 0;
+            SearchInfo Info;
+        };
+        static constexpr int AnalysisLineCount = 3;
+        static constexpr int AnalysisPvMoves = 8;
+        bool bAnalysisMode = false;
+        std::atomic<std::uint32_t> AnalysisGeneration{ 0 };    // An external engine's lines may still arrive as it changes
+        SpscQueue<AnalysisUpdate, 64> AnalysisQueue;
+        SearchInfo AnalysisLines[AnalysisLineCount];
+        void StartAnalysis();
+        void UpdateAnalysis();
+
+        // The mate solver runs beside the analysis search and is polled like it
+        static constexpr std::uint64_t MateSolverNodes = 5000000;
+        MateSolver MateFinder;
+        bool bMateSearchPending = false;
+        std::string MateText;
+
         // ----------------------------------------------------
         // Window Functionality
         // ----------------------------------------------------
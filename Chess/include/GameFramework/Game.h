@@ -10,8 +10,28 @@ namespace we
 	class Game : public Application
 	{
 	public:
-		Game();
+		Game(const std::string& InLearningFile = {}, const std::string& InExternalEngine = {}, const std::string& InPgnFile = "games.pgn", const std::string& InReviewFile = {}, bool bInHotSeat = false);
+
+		// Empty unless the game was started with --learn
+		const std::string& GetLearningFile() const { return LearningFile; }
+
+		// Empty unless the game was started with --engine
+		const std::string& GetExternalEngine() const { return ExternalEngine; }
+
+		// Every finished or exported game is appended here
+		const std::string& GetPgnFile() const { return PgnFile; }
+
+		// Empty unless the game was started with --review
+		const std::string& GetReviewFile() const { return ReviewFile; }
+
+		// Two players share the board when the game was started with --hotseat
+		bool IsHotSeat() const { return bHotSeat; }
 
 	private:
+		std::string LearningFile;
+		std::string ExternalEngine;
+		std::string PgnFile;
+		std::string ReviewFile;
+		bool bHotSeat;
 	};
 }
\ No newline at end of file
@@ -21,6 +21,17 @@ namespace we
         void Stalemate();
         void Draw();
         void Promotion(EPlayerTurn Color, sf::Vector2i NewPromotionSquare);
+        void BookHint(std::string Hint);
+        void TablebaseWin(EPlayerTurn Winner);
+        void Analysis(std::string Lines);
+        void Clock(std::string Text);
+        void Review(std::string Text);
+        void Explorer(std::string Text);
+        void TimeForfeit(EPlayerTurn Winner);
+        void RecoveryAvailable(bool bAvailable);
+        void ToggleAnalysis();
+        void ExportGame();
+        void ResumeGame();
         void RestartGame();
         void QuitGame();
         void ToggleFullScreen();
@@ -17,10 +17,29 @@ namespace we
 		Delegate<> OnStalemate;
 		Delegate<> OnDraw;
 		Delegate<EPlayerTurn, sf::Vector2i> OnPromotionRequested;
+		Delegate<std::string> OnBookHintChanged;
+		Delegate<EPlayerTurn> OnTablebaseWin;
+		Delegate<std::string> OnAnalysisChanged;
+		Delegate<std::string> OnClockChanged;
+		Delegate<std::string> OnReviewChanged;
+		Delegate<std::string> OnExplorerChanged;
+		Delegate<EPlayerTurn> OnTimeForfeit;
+		Delegate<bool> OnRecoveryAvailable;
 		void Checkmate(EPlayerTurn Winner);
 		void Stalemate();
 		void Draw();
 		void Promotion(EPlayerTurn Color, sf::Vector2i PromotionSquare);
+		void BookHint(std::string Hint);
+		void TablebaseWin(EPlayerTurn Winner);
+		void AnalysisChanged(std::string Lines);
+		void ClockChanged(std::string Clock);
+		void ReviewChanged(std::string Review);
+		void ExplorerChanged(std::string Explorer);
+		void TimeForfeit(EPlayerTurn Winner);
+		void RecoveryAvailable(bool bAvailable);
+		void ToggleAnalysis();
+		void ExportGame();
+		void ResumeGame();
 		void PromoteTo(EChessPieceType Choice, sf::Vector2i PromotionSquare);
 
 	private:
@@ -25,8 +25,16 @@ namespace we
 		void Checkmated();
 		void Stalemated();
 		void Drawn();
+		void TablebaseWon();
+		void TimeForfeited();
 		void PromotionVisibility(EPlayerTurn Color, bool Visibility);
 		void PromotionVisibility(bool Visibility);
+		void SetBookHint(const string& Hint);
+		void SetAnalysisText(const string& Lines);
+		void SetClockText(const string& Clock);
+		void SetReviewText(const string& Review);
+		void SetExplorerText(const string& Explorer);
+		void SetResumeVisibility(bool Visibility);
 		Delegate<> OnRestartButtonClicked;
 		Delegate<> OnQuitButtonClicked;
 		Delegate<> OnFullScreenButtonClicked;
@@ -35,6 +43,9 @@ namespace we
 		Delegate<> OnRookSelected;
 		Delegate<> OnBishopSelected;
 		Delegate<> OnKnightSelected;
+		Delegate<> OnAnalysisButtonClicked;
+		Delegate<> OnExportButtonClicked;
+		Delegate<> OnResumeButtonClicked;
 
 	private:
 		virtual void Initialize(Renderer& GameRenderer) override;
@@ -46,18 +57,34 @@ namespace we
 		void RookButtonClicked();
 		void BishopButtonClicked();
 		void KnightButtonClicked();
+		void AnalysisButtonClicked();
+		void ExportButtonClicked();
+		void ResumeButtonClicked();
 		void InitializeButtons(const sf::Vector2u& ViewportSize);
 		void InitializeText(const sf::Vector2u& ViewportSize);
 		Button RestartButton;
 		Button QuitButton;
 		Button FullScreenButton;
 		Button MinimizeButton;
+		Button AnalysisButton;
+		Button ExportButton;
+		Button ResumeButton;
 		TextBlock RestartButtonText;
+		TextBlock AnalysisButtonText;
+		TextBlock ExportButtonText;
+		TextBlock ResumeButtonText;
 		TextBlock CheckmateText;
 		TextBlock StalemateText;
 		TextBlock DrawnText;
+		TextBlock TablebaseText;
+		TextBlock TimeoutText;
 		TextBlock FlavorText;
 		TextBlock WinnerText;
+		TextBlock BookHintText;
+		TextBlock AnalysisText;
+		TextBlock ClockText;
+		TextBlock ReviewText;
+		TextBlock ExplorerText;
 		sf::Color TextColor{ 192, 35, 10, 255 };
 		sf::Color OutlineColor{ 0, 0, 0, 255 };
 		PromotionSelector PromotionMenu;
@@ -2,7 +2,16 @@
 #include "Framework/Renderer.h"
 #include "Framework/World.h"
 #include "Framework/Application.h"
+#include "Framework/AssetManager.h"
+#include "GameFramework/Game.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <thread>
 #include <sstream>
+#include <iomanip>
 
 namespace we
 {
@@ -12,16 +21,67 @@ namespace we
     {
     }
 
+    // The search threads feed AnalysisQueue, which is destroyed before Opponent
+    Board::~Board()
+    {
+        if (TablebaseLoad.valid()) TablebaseLoad.wait();
+        Opponent.Stop();
+        Opponent.Wait();
+        ExternalOpponent.Quit();
+    }
+
     void Board::BeginPlay()
     {
         m_WindowRef = &GetWorld()->GetApplication()->GetRenderer()->GetRenderWindow();
         SetActorLocation(sf::Vector2f{ float(GetWindowSize().x) / 2.0f, float(GetWindowSize().y) / 2.0f });
+        Book.Open(AssetManager::Get().GetAssetRootDirectory() + "book/book.bin");
+        Explorer.Open(AssetManager::Get().GetAssetRootDirectory() + "book/explorer.bin");
+        Opponent.SetThreadCount(std::max(1, int(std::thread::hardware_concurrency()) / 2));
+        Opponent.SetHashSize(64);
+        Opponent.LoadBook(AssetManager::Get().GetAssetRootDirectory() + "book/book.bin");
+        Opponent.LoadBitbases(AssetManager::Get().GetAssetRootDirectory() + "bitbases");
+        std::error_code NetworkError;
+        for (const std::filesystem::directory_entry& Entry : std::filesystem::directory_iterator{ AssetManager::Get().GetAssetRootDirectory() + "nnue", NetworkError })
+        {
+            if (Entry.path().extension() == ".nnue" && OpponentNetwork.LoadFromFile(Entry.path().string()))
+            {
+                Opponent.SetNetwork(&OpponentNetwork);
+                break;
+            }
+        }
+        if (const Game* ChessGame = dynamic_cast<const Game*>(GetWorld()->GetApplication()))
+        {
+            Opponent.SetLearningFile(ChessGame->GetLearningFile());
+            GameRecorder.Open(ChessGame->GetPgnFile());
+            bPlayAgainstEngine = !ChessGame->IsHotSeat();
+            if (!ChessGame->GetExternalEngine().empty())
+            {
+                LaunchExternalEngine(ChessGame->GetExternalEngine());
+            }
+        }
+        TablebaseLoad = std::async(std::launch::async, &Engine::SetSyzygyPath, &Opponent, AssetManager::Get().GetAssetRootDirectory() + "syzygy");
         InitializeBoard();
+
+        const Game* ChessGame = dynamic_cast<const Game*>(GetWorld()->GetApplication());
+        if (ChessGame && !ChessGame->GetReviewFile().empty())
+        {
+            LoadReview(ChessGame->GetReviewFile());
+        }
+        else
+        {
+            // Checked before the journal is opened; nothing is written to it until the first move
+            SetRecoveryOffered(GameJournal::Recover(AutosaveJournalFile, PendingRecovery));
+            Journal.Open(AutosaveJournalFile);
+        }
     }
 
     void Board::Tick(float DeltaTime)
     {
         HandleInput();
+        UpdateAdjudication();
+        UpdateClock();
+        UpdateEngine();
+        UpdateAnalysis();
     }
 
     void Board::Render(Renderer& GameRenderer)
@@ -48,6 +108,7 @@ namespace we
     void Board::ApplyPromotionChoice(EChessPieceType PromotionType, sf::Vector2i PromotionSquare)
     {
         PromotePawn(PromotionSquare, PromotionType);
+        SyncGamePosition(PendingPromotionFrom, PromotionSquare, PromotionType);
 
         EChessColor OpponentColor = (CurrentTurn == EPlayerTurn::White) ? EChessColor::Black : EChessColor::White;
 
@@ -67,17 +128,17 @@ namespace we
         if (Result.bIsCheckmate)
         {
             OnCheckmate.Broadcast(CurrentTurn);
-            bIsGameOver = true;
+            FinishGame(WinFor(CurrentTurn), "normal");
         }
         else if (Result.bIsStalemate)
         {
             OnStalemate.Broadcast();
-            bIsGameOver = true;
+            FinishGame("1/2-1/2", "normal");
         }
         else if (Result.bIsDraw)
         {
             OnDraw.Broadcast();
-            bIsGameOver = true;
+            FinishGame("1/2-1/2", "normal");
         }
 
         if (!bIsGameOver)
@@ -87,6 +148,7 @@ namespace we
 
         bIsWaitingForPromotion = false;
         PendingPromotionSquare = sf::Vector2i{ -1, -1 };
+        StartEngineTurn();
     }
 
     void Board::InitializeBoard()
@@ -109,6 +171,22 @@ namespace we
     }
 
     void Board::ClearBoard()
+    {
+        RemovePieces();
+        CurrentTurn = EPlayerTurn::White;
+        GamePosition.SetFromFen(Position::StartFen);
+        GameClock.Reset(ClockBaseMs, ClockIncrementMs);
+        bClockPaused = false;
+        ClockText.clear();
+        GameReplay.Begin(GamePosition);
+        GameMoveClocksMs.clear();
+        GameResult = "*";
+        GameTermination.clear();
+        UpdateBookHint();
+        UpdateExplorer();
+    }
+
+    void Board::RemovePieces()
     {
         for (auto& Piece : Pieces)
         {
@@ -127,7 +205,7 @@ namespace we
         }
         Pieces.clear();
         SelectedPiece.reset();
-        CurrentTurn = EPlayerTurn::White;
+        HoveredPiece.reset();
     }
 
     EChessColor Board::GetPieceColor(int value)
@@ -209,6 +287,7 @@ namespace we
     void Board::HandleInput()
     {
         if (bIsWaitingForPromotion) return;
+        HandleReviewInput();
         bool bLeftMouseDown = sf::Mouse::isButtonPressed(sf::Mouse::Button::Left);
 
         if (bLeftMouseDown)
@@ -256,7 +335,7 @@ namespace we
 
     void Board::HandleMouseHover()
     {
-        if (bIsGameOver || bIsDragging) return;
+        if (bIsGameOver || bIsDragging || IsEngineTurn()) return;
 
         sf::Vector2i gridPos = WorldToGrid(MouseWorldPosition);
 
@@ -302,7 +381,7 @@ namespace we
     {
         sf::Vector2i gridPos = WorldToGrid(MousePos);
 
-        if (!IsInBounds(gridPos))
+        if (!IsInBounds(gridPos) || IsEngineTurn())
         {
             return;
         }
@@ -341,6 +420,7 @@ namespace we
                 if (!bIsWaitingForPromotion)
                 {
                     SwitchTurn();
+                    StartEngineTurn();
                 }
             }
             else
@@ -449,6 +529,18 @@ namespace we
             }
         }
 
+        // ----------------------------------------------------
+        // Rules Mirror (promotions sync once the piece is chosen)
+        // ----------------------------------------------------
+        if (Result.bPawnPromoted)
+        {
+            PendingPromotionFrom = Result.From;
+        }
+        else
+        {
+            SyncGamePosition(Result.From, Result.To);
+        }
+
         // ----------------------------------------------------
         // Pawn Promotion 
         // ----------------------------------------------------
@@ -456,6 +548,7 @@ namespace we
         {
             PendingPromotionSquare = Result.To;
             bIsWaitingForPromotion = true;
+            if (IsEngineTurn()) return;
             OnPromotionRequested.Broadcast(CurrentTurn, Result.To);
             return;
         }
@@ -481,17 +574,17 @@ namespace we
         if (Result.bIsCheckmate)
         {
             OnCheckmate.Broadcast(CurrentTurn);
-            bIsGameOver = true;
+            FinishGame(WinFor(CurrentTurn), "normal");
         }
         else if (Result.bIsStalemate)
         {
             OnStalemate.Broadcast();
-            bIsGameOver = true;
+            FinishGame("1/2-1/2", "normal");
         }
         else if (Result.bIsDraw)
         {
             OnDraw.Broadcast();
-            bIsGameOver = true;
+            FinishGame("1/2-1/2", "normal");
         }
         else if (Result.bIsCheck)
         {
@@ -499,6 +592,727 @@ namespace we
         }
     }
 
+    // -------------------------------------------------------------------------
+    // Game Record
+    // -------------------------------------------------------------------------
+    void Board::FinishGame(const char* Result, const char* Termination)
+    {
+        if (bIsGameOver) return;
+
+        bIsGameOver = true;
+        GameResult = Result;
+        GameTermination = Termination;
+        Journal.Finish();
+        ExportPgn();
+
+        // Saved on its own thread for the same reason as the PGN
+        ReplaySave = std::async(std::launch::async, [Copy = GameReplay]() { return Copy.Save(LastGameReplayFile); });
+        ReviewCursor = ReplayCursor{ GameReplay };
+        ReviewPly = GameReplay.GetPlyCount();
+    }
+
+    // Only copies the record; SAN is generated on the writer thread
+    void Board::ExportPgn()
+    {
+        const std::string ExternalName = bUseExternalEngine ? ExternalOpponent.GetName() : std::string{};
+        const std::string EngineName = ExternalName.empty() ? "Diablo Inventory Chess" : ExternalName;
+        const auto PlayerName = [this, &EngineName](EPlayerTurn Side) { return bPlayAgainstEngine && Side == EngineSide ? EngineName : std::string{ "Player" }; };
+
+        PgnGame Record;
+        Record.SetTag("Event", "Casual game");
+        Record.SetTag("Site", "Diablo Inventory Chess");
+        Record.SetTag("Date", CurrentPgnDate());
+        Record.SetTag("White", PlayerName(EPlayerTurn::White));
+        Record.SetTag("Black", PlayerName(EPlayerTurn::Black));
+        Record.SetTag("TimeControl", std::to_string(ClockBaseMs / 1000) + "+" + std::to_string(ClockIncrementMs / 1000));
+        if (!GameTermination.empty())
+        {
+            Record.SetTag("Termination", GameTermination);
+        }
+        Record.Result = GameResult;
+
+        // A recovered or reviewed game may not start from the initial position
+        Position Start, Initial;
+        Initial.SetFromFen(Position::StartFen);
+        if (!GameReplay.GetKeyframes().empty() && GameReplay.GetKeyframes().front().Unpack(Start) && Start.GetKey() != Initial.GetKey())
+        {
+            Record.StartFen = Start.GetFen();
+        }
+        Record.Moves = GameReplay.GetMoves();
+        for (std::int32_t ClockMs : GameMoveClocksMs)
+        {
+            Record.Comments.push_back("[%clk " + ChessClock::FormatPgn(ClockMs) + "]");
+        }
+        GameRecorder.Write(std::move(Record));
+        LOG("Exported %d moves (%s)", GameReplay.GetPlyCount(), GameResult.c_str());
+    }
+
+    // -------------------------------------------------------------------------
+    // Autosave Recovery
+    // -------------------------------------------------------------------------
+    void Board::SetRecoveryOffered(bool bOffered)
+    {
+        if (bOffered == bRecoveryOffered) return;
+
+        bRecoveryOffered = bOffered;
+        if (!bRecoveryOffered)
+        {
+            PendingRecovery = JournalRecovery{};
+        }
+        OnRecoveryAvailable.Broadcast(bRecoveryOffered);
+    }
+
+    // The moves were already replayed into the rules core by Recover(); the
+    // actors are respawned once from the final position
+    void Board::RecoverGame()
+    {
+        if (!bRecoveryOffered || bIsGameOver || GameReplay.GetPlyCount() > 0) return;
+
+        const auto Start = std::chrono::steady_clock::now();
+        StopOpponent();
+        bEngineThinking = false;
+
+        GamePosition = PendingRecovery.Final;
+        GameReplay = PendingRecovery.Game;
+        GameMoveClocksMs = PendingRecovery.MoverClocksMs;
+        const List<we::Move>& Moves = GameReplay.GetMoves();
+        LastGameMove = Moves.empty() ? we::Move{} : Moves.back();
+        SyncPiecesToPosition();
+
+        // Each side keeps the time it had after its last move, plus the
+        // increment that move earned. White's first move starts the clock and
+        // earns none, so White has only earned one after its second move
+        GameClock.Reset(ClockBaseMs, ClockIncrementMs);
+        for (EColor Side : { White, Black })
+        {
+            if (PendingRecovery.ClockMs[Side] < 0) continue;
+
+            const bool bEarnedIncrement = Side == Black || GameReplay.GetPlyCount() > 2;
+            GameClock.SetRemainingMs(Side, PendingRecovery.ClockMs[Side] + (bEarnedIncrement ? ClockIncrementMs : 0));
+        }
+        if (!bAnalysisMode)
+        {
+            GameClock.Start(ToColor(CurrentTurn));
+        }
+
+        // The journal is rewritten so it starts cleanly at the recovered game
+        Position Walk;
+        GameReplay.GetKeyframes().front().Unpack(Walk);
+        Journal.Begin(Walk);
+        for (std::size_t i = 0; i < Moves.size(); ++i)
+        {
+            Walk.MakeMove(Moves[i]);
+            Journal.Record(Moves[i], GameMoveClocksMs[i], Walk);
+        }
+
+        LOG("Recovered %d plies%s in %.2f ms", GameReplay.GetPlyCount(), PendingRecovery.bFromSnapshot ? " from a snapshot" : "",
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count());
+        SetRecoveryOffered(false);
+        UpdateBookHint();
+        UpdateExplorer();
+        bAdjudicationPending = true;
+        if (bAnalysisMode)
+        {
+            StartAnalysis();
+        }
+        StartEngineTurn();
+    }
+
+    // -------------------------------------------------------------------------
+    // Replay Review
+    // -------------------------------------------------------------------------
+    void Board::LoadReview(const std::string& Path)
+    {
+        Replay Loaded;
+        if (!Loaded.Load(Path)) return;
+
+        GameReplay = std::move(Loaded);
+        GameMoveClocksMs.clear();
+        ReviewCursor = ReplayCursor{ GameReplay };
+        bIsGameOver = true;
+        LOG("Reviewing %d plies from %s", GameReplay.GetPlyCount(), Path.c_str());
+        SeekReview(GameReplay.GetPlyCount());
+    }
+
+    // Once the game is over: Left / Right step a ply, Home / End jump to the
+    // ends, and dragging with the right button scrubs across the window
+    void Board::HandleReviewInput()
+    {
+        if (!bIsGameOver || ReviewPly < 0 || !m_WindowRef || !m_WindowRef->hasFocus()) return;
+
+        int Keys = 0;
+        Keys |= sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left) ? ReviewBack : 0;
+        Keys |= sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right) ? ReviewForward : 0;
+        Keys |= sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Home) ? ReviewStart : 0;
+        Keys |= sf::Keyboard::isKeyPressed(sf::Keyboard::Key::End) ? ReviewEnd : 0;
+        const int Pressed = Keys & ~ReviewKeysLastFrame;
+        ReviewKeysLastFrame = Keys;
+
+        const int LastPly = GameReplay.GetPlyCount();
+        int Target = ReviewPly;
+        if (sf::Mouse::isButtonPressed(sf::Mouse::Button::Right))
+        {
+            Target = int(std::lround(std::clamp(MouseWorldPosition.x / BoardPixelWidth, 0.f, 1.f) * float(LastPly)));
+        }
+        if (Pressed & ReviewBack) Target = std::max(Target - 1, 0);
+        if (Pressed & ReviewForward) Target = std::min(Target + 1, LastPly);
+        if (Pressed & ReviewStart) Target = 0;
+        if (Pressed & ReviewEnd) Target = LastPly;
+
+        if (Target != ReviewPly)
+        {
+            SeekReview(Target);
+        }
+    }
+
+    // HandleMove is never involved: the cursor makes and unmakes moves in the
+    // rules core, and the actors follow once at the end
+    void Board::SeekReview(int Ply)
+    {
+        if (!ReviewCursor.Seek(Ply))
+        {
+            LOG("Cannot seek the replay to ply %d", Ply);
+            return;
+        }
+
+        ReviewPly = Ply;
+        GamePosition = ReviewCursor.GetPosition();
+        SyncPiecesToPosition();
+        UpdateBookHint();
+        UpdateExplorer();
+        if (bAnalysisMode)
+        {
+            StartAnalysis();
+        }
+
+        std::ostringstream Text;
+        Text << "Ply " << ReviewPly << " / " << GameReplay.GetPlyCount();
+        OnReviewChanged.Broadcast(Text.str());
+    }
+
+    // A recovered game plays on from here, so the pieces' castling and en
+    // passant flags are set from the position as well
+    void Board::SyncPiecesToPosition()
+    {
+        static constexpr EChessPieceType BoardTypes[] = { EChessPieceType::Pawn, EChessPieceType::Pawn, EChessPieceType::Knight,
+            EChessPieceType::Bishop, EChessPieceType::Rook, EChessPieceType::Queen, EChessPieceType::King };
+
+        // A king or rook without a castling right, and a pawn off its start rank, counts as moved
+        const int Rights = GamePosition.GetCastlingRights();
+        RemovePieces();
+        for (Square Sq = 0; Sq < 64; ++Sq)
+        {
+            const EPiece Piece = GamePosition.PieceOn(Sq);
+            if (Piece == NoPiece) continue;
+
+            const EColor Side = ColorOf(Piece);
+            const int BackRank = Side == White ? 0 : 7;
+            const int KingSide = Side == White ? WhiteKingSide : BlackKingSide;
+            const int QueenSide = Side == White ? WhiteQueenSide : BlackQueenSide;
+            bool bMoved = false;
+            switch (TypeOf(Piece))
+            {
+            case King:
+                bMoved = !(Rights & (KingSide | QueenSide));
+                break;
+            case Rook:
+                bMoved = !((Sq == MakeSquare(7, BackRank) && (Rights & KingSide)) || (Sq == MakeSquare(0, BackRank) && (Rights & QueenSide)));
+                break;
+            case Pawn:
+                bMoved = RelativeRank(Side, Sq) != 1;
+                break;
+            default:
+                break;
+            }
+
+            SpawnPiece(BoardTypes[TypeOf(Piece)], Side == White ? EChessColor::White : EChessColor::Black, SquareToGrid(Sq));
+            const shared<ChessPiece> Spawned = GetPieceAt(SquareToGrid(Sq));
+            if (Spawned && bMoved)
+            {
+                Spawned->SetHasMoved();
+            }
+        }
+        if (GamePosition.GetEnPassant() != NoSquare)
+        {
+            if (shared<ChessPiece> Pushed = GetPieceAt(SquareToGrid(GamePosition.GetEnPassant() + PawnPush(~GamePosition.GetSideToMove()))))
+            {
+                Pushed->SetWasPawnMovedTwo(true);
+            }
+        }
+        CurrentTurn = GamePosition.GetSideToMove() == White ? EPlayerTurn::White : EPlayerTurn::Black;
+    }
+
+    // -------------------------------------------------------------------------
+    // Rules Mirror & Opening Book
+    // -------------------------------------------------------------------------
+    Square Board::GridToSquare(const sf::Vector2i& GridPos) const
+    {
+        return MakeSquare(GridPos.x, GridSize - 1 - GridPos.y);
+    }
+
+    void Board::SyncGamePosition(const sf::Vector2i& From, const sf::Vector2i& To, EChessPieceType PromotionType)
+    {
+        static constexpr EPieceType CoreTypes[] = { King, Queen, Bishop, Knight, Rook, Pawn };
+
+        MoveList Moves;
+        GenerateLegalMoves(GamePosition, Moves);
+
+        for (we::Move Candidate : Moves)
+        {
+            if (Candidate.From() == GridToSquare(From) && Candidate.To() == GridToSquare(To)
+                && (!Candidate.IsPromotion() || Candidate.PromotionType() == CoreTypes[int(PromotionType)]))
+            {
+                const EColor Mover = GamePosition.GetSideToMove();
+                if (!Journal.IsRecording() && !bIsGameOver)
+                {
+                    // The first move of a new game replaces whatever could have been recovered
+                    Journal.Begin(GamePosition);
+                    SetRecoveryOffered(false);
+                }
+                GamePosition.MakeMove(Candidate);
+                LastGameMove = Candidate;
+                GameReplay.Append(Candidate);
+                GameMoveClocksMs.push_back(std::int32_t(GameClock.GetRemainingMs(Mover)));
+                Journal.Record(Candidate, GameMoveClocksMs.back(), GamePosition);
+                UpdateBookHint();
+                UpdateExplorer();
+                bAdjudicationPending = true;
+                if (bAnalysisMode)
+                {
+                    StartAnalysis();
+                }
+                return;
+            }
+        }
+
+        LOG("Board move %s%s has no match in the rules mirror", GridToAlgebraic(From).c_str(), GridToAlgebraic(To).c_str());
+    }
+
+    void Board::UpdateBookHint()
+    {
+        BookMove Moves[MaxMoves];
+        const int Count = Book.GetMoves(GamePosition, Moves, MaxMoves);
+
+        int TotalWeight = 0;
+        for (int i = 0; i < Count; ++i)
+        {
+            TotalWeight += Moves[i].Weight;
+        }
+
+        std::stringstream Hint;
+        if (Count > 0)
+        {
+            Hint << "Book:";
+            for (int i = 0; i < std::min(Count, 3); ++i)
+            {
+                Hint << "  " << MoveToUci(Moves[i].BookedMove) << " " << Moves[i].Weight * 100 / TotalWeight << "%";
+            }
+        }
+        OnBookHintChanged.Broadcast(Hint.str());
+    }
+
+    // Queried in place on every move; a lookup reads a few mapped pages and
+    // stays in microseconds, so it runs on the game thread
+    void Board::UpdateExplorer()
+    {
+        ExplorerMove Moves[MaxMoves];
+        const int Count = Explorer.GetMoves(GamePosition, Moves, MaxMoves);
+
+        std::uint64_t TotalGames = 0;
+        for (int i = 0; i < Count; ++i)
+        {
+            TotalGames += Moves[i].GetGames();
+        }
+
+        std::stringstream Text;
+        if (Count > 0)
+        {
+            Text << "Explorer: " << TotalGames << " games";
+            for (int i = 0; i < std::min(Count, ExplorerLineCount); ++i)
+            {
+                const double Games = double(Moves[i].GetGames());
+                Text << "\n" << std::left << std::setw(8) << MoveToSan(GamePosition, Moves[i].PlayedMove) << std::right
+                     << std::setw(8) << Moves[i].GetGames() << std::fixed << std::setprecision(0)
+                     << "   W " << Moves[i].WhiteWins * 100.0 / Games << "%  D " << Moves[i].Draws * 100.0 / Games
+                     << "%  B " << Moves[i].BlackWins * 100.0 / Games << "%";
+            }
+        }
+        OnExplorerChanged.Broadcast(Text.str());
+    }
+
+    void Board::UpdateAdjudication()
+    {
+        const auto IsReady = [](const auto& Future) { return Future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; };
+
+        if (TablebaseLoad.valid())
+        {
+            if (!IsReady(TablebaseLoad)) return;
+            TablebaseLoad.get();
+        }
+
+        // A verdict for a position the game has already left is dropped; the
+        // newer position is still pending and gets probed next
+        if (Adjudication.valid())
+        {
+            if (!IsReady(Adjudication)) return;
+
+            const TablebaseVerdict Verdict = Adjudication.get();
+            if (Verdict.bFound && Verdict.Key == GamePosition.GetKey() && !bIsGameOver && !bIsWaitingForPromotion)
+            {
+                const EPlayerTurn SideToMove = GamePosition.GetSideToMove() == White ? EPlayerTurn::White : EPlayerTurn::Black;
+                const EPlayerTurn Opponent = SideToMove == EPlayerTurn::White ? EPlayerTurn::Black : EPlayerTurn::White;
+
+                if (Verdict.Wdl == Syzygy::WdlWin)
+                {
+                    OnTablebaseWin.Broadcast(SideToMove);
+                    FinishGame(WinFor(SideToMove), "adjudication");
+                }
+                else if (Verdict.Wdl == Syzygy::WdlLoss)
+                {
+                    OnTablebaseWin.Broadcast(Opponent);
+                    FinishGame(WinFor(Opponent), "adjudication");
+                }
+                else
+                {
+                    OnDraw.Broadcast();
+                    FinishGame("1/2-1/2", "adjudication");
+                }
+            }
+        }
+
+        if (!bAdjudicationPending || bIsGameOver || bIsWaitingForPromotion) return;
+        bAdjudicationPending = false;
+        if (!Opponent.GetTablebases().CanProbe(GamePosition)) return;
+
+        // The root probe accounts for the fifty-move counter, so cursed wins and
+        // blessed losses come back as draws the way the game would end
+        Adjudication = std::async(std::launch::async, [this, Pos = GamePosition]() mutable
+        {
+            TablebaseVerdict Verdict;
+            Verdict.Key = Pos.GetKey();
+
+            Syzygy::RootProbe Probe;
+            Verdict.bFound = Opponent.GetTablebases().ProbeRoot(Pos, Probe);
+            Verdict.Wdl = Probe.Wdl == Syzygy::WdlWin || Probe.Wdl == Syzygy::WdlLoss ? Probe.Wdl : Syzygy::WdlDraw;
+            return Verdict;
+        });
+    }
+
+    // -------------------------------------------------------------------------
+    // Engine Opponent & Pondering
+    // -------------------------------------------------------------------------
+    sf::Vector2i Board::SquareToGrid(Square Sq) const
+    {
+        return { FileOf(Sq), GridSize - 1 - RankOf(Sq) };
+    }
+
+    void Board::StartEngineTurn()
+    {
+        if (bIsGameOver || !IsEngineTurn() || bEngineThinking) return;
+        bEngineThinking = true;
+
+        // The ponder search already sits in this position and simply keeps going
+        if (IsOpponentPondering() && LastGameMove == PonderMove)
+        {
+            if (bUseExternalEngine)
+            {
+                ExternalOpponent.PonderHit();
+            }
+            else
+            {
+                Opponent.PonderHit();
+            }
+            return;
+        }
+
+        // Start() stops a ponder on the wrong reply; the TT keeps what it learned
+        StartOpponent(GamePosition, MakeEngineLimits());
+    }
+
+    void Board::UpdateEngine()
+    {
+        if (bIsGameOver)
+        {
+            if (IsOpponentSearching()) StopOpponent();
+            return;
+        }
+        if (!bEngineThinking || IsOpponentSearching()) return;
+
+        bEngineThinking = false;
+        const SearchResult Result = GetOpponentResult();
+        if (Result.BestMove.IsNull()) return;
+
+        PlayEngineMove(Result.BestMove);
+
+        // Search the expected reply while the human thinks
+        PonderMove = Result.PonderMove;
+        if (!bIsGameOver && !IsEngineTurn() && !PonderMove.IsNull())
+        {
+            Position PonderPosition = GamePosition;
+            PonderPosition.MakeMove(PonderMove);
+
+            SearchLimits PonderLimits = MakeEngineLimits();
+            PonderLimits.bPonder = true;
+            StartOpponent(PonderPosition, PonderLimits);
+        }
+    }
+
+    void Board::PlayEngineMove(we::Move EngineMove)
+    {
+        static constexpr EChessPieceType BoardTypes[] = { EChessPieceType::Pawn, EChessPieceType::Pawn, EChessPieceType::Knight,
+            EChessPieceType::Bishop, EChessPieceType::Rook, EChessPieceType::Queen, EChessPieceType::King };
+
+        sf::Vector2i From = SquareToGrid(EngineMove.From());
+        sf::Vector2i To = SquareToGrid(EngineMove.To());
+        shared<ChessPiece> Piece = GetPieceAt(From);
+
+        optional<MoveResult> MoveSim = Piece ? HandleMove(Piece, From, To) : std::nullopt;
+        if (!MoveSim.has_value())
+        {
+            LOG("Engine move %s has no match on the board", MoveToUci(EngineMove).c_str());
+            return;
+        }
+
+        UpdateBoard(MoveSim.value());
+        if (bIsWaitingForPromotion)
+        {
+            ApplyPromotionChoice(BoardTypes[EngineMove.PromotionType()], To);
+        }
+        else
+        {
+            SwitchTurn();
+        }
+    }
+
+    // The clock's remaining times at this moment; the engine's own time does
+    // not run while it ponders, so a ponder search is budgeted the same way
+    SearchLimits Board::MakeEngineLimits() const
+    {
+        SearchLimits Limits;
+        GameClock.FillLimits(Limits);
+        return Limits;
+    }
+
+    // The external engine reports like the analysis search always does; its
+    // lines are simply ignored while nobody is analysing
+    void Board::LaunchExternalEngine(const std::string& Path)
+    {
+        ExternalOpponent.OnInfo = [this](const SearchInfo& Info)
+        {
+            AnalysisQueue.TryPush(AnalysisUpdate{ AnalysisGeneration, Info });
+        };
+        bUseExternalEngine = ExternalOpponent.Launch(Path);
+        if (bUseExternalEngine)
+        {
+            ExternalOpponent.NewGame();
+            LOG("Playing against %s", Path.c_str());
+        }
+    }
+
+    void Board::StartOpponent(const Position& Pos, const SearchLimits& Limits)
+    {
+        if (bUseExternalEngine)
+        {
+            ExternalOpponent.Start(Pos, Limits);
+        }
+        else
+        {
+            // The engine takes no options mid-search, so a search waits for the tablebases
+            if (TablebaseLoad.valid()) TablebaseLoad.wait();
+            Opponent.Start(Pos, Limits);
+        }
+    }
+
+    // The built-in engine stops within a few nodes; the external one is only
+    // told to, and its late result is dropped when the next search starts
+    void Board::StopOpponent()
+    {
+        if (bUseExternalEngine)
+        {
+            ExternalOpponent.Stop();
+        }
+        else
+        {
+            Opponent.Stop();
+            Opponent.Wait();
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Game Clock
+    // -------------------------------------------------------------------------
+    void Board::UpdateClock()
+    {
+        if (bIsGameOver && GameClock.IsRunning())
+        {
+            GameClock.Stop();
+        }
+
+        const EColor Running = GameClock.GetRunningSide();
+        if (GameClock.IsRunning() && GameClock.IsFlagged(Running))
+        {
+            GameClock.Stop();
+
+            // A flag only loses to a side that still has something to mate with
+            const EColor Winner = ~Running;
+            const EPlayerTurn WinnerTurn = Winner == White ? EPlayerTurn::White : EPlayerTurn::Black;
+            if (PopCount(GamePosition.Pieces(Winner)) == 1)
+            {
+                OnDraw.Broadcast();
+                FinishGame("1/2-1/2", "time forfeit");
+            }
+            else
+            {
+                OnTimeForfeit.Broadcast(WinnerTurn);
+                FinishGame(WinFor(WinnerTurn), "time forfeit");
+            }
+        }
+
+        // Only sent when the displayed tenths or seconds change
+        std::ostringstream Text;
+        Text << "White " << ChessClock::Format(GameClock.GetRemainingMs(White))
+             << "   Black " << ChessClock::Format(GameClock.GetRemainingMs(Black));
+        if (Text.str() != ClockText)
+        {
+            ClockText = Text.str();
+            OnClockChanged.Broadcast(ClockText);
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Analysis Mode
+    // -------------------------------------------------------------------------
+    void Board::SetAnalysisMode(bool bEnabled)
+    {
+        if (bEnabled == bAnalysisMode) return;
+
+        // Whatever the engine was doing for the game (thinking or pondering) is dropped
+        StopOpponent();
+        bEngineThinking = false;
+        bAnalysisMode = bEnabled;
+
+        // Analysis is not part of the game, so neither side's time runs
+        if (bAnalysisMode && GameClock.IsRunning())
+        {
+            GameClock.Stop();
+            bClockPaused = true;
+        }
+        else if (!bAnalysisMode && bClockPaused && !bIsGameOver)
+        {
+            GameClock.Start(ToColor(CurrentTurn));
+            bClockPaused = false;
+        }
+
+        if (bAnalysisMode)
+        {
+            Opponent.OnInfo = [this](const SearchInfo& Info)
+            {
+                // A full queue only drops a line; the next iteration sends it again
+                AnalysisQueue.TryPush(AnalysisUpdate{ AnalysisGeneration, Info });
+            };
+            StartAnalysis();
+        }
+        else
+        {
+            Opponent.OnInfo = nullptr;
+            MateFinder.Stop();
+            MateFinder.Wait();
+            bMateSearchPending = false;
+            OnAnalysisChanged.Broadcast("");
+            StartEngineTurn();
+        }
+    }
+
+    // Restarting keeps the transposition table, so the lines for the new
+    // position build on everything searched before the move
+    void Board::StartAnalysis()
+    {
+        StopOpponent();
+        ++AnalysisGeneration;
+        for (SearchInfo& Line : AnalysisLines)
+        {
+            Line = SearchInfo{};
+        }
+        OnAnalysisChanged.Broadcast("Analysing...");
+
+        SearchLimits Limits;
+        Limits.bInfinite = true;
+        Limits.MultiPv = AnalysisLineCount;
+        StartOpponent(GamePosition, Limits);
+
+        MateLimits MateSearch;
+        MateSearch.Nodes = MateSolverNodes;
+        MateText.clear();
+        MateFinder.Start(GamePosition, MateSearch);
+        bMateSearchPending = true;
+    }
+
+    void Board::UpdateAnalysis()
+    {
+        bool bChanged = false;
+        AnalysisUpdate Update;
+        while (AnalysisQueue.TryPop(Update))
+        {
+            if (Update.Generation != AnalysisGeneration || Update.Info.MultiPv > AnalysisLineCount) continue;
+            AnalysisLines[Update.Info.MultiPv - 1] = std::move(Update.Info);
+            bChanged = true;
+        }
+
+        if (bMateSearchPending && !MateFinder.IsSearching())
+        {
+            bMateSearchPending = false;
+            const MateSolution& Solution = MateFinder.GetLastSolution();
+            LOG("Mate solver: %llu nodes, %llu nodes/s, %zu MB table", static_cast<unsigned long long>(Solution.Nodes),
+                static_cast<unsigned long long>(Solution.NodesPerSecond()), Solution.MemoryBytes / (1024 * 1024));
+            if (Solution.Result == EMateResult::Mate)
+            {
+                std::stringstream Line;
+                Line << "Forced mate in " << Solution.MovesToMate << ":";
+                for (const we::Move& Each : Solution.Line)
+                {
+                    Line << " " << MoveToUci(Each);
+                }
+                MateText = Line.str();
+                bChanged = true;
+            }
+        }
+
+        if (!bChanged || !bAnalysisMode) return;
+
+        // Scores are shown from White's side like on a scoresheet
+        const int Sign = GamePosition.GetSideToMove() == White ? 1 : -1;
+        std::stringstream Text;
+        Text << std::fixed << std::setprecision(2);
+        for (int i = 0; i < AnalysisLineCount; ++i)
+        {
+            const SearchInfo& Line = AnalysisLines[i];
+            if (Line.Pv.empty()) continue;
+
+            Text << i + 1 << ". ";
+            if (IsMateScore(Line.Score))
+            {
+                const int MovesToMate = (ScoreMate - std::abs(Line.Score) + 1) / 2;
+                Text << (Line.Score * Sign > 0 ? "#" : "#-") << MovesToMate;
+            }
+            else
+            {
+                Text << std::showpos << Line.Score * Sign / 100.0 << std::noshowpos;
+            }
+            Text << "  d" << Line.Depth << " ";
+
+            for (int Ply = 0; Ply < std::min(int(Line.Pv.size()), AnalysisPvMoves); ++Ply)
+            {
+                Text << " " << MoveToUci(Line.Pv[Ply]);
+            }
+            Text << "\n";
+        }
+        if (!MateText.empty())
+        {
+            Text << MateText << "\n";
+        }
+        OnAnalysisChanged.Broadcast(Text.str());
+    }
+
     bool Board::IsInBounds(const sf::Vector2i& GridPos) const
     {
         return GridPos.x >= 0 && GridPos.x < GridSize && GridPos.y >= 0 && GridPos.y < GridSize;
@@ -963,6 +1777,11 @@ namespace we
 
     void Board::SwitchTurn()
     {
+        // The first move starts the clock, so White's time only runs from move two
+        if (!bAnalysisMode)
+        {
+            GameClock.Press(ToColor(CurrentTurn));
+        }
         CurrentTurn = (CurrentTurn == EPlayerTurn::White) ? EPlayerTurn::Black : EPlayerTurn::White;
     }
 
@@ -1,17 +1,70 @@
 ﻿#include "GameFramework/Game.h"
 #include "GameFramework/Play.h"
 #include "Framework/Assetmanager.h"
+#include "Engine/Benchmark.h"
 #include "config.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
-we::Application* GetApplication()
+// "Chess.exe --bench [depth]" prints the search bench signature and exits.
+// "Chess.exe --learn [file]" keeps the engine's deep results in a learning
+// file (learning.bin by default) and starts every game from them.
+// "Chess.exe --engine <path>" plays and analyses with another UCI engine.
+// "Chess.exe --pgn <file>" appends the games there instead of games.pgn.
+// "Chess.exe --review <file>" opens a replay, such as the last_game.replay
+// every finished game leaves, to step through with the arrow keys.
+// "Chess.exe --hotseat" lets two players share the board, with no engine.
+we::Application* GetApplication(int argc, char** argv)
 {
-	return new we::Game{};
+	if (argc > 1 && std::strcmp(argv[1], "--bench") == 0)
+	{
+		const int Depth = argc > 2 ? std::atoi(argv[2]) : we::DefaultBenchDepth;
+		std::printf("%s\n", we::FormatSearchBenchmark(we::RunSearchBenchmark(Depth)).c_str());
+		return nullptr;
+	}
+
+	std::string LearningFile;
+	std::string ExternalEngine;
+	std::string PgnFile = "games.pgn";
+	std::string ReviewFile;
+	bool bHotSeat = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		const bool bHasValue = i + 1 < argc && argv[i + 1][0] != '-';
+		if (std::strcmp(argv[i], "--learn") == 0)
+		{
+			LearningFile = bHasValue ? argv[++i] : "learning.bin";
+		}
+		else if (std::strcmp(argv[i], "--engine") == 0 && bHasValue)
+		{
+			ExternalEngine = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--pgn") == 0 && bHasValue)
+		{
+			PgnFile = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--review") == 0 && bHasValue)
+		{
+			ReviewFile = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--hotseat") == 0)
+		{
+			bHotSeat = true;
+		}
+	}
+	return new we::Game{ LearningFile, ExternalEngine, PgnFile, ReviewFile, bHotSeat };
 }
 
 namespace we
 {
-	Game::Game()
+	Game::Game(const std::string& InLearningFile, const std::string& InExternalEngine, const std::string& InPgnFile, const std::string& InReviewFile, bool bInHotSeat)
 		: Application{1920, 1080, "Chess", sf::Style::None}
+		, LearningFile{ InLearningFile }
+		, ExternalEngine{ InExternalEngine }
+		, PgnFile{ InPgnFile }
+		, ReviewFile{ InReviewFile }
+		, bHotSeat{ bInHotSeat }
 	{
 		AssetManager::Get().SetAssetRootDirctory(GetAssetDirectory());
 		weak<Play> PlayChess = LoadWorld<Play>();
@@ -24,10 +24,21 @@ namespace we
 		GameMenu.lock()->OnRookSelected.Bind(GetWeakObject(), &Play::ChooseRook);
 		GameMenu.lock()->OnBishopSelected.Bind(GetWeakObject(), &Play::ChooseBishop);
 		GameMenu.lock()->OnKnightSelected.Bind(GetWeakObject(), &Play::ChooseKnight);
+		GameMenu.lock()->OnAnalysisButtonClicked.Bind(GetWeakObject(), &Play::ToggleAnalysis);
+		GameMenu.lock()->OnExportButtonClicked.Bind(GetWeakObject(), &Play::ExportGame);
+		GameMenu.lock()->OnResumeButtonClicked.Bind(GetWeakObject(), &Play::ResumeGame);
 		NewChessGame->OnCheckmate.Bind(GetWeakObject(), &Play::Checkmate);
 		NewChessGame->OnStalemate.Bind(GetWeakObject(), &Play::Stalemate);
 		NewChessGame->OnDraw.Bind(GetWeakObject(), &Play::Draw);
 		NewChessGame->OnPromotionRequested.Bind(GetWeakObject(), &Play::Promotion);
+		NewChessGame->OnBookHintChanged.Bind(GetWeakObject(), &Play::BookHint);
+		NewChessGame->OnTablebaseWin.Bind(GetWeakObject(), &Play::TablebaseWin);
+		NewChessGame->OnAnalysisChanged.Bind(GetWeakObject(), &Play::Analysis);
+		NewChessGame->OnClockChanged.Bind(GetWeakObject(), &Play::Clock);
+		NewChessGame->OnReviewChanged.Bind(GetWeakObject(), &Play::Review);
+		NewChessGame->OnExplorerChanged.Bind(GetWeakObject(), &Play::Explorer);
+		NewChessGame->OnTimeForfeit.Bind(GetWeakObject(), &Play::TimeForfeit);
+		NewChessGame->OnRecoveryAvailable.Bind(GetWeakObject(), &Play::RecoveryAvailable);
 		sf::RenderWindow& Win = GetApplication()->GetRenderer()->GetRenderWindow();
 		sf::Vector2u GameResolution = { 1920, 1080 };
 		ApplyAspectRatio(GetApplication()->IsFullscreen(), Win.getSize(), GameResolution);
@@ -70,6 +81,67 @@ namespace we
 		PromotionSquare = NewPromotionSquare;
 	}
 
+	void Play::BookHint(std::string Hint)
+	{
+		GameMenu.lock()->SetBookHint(Hint);
+	}
+
+	void Play::TablebaseWin(EPlayerTurn Winner)
+	{
+		GameMenu.lock()->SetWinnerText(Winner);
+		GameMenu.lock()->SetVisibility(true);
+		GameMenu.lock()->TablebaseWon();
+		Overlay();
+	}
+
+	void Play::Analysis(std::string Lines)
+	{
+		GameMenu.lock()->SetAnalysisText(Lines);
+	}
+
+	void Play::Clock(std::string Text)
+	{
+		GameMenu.lock()->SetClockText(Text);
+	}
+
+	void Play::Review(std::string Text)
+	{
+		GameMenu.lock()->SetReviewText(Text);
+	}
+
+	void Play::Explorer(std::string Text)
+	{
+		GameMenu.lock()->SetExplorerText(Text);
+	}
+
+	void Play::TimeForfeit(EPlayerTurn Winner)
+	{
+		GameMenu.lock()->SetWinnerText(Winner);
+		GameMenu.lock()->SetVisibility(true);
+		GameMenu.lock()->TimeForfeited();
+		Overlay();
+	}
+
+	void Play::RecoveryAvailable(bool bAvailable)
+	{
+		GameMenu.lock()->SetResumeVisibility(bAvailable);
+	}
+
+	void Play::ToggleAnalysis()
+	{
+		NewChessGame->ToggleAnalysis();
+	}
+
+	void Play::ExportGame()
+	{
+		NewChessGame->ExportGame();
+	}
+
+	void Play::ResumeGame()
+	{
+		NewChessGame->ResumeGame();
+	}
+
 	void Play::RestartGame()
 	{
 		GetApplication()->LoadWorld<Play>();
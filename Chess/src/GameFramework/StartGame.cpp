@@ -19,6 +19,14 @@ namespace we
 			ChessBoard.lock()->OnStalemate.Bind(GetWeakObject(), &StartGame::Stalemate);
 			ChessBoard.lock()->OnDraw.Bind(GetWeakObject(), &StartGame::Draw);
 			ChessBoard.lock()->OnPromotionRequested.Bind(GetWeakObject(), &StartGame::Promotion);
+			ChessBoard.lock()->OnBookHintChanged.Bind(GetWeakObject(), &StartGame::BookHint);
+			ChessBoard.lock()->OnTablebaseWin.Bind(GetWeakObject(), &StartGame::TablebaseWin);
+			ChessBoard.lock()->OnAnalysisChanged.Bind(GetWeakObject(), &StartGame::AnalysisChanged);
+			ChessBoard.lock()->OnClockChanged.Bind(GetWeakObject(), &StartGame::ClockChanged);
+			ChessBoard.lock()->OnReviewChanged.Bind(GetWeakObject(), &StartGame::ReviewChanged);
+			ChessBoard.lock()->OnExplorerChanged.Bind(GetWeakObject(), &StartGame::ExplorerChanged);
+			ChessBoard.lock()->OnTimeForfeit.Bind(GetWeakObject(), &StartGame::TimeForfeit);
+			ChessBoard.lock()->OnRecoveryAvailable.Bind(GetWeakObject(), &StartGame::RecoveryAvailable);
 		}
 	}
 
@@ -46,6 +54,70 @@ namespace we
 		OnPromotionRequested.Broadcast(Color, PromotionSquare);
 	}
 
+	void StartGame::BookHint(std::string Hint)
+	{
+		OnBookHintChanged.Broadcast(Hint);
+	}
+
+	void StartGame::TablebaseWin(EPlayerTurn Winner)
+	{
+		OnTablebaseWin.Broadcast(Winner);
+	}
+
+	void StartGame::AnalysisChanged(std::string Lines)
+	{
+		OnAnalysisChanged.Broadcast(Lines);
+	}
+
+	void StartGame::ClockChanged(std::string Clock)
+	{
+		OnClockChanged.Broadcast(Clock);
+	}
+
+	void StartGame::ReviewChanged(std::string Review)
+	{
+		OnReviewChanged.Broadcast(Review);
+	}
+
+	void StartGame::ExplorerChanged(std::string Explorer)
+	{
+		OnExplorerChanged.Broadcast(Explorer);
+	}
+
+	void StartGame::TimeForfeit(EPlayerTurn Winner)
+	{
+		OnTimeForfeit.Broadcast(Winner);
+	}
+
+	void StartGame::RecoveryAvailable(bool bAvailable)
+	{
+		OnRecoveryAvailable.Broadcast(bAvailable);
+	}
+
+	void StartGame::ToggleAnalysis()
+	{
+		if (!ChessBoard.expired())
+		{
+			ChessBoard.lock()->SetAnalysisMode(!ChessBoard.lock()->IsAnalysing());
+		}
+	}
+
+	void StartGame::ExportGame()
+	{
+		if (!ChessBoard.expired())
+		{
+			ChessBoard.lock()->ExportPgn();
+		}
+	}
+
+	void StartGame::ResumeGame()
+	{
+		if (!ChessBoard.expired())
+		{
+			ChessBoard.lock()->RecoverGame();
+		}
+	}
+
 	void StartGame::PromoteTo(EChessPieceType Choice, sf::Vector2i PromotionSquare)
 	{
 		ChessBoard.lock()->ApplyPromotionChoice(Choice, PromotionSquare);
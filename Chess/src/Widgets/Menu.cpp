@@ -7,21 +7,43 @@ namespace we
 		, QuitButton{ "closebutton.png" }
 		, FullScreenButton{"fullscreenbutton.png"}
 		, MinimizeButton{"minimizebutton.png"}
+		, AnalysisButton{ "button.png" }
+		, ExportButton{ "button.png" }
+		, ResumeButton{ "button.png" }
 		, RestartButtonText{ "Restart" }
+		, AnalysisButtonText{ "Analyze" }
+		, ExportButtonText{ "Export" }
+		, ResumeButtonText{ "Resume" }
 		, CheckmateText{"Checkmate"}
 		, StalemateText{"Stalemate"}
 		, DrawnText{"Draw"}
+		, TablebaseText{"Tablebase"}
+		, TimeoutText{"Timeout"}
 		, FlavorText{"Your deeds of valor will be forgotten"}
 		, WinnerText{"Winner"}
+		, BookHintText{"", "font/exocet.ttf", 28}
+		, AnalysisText{"", "font/exocet.ttf", 28}
+		, ClockText{"", "font/exocet.ttf", 28}
+		, ReviewText{"", "font/exocet.ttf", 28}
+		, ExplorerText{"", "font/exocet.ttf", 24}
 		, PromotionMenu{}
 	{
 		RestartButton.SetVisibility(false);
 		RestartButtonText.SetVisibility(false);
+		ResumeButton.SetVisibility(false);
+		ResumeButtonText.SetVisibility(false);
 		CheckmateText.SetVisibility(false);
 		StalemateText.SetVisibility(false);
 		DrawnText.SetVisibility(false);
+		TablebaseText.SetVisibility(false);
+		TimeoutText.SetVisibility(false);
 		FlavorText.SetVisibility(false);
 		WinnerText.SetVisibility(false);
+		BookHintText.SetVisibility(false);
+		AnalysisText.SetVisibility(false);
+		ClockText.SetVisibility(false);
+		ReviewText.SetVisibility(false);
+		ExplorerText.SetVisibility(false);
 		PromotionMenu.SetVisibility(false);
 	}
 
@@ -32,11 +54,24 @@ namespace we
 		QuitButton.NativeRender(GameRenderer);
 		FullScreenButton.NativeRender(GameRenderer);
 		MinimizeButton.NativeRender(GameRenderer);
+		AnalysisButton.NativeRender(GameRenderer);
+		AnalysisButtonText.NativeRender(GameRenderer);
+		ExportButton.NativeRender(GameRenderer);
+		ExportButtonText.NativeRender(GameRenderer);
+		ResumeButton.NativeRender(GameRenderer);
+		ResumeButtonText.NativeRender(GameRenderer);
 		CheckmateText.NativeRender(GameRenderer);
 		StalemateText.NativeRender(GameRenderer);
 		DrawnText.NativeRender(GameRenderer);
+		TablebaseText.NativeRender(GameRenderer);
+		TimeoutText.NativeRender(GameRenderer);
 		FlavorText.NativeRender(GameRenderer);
 		WinnerText.NativeRender(GameRenderer);
+		BookHintText.NativeRender(GameRenderer);
+		AnalysisText.NativeRender(GameRenderer);
+		ClockText.NativeRender(GameRenderer);
+		ReviewText.NativeRender(GameRenderer);
+		ExplorerText.NativeRender(GameRenderer);
 
 		PromotionMenu.NativeRender(GameRenderer);
 		PromotionMenu.DrawChoices(GameRenderer);
@@ -52,6 +87,9 @@ namespace we
 			|| QuitButton.HandleEvent(Event, GameRenderer)
 			|| FullScreenButton.HandleEvent(Event, GameRenderer)
 			|| MinimizeButton.HandleEvent(Event, GameRenderer)
+			|| AnalysisButton.HandleEvent(Event, GameRenderer)
+			|| ExportButton.HandleEvent(Event, GameRenderer)
+			|| ResumeButton.HandleEvent(Event, GameRenderer)
 			|| PromotionMenu.QueenSelected.HandleEvent(Event, GameRenderer)
 			|| PromotionMenu.RookSelected.HandleEvent(Event, GameRenderer)
 			|| PromotionMenu.BishopSelected.HandleEvent(Event, GameRenderer)
@@ -69,6 +107,9 @@ namespace we
 		QuitButton.OnButtonClicked.Bind(GetWeakObject(), &Menu::QuitButtonClicked);
 		FullScreenButton.OnButtonClicked.Bind(GetWeakObject(), &Menu::FullScreenButtonClicked);
 		MinimizeButton.OnButtonClicked.Bind(GetWeakObject(), &Menu::MinimizeButtonClicked);
+		AnalysisButton.OnButtonClicked.Bind(GetWeakObject(), &Menu::AnalysisButtonClicked);
+		ExportButton.OnButtonClicked.Bind(GetWeakObject(), &Menu::ExportButtonClicked);
+		ResumeButton.OnButtonClicked.Bind(GetWeakObject(), &Menu::ResumeButtonClicked);
 		PromotionMenu.QueenSelected.OnButtonClicked.Bind(GetWeakObject(), &Menu::QueenButtonClicked);
 		PromotionMenu.RookSelected.OnButtonClicked.Bind(GetWeakObject(), &Menu::RookButtonClicked);
 		PromotionMenu.BishopSelected.OnButtonClicked.Bind(GetWeakObject(), &Menu::BishopButtonClicked);
@@ -95,6 +136,21 @@ namespace we
 		OnMinimizeButtonClicked.Broadcast();
 	}
 
+	void Menu::AnalysisButtonClicked()
+	{
+		OnAnalysisButtonClicked.Broadcast();
+	}
+
+	void Menu::ExportButtonClicked()
+	{
+		OnExportButtonClicked.Broadcast();
+	}
+
+	void Menu::ResumeButtonClicked()
+	{
+		OnResumeButtonClicked.Broadcast();
+	}
+
 	void Menu::QueenButtonClicked()
 	{
 		OnQueenSelected.Broadcast();
@@ -133,6 +189,24 @@ namespace we
 		QuitButton.SetWidgetPosition({ ViewportSize.x - 40.f, 70.f });
 		FullScreenButton.SetWidgetPosition({ ViewportSize.x - 114.f, 70.f });
 		MinimizeButton.SetWidgetPosition({ ViewportSize.x - 188.f, 70.f });
+		AnalysisButton.CenterOrigin();
+		AnalysisButtonText.CenterOrigin();
+		AnalysisButtonText.SetColor(sf::Color::Black);
+		AnalysisButtonText.SetOutline(sf::Color::Black, 1.f);
+		AnalysisButton.SetWidgetPosition({ 200.f, 70.f });
+		AnalysisButtonText.SetWidgetPosition(AnalysisButton.GetWidgetPosition());
+		ExportButton.CenterOrigin();
+		ExportButtonText.CenterOrigin();
+		ExportButtonText.SetColor(sf::Color::Black);
+		ExportButtonText.SetOutline(sf::Color::Black, 1.f);
+		ExportButton.SetWidgetPosition({ ViewportSize.x - 200.f, ViewportSize.y - 60.f });
+		ExportButtonText.SetWidgetPosition(ExportButton.GetWidgetPosition());
+		ResumeButton.CenterOrigin();
+		ResumeButtonText.CenterOrigin();
+		ResumeButtonText.SetColor(sf::Color::Black);
+		ResumeButtonText.SetOutline(sf::Color::Black, 1.f);
+		ResumeButton.SetWidgetPosition({ 200.f, 170.f });
+		ResumeButtonText.SetWidgetPosition(ResumeButton.GetWidgetPosition());
 		PromotionMenu.SetWidgetPosition({ ViewportSize.x - 124.f, ViewportSize.y / 2.f });
 	}
 
@@ -141,18 +215,28 @@ namespace we
 		CheckmateText.SetFontSize(80);
 		StalemateText.SetFontSize(80);
 		DrawnText.SetFontSize(80);
+		TablebaseText.SetFontSize(80);
+		TimeoutText.SetFontSize(80);
 		CheckmateText.CenterOrigin();
 		StalemateText.CenterOrigin();
 		DrawnText.CenterOrigin();
+		TablebaseText.CenterOrigin();
+		TimeoutText.CenterOrigin();
 		CheckmateText.SetColor(TextColor);
 		StalemateText.SetColor(TextColor);
 		DrawnText.SetColor(TextColor);
+		TablebaseText.SetColor(TextColor);
+		TimeoutText.SetColor(TextColor);
 		CheckmateText.SetOutline(OutlineColor, 3.f);
 		StalemateText.SetOutline(OutlineColor, 3.f);
 		DrawnText.SetOutline(OutlineColor, 3.f);
+		TablebaseText.SetOutline(OutlineColor, 3.f);
+		TimeoutText.SetOutline(OutlineColor, 3.f);
 		CheckmateText.SetWidgetPosition({ ViewportSize.x / 2.f, 400.f });
 		StalemateText.SetWidgetPosition({ ViewportSize.x / 2.f, 200.f });
 		DrawnText.SetWidgetPosition({ ViewportSize.x / 2.f, 200.f });
+		TablebaseText.SetWidgetPosition({ ViewportSize.x / 2.f, 400.f });
+		TimeoutText.SetWidgetPosition({ ViewportSize.x / 2.f, 400.f });
 
 		FlavorText.CenterOrigin();
 		FlavorText.SetColor(TextColor);
@@ -164,6 +248,26 @@ namespace we
 		WinnerText.SetColor(TextColor);
 		WinnerText.SetOutline(OutlineColor, 3.f);
 		WinnerText.SetWidgetPosition({ ViewportSize.x / 2.f, 300.f });
+
+		BookHintText.SetColor(TextColor);
+		BookHintText.SetOutline(OutlineColor, 1.f);
+		BookHintText.SetWidgetPosition({ 40.f, ViewportSize.y - 80.f });
+
+		AnalysisText.SetColor(TextColor);
+		AnalysisText.SetOutline(OutlineColor, 1.f);
+		AnalysisText.SetWidgetPosition({ 40.f, 160.f });
+
+		ClockText.SetColor(TextColor);
+		ClockText.SetOutline(OutlineColor, 1.f);
+		ClockText.SetWidgetPosition({ 40.f, ViewportSize.y - 130.f });
+
+		ReviewText.SetColor(TextColor);
+		ReviewText.SetOutline(OutlineColor, 1.f);
+		ReviewText.SetWidgetPosition({ 40.f, ViewportSize.y - 180.f });
+
+		ExplorerText.SetColor(TextColor);
+		ExplorerText.SetOutline(OutlineColor, 1.f);
+		ExplorerText.SetWidgetPosition({ 40.f, ViewportSize.y - 340.f });
 	}
 
 	void Menu::SetWinnerText(EPlayerTurn Winner)
@@ -183,6 +287,42 @@ namespace we
 		}
 	}
 
+	void Menu::SetBookHint(const string& Hint)
+	{
+		BookHintText.SetText(Hint);
+		BookHintText.SetVisibility(!Hint.empty());
+	}
+
+	void Menu::SetAnalysisText(const string& Lines)
+	{
+		AnalysisText.SetText(Lines);
+		AnalysisText.SetVisibility(!Lines.empty());
+	}
+
+	void Menu::SetClockText(const string& Clock)
+	{
+		ClockText.SetText(Clock);
+		ClockText.SetVisibility(!Clock.empty());
+	}
+
+	void Menu::SetReviewText(const string& Review)
+	{
+		ReviewText.SetText(Review);
+		ReviewText.SetVisibility(!Review.empty());
+	}
+
+	void Menu::SetExplorerText(const string& Explorer)
+	{
+		ExplorerText.SetText(Explorer);
+		ExplorerText.SetVisibility(!Explorer.empty());
+	}
+
+	void Menu::SetResumeVisibility(bool Visibility)
+	{
+		ResumeButton.SetVisibility(Visibility);
+		ResumeButtonText.SetVisibility(Visibility);
+	}
+
 	void Menu::SetVisibility(bool NewVisibility)
 	{
 		RestartButton.SetVisibility(NewVisibility);
@@ -207,6 +347,20 @@ namespace we
 		DrawnText.SetVisibility(true);
 	}
 
+	void Menu::TablebaseWon()
+	{
+		TablebaseText.SetVisibility(true);
+		WinnerText.CenterOrigin();
+		WinnerText.SetVisibility(true);
+	}
+
+	void Menu::TimeForfeited()
+	{
+		TimeoutText.SetVisibility(true);
+		WinnerText.CenterOrigin();
+		WinnerText.SetVisibility(true);
+	}
+
 	void Menu::PromotionVisibility(EPlayerTurn Color, bool Visibility)
 	{
 		PromotionMenu.SetPieceColor(Color);
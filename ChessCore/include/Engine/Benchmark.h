@@ -0,0 +1,60 @@
+#pragma once
+#include "Framework/Core.h"
+#include <cstdint>
+
+namespace we
+{
+	namespace Nnue { class Network; }
+
+	// ----------------------------------------------------
+	// Micro Benchmarks
+	// ----------------------------------------------------
+	struct EvalBenchmarkResult
+	{
+		std::uint64_t Calls = 0;
+		double Seconds = 0.0;
+		std::int64_t Checksum = 0;
+		std::uint64_t PawnHashProbes = 0;
+		std::uint64_t PawnHashHits = 0;
+
+		double CallsPerSecond() const { return Seconds > 0.0 ? Calls / Seconds : 0.0; }
+		double PawnHashHitRate() const { return PawnHashProbes ? double(PawnHashHits) / PawnHashProbes : 0.0; }
+	};
+
+	struct SearchBenchmarkResult
+	{
+		int Depth = 0;
+		List<std::uint64_t> Nodes;			// One entry per position
+		std::uint64_t TotalNodes = 0;		// The signature: changes only when the search does
+		std::int64_t TimeMs = 0;
+
+		std::uint64_t NodesPerSecond() const { return TimeMs > 0 ? TotalNodes * 1000 / std::uint64_t(TimeMs) : TotalNodes * 1000; }
+	};
+
+	const List<string>& GetBenchPositions();
+
+	// About fifty middlegame, endgame and mate positions for the search bench
+	const List<string>& GetSearchBenchPositions();
+
+	// Evaluates each bench position and then every child with make / unmake
+	// until at least MinCalls evaluations have been made. A network switches
+	// the evaluator to NNUE inference, with the children updated incrementally.
+	EvalBenchmarkResult BenchmarkEvaluation(std::uint64_t MinCalls = 2000000, const Nnue::Network* Network = nullptr, bool bPawnHash = true);
+
+	// Evaluates every leaf of a full-width move tree of the given depth from each
+	// bench position, the order in which a search meets pawn structures
+	EvalBenchmarkResult BenchmarkTreeEvaluation(int Depth, bool bPawnHash);
+
+	// ----------------------------------------------------
+	// Search Bench
+	// ----------------------------------------------------
+	constexpr int DefaultBenchDepth = 12;
+
+	// Searches every search bench position to Depth on one thread with a fresh
+	// hash table and no book, network or tablebases, so the node total is the
+	// same on every build that searches the same tree
+	SearchBenchmarkResult RunSearchBenchmark(int Depth = DefaultBenchDepth);
+
+	// "Nodes searched" / "Nodes/second" summary printed by every bench front end
+	string FormatSearchBenchmark(const SearchBenchmarkResult& Result);
+}
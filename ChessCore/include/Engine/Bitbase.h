@@ -0,0 +1,132 @@
+#pragma once
+#include "Rules/Position.h"
+#include "IO/MappedFile.h"
+
+namespace we
+{
+	enum class EWdl : int
+	{
+		Loss = -1,
+		Draw = 0,
+		Win = 1
+	};
+
+	namespace Bitbase
+	{
+		constexpr int MaxPieces = 4;
+		constexpr int HeaderSize = 16;
+		constexpr std::uint8_t FileVersion = 1;
+
+		// Two bits per position, from the side to move's point of view
+		enum ECode : std::uint8_t
+		{
+			CodeInvalid = 0,
+			CodeDraw = 1,
+			CodeWin = 2,
+			CodeLoss = 3
+		};
+
+		// ------------------------------------------------
+		// Material Signature ("KQKR", stronger side first)
+		// ------------------------------------------------
+		// Tables always store the stronger side as White; a position with the
+		// stronger side on Black is probed colour flipped.
+		struct Material
+		{
+			EPieceType Pieces[2][MaxPieces - 2] = {};	// [0] stronger side, [1] weaker side, kings excluded
+			int Count[2] = { 0, 0 };
+
+			int PieceCount() const { return 2 + Count[0] + Count[1]; }
+			string GetSignature() const;
+			std::uint64_t GetKey() const;
+
+			// Accepts either side first and returns the canonical ordering
+			static bool Parse(const string& Signature, Material& OutMaterial);
+		};
+
+		std::uint64_t MaterialKey(const Position& Pos, EColor Strong);
+		std::size_t IndexCount(int PieceCount);
+
+		// Squares are ordered strong king, weak king, then the Material piece order
+		void Normalize(Square* Squares, int Count);
+		std::size_t IndexOf(const Square* Squares, int Count, int StrongToMove);
+	}
+
+	// ----------------------------------------------------
+	// One Win / Draw / Loss Table
+	// ----------------------------------------------------
+	class BitbaseTable
+	{
+	public:
+		BitbaseTable();
+
+		bool Open(const string& Path);
+		void SetData(const Bitbase::Material& InMaterial, List<std::uint8_t>&& Packed);
+		bool Save(const string& Path) const;
+
+		bool Probe(const Position& Pos, EColor Strong, EWdl& OutWdl) const;
+		Bitbase::ECode ReadCode(std::size_t Index) const { return Bitbase::ECode((Data[Index >> 2] >> ((Index & 3) * 2)) & 3); }
+		const Bitbase::Material& GetMaterial() const { return TableMaterial; }
+
+	private:
+		Bitbase::Material TableMaterial;
+		MappedFile File;
+		List<std::uint8_t> Owned;
+		const std::uint8_t* Data;
+	};
+
+	// ----------------------------------------------------
+	// Loaded Tables, Probed During Search
+	// ----------------------------------------------------
+	// Read-only after loading, so any number of search threads may probe at once.
+	class BitbaseSet
+	{
+	public:
+		BitbaseSet();
+
+		// Maps every "<signature>.bb" file found for the supported material sets
+		int LoadDirectory(const string& Directory);
+		void Add(unique<BitbaseTable> Table);
+		void Clear();
+		const BitbaseTable* Find(const Bitbase::Material& InMaterial) const;
+
+		bool Probe(const Position& Pos, EWdl& OutWdl) const;
+		int GetMaxPieces() const { return MaxLoadedPieces; }
+
+	private:
+		Dictionary<std::uint64_t, unique<BitbaseTable>> Tables;
+		int MaxLoadedPieces;
+	};
+
+	// ----------------------------------------------------
+	// Multithreaded Retrograde Generator
+	// ----------------------------------------------------
+	// Tables reached by captures and promotions are generated first and added
+	// to the same set, so one call can build a whole family of endings.
+	class BitbaseGenerator
+	{
+	public:
+		struct Stats
+		{
+			string Signature;
+			std::size_t Positions = 0;
+			std::size_t Wins = 0;
+			std::size_t Draws = 0;
+			std::size_t Losses = 0;
+			int Passes = 0;
+			double Seconds = 0.0;
+
+			double PositionsPerSecond() const { return Seconds > 0.0 ? Positions / Seconds : 0.0; }
+		};
+
+		BitbaseGenerator(BitbaseSet& InTables, int InThreadCount);
+
+		bool Generate(const string& Signature, List<Stats>& OutStats);
+
+	private:
+		Stats GenerateTable(const Bitbase::Material& InMaterial);
+
+		BitbaseSet& Tables;
+		int ThreadCount;
+	};
+}
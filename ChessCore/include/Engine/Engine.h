@@ -0,0 +1,114 @@
+#pragma once
+#include "Engine/Search.h"
+#include "Engine/OpeningBook.h"
+#include "Engine/Bitbase.h"
+#include "Engine/Syzygy.h"
+#include "Engine/LearningFile.h"
+#include "Engine/TimeManager.h"
+#include <thread>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Asynchronous Engine
+	// ----------------------------------------------------
+	// Start() returns immediately; the search runs on its own threads and
+	// reports through OnInfo / OnBestMove from the main search thread.
+	// Callers that own a render loop should hand those results over to it
+	// rather than touch game state from inside the callbacks.
+	class Engine
+	{
+	public:
+		Engine();
+		~Engine();
+
+		Engine(const Engine&) = delete;
+		Engine& operator=(const Engine&) = delete;
+
+		// ------------------------------------------------
+		// Options (only while idle)
+		// ------------------------------------------------
+		void SetHashSize(std::size_t MegaBytes);
+		void SetThreadCount(int Count);
+		void SetNetwork(const Nnue::Network* InNetwork) { Network = InNetwork; }
+		bool LoadBook(const string& Path);
+		void SetBookEnabled(bool bEnabled) { bUseBook = bEnabled; }
+		void SetBookSeed(std::uint64_t Seed) { Book.SetSeed(Seed); }
+		int LoadBitbases(const string& Directory);		// Replaces the loaded ones; empty unloads them
+		int SetSyzygyPath(const string& Paths);
+		void SetTelemetryLog(const string& Path) { TelemetryLogPath = Path; }	// Appends one JSON line per search; empty disables
+		bool SetLearningFile(const string& Path);		// Merges it into the TT and records deep results to it; empty disables
+		void NewGame();
+
+		int GetThreadCount() const { return int(Workers.size()); }
+		const SyzygyTablebases& GetTablebases() const { return Tablebases; }	// Safe to probe from any thread
+		std::size_t GetHashSize() const { return TT.GetSizeMegaBytes(); }
+
+		// ------------------------------------------------
+		// Searching
+		// ------------------------------------------------
+		void Start(const Position& Pos, const SearchLimits& Limits);
+		void Stop() { bStopRequested = true; }
+		void PonderHit();
+		void Wait();
+		bool IsSearching() const { return bSearching; }
+		bool IsPondering() const { return bPondering; }
+
+		// Blocking convenience wrapper around Start() and Wait()
+		SearchResult Think(const Position& Pos, const SearchLimits& Limits);
+		const SearchResult& GetLastResult() const { return LastResult; }
+
+		// Merges the threads' counters mid-search; once finished, returns the
+		// whole search including the per-iteration times
+		SearchStats GetStatistics() const;
+
+		std::function<void(const SearchInfo&)> OnInfo;
+		std::function<void(const SearchResult&)> OnBestMove;
+
+	private:
+		friend class SearchWorker;
+
+		void RunSearch(Position Pos, SearchLimits Limits);
+		SearchInfo MakeInfo(const SearchWorker& Worker, int Line) const;
+		SearchStats CollectStatistics() const;
+		void AppendTelemetry(const Position& Pos, const SearchResult& Result, const SearchStats& Stats) const;
+		void ReportIteration(const SearchWorker& Worker);
+		bool CheckLimits();
+		bool IsStopRequested() const { return bStopRequested.load(std::memory_order_relaxed); }
+		void WaitForPonderHit();
+		std::int64_t GetElapsedMs() const { return Timer.GetElapsedMs(); }
+		std::uint64_t GetTotalNodes() const;
+
+		TranspositionTable TT;
+		OpeningBook Book;
+		bool bUseBook;
+		BitbaseSet Bitbases;
+		SyzygyTablebases Tablebases;
+		bool bRootInTablebase;
+		const Nnue::Network* Network;
+
+		List<unique<SearchWorker>> Workers;
+		std::thread MainThread;
+		std::atomic<bool> bStopRequested;
+		std::atomic<bool> bSearching;
+		std::atomic<bool> bPondering;
+
+		SearchLimits ActiveLimits;
+		TimeManager Timer;
+		SearchResult LastResult;
+
+		List<IterationStats> Iterations;		// Written by the main search thread
+		SearchStats LastStats;
+		std::int64_t IterationStartMs;
+		std::uint64_t IterationStartNodes;
+		string TelemetryLogPath;
+		LearningFile Learning;
+	};
+
+	// ----------------------------------------------------
+	// UCI Reporting
+	// ----------------------------------------------------
+	// "info depth .. pv .." for one line, and an "info string" with its telemetry
+	string FormatUciInfo(const SearchInfo& Info);
+	string FormatUciStats(const SearchStats& Stats);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "Rules/Position.h"
+#include "Engine/Nnue.h"
+#include "Engine/PawnHash.h"
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Position Evaluation
+	// ----------------------------------------------------
+	// Without a network this is the hand-crafted tapered evaluation: material and
+	// piece-square terms are read from the incrementally updated Position state;
+	// pawn structure comes from a per-evaluator pawn hash and mobility is
+	// computed on demand.
+	// With a network the accumulators are kept per Position state and brought up
+	// to date lazily from the nearest valid ancestor, so one Evaluator per search
+	// thread is expected.
+	class Evaluator
+	{
+	public:
+		int Evaluate(const Position& Pos);
+		int EvaluateClassical(const Position& Pos);
+		int EvaluateNetwork(const Position& Pos);
+
+		// Brings both accumulators of the current state up to date, for callers
+		// that score several positions together with Network::PropagateBatch().
+		// The reference is only valid until the next evaluation.
+		const Nnue::Accumulator& GetAccumulator(const Position& Pos);
+
+		void SetNetwork(const Nnue::Network* InNetwork);
+		bool IsUsingNetwork() const { return Network != nullptr; }
+		const Nnue::Network* GetNetwork() const { return Network; }
+		void SetPawnHashEnabled(bool bEnabled) { bUsePawnHash = bEnabled; }
+		PawnHashTable& GetPawnTable() { return PawnTable; }
+		const PawnHashTable& GetPawnTable() const { return PawnTable; }
+
+		static int Taper(const EvalScore& Score, int Phase);
+		static EvalScore EvaluatePawns(const Position& Pos);
+		static EvalScore EvaluatePawns(const Position& Pos, PawnEntry& Entry);
+		static EvalScore EvaluateMobility(const Position& Pos);
+
+	private:
+		void UpdateAccumulator(const Position& Pos, EColor Perspective);
+
+		const Nnue::Network* Network = nullptr;
+		List<Nnue::Accumulator> Accumulators;
+		PawnHashTable PawnTable;
+		bool bUsePawnHash = true;
+	};
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "Engine/TranspositionTable.h"
+#include "Rules/Position.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace we
+{
+	// One search result as it sits in the file; written in host byte order
+	struct LearnedEntry
+	{
+		HashKey Key = 0;
+		std::int16_t Score = 0;			// Relative to this position, as stored in the TT
+		std::uint16_t BestMove = 0;
+		std::uint8_t Depth = 0;
+		std::uint8_t Bound = 0;
+		std::uint16_t Check = 0;		// Rejects a record torn by a crash mid-append
+	};
+	static_assert(sizeof(LearnedEntry) == 16, "Learning file records are 16 bytes");
+
+	// ----------------------------------------------------
+	// Persistent Learning File
+	// ----------------------------------------------------
+	// An append-only log of deep search results that survives between runs.
+	// MergeInto() maps the file and stores its newest records into the TT, at
+	// most as many as the table holds, so only the tail of a large file is ever
+	// paged in. Record() only queues; a writer thread appends the queue in
+	// batches, so neither the search nor the caller waits on the disk.
+	class LearningFile
+	{
+	public:
+		static constexpr int DefaultMinDepth = 10;
+
+		LearningFile();
+		~LearningFile();
+
+		LearningFile(const LearningFile&) = delete;
+		LearningFile& operator=(const LearningFile&) = delete;
+
+		// Creates the file when missing
+		bool Open(const string& Path);
+		// Writes whatever is still queued
+		void Close();
+		bool IsOpen() const { return bOpen; }
+
+		void SetMinDepth(int Depth) { MinDepth = Depth; }
+		int GetMinDepth() const { return MinDepth; }
+
+		// Returns the number of records stored; the table must not be searched meanwhile
+		std::size_t MergeInto(TranspositionTable& TT) const;
+
+		// The root and the PV positions that were still searched to MinDepth
+		void Record(const Position& Root, int Score, int Depth, const List<Move>& Pv);
+
+	private:
+		void RunWriter();
+
+		string Path;
+		bool bOpen;
+		int MinDepth;
+
+		std::thread Writer;
+		mutable std::mutex Lock;
+		std::condition_variable Wake;
+		List<LearnedEntry> Pending;		// Not yet on disk; the writer drops what it wrote
+		bool bStopWriter;
+	};
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include "Rules/Position.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace we
+{
+	enum class EMateResult
+	{
+		Unknown,		// Node budget spent or stopped
+		Mate,
+		NoMate			// Proven: no mate at all, or none within MaxMoves
+	};
+
+	struct MateLimits
+	{
+		std::uint64_t Nodes = 10000000;		// 0 = until solved or stopped
+		int MaxMoves = 0;					// Mate in at most this many moves; 0 = any length
+	};
+
+	struct MateSolution
+	{
+		EMateResult Result = EMateResult::Unknown;
+		List<Move> Line;					// Fastest mate against the longest defence found
+		int MovesToMate = 0;
+		std::uint64_t Nodes = 0;
+		std::int64_t TimeMs = 0;
+		std::size_t MemoryBytes = 0;		// Hash table size
+
+		std::uint64_t NodesPerSecond() const { return TimeMs > 0 ? Nodes * 1000 / std::uint64_t(TimeMs) : Nodes * 1000; }
+	};
+
+	// ----------------------------------------------------
+	// Depth-first Proof-Number Search
+	// ----------------------------------------------------
+	// Proves or disproves that the side to move can force mate. The side to
+	// move is the attacker; every node keeps a proof and a disproof number in
+	// the solver's own table, and the search always descends into the most
+	// proving child with thresholds, so it needs no more memory than the table.
+	// Repetitions and the ply horizon count as unknown: they refute the attack
+	// on this path only, so nothing resting on them is stored and a root
+	// refuted through them is not reported as NoMate. Like Engine, it can run on its own thread.
+	class MateSolver
+	{
+	public:
+		MateSolver();
+		~MateSolver();
+
+		MateSolver(const MateSolver&) = delete;
+		MateSolver& operator=(const MateSolver&) = delete;
+
+		// ------------------------------------------------
+		// Options (only while idle)
+		// ------------------------------------------------
+		void SetHashSize(std::size_t MegaBytes);
+		void Clear();
+
+		std::size_t GetMemoryBytes() const { return EntryCount * sizeof(Entry); }
+
+		// ------------------------------------------------
+		// Solving
+		// ------------------------------------------------
+		MateSolution Solve(const Position& Pos, const MateLimits& Limits);
+
+		void Start(const Position& Pos, const MateLimits& Limits);
+		void Stop() { bStopRequested = true; }
+		void Wait();
+		bool IsSearching() const { return bSearching; }
+		const MateSolution& GetLastSolution() const { return LastSolution; }
+
+		// Called from the solver thread once a Start()ed search ends
+		std::function<void(const MateSolution&)> OnSolved;
+
+	private:
+		struct Entry
+		{
+			std::uint64_t Key = 0;
+			std::uint32_t Proof = 0;
+			std::uint32_t Disproof = 0;
+			std::uint32_t Work = 0;			// Nodes spent below; the cheapest entry is replaced first
+			std::uint16_t Distance = 0;		// Plies to mate once proven
+		};
+
+		struct Numbers
+		{
+			std::uint32_t Proof = 1;
+			std::uint32_t Disproof = 1;
+			int Distance = 0;
+			bool bPathDependent = false;		// Disproven only through a repetition or the ply horizon
+		};
+
+		// The children of one node on the current path
+		struct Frame
+		{
+			MoveList Moves;
+			HashKey ChildKeys[MaxMoves];
+			Numbers Children[MaxMoves];
+		};
+
+		static constexpr int BucketSize = 4;
+		static constexpr int MaxSolvePly = 128;
+
+		Numbers SolveRoot(const Position& Pos);
+		Numbers SolveUnlimited(const Position& Pos);
+		void Search(Position& Pos, int Ply, int Remaining, std::uint32_t ProofLimit, std::uint32_t DisproofLimit, Numbers& Out);
+		void ExtractLine(Position Pos, int Remaining, List<Move>& OutLine) const;
+		HashKey KeyFor(const Position& Pos, int Remaining) const;
+		bool Lookup(HashKey Key, Numbers& Out) const;
+		void Store(HashKey Key, const Numbers& Value, std::uint64_t Work);
+		bool IsLimited() const { return ActiveLimits.MaxMoves > 0; }
+
+		unique<Entry[]> Table;
+		std::size_t EntryCount;
+		unique<Frame[]> Frames;				// One per ply, kept off the thread's stack
+
+		EColor Attacker;
+		MateLimits ActiveLimits;
+		std::uint64_t Nodes;
+		bool bAborted;
+		std::chrono::steady_clock::time_point StartTime;
+
+		std::thread SolverThread;
+		std::atomic<bool> bStopRequested;
+		std::atomic<bool> bSearching;
+		MateSolution LastSolution;
+	};
+}
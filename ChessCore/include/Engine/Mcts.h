@@ -0,0 +1,167 @@
+#pragma once
+#include "Engine/Search.h"
+#include "Engine/TimeManager.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Monte Carlo Tree Node
+	// ----------------------------------------------------
+	// The children of a node sit next to each other in the arena, so a node only
+	// records where its block starts and how long it is. Visits and ValueSum are
+	// shared by every search thread; ValueSum is fixed point and seen from the
+	// side that played LastMove.
+	struct MctsNode
+	{
+		enum EState : std::uint8_t
+		{
+			Unexpanded,
+			Expanding,							// One thread is generating the children
+			Expanded,
+			Terminal							// Mate, stalemate or a draw by rule
+		};
+
+		Move LastMove;
+		std::uint16_t ChildCount = 0;
+		std::atomic<std::uint8_t> State{ Unexpanded };
+		std::int8_t TerminalValue = 0;			// -1, 0 or 1 once Terminal
+		float Prior = 0.0f;
+		std::uint32_t FirstChild = 0;			// Published by the release store of Expanded
+		std::atomic<std::int32_t> Visits{ 0 };	// Finished playouts plus the ones in flight
+		std::atomic<std::int64_t> ValueSum{ 0 };
+	};
+
+	// ----------------------------------------------------
+	// Node Arena
+	// ----------------------------------------------------
+	// One allocation made up front; threads claim blocks of children with a
+	// single fetch_add and nothing is freed until the whole arena is cleared.
+	class MctsArena
+	{
+	public:
+		static constexpr std::uint32_t InvalidNode = 0xFFFFFFFF;
+
+		MctsArena();
+
+		void Resize(std::size_t MegaBytes);
+		void Clear() { Used.store(0, std::memory_order_relaxed); }
+
+		// InvalidNode once the arena is full
+		std::uint32_t Allocate(std::uint32_t Count);
+
+		MctsNode& operator[](std::uint32_t Index) { return Nodes[Index]; }
+		const MctsNode& operator[](std::uint32_t Index) const { return Nodes[Index]; }
+
+		std::uint32_t GetUsed() const { return std::min(Used.load(std::memory_order_relaxed), Capacity); }
+		std::uint32_t GetCapacity() const { return Capacity; }
+
+	private:
+		unique<MctsNode[]> Nodes;
+		std::uint32_t Capacity;
+		std::atomic<std::uint32_t> Used;
+	};
+
+	// ----------------------------------------------------
+	// PUCT Search
+	// ----------------------------------------------------
+	// An alternative to the alpha-beta Engine for analysis, with the same
+	// Start / Stop / Wait interface, callbacks and telemetry; "nodes" are
+	// playouts. Threads share one tree and spread out with virtual loss. Each
+	// thread selects a batch of leaves before scoring them, so with a network
+	// the batch goes through Network::PropagateBatch() in one call.
+	// The tree is kept between searches: when the next root is found within two
+	// plies of the last one, that subtree is compacted into the second arena and
+	// becomes the new tree.
+	class MctsEngine
+	{
+	public:
+		MctsEngine();
+		~MctsEngine();
+
+		MctsEngine(const MctsEngine&) = delete;
+		MctsEngine& operator=(const MctsEngine&) = delete;
+
+		// ------------------------------------------------
+		// Options (only while idle)
+		// ------------------------------------------------
+		void SetTreeSize(std::size_t MegaBytes);		// Per arena; re-rooting needs two
+		void SetThreadCount(int Count);
+		void SetBatchSize(int Size);
+		void SetNetwork(const Nnue::Network* InNetwork) { Network = InNetwork; }
+		void NewGame();
+
+		int GetThreadCount() const { return ThreadCount; }
+		std::size_t GetTreeSize() const { return TreeMegaBytes; }
+
+		// ------------------------------------------------
+		// Searching
+		// ------------------------------------------------
+		// Limits.Nodes counts playouts and Limits.Depth bounds the average
+		// playout depth; SearchMoves is ignored
+		void Start(const Position& Pos, const SearchLimits& Limits);
+		void Stop() { bStopRequested = true; }
+		void PonderHit();
+		void Wait();
+		bool IsSearching() const { return bSearching; }
+		bool IsPondering() const { return bPondering; }
+
+		SearchResult Think(const Position& Pos, const SearchLimits& Limits);
+		const SearchResult& GetLastResult() const { return LastResult; }
+
+		// Nodes are playouts, so NodesPerSecond() is playouts per second
+		SearchStats GetStatistics() const;
+
+		std::function<void(const SearchInfo&)> OnInfo;
+		std::function<void(const SearchResult&)> OnBestMove;
+
+	private:
+		struct Leaf;
+
+		void RunSearch();
+		void RunWorker(int Index);
+		bool SelectLeaf(Position& Pos, Evaluator& Eval, Leaf& OutLeaf);
+		void Expand(Position& Pos, MctsNode& Node, int Ply);
+		void Backup(const Leaf& Played, float Value);
+		void CancelPlayout(const std::uint32_t* Path, int Length);
+		std::uint32_t SelectChild(const MctsNode& Node) const;
+
+		void ReuseTree(const Position& Pos);
+		void CopySubtree(std::uint32_t From);
+		void ReportLines();
+		void CheckLimits();
+
+		MctsArena& Tree() { return Arenas[ActiveArena]; }
+		const MctsArena& Tree() const { return Arenas[ActiveArena]; }
+		std::uint32_t BestChild(std::uint32_t Node) const;
+		List<Move> GetPv(std::uint32_t Node) const;
+
+		MctsArena Arenas[2];
+		int ActiveArena;
+		std::uint32_t Root;
+		Position RootPos;
+		bool bHasTree;
+
+		std::size_t TreeMegaBytes;
+		int ThreadCount;
+		int BatchSize;
+		const Nnue::Network* Network;
+
+		std::thread MainThread;
+		std::atomic<bool> bStopRequested;
+		std::atomic<bool> bSearching;
+		std::atomic<bool> bPondering;
+		std::atomic<std::uint64_t> Playouts;
+		std::atomic<std::uint64_t> TotalDepth;
+		std::atomic<int> MaxDepth;
+
+		SearchLimits ActiveLimits;
+		TimeManager Timer;
+		std::int64_t NextReportMs;
+		SearchResult LastResult;
+		SearchStats LastStats;
+	};
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "Rules/Position.h"
+#include "IO/MappedFile.h"
+
+namespace we
+{
+	namespace Nnue
+	{
+		// ----------------------------------------------------
+		// Architecture: HalfKP(40960) -> 2x256 -> 32 -> 32 -> 1
+		// ----------------------------------------------------
+		constexpr int PieceSquareInputs = 10 * 64;
+		constexpr int InputSize = 64 * PieceSquareInputs;
+		constexpr int HiddenSize = 256;
+		constexpr int Layer1Size = 32;
+		constexpr int Layer2Size = 32;
+
+		constexpr int ActivationMax = 127;
+		constexpr int WeightShift = 6;
+		constexpr int OutputScale = 16;
+
+		constexpr std::uint32_t FileVersion = 1;
+
+		struct alignas(64) Accumulator
+		{
+			std::int16_t Values[ColorCount][HiddenSize];
+			std::uint64_t Serial[ColorCount] = { 0, 0 };
+		};
+
+		// ----------------------------------------------------
+		// Network Weights
+		// ----------------------------------------------------
+		// Weights are used in place from the mapped file; nothing is copied.
+		// File layout: 64 byte header, then each array below in order, little endian.
+		class Network
+		{
+		public:
+			Network();
+
+			bool LoadFromFile(const string& Path);
+			bool LoadFromMemory(const void* Data, std::size_t Size);
+			bool IsLoaded() const { return FeatureWeights != nullptr; }
+
+			void RefreshAccumulator(const Position& Pos, EColor Perspective, Accumulator& Acc) const;
+			void UpdateAccumulator(const DirtyPieces& Dirty, Square KingSq, EColor Perspective, const Accumulator& From, Accumulator& To) const;
+			int Propagate(const Accumulator& Acc, EColor SideToMove) const;
+
+			// Same scores as Propagate() for Count positions at once; every weight
+			// row is read once for the whole batch while it is still in cache
+			void PropagateBatch(const Accumulator* const* Accs, const EColor* SidesToMove, int Count, int* OutScores) const;
+
+			static std::size_t GetFileSize();
+
+			// A correctly laid out network with random weights, for throughput measurements
+			static List<std::uint8_t> MakeRandomNetwork(std::uint64_t Seed);
+
+		private:
+			MappedFile File;
+
+			const std::int16_t* FeatureBiases;
+			const std::int16_t* FeatureWeights;
+			const std::int32_t* Layer1Biases;
+			const std::int8_t* Layer1Weights;
+			const std::int32_t* Layer2Biases;
+			const std::int8_t* Layer2Weights;
+			const std::int32_t* OutputBias;
+			const std::int8_t* OutputWeights;
+		};
+
+		int FeatureIndex(EColor Perspective, Square KingSq, EPiece Piece, Square Sq);
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "Rules/Position.h"
+#include "IO/MappedFile.h"
+
+namespace we
+{
+	struct BookMove
+	{
+		Move BookedMove;
+		int Weight = 0;
+	};
+
+	// ----------------------------------------------------
+	// Polyglot Layout Opening Book
+	// ----------------------------------------------------
+	// The file is a sorted array of 16 byte big endian entries
+	// (key, move, weight, learn) and is searched in place in the mapping, so a
+	// lookup touches only the handful of pages on its binary search path.
+	// Keys are the Polyglot Random64 keys, so standard .bin books work as well
+	// as those built with chess_book.
+	class OpeningBook
+	{
+	public:
+		static constexpr int EntrySize = 16;
+
+		OpeningBook();
+
+		bool Open(const string& Path);
+		void Close() { File.Close(); }
+		bool IsOpen() const { return File.IsOpen(); }
+		std::size_t GetEntryCount() const { return File.GetSize() / EntrySize; }
+
+		// All legal book moves for the position, heaviest first
+		int GetMoves(const Position& Pos, BookMove* OutMoves, int MaxMoves) const;
+
+		// Weighted random choice among the book moves, NullMove when out of book
+		Move Probe(const Position& Pos);
+		void SetSeed(std::uint64_t Seed) { RandomState = Seed ? Seed : 1; }
+
+		// Polyglot Random64 key; unrelated to Position::GetKey()
+		static HashKey ComputeKey(const Position& Pos);
+
+		// Polyglot move field (to file, to rank, from file, from rank, promotion)
+		static std::uint16_t EncodeMove(Move InMove);
+		static Move DecodeMove(const Position& Pos, std::uint16_t Encoded);
+
+	private:
+		std::size_t LowerBound(HashKey Key) const;
+		HashKey ReadKey(std::size_t Index) const;
+
+		MappedFile File;
+		std::uint64_t RandomState;
+	};
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "Rules/Position.h"
+#include "IO/MappedFile.h"
+
+namespace we
+{
+	// One (position, move) pair with the results of the games that played it
+	struct ExplorerRecord
+	{
+		HashKey Key = 0;
+		std::uint16_t MoveData = 0;			// Move::Data
+		std::uint16_t Reserved = 0;
+		std::uint32_t WhiteWins = 0;
+		std::uint32_t Draws = 0;
+		std::uint32_t BlackWins = 0;
+
+		std::uint64_t GetGames() const { return std::uint64_t(WhiteWins) + Draws + BlackWins; }
+	};
+
+	static_assert(sizeof(ExplorerRecord) == 24, "ExplorerRecord must stay a 24-byte record");
+
+	struct ExplorerMove
+	{
+		Move PlayedMove;
+		std::uint32_t WhiteWins = 0;
+		std::uint32_t Draws = 0;
+		std::uint32_t BlackWins = 0;
+
+		std::uint64_t GetGames() const { return std::uint64_t(WhiteWins) + Draws + BlackWins; }
+	};
+
+	// ----------------------------------------------------
+	// Opening Explorer Index
+	// ----------------------------------------------------
+	// A 16-byte header and then ExplorerRecords sorted by key and move, built
+	// by chess_explorer from PGN archives. The file is searched in place in
+	// the mapping: Zobrist keys are spread evenly, so an interpolation search
+	// lands next to the key in a couple of probes and touches only a few
+	// pages, however large the index is.
+	class OpeningExplorer
+	{
+	public:
+		static constexpr char Magic[8] = { 'W', 'E', 'E', 'X', 'P', 'L', 'O', 'R' };
+		static constexpr std::size_t HeaderSize = 16;		// Magic, record size, reserved
+
+		OpeningExplorer();
+
+		bool Open(const string& Path);
+		void Close() { File.Close(); }
+		bool IsOpen() const { return File.IsOpen(); }
+		std::size_t GetRecordCount() const { return RecordCount; }
+
+		// The legal moves played from the position, most played first
+		int GetMoves(const Position& Pos, ExplorerMove* OutMoves, int MaxMoves) const;
+
+	private:
+		std::size_t LowerBound(HashKey Key) const;
+		HashKey ReadKey(std::size_t Index) const;
+		ExplorerRecord ReadRecord(std::size_t Index) const;
+
+		MappedFile File;
+		std::size_t RecordCount;
+	};
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "Rules/Position.h"
+#include "Engine/EvalParams.h"
+#include <atomic>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Cached Pawn Structure
+	// ----------------------------------------------------
+	// Everything here depends only on the pawns, except the shields, which
+	// also depend on the king squares they were computed for and are redone
+	// in place when a king moves.
+	struct PawnEntry
+	{
+		HashKey Key = 0;
+		EvalScore Score;						// Doubled, isolated, backward and passed pawns, White's view
+		Bitboard PassedPawns[ColorCount] = { 0, 0 };
+		Square ShieldKing[ColorCount] = { NoSquare, NoSquare };
+		EvalScore Shield[ColorCount];
+
+		const EvalScore& GetShield(const Position& Pos, EColor Color);
+	};
+
+	// ----------------------------------------------------
+	// Pawn Hash Table
+	// ----------------------------------------------------
+	// Owned by one Evaluator, so it needs no locking. The counters are only
+	// written by the owning thread but may be read by others for statistics.
+	class PawnHashTable
+	{
+	public:
+		static constexpr std::size_t DefaultEntries = 1 << 14;
+
+		PawnHashTable();
+
+		void Resize(std::size_t EntryCount);
+		void Clear();
+
+		// Returns the entry for the position's pawns, evaluating them on a miss
+		PawnEntry& Probe(const Position& Pos);
+
+		std::uint64_t GetProbes() const { return Probes.load(std::memory_order_relaxed); }
+		std::uint64_t GetHits() const { return Hits.load(std::memory_order_relaxed); }
+		void ResetStats();
+
+		// Fills an entry without touching the table, for callers with no cache
+		static void EvaluateEntry(const Position& Pos, PawnEntry& OutEntry);
+
+	private:
+		static void Increment(std::atomic<std::uint64_t>& Counter) { Counter.store(Counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+		List<PawnEntry> Entries;
+		std::size_t Mask;
+		std::atomic<std::uint64_t> Probes;
+		std::atomic<std::uint64_t> Hits;
+	};
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include "Rules/Position.h"
+#include "Engine/Evaluation.h"
+#include "Engine/TranspositionTable.h"
+#include "Engine/Bitbase.h"
+#include "Engine/SearchStats.h"
+#include <atomic>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Scores
+	// ----------------------------------------------------
+	constexpr int ScoreDraw = 0;
+	constexpr int ScoreMate = 32000;
+	constexpr int ScoreInfinite = 32001;
+	constexpr int ScoreNone = 32002;
+	constexpr int ScoreMateInMaxPly = ScoreMate - MaxPly;
+	constexpr int ScoreKnownWin = 20000;	// Bitbase wins, kept well below the mate range
+
+	inline int MateIn(int Ply) { return ScoreMate - Ply; }
+	inline int MatedIn(int Ply) { return -ScoreMate + Ply; }
+	inline bool IsMateScore(int Score) { return Score >= ScoreMateInMaxPly || Score <= -ScoreMateInMaxPly; }
+
+	// ----------------------------------------------------
+	// Search Requests and Reports
+	// ----------------------------------------------------
+	struct SearchLimits
+	{
+		int Depth = 0;							// 0 searches until stopped by time, nodes or Stop()
+		std::uint64_t Nodes = 0;
+		std::int64_t MoveTime = 0;				// Milliseconds
+		std::int64_t Time[ColorCount] = { 0, 0 };
+		std::int64_t Increment[ColorCount] = { 0, 0 };
+		int MovesToGo = 0;
+		bool bInfinite = false;
+		bool bPonder = false;					// Time and node limits wait for Engine::PonderHit()
+		int MultiPv = 1;						// Lines reported per iteration, best first
+		List<Move> SearchMoves;					// Empty searches every legal move
+	};
+
+	struct PvLine
+	{
+		int Score = 0;
+		List<Move> Pv;
+	};
+
+	// One line of one iteration; Multi-PV searches report every line in turn
+	struct SearchInfo
+	{
+		int MultiPv = 1;
+		int Depth = 0;
+		int SelDepth = 0;
+		int Score = 0;
+		std::uint64_t Nodes = 0;
+		std::int64_t TimeMs = 0;
+		int Hashfull = 0;
+		std::uint64_t PawnHashProbes = 0;
+		std::uint64_t PawnHashHits = 0;
+		SearchStats Stats;
+		List<Move> Pv;
+
+		std::uint64_t NodesPerSecond() const { return TimeMs > 0 ? Nodes * 1000 / std::uint64_t(TimeMs) : Nodes * 1000; }
+		double PawnHashHitRate() const { return PawnHashProbes ? double(PawnHashHits) / PawnHashProbes : 0.0; }
+	};
+
+	struct SearchResult
+	{
+		Move BestMove;
+		Move PonderMove;
+		int Score = 0;
+		int Depth = 0;
+		std::uint64_t Nodes = 0;
+		bool bFromBook = false;
+	};
+
+	class Engine;
+
+	// ----------------------------------------------------
+	// One Lazy SMP Search Thread
+	// ----------------------------------------------------
+	// Every worker runs its own iterative deepening on a private Position and
+	// Evaluator; workers only communicate through the shared transposition table.
+	class SearchWorker
+	{
+	public:
+		SearchWorker(Engine& InOwner, int InIndex);
+
+		void Run(const Position& Root, const SearchLimits& Limits);
+		void ClearHistory();
+
+		std::uint64_t GetNodes() const { return Nodes.load(std::memory_order_relaxed); }
+		int GetCompletedDepth() const { return CompletedDepth; }
+		int GetBestScore() const { return BestScore; }
+		int GetSelDepth() const { return SelDepth; }
+		const List<Move>& GetBestPv() const { return BestPv; }
+		const List<PvLine>& GetLines() const { return Lines; }
+		const PawnHashTable& GetPawnTable() const { return Eval.GetPawnTable(); }
+		const SearchCounters& GetCounters() const { return Counters; }
+		bool IsMainThread() const { return Index == 0; }
+
+	private:
+		int AlphaBeta(int Alpha, int Beta, int Depth, int Ply, bool bNullAllowed);
+		int Quiescence(int Alpha, int Beta, int Ply);
+		int EvaluateClamped();
+		int KnownWinProgress(EColor Winner) const;
+
+		void ScoreMoves(const MoveList& Moves, int* Scores, Move TTMove, int Ply) const;
+		static Move PickNext(MoveList& Moves, int* Scores, int Index);
+		void UpdateQuietStats(Move Best, const Move* Quiets, int QuietCount, int Depth, int Ply);
+		void UpdatePv(int Ply, Move BestMove);
+		bool IsRootMoveAllowed(Move Candidate) const;
+		bool ShouldStop();
+
+		void CountNode() { Nodes.store(Nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+		Engine& Owner;
+		int Index;
+		Position Pos;
+		Evaluator Eval;
+		const List<Move>* SearchMoves;
+		List<Move> ExcludedRootMoves;			// Roots of the lines already found this iteration
+		std::uint64_t RootMaterial;
+
+		std::atomic<std::uint64_t> Nodes;
+		SearchCounters Counters;
+		int SelDepth;
+		int CompletedDepth;
+		int BestScore;
+		List<Move> BestPv;
+		List<PvLine> Lines;
+
+		int StaticEvals[MaxPly + 1];
+		Move Killers[MaxPly + 1][2];
+		int History[ColorCount][64][64];
+		Move PvTable[MaxPly + 1][MaxPly + 1];
+		int PvLength[MaxPly + 1];
+	};
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "Framework/Core.h"
+#include <atomic>
+#include <cstdint>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Search Telemetry
+	// ----------------------------------------------------
+	struct IterationStats
+	{
+		int Depth = 0;
+		std::int64_t TimeMs = 0;				// Spent on this iteration alone
+		std::uint64_t Nodes = 0;				// Searched in this iteration alone, every thread
+	};
+
+	// A merged snapshot of every search thread's counters
+	struct SearchStats
+	{
+		int Threads = 0;
+		std::int64_t TimeMs = 0;
+		std::uint64_t Nodes = 0;				// Includes QNodes
+		std::uint64_t QNodes = 0;
+		std::uint64_t TTProbes = 0;
+		std::uint64_t TTHits = 0;
+		std::uint64_t BetaCutoffs = 0;
+		std::uint64_t FirstMoveCutoffs = 0;
+		std::uint64_t NullMoveTries = 0;
+		std::uint64_t NullMoveCutoffs = 0;
+		List<IterationStats> Iterations;		// Main thread only
+
+		std::uint64_t NodesPerSecond() const { return TimeMs > 0 ? Nodes * 1000 / std::uint64_t(TimeMs) : Nodes * 1000; }
+		double TTHitRate() const { return TTProbes ? double(TTHits) / TTProbes : 0.0; }
+		double FirstMoveCutoffRate() const { return BetaCutoffs ? double(FirstMoveCutoffs) / BetaCutoffs : 0.0; }
+		double NullMoveSuccessRate() const { return NullMoveTries ? double(NullMoveCutoffs) / NullMoveTries : 0.0; }
+
+		// Sums the time and counters of a further search; iterations are not kept
+		void Accumulate(const SearchStats& Other);
+
+		// Geometric mean of the growth in nodes from one iteration to the next
+		double BranchingFactor() const;
+
+		// One JSON object on a single line, for appending to a log per move
+		string ToJson() const;
+	};
+
+	// ----------------------------------------------------
+	// Per-Thread Counters
+	// ----------------------------------------------------
+	// Written only by the owning search thread, so increments need no atomic
+	// read-modify-write; any thread may read them to merge a snapshot.
+	class SearchCounters
+	{
+	public:
+		enum ECounter : int
+		{
+			QNodes,
+			TTProbes,
+			TTHits,
+			BetaCutoffs,
+			FirstMoveCutoffs,
+			NullMoveTries,
+			NullMoveCutoffs,
+			CounterCount
+		};
+
+		SearchCounters();
+
+		void Increment(ECounter Counter) { Values[Counter].store(Values[Counter].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+		void Reset();
+		void AddTo(SearchStats& OutStats) const;
+
+	private:
+		std::atomic<std::uint64_t> Values[CounterCount];
+	};
+}
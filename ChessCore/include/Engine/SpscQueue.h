@@ -0,0 +1,63 @@
+#pragma once
+#include "Framework/Core.h"
+#include <atomic>
+#include <cstddef>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Lock-free Single Producer / Single Consumer Queue
+	// ----------------------------------------------------
+	// A fixed ring of Capacity slots (a power of two). Neither side ever waits:
+	// TryPush() fails when the ring is full and TryPop() when it is empty, so a
+	// search thread can hand results to a render loop without either stalling.
+	// The indices only grow; each sits on its own cache line so the producer and
+	// consumer do not invalidate each other's writes.
+	template<typename T, std::size_t Capacity>
+	class SpscQueue
+	{
+		static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+	public:
+		SpscQueue()
+			: Slots{}
+			, Head{ 0 }
+			, Tail{ 0 }
+		{
+		}
+
+		SpscQueue(const SpscQueue&) = delete;
+		SpscQueue& operator=(const SpscQueue&) = delete;
+
+		// Producer thread only
+		bool TryPush(T&& Item)
+		{
+			const std::size_t Write = Tail.load(std::memory_order_relaxed);
+			if (Write - Head.load(std::memory_order_acquire) == Capacity) { return false; }
+
+			Slots[Write & (Capacity - 1)] = std::move(Item);
+			Tail.store(Write + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Consumer thread only
+		bool TryPop(T& OutItem)
+		{
+			const std::size_t Read = Head.load(std::memory_order_relaxed);
+			if (Read == Tail.load(std::memory_order_acquire)) { return false; }
+
+			OutItem = std::move(Slots[Read & (Capacity - 1)]);
+			Head.store(Read + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool IsEmpty() const { return Head.load(std::memory_order_acquire) == Tail.load(std::memory_order_acquire); }
+
+	private:
+		static constexpr std::size_t CacheLine = 64;
+
+		T Slots[Capacity];
+		alignas(CacheLine) std::atomic<std::size_t> Head;
+		alignas(CacheLine) std::atomic<std::size_t> Tail;
+	};
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "Rules/Position.h"
+#include <mutex>
+
+namespace we
+{
+	namespace Syzygy
+	{
+		constexpr int MaxPieces = 7;
+
+		// From the side to move's point of view; cursed wins and blessed losses
+		// are draws under the fifty-move rule
+		enum EWdlScore : int
+		{
+			WdlLoss = -2,
+			WdlBlessedLoss = -1,
+			WdlDraw = 0,
+			WdlCursedWin = 1,
+			WdlWin = 2
+		};
+
+		enum EProbeState : int
+		{
+			ProbeChangeStm = -1,		// DTZ table stores the other side to move
+			ProbeFail = 0,
+			ProbeOk = 1,
+			ProbeZeroingBestMove = 2	// Best move zeroes the fifty-move counter
+		};
+
+		struct RootProbe
+		{
+			List<Move> BestMoves;		// Every move sharing the best DTZ rank
+			EWdlScore Wdl = WdlDraw;
+			int Dtz = 0;				// Plies to the next zeroing move from the root, signed like Wdl
+		};
+
+		struct Table;
+	}
+
+	// ----------------------------------------------------
+	// Syzygy WDL / DTZ Tablebases
+	// ----------------------------------------------------
+	// Init() only records which files exist; each file is memory mapped on its
+	// first probe. Probing is const and lock-free once a table is mapped, so
+	// every search thread can share one instance.
+	class SyzygyTablebases
+	{
+	public:
+		SyzygyTablebases();
+		~SyzygyTablebases();
+
+		SyzygyTablebases(const SyzygyTablebases&) = delete;
+		SyzygyTablebases& operator=(const SyzygyTablebases&) = delete;
+
+		// Paths are separated by ';' on Windows and ':' elsewhere; returns the number of tables found
+		int Init(const string& Paths);
+		int GetMaxPieces() const { return MaxCardinality; }
+		bool CanProbe(const Position& Pos) const { return PopCount(Pos.Pieces()) <= MaxCardinality && Pos.GetCastlingRights() == NoCastling; }
+
+		bool ProbeWdl(Position& Pos, Syzygy::EWdlScore& OutWdl) const;
+		bool ProbeDtz(Position& Pos, int& OutDtz) const;
+		bool ProbeRoot(Position& Pos, Syzygy::RootProbe& OutProbe) const;
+
+	private:
+		int SearchWdl(Position& Pos, Syzygy::EProbeState& State, bool bCheckZeroingMoves) const;
+		int ProbeDtzScore(Position& Pos, Syzygy::EProbeState& State) const;
+		int ProbeTable(const Position& Pos, int Type, int Wdl, Syzygy::EProbeState& State) const;
+		bool MapTable(Syzygy::Table& Entry, int Type) const;
+		void AddTable(const List<EPieceType>& Pieces);
+
+		List<string> Paths;
+		List<unique<Syzygy::Table>> Tables;
+		Dictionary<std::uint64_t, Syzygy::Table*> TablesByKey;
+		int MaxCardinality;
+		mutable std::mutex MapMutex;
+	};
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "Engine/Search.h"
+#include <chrono>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Search Time Budget
+	// ----------------------------------------------------
+	// Splits the remaining clock time into a soft limit, after which no new
+	// iteration starts, and a hard limit that stops the search mid-iteration.
+	// Times are kept in microseconds on the steady clock so the hard limit
+	// can be polled from inside the search without rounding it away.
+	class TimeManager
+	{
+	public:
+		TimeManager();
+
+		// Starts timing a search for the side Us; no limit means none applies
+		void Init(const SearchLimits& Limits, EColor Us);
+
+		std::int64_t GetElapsedUs() const;
+		std::int64_t GetElapsedMs() const { return GetElapsedUs() / 1000; }
+		std::int64_t GetSoftLimitMs() const { return SoftLimitUs / 1000; }
+		std::int64_t GetHardLimitMs() const { return HardLimitUs / 1000; }
+		bool HasLimit() const { return HardLimitUs > 0; }
+
+		bool IsSoftLimitReached() const { return SoftLimitUs && GetElapsedUs() >= SoftLimitUs; }
+		bool IsHardLimitReached() const { return HardLimitUs && GetElapsedUs() >= HardLimitUs; }
+
+		// An iteration takes about twice as long as the one before it, so one
+		// that would end well past the hard limit is not worth starting
+		bool CanStartIteration(std::int64_t LastIterationMs) const;
+
+	private:
+		std::chrono::steady_clock::time_point StartTime;
+		std::int64_t SoftLimitUs;
+		std::int64_t HardLimitUs;
+	};
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "Rules/ChessTypes.h"
+#include "Framework/Core.h"
+#include <atomic>
+
+namespace we
+{
+	enum EBound : int
+	{
+		BoundNone = 0,
+		BoundUpper = 1,
+		BoundLower = 2,
+		BoundExact = BoundUpper | BoundLower
+	};
+
+	struct TTHit
+	{
+		Move BestMove;
+		int Score = 0;
+		int StaticEval = 0;
+		int Depth = 0;
+		EBound Bound = BoundNone;
+	};
+
+	// ----------------------------------------------------
+	// Shared Transposition Table
+	// ----------------------------------------------------
+	// Every search thread reads and writes the same table without locks. Each
+	// entry stores its key xor'ed with its data, so an entry torn by two racing
+	// writers fails the key check instead of returning a mixed result.
+	class TranspositionTable
+	{
+	public:
+		TranspositionTable();
+
+		void Resize(std::size_t MegaBytes);
+		void Clear();
+		void NewSearch() { Generation = (Generation + 1) & GenerationMask; }
+
+		bool Probe(HashKey Key, TTHit& OutHit) const;
+		void Store(HashKey Key, Move BestMove, int Score, int StaticEval, int Depth, EBound Bound);
+		void Prefetch(HashKey Key) const;
+
+		// Permille of sampled entries written during the current search
+		int Hashfull() const;
+		std::size_t GetSizeMegaBytes() const { return SizeMegaBytes; }
+		std::size_t GetEntryCount() const { return BucketCount * BucketSize; }
+
+	private:
+		struct Entry
+		{
+			std::atomic<std::uint64_t> KeyXorData{ 0 };
+			std::atomic<std::uint64_t> Data{ 0 };
+		};
+
+		static constexpr int BucketSize = 4;
+		static constexpr int GenerationMask = 63;
+
+		struct alignas(64) Bucket
+		{
+			Entry Entries[BucketSize];
+		};
+
+		Bucket& BucketFor(HashKey Key) const { return Buckets[Key & (BucketCount - 1)]; }
+
+		static std::uint64_t Pack(Move BestMove, int Score, int StaticEval, int Depth, EBound Bound, int InGeneration);
+
+		unique<Bucket[]> Buckets;
+		std::size_t BucketCount;
+		std::size_t SizeMegaBytes;
+		int Generation;
+	};
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "Engine/Search.h"
+#include "IO/ChildProcess.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// External UCI Engine
+	// ----------------------------------------------------
+	// Drives another engine binary through its stdin and stdout with the same
+	// Start / Stop / OnInfo / OnBestMove shape as Engine. Every call only
+	// queues a command and returns; one I/O thread writes the queue, reads
+	// the child's output and reports from there, so nothing the caller does
+	// ever waits on the child. Each "go" is answered by exactly one
+	// "bestmove", which is how results of stopped searches are told apart
+	// from the current one and dropped.
+	class UciEngine
+	{
+	public:
+		UciEngine();
+		~UciEngine();
+
+		UciEngine(const UciEngine&) = delete;
+		UciEngine& operator=(const UciEngine&) = delete;
+
+		// Assign the callbacks first; they are called from the I/O thread
+		bool Launch(const string& Path, const List<string>& Arguments = {});
+		void Quit();		// Asks the engine to quit and kills it if it has not within a second
+
+		bool IsRunning() const { return bRunning; }
+		bool IsReady() const { return bUciOk; }		// "uciok" has arrived
+		string GetName() const;
+
+		// ------------------------------------------------
+		// Options (sent in order, so they apply from the next search on)
+		// ------------------------------------------------
+		void SetOption(const string& Name, const string& Value);
+		void NewGame();
+
+		// ------------------------------------------------
+		// Searching
+		// ------------------------------------------------
+		// Stops a search still running; its result is never reported
+		void Start(const Position& Pos, const SearchLimits& Limits);
+		void Stop();
+		void PonderHit();
+		bool IsSearching() const { return PendingSearches > 0; }
+		bool IsPondering() const { return bPondering; }
+		SearchResult GetLastResult() const;
+
+		std::function<void(const SearchInfo&)> OnInfo;
+		std::function<void(const SearchResult&)> OnBestMove;
+
+	private:
+		void Send(const string& Command);
+		void RunIo();
+		void HandleLine(const string& Line);
+		bool ParseInfo(const string& Line, const Position& Root, SearchInfo& OutInfo) const;
+		void FinishSearches();
+		static string FormatGo(const SearchLimits& Limits);
+
+		ChildProcess Process;
+		std::thread IoThread;
+		std::atomic<bool> bRunning;
+		std::atomic<bool> bUciOk;
+		std::atomic<bool> bQuitRequested;
+		std::atomic<int> PendingSearches;
+		std::atomic<bool> bPondering;
+
+		mutable std::mutex Lock;				// Guards everything below
+		string Outbox;							// Commands the pipe has not taken yet
+		std::size_t HandshakeBytes;				// Of Outbox, what may go out before uciok
+		List<Position> Roots;					// One per "go" still to be answered, oldest first
+		SearchInfo LastInfo;					// Best line of the current search
+		SearchResult LastResult;
+		string Name;
+		int SentMultiPv;
+	};
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "Framework/Core.h"
+#include <cstddef>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Child Process with Non-blocking Pipes
+	// ----------------------------------------------------
+	// The child's stdin and stdout are pipes on our side; neither Read() nor
+	// Write() ever waits on the child, so a stalled process cannot stall the
+	// thread talking to it. Its stderr is left attached to ours.
+	class ChildProcess
+	{
+	public:
+		ChildProcess();
+		~ChildProcess();
+
+		ChildProcess(const ChildProcess&) = delete;
+		ChildProcess& operator=(const ChildProcess&) = delete;
+
+		bool Launch(const string& Path, const List<string>& Arguments = {});
+		void Terminate();						// Kills the child if it is still running
+		bool WaitForExit(int TimeoutMs);		// True once the child has exited and been reaped
+
+		bool IsLaunched() const { return bLaunched; }
+
+		// Bytes read or written, 0 when the pipe is not ready, -1 once it is closed
+		std::ptrdiff_t Read(char* Buffer, std::size_t Size);
+		std::ptrdiff_t Write(const char* Data, std::size_t Size);
+
+		// Waits at most TimeoutMs for output; used to idle without spinning
+		bool WaitReadable(int TimeoutMs);
+
+	private:
+		void Reset();
+		void ClosePipes();
+
+		bool bLaunched;
+#ifdef _WIN32
+		void* ProcessHandle;
+		void* InputWrite;
+		void* OutputRead;
+#else
+		int ProcessId;
+		int InputWrite;
+		int OutputRead;
+#endif
+	};
+}
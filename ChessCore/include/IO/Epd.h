@@ -0,0 +1,27 @@
+#pragma once
+#include "Rules/Position.h"
+#include <utility>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Extended Position Description
+	// ----------------------------------------------------
+	// The four FEN board fields followed by "opcode operand ...;" operations,
+	// e.g. 'r1b1k2r/... w KQkq - bm Qxf7+; id "WAC.002";'
+	struct EpdRecord
+	{
+		string Fen;										// hmvc / fmvn fill the counters when present
+		List<std::pair<string, List<string>>> Operations;	// In file order, quotes removed
+
+		const List<string>* FindOperation(const string& Opcode) const;
+		string GetId() const;
+
+		// "bm" / "am" operands resolved against the position; unparsable ones are dropped
+		List<Move> GetMoves(const string& Opcode) const;
+	};
+
+	// False for blank lines, comments and invalid positions
+	bool ParseEpdLine(const string& Line, EpdRecord& OutRecord);
+	List<EpdRecord> LoadEpdFile(const string& Path);
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "IO/Replay.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace we
+{
+	// What a journal holds of a game that never finished
+	struct JournalRecovery
+	{
+		Position Final;
+		Replay Game;						// From the game's start, or from a snapshot when moves before it were lost
+		List<std::int32_t> MoverClocksMs;	// One per move of Game
+		std::int32_t ClockMs[ColorCount] = { -1, -1 };	// Each side's time after its last move; -1 when it has not moved
+		bool bFromSnapshot = false;
+	};
+
+	// ----------------------------------------------------
+	// Crash-safe Game Journal
+	// ----------------------------------------------------
+	// An append-only file of 8-byte move entries, each with the mover's clock,
+	// and a PackedPosition snapshot every SnapshotInterval plies. Every entry
+	// carries a check byte, so a write torn by a crash only loses the entries
+	// after it. Like LearningFile, the calls only queue: a writer thread
+	// appends and syncs whatever has built up in one batch, so a move never
+	// waits for the disk.
+	class GameJournal
+	{
+	public:
+		static constexpr int SnapshotInterval = 32;
+
+		GameJournal();
+		~GameJournal();
+
+		GameJournal(const GameJournal&) = delete;
+		GameJournal& operator=(const GameJournal&) = delete;
+
+		// Starts the writer; the file is left alone until Begin()
+		void Open(const string& InPath);
+		void Close();			// Writes and syncs everything still queued first
+		bool IsOpen() const { return Writer.joinable(); }
+		bool IsRecording() const { return bRecording; }
+
+		// ------------------------------------------------
+		// Recording
+		// ------------------------------------------------
+		void Begin(const Position& Start);		// Replaces whatever the file held
+		void Record(Move Played, std::int64_t MoverClockMs, const Position& After);
+		void Finish();							// Marks the game over, so it is not offered for recovery
+
+		// ------------------------------------------------
+		// Recovery
+		// ------------------------------------------------
+		// Plays the journal's moves into the rules core, checking them against
+		// the snapshots; a move that does not fit resumes from the next good
+		// snapshot. False when the file holds no unfinished game with moves.
+		static bool Recover(const string& Path, JournalRecovery& Out);
+
+	private:
+		void Queue(std::uint8_t Type, std::uint16_t MoveData, std::int32_t Value, const PackedPosition* Snapshot);
+		void RunWriter();
+
+		string Path;
+		bool bRecording;
+		int Plies;
+
+		std::thread Writer;
+		std::mutex Lock;
+		std::condition_variable Wake;
+		List<std::uint8_t> Pending;
+		bool bTruncate;						// Begin() was called since the last batch
+		bool bStopWriter;
+	};
+}
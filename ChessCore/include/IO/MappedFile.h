@@ -0,0 +1,43 @@
+#pragma once
+#include "Framework/Core.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Read-only Memory Mapped File
+	// ----------------------------------------------------
+	// Pages are faulted in by the OS on first touch, so large tables cost
+	// resident memory only for the parts that are actually read.
+	class MappedFile
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& Other) noexcept;
+		MappedFile& operator=(MappedFile&& Other) noexcept;
+
+		bool Open(const string& Path);
+		void Close();
+
+		bool IsOpen() const { return Data != nullptr; }
+		const std::uint8_t* GetData() const { return Data; }
+		std::size_t GetSize() const { return Size; }
+
+	private:
+		void Reset();
+
+		const std::uint8_t* Data;
+		std::size_t Size;
+#ifdef _WIN32
+		void* FileHandle;
+		void* MappingHandle;
+#else
+		int FileDescriptor;
+#endif
+	};
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "Rules/Position.h"
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Packed Position (32 bytes)
+	// ----------------------------------------------------
+	// A fixed-size record for large position files: the occupancy bitboard,
+	// then one 4-bit piece code per occupied square from a1 upwards, then the
+	// game state. Scores and results are from White's point of view so a file
+	// can be read without unpacking each position first.
+	struct PackedPosition
+	{
+		enum EResult : std::uint8_t
+		{
+			BlackWins = 0,
+			Draw = 1,
+			WhiteWins = 2
+		};
+
+		std::uint64_t Occupied = 0;
+		std::uint8_t Pieces[16] = {};
+		std::uint8_t Flags = 0;				// Bit 0: black to move, bits 1-4: castling rights
+		std::uint8_t EnPassant = NoSquare;
+		std::uint8_t HalfmoveClock = 0;
+		std::uint8_t Result = Draw;
+		std::uint16_t FullmoveNumber = 1;
+		std::int16_t Score = 0;
+
+		static PackedPosition Pack(const Position& Pos, int WhiteScore, EResult InResult);
+
+		// Full state, castling and en passant included
+		bool Unpack(Position& OutPos) const;
+		string ToFen() const;
+
+		// Pieces and side to move only; faster, and enough for evaluation
+		void UnpackPieces(Position& OutPos) const;
+
+		EColor GetSideToMove() const { return EColor(Flags & 1); }
+		double GetResultScore() const { return Result * 0.5; }
+	};
+
+	static_assert(sizeof(PackedPosition) == 32, "PackedPosition must stay a 32-byte record");
+}
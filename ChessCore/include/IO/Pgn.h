@@ -0,0 +1,28 @@
+#pragma once
+#include "Rules/Position.h"
+#include <utility>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Portable Game Notation
+	// ----------------------------------------------------
+	struct PgnGame
+	{
+		List<std::pair<string, string>> Tags;	// Beyond the Seven Tag Roster, in output order
+		string StartFen;						// Empty for the standard starting position
+		List<Move> Moves;
+		List<string> Comments;					// Optional, one per move; empty strings are skipped
+		string Result = "*";
+
+		void SetTag(const string& Name, const string& Value);
+		const string* FindTag(const string& Name) const;
+	};
+
+	// The Seven Tag Roster comes first with "?" for anything missing, then the
+	// other tags, FEN / SetUp for a custom start, and SAN movetext wrapped at 80 columns
+	string FormatPgn(const PgnGame& Game);
+
+	// Today's local date as the Date tag writes it, "2024.05.31"
+	string CurrentPgnDate();
+}
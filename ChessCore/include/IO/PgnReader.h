@@ -0,0 +1,75 @@
+#pragma once
+#include "IO/Pgn.h"
+#include "IO/MappedFile.h"
+#include <functional>
+#include <string_view>
+
+namespace we
+{
+	// One game as the reader sees it. The views point into the input and the
+	// lists are reused for the next game, so a view is only valid during the
+	// callback; ToGame() makes a copy that owns its data.
+	struct PgnGameView
+	{
+		std::size_t Offset = 0;								// First byte of the game in the input
+		List<std::pair<std::string_view, std::string_view>> Tags;	// Values still escaped
+		std::string_view StartFen;							// Empty for the standard starting position
+		List<Move> Moves;
+		std::string_view Result = "*";
+
+		std::string_view FindTag(std::string_view Name) const;
+		PgnGame ToGame() const;
+	};
+
+	struct PgnError
+	{
+		std::size_t Offset = 0;				// Of the game the error belongs to
+		string Message;
+	};
+
+	struct PgnImportStats
+	{
+		std::uint64_t Games = 0;			// Delivered to the callback
+		std::uint64_t Malformed = 0;		// Reported and skipped
+		std::uint64_t Moves = 0;
+		std::size_t Bytes = 0;
+		std::int64_t TimeMs = 0;
+
+		double GamesPerSecond() const { return TimeMs > 0 ? Games * 1000.0 / TimeMs : 0.0; }
+		double MegaBytesPerSecond() const { return TimeMs > 0 ? Bytes / 1000.0 / TimeMs : 0.0; }
+	};
+
+	// ----------------------------------------------------
+	// Streaming PGN Import
+	// ----------------------------------------------------
+	// Tokenises tags and movetext in place, resolves every SAN move against
+	// the legal moves of the position, and skips comments, variations and
+	// NAGs. A malformed game is reported with its offset and the reader moves
+	// on to the next one. Large inputs are split on game boundaries and the
+	// parts parsed on several threads, so OnGame must be thread-safe and
+	// games arrive in no particular order.
+	class PgnReader
+	{
+	public:
+		bool Open(const string& Path);
+		void Close() { File.Close(); }
+		std::size_t GetSize() const { return File.GetSize(); }
+
+		// Threads = 0 uses every hardware thread
+		PgnImportStats Read(const std::function<void(const PgnGameView&)>& OnGame, int Threads = 0);
+		const List<PgnError>& GetErrors() const { return Errors; }		// By offset; the first MaxErrorsKept only
+
+		// The same for text already in memory
+		static PgnImportStats Parse(std::string_view Text, const std::function<void(const PgnGameView&)>& OnGame, int Threads,
+			List<PgnError>* OutErrors = nullptr);
+
+		static constexpr std::size_t MaxErrorsKept = 1000;
+
+	private:
+		MappedFile File;
+		List<PgnError> Errors;
+	};
+
+	// Every well-formed game of a file, in file order
+	List<PgnGame> LoadPgnFile(const string& Path, List<PgnError>* OutErrors = nullptr);
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "IO/Pgn.h"
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Background PGN Writer
+	// ----------------------------------------------------
+	// Write() only queues a copy of the game; the writer thread formats the
+	// SAN and appends it through a large stdio buffer, flushing once per
+	// batch, so the caller never waits on the disk.
+	class PgnWriter
+	{
+	public:
+		PgnWriter();
+		~PgnWriter();
+
+		PgnWriter(const PgnWriter&) = delete;
+		PgnWriter& operator=(const PgnWriter&) = delete;
+
+		// Games are appended; the file is opened by the writer thread
+		void Open(const string& InPath);
+		void Close();			// Writes everything still queued first
+		bool IsOpen() const { return Writer.joinable(); }
+
+		void Write(PgnGame Game);
+
+	private:
+		void RunWriter();
+
+		string Path;
+		std::thread Writer;
+		std::mutex Lock;
+		std::condition_variable Wake;
+		List<PgnGame> Pending;
+		bool bStopWriter;
+	};
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "IO/PackedPosition.h"
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Binary Game Replay
+	// ----------------------------------------------------
+	// A game as a stream of 16-bit moves plus a PackedPosition keyframe every
+	// KeyframeInterval plies, the start position being keyframe 0. On disk it
+	// is a 16-byte header, the keyframes, then the moves, so a 300-ply game
+	// takes about 1.2 KB. Moves are appended as they are played; the keyframes
+	// are taken along the way from a position the replay keeps itself.
+	class Replay
+	{
+	public:
+		static constexpr int DefaultKeyframeInterval = 16;
+
+		explicit Replay(int InKeyframeInterval = DefaultKeyframeInterval);
+
+		// ------------------------------------------------
+		// Recording
+		// ------------------------------------------------
+		void Begin(const Position& Start);
+		void Append(Move InMove);			// Must be legal in the position it follows
+
+		// ------------------------------------------------
+		// Files
+		// ------------------------------------------------
+		bool Save(const string& Path) const;
+		bool Load(const string& Path);
+
+		// ------------------------------------------------
+		// Accessors
+		// ------------------------------------------------
+		int GetPlyCount() const { return int(Moves.size()); }
+		int GetKeyframeInterval() const { return KeyframeInterval; }
+		const List<Move>& GetMoves() const { return Moves; }
+		const List<PackedPosition>& GetKeyframes() const { return Keyframes; }
+
+	private:
+		int KeyframeInterval;
+		List<PackedPosition> Keyframes;
+		List<Move> Moves;
+		Position Tail;						// After the last move, for the next keyframe
+	};
+
+	// ----------------------------------------------------
+	// Replay Cursor
+	// ----------------------------------------------------
+	// Seeks a replay to any ply. Short steps from the current ply make or
+	// unmake moves; longer jumps decode the keyframe at or before the target
+	// and play the rest forward, so no seek applies more than an interval of
+	// moves. Unmaking only reaches back to the keyframe last decoded, which is
+	// as far as the position's history goes.
+	class ReplayCursor
+	{
+	public:
+		explicit ReplayCursor(const Replay& InSource);
+
+		// False when the target is out of range or the file holds an illegal move
+		bool Seek(int TargetPly);
+
+		int GetPly() const { return Ply; }
+		const Position& GetPosition() const { return Pos; }
+
+	private:
+		bool DecodeKeyframe(int Index);
+
+		const Replay* Source;
+		Position Pos;
+		int Ply;
+		int BasePly;						// Ply of the keyframe Pos was decoded from
+	};
+}
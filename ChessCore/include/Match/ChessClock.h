@@ -0,0 +1,49 @@
+#pragma once
+#include "Engine/Search.h"
+#include <chrono>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Two-Sided Game Clock
+	// ----------------------------------------------------
+	// At most one side's time runs. Remaining times are read live from the
+	// steady clock in microseconds, so polling the clock every frame never
+	// accumulates rounding error; only Press() and Stop() settle them.
+	class ChessClock
+	{
+	public:
+		ChessClock();
+
+		void Reset(std::int64_t BaseMs, std::int64_t IncrementMs);
+		void Start(EColor Side);			// Runs Side's time without an increment, e.g. for the first move
+		void Press(EColor Mover);			// Mover has moved: its time stops and gains the increment, the other side's runs
+		void Stop();
+		void SetRemainingMs(EColor Side, std::int64_t Ms);	// While stopped, e.g. to resume a saved game
+
+		bool IsRunning() const { return bRunning; }
+		EColor GetRunningSide() const { return RunningSide; }
+		std::int64_t GetRemainingMs(EColor Side) const;
+		std::int64_t GetIncrementMs() const { return IncrementUs / 1000; }
+		bool IsFlagged(EColor Side) const { return GetRemainingUs(Side) <= 0; }
+
+		// Time[] and Increment[] for an engine about to search
+		void FillLimits(SearchLimits& Limits) const;
+
+		// "4:05" above twenty seconds, "19.3" below
+		static string Format(std::int64_t Ms);
+
+		// "0:04:05" for a PGN [%clk] comment
+		static string FormatPgn(std::int64_t Ms);
+
+	private:
+		std::int64_t GetRemainingUs(EColor Side) const;
+		void Settle();
+
+		std::int64_t RemainingUs[ColorCount];
+		std::int64_t IncrementUs;
+		EColor RunningSide;
+		bool bRunning;
+		std::chrono::steady_clock::time_point TurnStart;
+	};
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "Framework/Core.h"
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Match Score and Elo
+	// ----------------------------------------------------
+	// Counted from the first engine's point of view
+	struct MatchScore
+	{
+		int Wins = 0;
+		int Draws = 0;
+		int Losses = 0;
+
+		int Games() const { return Wins + Draws + Losses; }
+		double Score() const { return Games() ? (Wins + 0.5 * Draws) / Games() : 0.5; }
+		double Variance() const;				// Of a single game's score
+
+		double Elo() const;
+		double EloError95() const;				// Half width of the 95% confidence interval
+		double LikelihoodOfSuperiority() const;
+	};
+
+	double EloToScore(double Elo);
+	double ScoreToElo(double Score);
+
+	// ----------------------------------------------------
+	// Sequential Probability Ratio Test
+	// ----------------------------------------------------
+	// Tests H0: Elo = Elo0 against H1: Elo = Elo1 with the usual normal
+	// approximation to the generalised SPRT on per-game scores.
+	enum class ESprtState
+	{
+		Running,
+		AcceptH0,
+		AcceptH1
+	};
+
+	struct SprtTest
+	{
+		double Elo0 = 0.0;
+		double Elo1 = 5.0;
+		double Alpha = 0.05;
+		double Beta = 0.05;
+
+		double LowerBound() const;
+		double UpperBound() const;
+		double LogLikelihoodRatio(const MatchScore& Score) const;
+		ESprtState Evaluate(const MatchScore& Score) const;
+	};
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "Engine/Engine.h"
+#include "IO/Pgn.h"
+
+namespace we
+{
+	enum class EGameResult
+	{
+		None,
+		WhiteWins,
+		BlackWins,
+		Draw
+	};
+
+	enum class ETermination
+	{
+		None,
+		Checkmate,
+		Stalemate,
+		Repetition,
+		FiftyMoves,
+		InsufficientMaterial,
+		Tablebase,
+		TimeForfeit,
+		IllegalMove,
+		MaxPlies
+	};
+
+	const char* ResultToString(EGameResult Result);
+	const char* TerminationToString(ETermination Termination);
+
+	// ----------------------------------------------------
+	// Time Control
+	// ----------------------------------------------------
+	// Parses "60+0.6" (seconds plus increment), "movetime=100", "nodes=20000"
+	// or "depth=8"; the last three are per move and never forfeit
+	struct TimeControl
+	{
+		std::int64_t BaseMs = 10000;
+		std::int64_t IncrementMs = 100;
+		std::int64_t MoveTimeMs = 0;
+		std::uint64_t Nodes = 0;
+		int Depth = 0;
+
+		bool Parse(const string& Text);
+		string ToPgnTag() const;
+		bool UsesClock() const { return !MoveTimeMs && !Nodes && !Depth; }
+	};
+
+	// ----------------------------------------------------
+	// Headless Games Between Two Engines
+	// ----------------------------------------------------
+	struct GameSettings
+	{
+		TimeControl Clock;
+		std::int64_t TimeMarginMs = 50;			// Overrun tolerated before a flag falls
+		int MaxPlies = 800;						// Adjudicated a draw beyond this
+		const SyzygyTablebases* Tablebases = nullptr;
+	};
+
+	struct GameRecord
+	{
+		string StartFen;
+		List<Move> Moves;
+		List<std::int64_t> MoveTimesMs;
+		EGameResult Result = EGameResult::None;
+		ETermination Termination = ETermination::None;
+
+		PgnGame ToPgn(const string& WhiteName, const string& BlackName) const;
+	};
+
+	// Decides a finished or tablebase-resolved game with the rules core alone
+	ETermination Adjudicate(Position& Pos, const SyzygyTablebases* Tablebases, EGameResult& OutResult);
+
+	// Both engines must be idle; each one's options are left as the caller set them
+	GameRecord PlayGame(Engine& WhitePlayer, Engine& BlackPlayer, const string& StartFen, const GameSettings& Settings);
+
+	// One FEN or EPD per line; EPD operations are dropped and blank or '#' lines skipped
+	List<string> LoadOpenings(const string& Path);
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "Rules/ChessTypes.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Constants
+	// ----------------------------------------------------
+	constexpr Bitboard FileABB = 0x0101010101010101ULL;
+	constexpr Bitboard FileHBB = FileABB << 7;
+	constexpr Bitboard Rank1BB = 0xFFULL;
+	constexpr Bitboard Rank8BB = Rank1BB << 56;
+	constexpr Bitboard DarkSquaresBB = 0xAA55AA55AA55AA55ULL;
+
+	constexpr Bitboard SquareBB(Square Sq) { return 1ULL << Sq; }
+	constexpr Bitboard FileBB(int File) { return FileABB << File; }
+	constexpr Bitboard RankBB(int Rank) { return Rank1BB << (8 * Rank); }
+
+	// ----------------------------------------------------
+	// Bit Twiddling
+	// ----------------------------------------------------
+	inline int PopCount(Bitboard B)
+	{
+#ifdef _MSC_VER
+		return int(__popcnt64(B));
+#else
+		return __builtin_popcountll(B);
+#endif
+	}
+
+	inline Square Lsb(Bitboard B)
+	{
+#ifdef _MSC_VER
+		unsigned long Index;
+		_BitScanForward64(&Index, B);
+		return Square(Index);
+#else
+		return Square(__builtin_ctzll(B));
+#endif
+	}
+
+	inline Square Msb(Bitboard B)
+	{
+#ifdef _MSC_VER
+		unsigned long Index;
+		_BitScanReverse64(&Index, B);
+		return Square(Index);
+#else
+		return Square(63 ^ __builtin_clzll(B));
+#endif
+	}
+
+	inline Square PopLsb(Bitboard& B)
+	{
+		Square Sq = Lsb(B);
+		B &= B - 1;
+		return Sq;
+	}
+
+	inline bool MoreThanOne(Bitboard B) { return (B & (B - 1)) != 0; }
+
+	template<int Delta>
+	constexpr Bitboard Shift(Bitboard B)
+	{
+		return Delta == 8 ? B << 8
+			: Delta == -8 ? B >> 8
+			: Delta == 9 ? (B & ~FileHBB) << 9
+			: Delta == 7 ? (B & ~FileABB) << 7
+			: Delta == -7 ? (B & ~FileHBB) >> 7
+			: Delta == -9 ? (B & ~FileABB) >> 9
+			: Delta == 1 ? (B & ~FileHBB) << 1
+			: Delta == -1 ? (B & ~FileABB) >> 1
+			: 0;
+	}
+
+	// ----------------------------------------------------
+	// Attack Tables
+	// ----------------------------------------------------
+	namespace Bitboards
+	{
+		void Init();
+
+		extern Bitboard PawnAttacks[ColorCount][64];
+		extern Bitboard KnightAttacks[64];
+		extern Bitboard KingAttacks[64];
+		extern Bitboard Between[64][64];
+		extern Bitboard Line[64][64];
+		extern Bitboard AdjacentFiles[8];
+		extern Bitboard ForwardFiles[ColorCount][64];
+		extern Bitboard PassedPawnSpan[ColorCount][64];
+
+		Bitboard BishopAttacks(Square Sq, Bitboard Occupied);
+		Bitboard RookAttacks(Square Sq, Bitboard Occupied);
+		inline Bitboard QueenAttacks(Square Sq, Bitboard Occupied) { return BishopAttacks(Sq, Occupied) | RookAttacks(Sq, Occupied); }
+
+		Bitboard Attacks(EPieceType Type, Square Sq, Bitboard Occupied);
+	}
+}
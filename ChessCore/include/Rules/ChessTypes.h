@@ -0,0 +1,130 @@
+#pragma once
+#include <cstdint>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Primitive Types
+	// ----------------------------------------------------
+	using Bitboard = std::uint64_t;
+	using Square = int;			// 0 = a1 ... 63 = h8
+	using HashKey = std::uint64_t;
+
+	constexpr Square NoSquare = 64;
+	constexpr int MaxPly = 128;
+	constexpr int MaxMoves = 256;
+
+	enum EColor : int
+	{
+		White,
+		Black,
+		ColorCount
+	};
+
+	enum EPieceType : int
+	{
+		NoPieceType,
+		Pawn,
+		Knight,
+		Bishop,
+		Rook,
+		Queen,
+		King,
+		PieceTypeCount
+	};
+
+	// Piece = Color << 3 | Type, so both halves can be recovered with a mask
+	enum EPiece : int
+	{
+		NoPiece,
+		WhitePawn = 1, WhiteKnight, WhiteBishop, WhiteRook, WhiteQueen, WhiteKing,
+		BlackPawn = 9, BlackKnight, BlackBishop, BlackRook, BlackQueen, BlackKing,
+		PieceCount = 16
+	};
+
+	enum ECastlingRights : int
+	{
+		NoCastling = 0,
+		WhiteKingSide = 1,
+		WhiteQueenSide = 2,
+		BlackKingSide = 4,
+		BlackQueenSide = 8,
+		AllCastling = 15
+	};
+
+	// ----------------------------------------------------
+	// Helpers
+	// ----------------------------------------------------
+	constexpr EColor operator~(EColor Color) { return EColor(Color ^ Black); }
+	constexpr EPiece MakePiece(EColor Color, EPieceType Type) { return EPiece((Color << 3) | Type); }
+	constexpr EPieceType TypeOf(EPiece Piece) { return EPieceType(Piece & 7); }
+	constexpr EColor ColorOf(EPiece Piece) { return EColor(Piece >> 3); }
+
+	constexpr Square MakeSquare(int File, int Rank) { return Rank * 8 + File; }
+	constexpr int FileOf(Square Sq) { return Sq & 7; }
+	constexpr int RankOf(Square Sq) { return Sq >> 3; }
+	constexpr Square FlipRank(Square Sq) { return Sq ^ 56; }
+	constexpr int RelativeRank(EColor Color, Square Sq) { return Color == White ? RankOf(Sq) : 7 - RankOf(Sq); }
+	constexpr int PawnPush(EColor Color) { return Color == White ? 8 : -8; }
+
+	// ----------------------------------------------------
+	// Move Encoding (16 bits: from | to << 6 | flag << 12)
+	// ----------------------------------------------------
+	enum EMoveFlag : int
+	{
+		QuietMove = 0,
+		DoublePawnPush = 1,
+		KingCastle = 2,
+		QueenCastle = 3,
+		CaptureMove = 4,
+		EnPassantCapture = 5,
+		KnightPromotion = 8,
+		BishopPromotion = 9,
+		RookPromotion = 10,
+		QueenPromotion = 11,
+		KnightPromotionCapture = 12,
+		BishopPromotionCapture = 13,
+		RookPromotionCapture = 14,
+		QueenPromotionCapture = 15
+	};
+
+	struct Move
+	{
+		std::uint16_t Data = 0;
+
+		constexpr Move() = default;
+		constexpr explicit Move(std::uint16_t Raw) : Data{ Raw } {}
+		constexpr Move(Square From, Square To, EMoveFlag Flag = QuietMove)
+			: Data{ std::uint16_t(From | (To << 6) | (Flag << 12)) }
+		{
+		}
+
+		constexpr Square From() const { return Data & 63; }
+		constexpr Square To() const { return (Data >> 6) & 63; }
+		constexpr EMoveFlag Flag() const { return EMoveFlag(Data >> 12); }
+		constexpr bool IsCapture() const { return (Flag() & CaptureMove) != 0; }
+		constexpr bool IsPromotion() const { return (Flag() & KnightPromotion) != 0; }
+		constexpr bool IsCastle() const { return Flag() == KingCastle || Flag() == QueenCastle; }
+		constexpr bool IsQuiet() const { return !IsCapture() && !IsPromotion(); }
+		constexpr EPieceType PromotionType() const { return EPieceType(Knight + (Flag() & 3)); }
+		constexpr bool IsNull() const { return Data == 0; }
+
+		constexpr bool operator==(const Move& Other) const { return Data == Other.Data; }
+		constexpr bool operator!=(const Move& Other) const { return Data != Other.Data; }
+	};
+
+	constexpr Move NullMove{};
+
+	struct MoveList
+	{
+		Move Moves[MaxMoves];
+		int Count = 0;
+
+		void Add(Move NewMove) { Moves[Count++] = NewMove; }
+		Move* begin() { return Moves; }
+		Move* end() { return Moves + Count; }
+		const Move* begin() const { return Moves; }
+		const Move* end() const { return Moves + Count; }
+		int Size() const { return Count; }
+	};
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "Rules/Position.h"
+#include <string_view>
+
+namespace we
+{
+	enum class EMoveGenType
+	{
+		All,
+		Captures,	// Captures and queen promotions, for quiescence
+		Quiets		// Everything GenerateMoves<Captures> leaves out
+	};
+
+	// ----------------------------------------------------
+	// Move Generation
+	// ----------------------------------------------------
+	void GenerateMoves(const Position& Pos, MoveList& Moves, EMoveGenType Type = EMoveGenType::All);
+	void GenerateLegalMoves(const Position& Pos, MoveList& Moves);
+	bool HasLegalMove(const Position& Pos);
+
+	std::uint64_t Perft(Position& Pos, int Depth);
+
+	// ----------------------------------------------------
+	// Coordinate Notation
+	// ----------------------------------------------------
+	string MoveToUci(Move InMove);
+	Move ParseUciMove(const Position& Pos, const string& Text);
+	string SquareToString(Square Sq);
+
+	// ----------------------------------------------------
+	// Standard Algebraic Notation
+	// ----------------------------------------------------
+	// Makes and unmakes the move to add the check or mate suffix, leaving Pos unchanged
+	string MoveToSan(Position& Pos, Move InMove);
+
+	// Tolerates missing or extra check marks, annotations, "0-0" castling and a
+	// missing '=' before the promotion piece; NullMove if illegal or ambiguous
+	Move ParseSanMove(const Position& Pos, std::string_view Text);
+}
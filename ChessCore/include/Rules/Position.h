@@ -0,0 +1,136 @@
+#pragma once
+#include "Framework/Core.h"
+#include "Rules/Bitboards.h"
+#include "Engine/EvalParams.h"
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Pieces touched by the last move, for incremental consumers
+	// ----------------------------------------------------
+	struct DirtyPieces
+	{
+		static constexpr int MaxCount = 3;
+
+		int Count = 0;
+		EPiece Piece[MaxCount] = {};
+		Square From[MaxCount] = {};		// NoSquare when the piece was added
+		Square To[MaxCount] = {};		// NoSquare when the piece was removed
+
+		void Add(EPiece InPiece, Square InFrom, Square InTo)
+		{
+			Piece[Count] = InPiece;
+			From[Count] = InFrom;
+			To[Count] = InTo;
+			++Count;
+		}
+	};
+
+	// ----------------------------------------------------
+	// Per-ply State (restored wholesale on unmake)
+	// ----------------------------------------------------
+	struct StateInfo
+	{
+		HashKey Key = 0;
+		HashKey PawnKey = 0;	// Pawns only, for the evaluation's pawn hash
+		int CastlingRights = NoCastling;
+		Square EnPassant = NoSquare;
+		int HalfmoveClock = 0;
+		int PliesFromNull = 0;
+		EPiece Captured = NoPiece;
+		Bitboard Checkers = 0;
+		Bitboard Pinned = 0;
+
+		// Incrementally updated evaluation terms
+		EvalScore PsqScore;
+		int Phase = 0;
+
+		// Unique per made move so caches keyed on a state can tell it was replaced
+		std::uint64_t Serial = 0;
+		DirtyPieces Dirty;
+	};
+
+	// ----------------------------------------------------
+	// Headless Position with make / unmake
+	// ----------------------------------------------------
+	class Position
+	{
+	public:
+		static constexpr const char* StartFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+		Position();
+
+		bool SetFromFen(const string& Fen);
+		string GetFen() const;
+
+		// Places pieces directly with no castling or en passant rights, for table generators
+		void SetFromPieces(const EPiece* InPieces, const Square* Squares, int Count, EColor InSideToMove);
+
+		void MakeMove(Move InMove);
+		void UnmakeMove(Move InMove);
+		void MakeNullMove();
+		void UnmakeNullMove();
+
+		// ------------------------------------------------
+		// Accessors
+		// ------------------------------------------------
+		EPiece PieceOn(Square Sq) const { return Board[Sq]; }
+		Bitboard Pieces() const { return ByColor[White] | ByColor[Black]; }
+		Bitboard Pieces(EColor Color) const { return ByColor[Color]; }
+		Bitboard Pieces(EPieceType Type) const { return ByType[Type]; }
+		Bitboard Pieces(EColor Color, EPieceType Type) const { return ByColor[Color] & ByType[Type]; }
+		Square KingSquare(EColor Color) const { return Lsb(Pieces(Color, King)); }
+		int PieceCount(EColor Color, EPieceType Type) const { return PopCount(Pieces(Color, Type)); }
+
+		EColor GetSideToMove() const { return SideToMove; }
+		HashKey GetKey() const { return State().Key; }
+		HashKey GetPawnKey() const { return State().PawnKey; }
+		int GetCastlingRights() const { return State().CastlingRights; }
+		Square GetEnPassant() const { return State().EnPassant; }
+		int GetHalfmoveClock() const { return State().HalfmoveClock; }
+		int GetGamePly() const { return GamePly; }
+		Bitboard GetCheckers() const { return State().Checkers; }
+		bool IsInCheck() const { return State().Checkers != 0; }
+		EPiece GetCapturedPiece() const { return State().Captured; }
+
+		const EvalScore& GetPsqScore() const { return State().PsqScore; }
+		int GetPhase() const { return State().Phase; }
+
+		int GetStateCount() const { return int(History.size()); }
+		const StateInfo& GetState(int Index) const { return History[Index]; }
+
+		// ------------------------------------------------
+		// Attack Queries
+		// ------------------------------------------------
+		Bitboard AttackersTo(Square Sq, Bitboard Occupied) const;
+		Bitboard AttackersTo(Square Sq) const { return AttackersTo(Sq, Pieces()); }
+		bool IsSquareAttacked(Square Sq, EColor Attacker) const;
+		bool IsLegal(Move InMove) const;
+		bool IsPseudoLegal(Move InMove) const;
+		bool CanCastle(ECastlingRights Right) const;
+
+		// ------------------------------------------------
+		// Draw Detection
+		// ------------------------------------------------
+		bool IsRepetition(int SearchPly) const;
+		bool IsFiftyMoveDraw() const { return State().HalfmoveClock >= 100; }
+		bool IsInsufficientMaterial() const;
+
+	private:
+		void Clear();
+		void PutPiece(EPiece Piece, Square Sq);
+		void RemovePiece(Square Sq);
+		void MovePiece(Square From, Square To);
+		void UpdateCheckInfo();
+
+		const StateInfo& State() const { return History.back(); }
+		StateInfo& State() { return History.back(); }
+
+		EPiece Board[64];
+		Bitboard ByType[PieceTypeCount];
+		Bitboard ByColor[ColorCount];
+		EColor SideToMove;
+		int GamePly;
+		List<StateInfo> History;
+	};
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "Rules/ChessTypes.h"
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Zobrist Keys
+	// ----------------------------------------------------
+	namespace Zobrist
+	{
+		void Init();
+
+		extern HashKey PieceSquare[PieceCount][64];
+		extern HashKey Castling[16];
+		extern HashKey EnPassantFile[8];
+		extern HashKey SideToMove;
+		extern HashKey NoPawns;		// Seeds the pawn key so a pawnless position never hashes to 0
+	}
+}
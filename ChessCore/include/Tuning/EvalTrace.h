@@ -0,0 +1,60 @@
+#pragma once
+#include "Rules/Position.h"
+#include "Engine/EvalParams.h"
+
+namespace we
+{
+	namespace EvalTuning
+	{
+		// ----------------------------------------------------
+		// Tunable Parameters
+		// ----------------------------------------------------
+		// Every EvalScore in EvalParams, flattened into one list. Each parameter
+		// becomes two weights (midgame, endgame) at 2 * Index and 2 * Index + 1.
+		struct ParamBlock
+		{
+			const char* Name;					// As declared in EvalParams.h
+			const EvalScore* Defaults;
+			int Count;
+			int Offset;
+			bool bArray;
+		};
+
+		const List<ParamBlock>& GetParamBlocks();
+		int GetParamCount();
+		List<EvalScore> GetDefaultParams();
+
+		// ----------------------------------------------------
+		// Evaluation Trace
+		// ----------------------------------------------------
+		// The hand-crafted evaluation is linear in its parameters once the phase is
+		// known, so a position reduces to how often each parameter was applied, net
+		// of White minus Black. Terms may repeat an index.
+		struct EvalTrace
+		{
+			struct Term
+			{
+				std::uint16_t Index;
+				std::int16_t Count;
+			};
+
+			static constexpr int MaxTerms = 320;
+
+			Term Terms[MaxTerms];
+			int TermCount = 0;
+			int Phase = 0;						// Clamped to EvalParams::MaxPhase
+
+			void Add(int Index, int Count) { Terms[TermCount++] = Term{ std::uint16_t(Index), std::int16_t(Count) }; }
+		};
+
+		// Mirrors Evaluator::EvaluateClassical term for term
+		void TraceEvaluation(const Position& Pos, EvalTrace& OutTrace);
+
+		// White's view, in centipawns, before rounding
+		double EvaluateTrace(const EvalTrace& Trace, const double* Weights);
+
+		// Rewrites the initialiser of every tuned table in the text of EvalParams.h,
+		// leaving comments and everything else as they were; empty on failure
+		string RegenerateEvalParams(const string& Template, const List<EvalScore>& Params);
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "IO/MappedFile.h"
+#include "IO/PackedPosition.h"
+#include "Engine/EvalParams.h"
+#include <functional>
+
+namespace we
+{
+	// ----------------------------------------------------
+	// Corpus Preparation
+	// ----------------------------------------------------
+	struct CorpusStats
+	{
+		std::uint64_t Lines = 0;
+		std::uint64_t Packed = 0;
+		std::uint64_t Skipped = 0;			// Unreadable, no result, or in check
+	};
+
+	// Reads "<FEN or EPD> <result>" lines from a memory-mapped text file, where the
+	// result is 1-0 / 0-1 / 1/2-1/2 or 1.0 / 0.5 / 0.0, optionally quoted or
+	// bracketed. Each position is resolved to the end of its quiescence PV and
+	// written as a PackedPosition. The text is split across threads at line breaks.
+	CorpusStats PackCorpus(const string& TextPath, const string& PackedPath, int Threads);
+
+	// ----------------------------------------------------
+	// Texel Tuner
+	// ----------------------------------------------------
+	// Minimises the mean squared error between game results and the sigmoid of
+	// the evaluation over a memory-mapped file of packed quiet positions. Every
+	// epoch streams the 32-byte records in contiguous slices, one per thread,
+	// and traces each position against the current weights.
+	struct TunerSettings
+	{
+		int Threads = 1;
+		int Epochs = 200;
+		double LearningRate = 1.0;			// Adam step size, in centipawns
+		double ScalingK = 0.0;				// 0 fits K to the default parameters first
+	};
+
+	class TexelTuner
+	{
+	public:
+		TexelTuner();
+
+		bool Open(const string& PackedPath);
+		std::size_t GetPositionCount() const { return Corpus.GetSize() / sizeof(PackedPosition); }
+
+		// Golden-section search for the K that best fits the current weights
+		double FitScalingConstant(int Threads);
+		double ComputeError(double K, int Threads) const;
+
+		void Run(const TunerSettings& Settings, const std::function<void(int Epoch, double Error)>& OnEpoch);
+
+		double GetScalingConstant() const { return ScalingK; }
+		List<EvalScore> GetParams() const;
+
+	private:
+		// Sums the error and, when OutGradient is given, its gradient over [Begin, End)
+		double Accumulate(std::size_t Begin, std::size_t End, double K, double* OutGradient) const;
+		double ParallelPass(double K, int Threads, List<double>* OutGradient) const;
+
+		const PackedPosition* GetRecords() const { return reinterpret_cast<const PackedPosition*>(Corpus.GetData()); }
+
+		MappedFile Corpus;
+		List<double> Weights;
+		double ScalingK;
+	};
+}
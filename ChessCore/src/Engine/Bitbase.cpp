@@ -0,0 +1,658 @@
+#include "Engine/Bitbase.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+namespace we
+{
+	namespace
+	{
+		constexpr char Magic[4] = { 'W', 'E', 'B', 'B' };
+		constexpr const char* PieceLetters = " PNBRQK";
+		constexpr int PieceValues[PieceTypeCount] = { 0, 1, 3, 3, 5, 9, 0 };
+
+		// Generation-only status; the first four share values with Bitbase::ECode
+		enum EStatus : std::uint8_t
+		{
+			StatusUnknown = 0,
+			StatusDraw = Bitbase::CodeDraw,
+			StatusWin = Bitbase::CodeWin,
+			StatusLoss = Bitbase::CodeLoss,
+			StatusInvalid = 4
+		};
+
+		EPieceType TypeFromLetter(char Letter)
+		{
+			const char* Found = std::strchr(PieceLetters + 1, Letter);
+			return Letter && Found ? EPieceType(Found - PieceLetters) : NoPieceType;
+		}
+
+		int SideValue(const EPieceType* Types, int Count)
+		{
+			int Value = 0;
+			for (int i = 0; i < Count; ++i)
+			{
+				Value += PieceValues[Types[i]];
+			}
+			return Value;
+		}
+
+		// Runs Body(ThreadIndex) on ThreadCount threads, the caller being thread zero
+		template<typename Func>
+		void RunParallel(int ThreadCount, Func&& Body)
+		{
+			List<std::thread> Threads;
+			for (int i = 1; i < ThreadCount; ++i)
+			{
+				Threads.emplace_back(Body, i);
+			}
+			Body(0);
+			for (std::thread& Thread : Threads)
+			{
+				Thread.join();
+			}
+		}
+
+		// ------------------------------------------------
+		// Index Layout
+		// ------------------------------------------------
+		// Pieces: strong king, weak king, strong pieces, weak pieces. The strong
+		// side is White and its king stays on files a-d (32 squares).
+		struct TableLayout
+		{
+			explicit TableLayout(const Bitbase::Material& InMaterial)
+				: PieceCount{ InMaterial.PieceCount() }
+			{
+				Pieces[0] = WhiteKing;
+				Pieces[1] = BlackKing;
+				int Next = 2;
+				for (int Side = 0; Side < 2; ++Side)
+				{
+					for (int i = 0; i < InMaterial.Count[Side]; ++i)
+					{
+						Pieces[Next++] = MakePiece(EColor(Side), InMaterial.Pieces[Side][i]);
+					}
+				}
+			}
+
+			int Decode(std::size_t Index, Square* Squares) const
+			{
+				for (int i = PieceCount - 1; i >= 1; --i)
+				{
+					Squares[i] = Square(Index & 63);
+					Index >>= 6;
+				}
+				Squares[0] = MakeSquare(int(Index & 3), int((Index >> 2) & 7));
+				return int(Index >> 5);
+			}
+
+			int PieceCount;
+			EPiece Pieces[Bitbase::MaxPieces];
+		};
+	}
+
+	namespace Bitbase
+	{
+		// ----------------------------------------------------
+		// Material Signature
+		// ----------------------------------------------------
+		string Material::GetSignature() const
+		{
+			string Signature;
+			for (int Side = 0; Side < 2; ++Side)
+			{
+				Signature += 'K';
+				for (int i = 0; i < Count[Side]; ++i)
+				{
+					Signature += PieceLetters[Pieces[Side][i]];
+				}
+			}
+			return Signature;
+		}
+
+		std::uint64_t Material::GetKey() const
+		{
+			std::uint64_t Key = 0;
+			for (int Side = 0; Side < 2; ++Side)
+			{
+				for (int i = 0; i < Count[Side]; ++i)
+				{
+					Key += 1ULL << (4 * (Side * 5 + Pieces[Side][i] - Pawn));
+				}
+			}
+			return Key;
+		}
+
+		bool Material::Parse(const string& Signature, Material& OutMaterial)
+		{
+			const std::size_t Split = Signature.find('K', 1);
+			if (Signature.empty() || Signature[0] != 'K' || Split == string::npos) { return false; }
+
+			Material Parsed;
+			const string Sides[2] = { Signature.substr(1, Split - 1), Signature.substr(Split + 1) };
+			for (int Side = 0; Side < 2; ++Side)
+			{
+				for (char Letter : Sides[Side])
+				{
+					const EPieceType Type = TypeFromLetter(Letter);
+					if (Type == NoPieceType || Type == King || Parsed.PieceCount() >= MaxPieces) { return false; }
+					Parsed.Pieces[Side][Parsed.Count[Side]++] = Type;
+				}
+				std::sort(Parsed.Pieces[Side], Parsed.Pieces[Side] + Parsed.Count[Side], [](EPieceType A, EPieceType B) { return A > B; });
+			}
+
+			// Stronger side first; equal material keeps the lexicographically larger set first
+			const int Values[2] = { SideValue(Parsed.Pieces[0], Parsed.Count[0]), SideValue(Parsed.Pieces[1], Parsed.Count[1]) };
+			const bool bSwap = Values[1] > Values[0]
+				|| (Values[1] == Values[0] && std::lexicographical_compare(Parsed.Pieces[0], Parsed.Pieces[0] + Parsed.Count[0], Parsed.Pieces[1], Parsed.Pieces[1] + Parsed.Count[1]));
+			if (bSwap)
+			{
+				std::swap(Parsed.Pieces[0], Parsed.Pieces[1]);
+				std::swap(Parsed.Count[0], Parsed.Count[1]);
+			}
+
+			OutMaterial = Parsed;
+			return true;
+		}
+
+		std::uint64_t MaterialKey(const Position& Pos, EColor Strong)
+		{
+			std::uint64_t Key = 0;
+			const EColor Sides[2] = { Strong, ~Strong };
+			for (int Side = 0; Side < 2; ++Side)
+			{
+				for (int Type = Pawn; Type <= Queen; ++Type)
+				{
+					Key += std::uint64_t(Pos.PieceCount(Sides[Side], EPieceType(Type))) << (4 * (Side * 5 + Type - Pawn));
+				}
+			}
+			return Key;
+		}
+
+		std::size_t IndexCount(int PieceCount)
+		{
+			return std::size_t(2 * 32) << (6 * (PieceCount - 1));
+		}
+
+		void Normalize(Square* Squares, int Count)
+		{
+			if (FileOf(Squares[0]) > 3)
+			{
+				for (int i = 0; i < Count; ++i)
+				{
+					Squares[i] ^= 7;
+				}
+			}
+		}
+
+		std::size_t IndexOf(const Square* Squares, int Count, int StrongToMove)
+		{
+			std::size_t Index = std::size_t(StrongToMove) * 32 + RankOf(Squares[0]) * 4 + FileOf(Squares[0]);
+			for (int i = 1; i < Count; ++i)
+			{
+				Index = (Index << 6) | std::size_t(Squares[i]);
+			}
+			return Index;
+		}
+	}
+
+	// ----------------------------------------------------
+	// Table
+	// ----------------------------------------------------
+	BitbaseTable::BitbaseTable()
+		: TableMaterial{}
+		, File{}
+		, Owned{}
+		, Data{ nullptr }
+	{
+	}
+
+	bool BitbaseTable::Open(const string& Path)
+	{
+		if (!File.Open(Path)) { return false; }
+
+		const std::uint8_t* Header = File.GetData();
+		Bitbase::Material Parsed;
+		bool bValid = File.GetSize() >= std::size_t(Bitbase::HeaderSize)
+			&& std::memcmp(Header, Magic, sizeof(Magic)) == 0
+			&& Header[4] == Bitbase::FileVersion;
+
+		if (bValid)
+		{
+			Parsed.Count[0] = Header[6];
+			Parsed.Count[1] = Header[7];
+			bValid = Parsed.PieceCount() == Header[5] && Parsed.PieceCount() <= Bitbase::MaxPieces;
+		}
+		for (int Side = 0; bValid && Side < 2; ++Side)
+		{
+			for (int i = 0; i < Parsed.Count[Side]; ++i)
+			{
+				Parsed.Pieces[Side][i] = EPieceType(Header[8 + Side * 4 + i]);
+				bValid = bValid && Parsed.Pieces[Side][i] >= Pawn && Parsed.Pieces[Side][i] <= Queen;
+			}
+		}
+		bValid = bValid && File.GetSize() == Bitbase::HeaderSize + Bitbase::IndexCount(Parsed.PieceCount()) / 4;
+
+		if (!bValid)
+		{
+			LOG("Bitbase %s has an invalid header or size", Path.c_str());
+			File.Close();
+			return false;
+		}
+
+		TableMaterial = Parsed;
+		Data = Header + Bitbase::HeaderSize;
+		return true;
+	}
+
+	void BitbaseTable::SetData(const Bitbase::Material& InMaterial, List<std::uint8_t>&& Packed)
+	{
+		File.Close();
+		TableMaterial = InMaterial;
+		Owned = std::move(Packed);
+		Data = Owned.data();
+	}
+
+	bool BitbaseTable::Save(const string& Path) const
+	{
+		std::uint8_t Header[Bitbase::HeaderSize] = {};
+		std::memcpy(Header, Magic, sizeof(Magic));
+		Header[4] = Bitbase::FileVersion;
+		Header[5] = std::uint8_t(TableMaterial.PieceCount());
+		Header[6] = std::uint8_t(TableMaterial.Count[0]);
+		Header[7] = std::uint8_t(TableMaterial.Count[1]);
+		for (int Side = 0; Side < 2; ++Side)
+		{
+			for (int i = 0; i < TableMaterial.Count[Side]; ++i)
+			{
+				Header[8 + Side * 4 + i] = std::uint8_t(TableMaterial.Pieces[Side][i]);
+			}
+		}
+
+		FILE* Out = std::fopen(Path.c_str(), "wb");
+		if (!Out) { return false; }
+
+		const std::size_t Bytes = Bitbase::IndexCount(TableMaterial.PieceCount()) / 4;
+		const bool bWritten = std::fwrite(Header, sizeof(Header), 1, Out) == 1 && std::fwrite(Data, 1, Bytes, Out) == Bytes;
+		return std::fclose(Out) == 0 && bWritten;
+	}
+
+	bool BitbaseTable::Probe(const Position& Pos, EColor Strong, EWdl& OutWdl) const
+	{
+		Square Squares[Bitbase::MaxPieces];
+		int Count = 0;
+		Squares[Count++] = Pos.KingSquare(Strong);
+		Squares[Count++] = Pos.KingSquare(~Strong);
+
+		const EColor Sides[2] = { Strong, ~Strong };
+		for (int Side = 0; Side < 2; ++Side)
+		{
+			Bitboard Used = 0;
+			for (int i = 0; i < TableMaterial.Count[Side]; ++i)
+			{
+				const Square Sq = Lsb(Pos.Pieces(Sides[Side], TableMaterial.Pieces[Side][i]) & ~Used);
+				Used |= SquareBB(Sq);
+				Squares[Count++] = Sq;
+			}
+		}
+
+		if (Strong == Black)
+		{
+			for (int i = 0; i < Count; ++i)
+			{
+				Squares[i] = FlipRank(Squares[i]);
+			}
+		}
+		Bitbase::Normalize(Squares, Count);
+
+		const int StrongToMove = Pos.GetSideToMove() == Strong ? 0 : 1;
+		switch (ReadCode(Bitbase::IndexOf(Squares, Count, StrongToMove)))
+		{
+		case Bitbase::CodeDraw: OutWdl = EWdl::Draw; return true;
+		case Bitbase::CodeWin:  OutWdl = EWdl::Win; return true;
+		case Bitbase::CodeLoss: OutWdl = EWdl::Loss; return true;
+		default:                return false;
+		}
+	}
+
+	// ----------------------------------------------------
+	// Set
+	// ----------------------------------------------------
+	BitbaseSet::BitbaseSet()
+		: Tables{}
+		, MaxLoadedPieces{ 0 }
+	{
+	}
+
+	int BitbaseSet::LoadDirectory(const string& Directory)
+	{
+		std::error_code Error;
+		std::filesystem::directory_iterator It{ Directory, Error };
+		if (Error) { return 0; }
+
+		int Loaded = 0;
+		for (const std::filesystem::directory_entry& Entry : It)
+		{
+			if (Entry.path().extension() != ".bb") { continue; }
+
+			unique<BitbaseTable> Table = std::make_unique<BitbaseTable>();
+			if (Table->Open(Entry.path().string()))
+			{
+				Add(std::move(Table));
+				++Loaded;
+			}
+		}
+		return Loaded;
+	}
+
+	void BitbaseSet::Add(unique<BitbaseTable> Table)
+	{
+		MaxLoadedPieces = std::max(MaxLoadedPieces, Table->GetMaterial().PieceCount());
+		Tables[Table->GetMaterial().GetKey()] = std::move(Table);
+	}
+
+	void BitbaseSet::Clear()
+	{
+		Tables.clear();
+		MaxLoadedPieces = 0;
+	}
+
+	const BitbaseTable* BitbaseSet::Find(const Bitbase::Material& InMaterial) const
+	{
+		const auto Found = Tables.find(InMaterial.GetKey());
+		return Found != Tables.end() ? Found->second.get() : nullptr;
+	}
+
+	bool BitbaseSet::Probe(const Position& Pos, EWdl& OutWdl) const
+	{
+		const int Count = PopCount(Pos.Pieces());
+		if (Count == 2)
+		{
+			OutWdl = EWdl::Draw;
+			return true;
+		}
+
+		// Tables are built without castling or en passant rights
+		if (Count > MaxLoadedPieces || Pos.GetCastlingRights() != NoCastling || Pos.GetEnPassant() != NoSquare) { return false; }
+
+		for (EColor Strong : { White, Black })
+		{
+			const auto Found = Tables.find(Bitbase::MaterialKey(Pos, Strong));
+			if (Found != Tables.end())
+			{
+				return Found->second->Probe(Pos, Strong, OutWdl);
+			}
+		}
+		return false;
+	}
+
+	// ----------------------------------------------------
+	// Generator
+	// ----------------------------------------------------
+	BitbaseGenerator::BitbaseGenerator(BitbaseSet& InTables, int InThreadCount)
+		: Tables{ InTables }
+		, ThreadCount{ std::max(InThreadCount, 1) }
+	{
+	}
+
+	bool BitbaseGenerator::Generate(const string& Signature, List<Stats>& OutStats)
+	{
+		Bitbase::Material Target;
+		if (!Bitbase::Material::Parse(Signature, Target) || Target.PieceCount() < 3) { return false; }
+		if (Tables.Find(Target)) { return true; }
+
+		// Every capture and promotion leads into a smaller or different table
+		for (int Side = 0; Side < 2; ++Side)
+		{
+			for (int i = 0; i < Target.Count[Side]; ++i)
+			{
+				Bitbase::Material Reduced = Target;
+				std::copy(Reduced.Pieces[Side] + i + 1, Reduced.Pieces[Side] + Reduced.Count[Side], Reduced.Pieces[Side] + i);
+				--Reduced.Count[Side];
+				if (Reduced.PieceCount() > 2 && !Generate(Reduced.GetSignature(), OutStats)) { return false; }
+
+				if (Target.Pieces[Side][i] != Pawn) { continue; }
+				for (int Promotion = Knight; Promotion <= Queen; ++Promotion)
+				{
+					Bitbase::Material Promoted = Target;
+					Promoted.Pieces[Side][i] = EPieceType(Promotion);
+					if (!Generate(Promoted.GetSignature(), OutStats)) { return false; }
+				}
+			}
+		}
+
+		OutStats.push_back(GenerateTable(Target));
+		return true;
+	}
+
+	BitbaseGenerator::Stats BitbaseGenerator::GenerateTable(const Bitbase::Material& InMaterial)
+	{
+		const auto Start = std::chrono::steady_clock::now();
+		const TableLayout Layout{ InMaterial };
+		const int PieceCount = Layout.PieceCount;
+		const std::size_t Count = Bitbase::IndexCount(PieceCount);
+
+		unique<std::atomic<std::uint8_t>[]> Status{ new std::atomic<std::uint8_t>[Count]() };
+		unique<std::atomic<std::uint8_t>[]> Remaining{ new std::atomic<std::uint8_t>[Count]() };
+		List<List<std::uint32_t>> Frontiers(ThreadCount);
+
+		// ------------------------------------------------
+		// Pass 1: terminal positions, exits into other tables and move counts
+		// ------------------------------------------------
+		constexpr std::size_t ChunkSize = 4096;
+		std::atomic<std::size_t> NextChunk{ 0 };
+		RunParallel(ThreadCount, [&](int Thread)
+		{
+			Position Pos;
+			Square Squares[Bitbase::MaxPieces];
+			MoveList Moves;
+
+			for (std::size_t Begin = NextChunk.fetch_add(ChunkSize); Begin < Count; Begin = NextChunk.fetch_add(ChunkSize))
+			{
+				for (std::size_t Index = Begin; Index < std::min(Begin + ChunkSize, Count); ++Index)
+				{
+					const EColor Us = EColor(Layout.Decode(Index, Squares));
+
+					Bitboard Occupied = 0;
+					bool bValid = true;
+					for (int i = 0; i < PieceCount && bValid; ++i)
+					{
+						bValid = !(Occupied & SquareBB(Squares[i]))
+							&& (TypeOf(Layout.Pieces[i]) != Pawn || (RankOf(Squares[i]) != 0 && RankOf(Squares[i]) != 7));
+						Occupied |= SquareBB(Squares[i]);
+					}
+					if (bValid)
+					{
+						Pos.SetFromPieces(Layout.Pieces, Squares, PieceCount, Us);
+						bValid = !Pos.IsSquareAttacked(Pos.KingSquare(~Us), Us);
+					}
+					if (!bValid)
+					{
+						Status[Index].store(StatusInvalid, std::memory_order_relaxed);
+						continue;
+					}
+
+					Moves.Count = 0;
+					GenerateLegalMoves(Pos, Moves);
+					if (Moves.Size() == 0)
+					{
+						Status[Index].store(Pos.IsInCheck() ? StatusLoss : StatusDraw, std::memory_order_relaxed);
+						if (Pos.IsInCheck()) { Frontiers[Thread].push_back(std::uint32_t(Index)); }
+						continue;
+					}
+
+					// Moves staying in this table are resolved backwards; the rest are probed now
+					int Open = 0;
+					bool bWin = false;
+					for (Move Candidate : Moves)
+					{
+						if (!Candidate.IsCapture() && !Candidate.IsPromotion())
+						{
+							++Open;
+							continue;
+						}
+
+						Pos.MakeMove(Candidate);
+						EWdl Child = EWdl::Draw;
+						Tables.Probe(Pos, Child);
+						Pos.UnmakeMove(Candidate);
+
+						if (Child == EWdl::Loss)
+						{
+							bWin = true;
+							break;
+						}
+						if (Child == EWdl::Draw)
+						{
+							++Open;		// Never decremented: a drawing exit can't be taken away
+						}
+					}
+
+					if (bWin || Open == 0)
+					{
+						Status[Index].store(bWin ? StatusWin : StatusLoss, std::memory_order_relaxed);
+						Frontiers[Thread].push_back(std::uint32_t(Index));
+					}
+					else
+					{
+						Remaining[Index].store(std::uint8_t(Open), std::memory_order_relaxed);
+					}
+				}
+			}
+		});
+
+		List<std::uint32_t> Frontier;
+		for (List<std::uint32_t>& Local : Frontiers)
+		{
+			Frontier.insert(Frontier.end(), Local.begin(), Local.end());
+			Local.clear();
+		}
+
+		// ------------------------------------------------
+		// Pass 2+: retrograde waves over un-moves
+		// ------------------------------------------------
+		// A lost position makes every predecessor a win; a won position takes one
+		// open move from each predecessor, which is lost once none are left.
+		Stats Result;
+		while (!Frontier.empty())
+		{
+			++Result.Passes;
+			std::atomic<std::size_t> NextItem{ 0 };
+			RunParallel(ThreadCount, [&](int Thread)
+			{
+				constexpr std::size_t ItemChunk = 256;
+				Square Squares[Bitbase::MaxPieces];
+				Square Raw[Bitbase::MaxPieces];
+
+				for (std::size_t Begin = NextItem.fetch_add(ItemChunk); Begin < Frontier.size(); Begin = NextItem.fetch_add(ItemChunk))
+				{
+					for (std::size_t Item = Begin; Item < std::min(Begin + ItemChunk, Frontier.size()); ++Item)
+					{
+						const std::size_t Index = Frontier[Item];
+						const bool bLost = Status[Index].load(std::memory_order_relaxed) == StatusLoss;
+						const int Mover = 1 - Layout.Decode(Index, Squares);
+
+						// The stored position and its mirror are both reachable from normalized predecessors
+						for (int Mirror = 0; Mirror < 2; ++Mirror)
+						{
+							Bitboard Occupied = 0;
+							for (int i = 0; i < PieceCount; ++i)
+							{
+								Raw[i] = Mirror ? Squares[i] ^ 7 : Squares[i];
+								Occupied |= SquareBB(Raw[i]);
+							}
+
+							for (int i = 0; i < PieceCount; ++i)
+							{
+								const EPiece Piece = Layout.Pieces[i];
+								if (ColorOf(Piece) != EColor(Mover)) { continue; }
+
+								const Square To = Raw[i];
+								Bitboard Origins = 0;
+								if (TypeOf(Piece) == Pawn)
+								{
+									const Square Single = To - PawnPush(EColor(Mover));
+									if (RelativeRank(EColor(Mover), To) >= 2 && !(Occupied & SquareBB(Single)))
+									{
+										Origins |= SquareBB(Single);
+										const Square Double = Single - PawnPush(EColor(Mover));
+										if (RelativeRank(EColor(Mover), To) == 3 && !(Occupied & SquareBB(Double)))
+										{
+											Origins |= SquareBB(Double);
+										}
+									}
+								}
+								else
+								{
+									Origins = Bitboards::Attacks(TypeOf(Piece), To, Occupied) & ~Occupied;
+								}
+
+								while (Origins)
+								{
+									Raw[i] = PopLsb(Origins);
+									if (FileOf(Raw[0]) <= 3)
+									{
+										const std::size_t Previous = Bitbase::IndexOf(Raw, PieceCount, Mover);
+										std::uint8_t Expected = StatusUnknown;
+										if (Status[Previous].load(std::memory_order_relaxed) == StatusUnknown)
+										{
+											if (bLost)
+											{
+												if (Status[Previous].compare_exchange_strong(Expected, StatusWin, std::memory_order_relaxed))
+												{
+													Frontiers[Thread].push_back(std::uint32_t(Previous));
+												}
+											}
+											else if (Remaining[Previous].fetch_sub(1, std::memory_order_relaxed) == 1
+												&& Status[Previous].compare_exchange_strong(Expected, StatusLoss, std::memory_order_relaxed))
+											{
+												Frontiers[Thread].push_back(std::uint32_t(Previous));
+											}
+										}
+									}
+								}
+								Raw[i] = To;
+							}
+						}
+					}
+				}
+			});
+
+			Frontier.clear();
+			for (List<std::uint32_t>& Local : Frontiers)
+			{
+				Frontier.insert(Frontier.end(), Local.begin(), Local.end());
+				Local.clear();
+			}
+		}
+
+		// ------------------------------------------------
+		// Pack two bits per position; anything unresolved is a draw
+		// ------------------------------------------------
+		List<std::uint8_t> Packed(Count / 4, 0);
+		for (std::size_t Index = 0; Index < Count; ++Index)
+		{
+			std::uint8_t Value = Status[Index].load(std::memory_order_relaxed);
+			Value = Value == StatusUnknown ? std::uint8_t(Bitbase::CodeDraw) : Value == StatusInvalid ? std::uint8_t(Bitbase::CodeInvalid) : Value;
+
+			Packed[Index >> 2] |= std::uint8_t(Value << ((Index & 3) * 2));
+			Result.Wins += Value == Bitbase::CodeWin;
+			Result.Draws += Value == Bitbase::CodeDraw;
+			Result.Losses += Value == Bitbase::CodeLoss;
+		}
+
+		unique<BitbaseTable> Table = std::make_unique<BitbaseTable>();
+		Table->SetData(InMaterial, std::move(Packed));
+		Tables.Add(std::move(Table));
+
+		Result.Signature = InMaterial.GetSignature();
+		Result.Positions = Count;
+		Result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+		return Result;
+	}
+}
@@ -0,0 +1,414 @@
+#include "Engine/Engine.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace we
+{
+	Engine::Engine()
+		: TT{}
+		, Book{}
+		, bUseBook{ true }
+		, Bitbases{}
+		, Tablebases{}
+		, bRootInTablebase{ false }
+		, Network{ nullptr }
+		, Workers{}
+		, MainThread{}
+		, bStopRequested{ false }
+		, bSearching{ false }
+		, bPondering{ false }
+		, ActiveLimits{}
+		, Timer{}
+		, LastResult{}
+		, Iterations{}
+		, LastStats{}
+		, IterationStartMs{ 0 }
+		, IterationStartNodes{ 0 }
+		, TelemetryLogPath{}
+		, Learning{}
+	{
+		SetThreadCount(1);
+	}
+
+	Engine::~Engine()
+	{
+		Stop();
+		Wait();
+	}
+
+	// ----------------------------------------------------
+	// Options
+	// ----------------------------------------------------
+	void Engine::SetHashSize(std::size_t MegaBytes)
+	{
+		Wait();
+		TT.Resize(MegaBytes);
+		Learning.MergeInto(TT);
+	}
+
+	void Engine::SetThreadCount(int Count)
+	{
+		Wait();
+		Workers.clear();
+		for (int i = 0; i < std::max(Count, 1); ++i)
+		{
+			Workers.push_back(std::make_unique<SearchWorker>(*this, i));
+		}
+	}
+
+	bool Engine::LoadBook(const string& Path)
+	{
+		Wait();
+		return Book.Open(Path);
+	}
+
+	int Engine::LoadBitbases(const string& Directory)
+	{
+		Wait();
+		Bitbases.Clear();
+		return Directory.empty() ? 0 : Bitbases.LoadDirectory(Directory);
+	}
+
+	int Engine::SetSyzygyPath(const string& Paths)
+	{
+		Wait();
+		return Tablebases.Init(Paths);
+	}
+
+	bool Engine::SetLearningFile(const string& Path)
+	{
+		Wait();
+		if (Path.empty())
+		{
+			Learning.Close();
+			return true;
+		}
+		if (!Learning.Open(Path)) { return false; }
+
+		const std::size_t Merged = Learning.MergeInto(TT);
+		LOG("Merged %zu learned positions from %s", Merged, Path.c_str());
+		return true;
+	}
+
+	void Engine::NewGame()
+	{
+		Wait();
+		TT.Clear();
+		Learning.MergeInto(TT);
+		for (auto& Worker : Workers)
+		{
+			Worker->ClearHistory();
+		}
+	}
+
+	// ----------------------------------------------------
+	// Searching
+	// ----------------------------------------------------
+	void Engine::Start(const Position& Pos, const SearchLimits& Limits)
+	{
+		Stop();
+		Wait();
+
+		bStopRequested = false;
+		bSearching = true;
+		bPondering = Limits.bPonder;
+		ActiveLimits = Limits;
+		Timer.Init(Limits, Pos.GetSideToMove());
+		Iterations.clear();
+		IterationStartMs = 0;
+		IterationStartNodes = 0;
+
+		MainThread = std::thread(&Engine::RunSearch, this, Pos, Limits);
+	}
+
+	// The clock has been running since Start(), so a long ponder can leave
+	// nothing to do but report the move already found
+	void Engine::PonderHit()
+	{
+		if (!bPondering) { return; }
+
+		if (Timer.IsSoftLimitReached())
+		{
+			bStopRequested = true;
+		}
+		bPondering = false;
+	}
+
+	void Engine::Wait()
+	{
+		if (MainThread.joinable())
+		{
+			MainThread.join();
+		}
+	}
+
+	SearchResult Engine::Think(const Position& Pos, const SearchLimits& Limits)
+	{
+		Start(Pos, Limits);
+		Wait();
+		return LastResult;
+	}
+
+	void Engine::RunSearch(Position Pos, SearchLimits Limits)
+	{
+		SearchResult Result;
+
+		if (bUseBook && Book.IsOpen() && !Limits.bInfinite && Limits.SearchMoves.empty())
+		{
+			Result.BestMove = Book.Probe(Pos);
+			Result.bFromBook = !Result.BestMove.IsNull();
+		}
+
+		if (Result.bFromBook)
+		{
+			WaitForPonderHit();
+		}
+
+		if (!Result.bFromBook)
+		{
+			// A tablebase root keeps only the DTZ-optimal moves; the search then
+			// picks among them and skips WDL probes, which would all agree
+			Syzygy::RootProbe Probe;
+			bRootInTablebase = Limits.SearchMoves.empty() && Tablebases.CanProbe(Pos) && Tablebases.ProbeRoot(Pos, Probe);
+			if (bRootInTablebase)
+			{
+				Limits.SearchMoves = Probe.BestMoves;
+			}
+
+			TT.NewSearch();
+
+			List<std::thread> Helpers;
+			for (std::size_t i = 1; i < Workers.size(); ++i)
+			{
+				Helpers.emplace_back([this, &Pos, &Limits, i]() { Workers[i]->Run(Pos, Limits); });
+			}
+
+			Workers[0]->Run(Pos, Limits);
+			WaitForPonderHit();
+			bStopRequested = true;
+			for (std::thread& Helper : Helpers)
+			{
+				Helper.join();
+			}
+
+			// Trust the deepest finished iteration; the main thread wins ties
+			const SearchWorker* Best = Workers[0].get();
+			for (const auto& Worker : Workers)
+			{
+				if (!Worker->GetBestPv().empty()
+					&& (Worker->GetCompletedDepth() > Best->GetCompletedDepth()
+						|| (Worker->GetCompletedDepth() == Best->GetCompletedDepth() && Worker->GetBestScore() > Best->GetBestScore())))
+				{
+					Best = Worker.get();
+				}
+			}
+
+			if (Best != Workers[0].get())
+			{
+				ReportIteration(*Best);
+			}
+
+			const List<Move>& Pv = Best->GetBestPv();
+			Result.BestMove = Pv.empty() ? NullMove : Pv[0];
+			Result.PonderMove = Pv.size() > 1 ? Pv[1] : NullMove;
+
+			// A search stopped before its first iteration still answers with a legal move
+			if (Result.BestMove.IsNull() && !Limits.SearchMoves.empty())
+			{
+				Result.BestMove = Limits.SearchMoves[0];
+			}
+			else if (Result.BestMove.IsNull())
+			{
+				MoveList Legal;
+				GenerateLegalMoves(Pos, Legal);
+				Result.BestMove = Legal.Size() > 0 ? Legal.Moves[0] : NullMove;
+			}
+			Result.Score = Best->GetBestScore();
+			Result.Depth = Best->GetCompletedDepth();
+			Result.Nodes = GetTotalNodes();
+
+			// A restricted root (searchmoves or a tablebase root) is not a result for the position
+			if (Limits.SearchMoves.empty())
+			{
+				Learning.Record(Pos, Result.Score, Result.Depth, Pv);
+			}
+		}
+
+		LastStats = CollectStatistics();
+		if (!Result.bFromBook && !TelemetryLogPath.empty())
+		{
+			AppendTelemetry(Pos, Result, LastStats);
+		}
+
+		LastResult = Result;
+		bSearching = false;
+		if (OnBestMove)
+		{
+			OnBestMove(Result);
+		}
+	}
+
+	// ----------------------------------------------------
+	// Limits
+	// ----------------------------------------------------
+	// A ponder search may run out of depth before the opponent moves; the
+	// move is only reported once it would be legal to play it
+	void Engine::WaitForPonderHit()
+	{
+		while (bPondering && !IsStopRequested())
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	bool Engine::CheckLimits()
+	{
+		if (IsStopRequested() || bPondering.load(std::memory_order_relaxed)) { return IsStopRequested(); }
+
+		if ((ActiveLimits.Nodes && GetTotalNodes() >= ActiveLimits.Nodes)
+			|| Timer.IsHardLimitReached())
+		{
+			bStopRequested = true;
+		}
+		return IsStopRequested();
+	}
+
+	SearchInfo Engine::MakeInfo(const SearchWorker& Worker, int Line) const
+	{
+		SearchInfo Info;
+		Info.MultiPv = Line + 1;
+		Info.Depth = Worker.GetCompletedDepth();
+		Info.SelDepth = Worker.GetSelDepth();
+		Info.Score = Worker.GetLines()[Line].Score;
+		Info.Nodes = GetTotalNodes();
+		Info.TimeMs = GetElapsedMs();
+		Info.Hashfull = TT.Hashfull();
+		for (const auto& Each : Workers)
+		{
+			Info.PawnHashProbes += Each->GetPawnTable().GetProbes();
+			Info.PawnHashHits += Each->GetPawnTable().GetHits();
+		}
+		Info.Stats = CollectStatistics();
+		Info.Pv = Worker.GetLines()[Line].Pv;
+		return Info;
+	}
+
+	SearchStats Engine::GetStatistics() const
+	{
+		if (!bSearching) { return LastStats; }
+
+		SearchStats Stats;
+		Stats.Threads = int(Workers.size());
+		Stats.TimeMs = GetElapsedMs();
+		Stats.Nodes = GetTotalNodes();
+		for (const auto& Worker : Workers)
+		{
+			Worker->GetCounters().AddTo(Stats);
+		}
+		return Stats;
+	}
+
+	// Main search thread only, where the iteration list is safe to read
+	SearchStats Engine::CollectStatistics() const
+	{
+		SearchStats Stats;
+		Stats.Threads = int(Workers.size());
+		Stats.TimeMs = GetElapsedMs();
+		Stats.Nodes = GetTotalNodes();
+		for (const auto& Worker : Workers)
+		{
+			Worker->GetCounters().AddTo(Stats);
+		}
+		Stats.Iterations = Iterations;
+		return Stats;
+	}
+
+	void Engine::AppendTelemetry(const Position& Pos, const SearchResult& Result, const SearchStats& Stats) const
+	{
+		std::ofstream Log(TelemetryLogPath, std::ios::app);
+		if (!Log)
+		{
+			LOG("Cannot append search telemetry to %s", TelemetryLogPath.c_str());
+			return;
+		}
+
+		Log << "{\"fen\":\"" << Pos.GetFen() << "\",\"bestmove\":\"" << MoveToUci(Result.BestMove)
+			<< "\",\"depth\":" << Result.Depth << ",\"score\":" << Result.Score
+			<< ",\"stats\":" << Stats.ToJson() << "}\n";
+	}
+
+	void Engine::ReportIteration(const SearchWorker& Worker)
+	{
+		// Helpers' iterations overlap the main thread's, so only the main thread is timed
+		if (Worker.IsMainThread())
+		{
+			const std::int64_t Now = GetElapsedMs();
+			const std::uint64_t TotalNodes = GetTotalNodes();
+			Iterations.push_back(IterationStats{ Worker.GetCompletedDepth(), Now - IterationStartMs, TotalNodes - IterationStartNodes });
+			IterationStartMs = Now;
+			IterationStartNodes = TotalNodes;
+		}
+
+		if (OnInfo)
+		{
+			for (int Line = 0; Line < int(Worker.GetLines().size()); ++Line)
+			{
+				OnInfo(MakeInfo(Worker, Line));
+			}
+		}
+
+		// Do not start an iteration that would likely be cut off by the hard limit
+		if (!bPondering && !Timer.CanStartIteration(Iterations.empty() ? 0 : Iterations.back().TimeMs))
+		{
+			bStopRequested = true;
+		}
+	}
+
+	std::uint64_t Engine::GetTotalNodes() const
+	{
+		std::uint64_t Total = 0;
+		for (const auto& Worker : Workers)
+		{
+			Total += Worker->GetNodes();
+		}
+		return Total;
+	}
+
+	// ----------------------------------------------------
+	// UCI Reporting
+	// ----------------------------------------------------
+	string FormatUciInfo(const SearchInfo& Info)
+	{
+		std::ostringstream Line;
+		Line << "info depth " << Info.Depth << " seldepth " << Info.SelDepth << " multipv " << Info.MultiPv << " score ";
+		if (IsMateScore(Info.Score))
+		{
+			const int MovesToMate = (ScoreMate - std::abs(Info.Score) + 1) / 2;
+			Line << "mate " << (Info.Score > 0 ? MovesToMate : -MovesToMate);
+		}
+		else
+		{
+			Line << "cp " << Info.Score;
+		}
+		Line << " nodes " << Info.Nodes << " nps " << Info.NodesPerSecond() << " hashfull " << Info.Hashfull << " time " << Info.TimeMs << " pv";
+		for (Move Each : Info.Pv)
+		{
+			Line << " " << MoveToUci(Each);
+		}
+		return Line.str();
+	}
+
+	string FormatUciStats(const SearchStats& Stats)
+	{
+		char Line[256];
+		const std::int64_t LastIterationMs = Stats.Iterations.empty() ? 0 : Stats.Iterations.back().TimeMs;
+		std::snprintf(Line, sizeof(Line), "info string qnodes %llu tthit %.1f%% firstcut %.1f%% nullcut %llu/%llu ebf %.2f itertime %lld",
+			static_cast<unsigned long long>(Stats.QNodes), Stats.TTHitRate() * 100.0, Stats.FirstMoveCutoffRate() * 100.0,
+			static_cast<unsigned long long>(Stats.NullMoveCutoffs), static_cast<unsigned long long>(Stats.NullMoveTries),
+			Stats.BranchingFactor(), static_cast<long long>(LastIterationMs));
+		return Line;
+	}
+}
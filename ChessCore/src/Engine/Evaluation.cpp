@@ -0,0 +1,177 @@
+#include "Engine/Evaluation.h"
+#include <algorithm>
+
+namespace we
+{
+	namespace
+	{
+		template<int Size>
+		const EvalScore& MobilityEntry(const EvalScore (&Table)[Size], int Count)
+		{
+			return Table[std::min(Count, Size - 1)];
+		}
+
+		EvalScore EvaluateMobilityFor(const Position& Pos, EColor Us)
+		{
+			const EColor Them = ~Us;
+			const Bitboard Occupied = Pos.Pieces();
+			const Bitboard TheirPawns = Pos.Pieces(Them, Pawn);
+			const Bitboard PawnAttacked = Them == White
+				? Shift<9>(TheirPawns) | Shift<7>(TheirPawns)
+				: Shift<-9>(TheirPawns) | Shift<-7>(TheirPawns);
+			const Bitboard SafeArea = ~(Pos.Pieces(Us) | PawnAttacked);
+
+			EvalScore Score;
+
+			Bitboard Knights = Pos.Pieces(Us, Knight);
+			while (Knights)
+			{
+				Score += MobilityEntry(EvalParams::KnightMobility, PopCount(Bitboards::KnightAttacks[PopLsb(Knights)] & SafeArea));
+			}
+
+			Bitboard Bishops = Pos.Pieces(Us, Bishop);
+			while (Bishops)
+			{
+				Score += MobilityEntry(EvalParams::BishopMobility, PopCount(Bitboards::BishopAttacks(PopLsb(Bishops), Occupied) & SafeArea));
+			}
+
+			Bitboard Rooks = Pos.Pieces(Us, Rook);
+			while (Rooks)
+			{
+				Score += MobilityEntry(EvalParams::RookMobility, PopCount(Bitboards::RookAttacks(PopLsb(Rooks), Occupied) & SafeArea));
+			}
+
+			Bitboard Queens = Pos.Pieces(Us, Queen);
+			while (Queens)
+			{
+				Score += MobilityEntry(EvalParams::QueenMobility, PopCount(Bitboards::QueenAttacks(PopLsb(Queens), Occupied) & SafeArea));
+			}
+
+			return Score;
+		}
+
+		bool MovesKing(const DirtyPieces& Dirty, EColor Color)
+		{
+			for (int i = 0; i < Dirty.Count; ++i)
+			{
+				if (Dirty.Piece[i] == MakePiece(Color, King)) { return true; }
+			}
+			return false;
+		}
+	}
+
+	int Evaluator::Evaluate(const Position& Pos)
+	{
+		return Network ? EvaluateNetwork(Pos) : EvaluateClassical(Pos);
+	}
+
+	int Evaluator::EvaluateClassical(const Position& Pos)
+	{
+		PawnEntry Uncached;
+		PawnEntry* Pawns = &Uncached;
+		if (bUsePawnHash)
+		{
+			Pawns = &PawnTable.Probe(Pos);
+		}
+		else
+		{
+			PawnHashTable::EvaluateEntry(Pos, Uncached);
+		}
+
+		EvalScore Score = Pos.GetPsqScore();
+		Score += EvaluatePawns(Pos, *Pawns);
+		Score += EvaluateMobility(Pos);
+
+		if (MoreThanOne(Pos.Pieces(White, Bishop))) { Score += EvalParams::BishopPair; }
+		if (MoreThanOne(Pos.Pieces(Black, Bishop))) { Score -= EvalParams::BishopPair; }
+
+		const int WhiteScore = Taper(Score, Pos.GetPhase());
+		const int Tempo = Taper(EvalParams::Tempo, Pos.GetPhase());
+		return (Pos.GetSideToMove() == White ? WhiteScore : -WhiteScore) + Tempo;
+	}
+
+	int Evaluator::EvaluateNetwork(const Position& Pos)
+	{
+		return Network->Propagate(GetAccumulator(Pos), Pos.GetSideToMove());
+	}
+
+	const Nnue::Accumulator& Evaluator::GetAccumulator(const Position& Pos)
+	{
+		const int Current = Pos.GetStateCount() - 1;
+		if (int(Accumulators.size()) <= Current)
+		{
+			Accumulators.resize(Current + 64);
+		}
+
+		UpdateAccumulator(Pos, White);
+		UpdateAccumulator(Pos, Black);
+		return Accumulators[Current];
+	}
+
+	void Evaluator::SetNetwork(const Nnue::Network* InNetwork)
+	{
+		Network = InNetwork && InNetwork->IsLoaded() ? InNetwork : nullptr;
+		Accumulators.clear();
+	}
+
+	void Evaluator::UpdateAccumulator(const Position& Pos, EColor Perspective)
+	{
+		const int Current = Pos.GetStateCount() - 1;
+		if (Accumulators[Current].Serial[Perspective] == Pos.GetState(Current).Serial) { return; }
+
+		// Walk back to the last state this perspective is valid for; a king move
+		// changes every feature so nothing before it can be reused
+		int Base = Current;
+		while (Base > 0
+			&& Accumulators[Base].Serial[Perspective] != Pos.GetState(Base).Serial
+			&& !MovesKing(Pos.GetState(Base).Dirty, Perspective))
+		{
+			--Base;
+		}
+
+		if (Accumulators[Base].Serial[Perspective] != Pos.GetState(Base).Serial)
+		{
+			Network->RefreshAccumulator(Pos, Perspective, Accumulators[Current]);
+			Accumulators[Current].Serial[Perspective] = Pos.GetState(Current).Serial;
+			return;
+		}
+
+		const Square KingSq = Pos.KingSquare(Perspective);
+		for (int Index = Base + 1; Index <= Current; ++Index)
+		{
+			Network->UpdateAccumulator(Pos.GetState(Index).Dirty, KingSq, Perspective, Accumulators[Index - 1], Accumulators[Index]);
+			Accumulators[Index].Serial[Perspective] = Pos.GetState(Index).Serial;
+		}
+	}
+
+	int Evaluator::Taper(const EvalScore& Score, int Phase)
+	{
+		Phase = std::min(Phase, EvalParams::MaxPhase);
+		return (Score.Mg * Phase + Score.Eg * (EvalParams::MaxPhase - Phase)) / EvalParams::MaxPhase;
+	}
+
+	EvalScore Evaluator::EvaluatePawns(const Position& Pos)
+	{
+		PawnEntry Entry;
+		PawnHashTable::EvaluateEntry(Pos, Entry);
+		return EvaluatePawns(Pos, Entry);
+	}
+
+	EvalScore Evaluator::EvaluatePawns(const Position& Pos, PawnEntry& Entry)
+	{
+		EvalScore Score = Entry.Score;
+		Score += Entry.GetShield(Pos, White);
+		Score -= Entry.GetShield(Pos, Black);
+
+		// Passed pawns whose next square is free; pieces move too often to cache this
+		const Bitboard Empty = ~Pos.Pieces();
+		Score += EvalParams::PassedPawnFree * PopCount(Shift<8>(Entry.PassedPawns[White]) & Empty);
+		Score -= EvalParams::PassedPawnFree * PopCount(Shift<-8>(Entry.PassedPawns[Black]) & Empty);
+		return Score;
+	}
+
+	EvalScore Evaluator::EvaluateMobility(const Position& Pos)
+	{
+		return EvaluateMobilityFor(Pos, White) - EvaluateMobilityFor(Pos, Black);
+	}
+}
@@ -0,0 +1,239 @@
+#include "Engine/LearningFile.h"
+#include "Engine/Search.h"
+#include "IO/MappedFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace we
+{
+	namespace
+	{
+		constexpr char Magic[8] = { 'W', 'E', 'L', 'E', 'A', 'R', 'N', '1' };
+		constexpr std::size_t HeaderSize = 16;				// Magic, record size, reserved
+		constexpr std::size_t FlushRecords = 256;
+		constexpr auto FlushInterval = std::chrono::seconds(5);
+
+		std::uint16_t ComputeCheck(const LearnedEntry& Entry)
+		{
+			std::uint64_t Mixed = Entry.Key ^ 0x9E3779B97F4A7C15ULL;
+			Mixed ^= std::uint64_t(std::uint16_t(Entry.Score)) | std::uint64_t(Entry.BestMove) << 16
+				| std::uint64_t(Entry.Depth) << 32 | std::uint64_t(Entry.Bound) << 40;
+			Mixed = (Mixed ^ (Mixed >> 31)) * 0xBF58476D1CE4E5B9ULL;
+			return std::uint16_t(Mixed >> 48);
+		}
+
+		// Records are appended blindly, so a torn one left by a crash or a full
+		// disk would misalign every record written after it
+		bool TrimTornRecord(const string& Path)
+		{
+			std::error_code Error;
+			const std::uintmax_t Size = std::filesystem::file_size(Path, Error);
+			if (Error || Size < HeaderSize) { return false; }
+
+			const std::uintmax_t Whole = Size - (Size - HeaderSize) % sizeof(LearnedEntry);
+			if (Whole != Size)
+			{
+				std::filesystem::resize_file(Path, Whole, Error);
+			}
+			return !Error;
+		}
+
+		// Same adjustment the search applies: mates count from the stored position
+		int ScoreToTT(int Score, int Ply)
+		{
+			return Score >= ScoreMateInMaxPly ? Score + Ply : Score <= -ScoreMateInMaxPly ? Score - Ply : Score;
+		}
+	}
+
+	LearningFile::LearningFile()
+		: Path{}
+		, bOpen{ false }
+		, MinDepth{ DefaultMinDepth }
+		, Writer{}
+		, Lock{}
+		, Wake{}
+		, Pending{}
+		, bStopWriter{ false }
+	{
+	}
+
+	LearningFile::~LearningFile()
+	{
+		Close();
+	}
+
+	bool LearningFile::Open(const string& InPath)
+	{
+		Close();
+
+		// Only the header is read here; the records are left to MergeInto()
+		char Header[HeaderSize] = {};
+		std::FILE* File = std::fopen(InPath.c_str(), "rb");
+		const bool bExists = File != nullptr;
+		const std::size_t HeaderRead = bExists ? std::fread(Header, 1, HeaderSize, File) : 0;
+		if (File) { std::fclose(File); }
+
+		if (!bExists || HeaderRead == 0)
+		{
+			File = std::fopen(InPath.c_str(), "wb");
+			if (!File)
+			{
+				LOG("Cannot create learning file %s", InPath.c_str());
+				return false;
+			}
+			const std::uint32_t RecordSize = sizeof(LearnedEntry);
+			std::memcpy(Header, Magic, sizeof(Magic));
+			std::memcpy(Header + sizeof(Magic), &RecordSize, sizeof(RecordSize));
+			const bool bWritten = std::fwrite(Header, 1, HeaderSize, File) == HeaderSize;
+			std::fclose(File);
+			if (!bWritten) { return false; }
+		}
+		else
+		{
+			std::uint32_t RecordSize = 0;
+			std::memcpy(&RecordSize, Header + sizeof(Magic), sizeof(RecordSize));
+			if (HeaderRead != HeaderSize || std::memcmp(Header, Magic, sizeof(Magic)) != 0 || RecordSize != sizeof(LearnedEntry))
+			{
+				LOG("%s is not a learning file", InPath.c_str());
+				return false;
+			}
+			if (!TrimTornRecord(InPath))
+			{
+				LOG("Cannot repair learning file %s", InPath.c_str());
+				return false;
+			}
+		}
+
+		Path = InPath;
+		bOpen = true;
+		bStopWriter = false;
+		Writer = std::thread(&LearningFile::RunWriter, this);
+		return true;
+	}
+
+	void LearningFile::Close()
+	{
+		if (!bOpen) { return; }
+
+		{
+			std::lock_guard<std::mutex> Guard{ Lock };
+			bStopWriter = true;
+		}
+		Wake.notify_one();
+		Writer.join();
+
+		Pending.clear();
+		bOpen = false;
+	}
+
+	// ----------------------------------------------------
+	// Reading
+	// ----------------------------------------------------
+	std::size_t LearningFile::MergeInto(TranspositionTable& TT) const
+	{
+		if (!bOpen) { return 0; }
+
+		// Later records are newer, so they are stored last and win ties in the table
+		std::size_t Stored = 0;
+		const std::size_t Capacity = TT.GetEntryCount();
+		auto StoreEntry = [&TT, &Stored](const LearnedEntry& Entry)
+		{
+			if (Entry.Check != ComputeCheck(Entry)) { return; }
+			TT.Store(Entry.Key, Move{ Entry.BestMove }, Entry.Score, ScoreNone, Entry.Depth, EBound(Entry.Bound & BoundExact));
+			++Stored;
+		};
+
+		MappedFile File;
+		if (File.Open(Path) && File.GetSize() > HeaderSize)
+		{
+			// A record cut short by a crash is ignored
+			const std::size_t Count = (File.GetSize() - HeaderSize) / sizeof(LearnedEntry);
+			const std::uint8_t* Records = File.GetData() + HeaderSize;
+			for (std::size_t i = Count - std::min(Count, Capacity); i < Count; ++i)
+			{
+				LearnedEntry Entry;
+				std::memcpy(&Entry, Records + i * sizeof(LearnedEntry), sizeof(LearnedEntry));
+				StoreEntry(Entry);
+			}
+		}
+
+		// Results still waiting for the writer
+		std::lock_guard<std::mutex> Guard{ Lock };
+		for (const LearnedEntry& Entry : Pending)
+		{
+			StoreEntry(Entry);
+		}
+		return Stored;
+	}
+
+	// ----------------------------------------------------
+	// Writing
+	// ----------------------------------------------------
+	void LearningFile::Record(const Position& Root, int Score, int Depth, const List<Move>& Pv)
+	{
+		if (!bOpen || Depth < MinDepth) { return; }
+
+		List<LearnedEntry> Entries;
+		Position Pos = Root;
+		for (std::size_t Ply = 0; Ply < Pv.size() && Depth - int(Ply) >= MinDepth; ++Ply)
+		{
+			LearnedEntry Entry;
+			Entry.Key = Pos.GetKey();
+			Entry.Score = std::int16_t(ScoreToTT(Ply % 2 == 0 ? Score : -Score, int(Ply)));
+			Entry.BestMove = Pv[Ply].Data;
+			Entry.Depth = std::uint8_t(std::min(Depth - int(Ply), 255));
+			Entry.Bound = std::uint8_t(BoundExact);
+			Entry.Check = ComputeCheck(Entry);
+			Entries.push_back(Entry);
+			Pos.MakeMove(Pv[Ply]);
+		}
+
+		bool bFull = false;
+		{
+			std::lock_guard<std::mutex> Guard{ Lock };
+			Pending.insert(Pending.end(), Entries.begin(), Entries.end());
+			bFull = Pending.size() >= FlushRecords;
+		}
+		if (bFull)
+		{
+			Wake.notify_one();
+		}
+	}
+
+	// Appends in batches: when enough records are queued, every few seconds,
+	// and once more on Close()
+	void LearningFile::RunWriter()
+	{
+		std::unique_lock<std::mutex> Guard{ Lock };
+		for (;;)
+		{
+			Wake.wait_for(Guard, FlushInterval, [this]() { return bStopWriter || Pending.size() >= FlushRecords; });
+			const bool bStopping = bStopWriter;
+			if (!Pending.empty())
+			{
+				const List<LearnedEntry> Batch = Pending;
+				Guard.unlock();
+
+				bool bWritten = false;
+				if (std::FILE* Output = std::fopen(Path.c_str(), "ab"))
+				{
+					bWritten = std::fwrite(Batch.data(), sizeof(LearnedEntry), Batch.size(), Output) == Batch.size();
+					bWritten = std::fclose(Output) == 0 && bWritten;
+				}
+
+				Guard.lock();
+				if (!bWritten)
+				{
+					LOG("Cannot append to learning file %s", Path.c_str());
+					TrimTornRecord(Path);
+				}
+				// Dropped either way, so a full disk does not grow the queue forever
+				Pending.erase(Pending.begin(), Pending.begin() + Batch.size());
+			}
+			if (bStopping) { return; }
+		}
+	}
+}
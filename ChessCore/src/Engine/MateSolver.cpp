@@ -0,0 +1,388 @@
+#include "Engine/MateSolver.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+
+namespace we
+{
+	namespace
+	{
+		// Settled nodes only; unsettled sums saturate one below, so a large but
+		// open subtree never reaches the root's limits
+		constexpr std::uint32_t Infinite = 1u << 30;
+		constexpr std::uint64_t StopCheckMask = 1023;
+
+		// Keeps the attacker and, for mate-in-N, the plies left apart in the table
+		constexpr HashKey BlackAttackerKey = 0x6C8E9CF570932BD5ULL;
+		constexpr HashKey RemainingKey = 0x9E3779B97F4A7C15ULL;
+
+		std::uint32_t AddNumbers(std::uint32_t A, std::uint32_t B)
+		{
+			return A >= Infinite || B >= Infinite ? Infinite : std::min(Infinite - 1, A + B);
+		}
+	}
+
+	MateSolver::MateSolver()
+		: Table{}
+		, EntryCount{ 0 }
+		, Frames{ std::make_unique<Frame[]>(MaxSolvePly) }
+		, Attacker{ White }
+		, ActiveLimits{}
+		, Nodes{ 0 }
+		, bAborted{ false }
+		, StartTime{}
+		, SolverThread{}
+		, bStopRequested{ false }
+		, bSearching{ false }
+		, LastSolution{}
+	{
+		SetHashSize(16);
+	}
+
+	MateSolver::~MateSolver()
+	{
+		Stop();
+		Wait();
+	}
+
+	// ----------------------------------------------------
+	// Options
+	// ----------------------------------------------------
+	void MateSolver::SetHashSize(std::size_t MegaBytes)
+	{
+		Wait();
+
+		// Whole buckets, a power of two of them
+		std::size_t Buckets = 1;
+		while (Buckets * 2 * BucketSize * sizeof(Entry) <= std::max<std::size_t>(MegaBytes, 1) * 1024 * 1024)
+		{
+			Buckets *= 2;
+		}
+		EntryCount = Buckets * BucketSize;
+		Table = std::make_unique<Entry[]>(EntryCount);
+	}
+
+	void MateSolver::Clear()
+	{
+		Wait();
+		std::fill(Table.get(), Table.get() + EntryCount, Entry{});
+	}
+
+	// ----------------------------------------------------
+	// Table
+	// ----------------------------------------------------
+	HashKey MateSolver::KeyFor(const Position& Pos, int Remaining) const
+	{
+		HashKey Key = Pos.GetKey() ^ (Attacker == Black ? BlackAttackerKey : 0);
+		return IsLimited() ? Key ^ (HashKey(Remaining + 1) * RemainingKey) : Key;
+	}
+
+	bool MateSolver::Lookup(HashKey Key, Numbers& Out) const
+	{
+		const Entry* Bucket = &Table[(Key & (EntryCount / BucketSize - 1)) * BucketSize];
+		for (int i = 0; i < BucketSize; ++i)
+		{
+			if (Bucket[i].Key == Key && Key != 0)
+			{
+				Out = Numbers{ Bucket[i].Proof, Bucket[i].Disproof, Bucket[i].Distance };
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void MateSolver::Store(HashKey Key, const Numbers& Value, std::uint64_t Work)
+	{
+		Entry* Bucket = &Table[(Key & (EntryCount / BucketSize - 1)) * BucketSize];
+		Entry* Target = Bucket;
+		for (int i = 0; i < BucketSize; ++i)
+		{
+			if (Bucket[i].Key == Key)
+			{
+				Target = &Bucket[i];
+				break;
+			}
+			if (Bucket[i].Work < Target->Work)
+			{
+				Target = &Bucket[i];
+			}
+		}
+
+		// Settled results are worth keeping over any unsettled subtree
+		const bool bSettled = Value.Proof == 0 || Value.Disproof == 0;
+		Target->Key = Key;
+		Target->Proof = Value.Proof;
+		Target->Disproof = Value.Disproof;
+		Target->Work = bSettled ? 0xFFFFFFFF : std::uint32_t(std::min<std::uint64_t>(Work, 0xFFFFFFFE));
+		Target->Distance = std::uint16_t(Value.Distance);
+	}
+
+	// ----------------------------------------------------
+	// Solving
+	// ----------------------------------------------------
+	MateSolution MateSolver::Solve(const Position& Pos, const MateLimits& Limits)
+	{
+		Attacker = Pos.GetSideToMove();
+		ActiveLimits = Limits;
+		Nodes = 0;
+		bAborted = false;
+		StartTime = std::chrono::steady_clock::now();
+
+		MateSolution Solution;
+		Numbers RootNumbers = IsLimited() ? SolveRoot(Pos) : SolveUnlimited(Pos);
+		if (RootNumbers.Disproof == 0 && !RootNumbers.bPathDependent)
+		{
+			Solution.Result = EMateResult::NoMate;
+		}
+
+		// A proof is not necessarily the quickest mate, so the same position is
+		// asked again for one move less until that fails or the budget runs out
+		while (RootNumbers.Proof == 0)
+		{
+			Solution.Result = EMateResult::Mate;
+			Solution.MovesToMate = (RootNumbers.Distance + 1) / 2;
+			Solution.Line.clear();
+			ExtractLine(Pos, IsLimited() ? ActiveLimits.MaxMoves * 2 - 1 : MaxSolvePly, Solution.Line);
+			if (Solution.MovesToMate <= 1 || bAborted) { break; }
+			if (IsLimited() && Solution.MovesToMate > ActiveLimits.MaxMoves) { break; }
+
+			ActiveLimits.MaxMoves = Solution.MovesToMate - 1;
+			RootNumbers = SolveRoot(Pos);
+		}
+
+		Solution.Nodes = Nodes;
+		Solution.TimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - StartTime).count();
+		Solution.MemoryBytes = GetMemoryBytes();
+		return Solution;
+	}
+
+	// Mates are first looked for under doubling move limits, where the plies
+	// left keep the search free of cycles; only when none turns up does the
+	// search run without a limit, to prove that there is no mate at all
+	MateSolver::Numbers MateSolver::SolveUnlimited(const Position& Pos)
+	{
+		for (int Moves = 2; Moves * 2 < MaxSolvePly && !bAborted; Moves *= 2)
+		{
+			ActiveLimits.MaxMoves = Moves;
+			const Numbers Bounded = SolveRoot(Pos);
+			if (Bounded.Proof == 0) { return Bounded; }
+		}
+
+		ActiveLimits.MaxMoves = 0;
+		return bAborted ? Numbers{} : SolveRoot(Pos);
+	}
+
+	MateSolver::Numbers MateSolver::SolveRoot(const Position& Pos)
+	{
+		Position Root = Pos;
+		Numbers RootNumbers;
+		Search(Root, 0, IsLimited() ? ActiveLimits.MaxMoves * 2 - 1 : MaxSolvePly, Infinite, Infinite, RootNumbers);
+		return RootNumbers;
+	}
+
+	void MateSolver::Start(const Position& Pos, const MateLimits& Limits)
+	{
+		Stop();
+		Wait();
+
+		bStopRequested = false;
+		bSearching = true;
+		SolverThread = std::thread([this, Pos, Limits]()
+		{
+			LastSolution = Solve(Pos, Limits);
+			bSearching = false;
+			if (OnSolved)
+			{
+				OnSolved(LastSolution);
+			}
+		});
+	}
+
+	void MateSolver::Wait()
+	{
+		if (SolverThread.joinable())
+		{
+			SolverThread.join();
+		}
+	}
+
+	// Returns once the node's proof or disproof number reaches its limit.
+	// OR nodes (attacker to move) take the smallest proof number of their
+	// children and the sum of the disproof numbers; AND nodes the reverse.
+	void MateSolver::Search(Position& Pos, int Ply, int Remaining, std::uint32_t ProofLimit, std::uint32_t DisproofLimit, Numbers& Out)
+	{
+		++Nodes;
+		if ((Nodes & StopCheckMask) == 0
+			&& (bStopRequested.load(std::memory_order_relaxed) || (ActiveLimits.Nodes && Nodes >= ActiveLimits.Nodes)))
+		{
+			bAborted = true;
+		}
+
+		const bool bOrNode = Pos.GetSideToMove() == Attacker;
+		const HashKey Key = KeyFor(Pos, Remaining);
+		const Numbers Proven{ 0, Infinite, 0 };
+		const Numbers Disproven{ Infinite, 0, 0 };
+		const Numbers Unknown{ Infinite, 0, 0, true };
+
+		Frame& Current = Frames[Ply];
+		MoveList& Moves = Current.Moves;
+		Moves.Count = 0;
+		GenerateLegalMoves(Pos, Moves);
+		if (Moves.Count == 0)
+		{
+			Out = !bOrNode && Pos.IsInCheck() ? Proven : Disproven;
+			Store(Key, Out, 1);
+			return;
+		}
+		if ((IsLimited() && Remaining == 0) || Pos.IsInsufficientMaterial() || Pos.IsFiftyMoveDraw())
+		{
+			Out = Disproven;
+			Store(Key, Out, 1);
+			return;
+		}
+		if (Ply + 1 >= MaxSolvePly)
+		{
+			Out = Unknown;
+			return;
+		}
+
+		// Children are keyed once. Without a move limit a repeated child is unknown
+		// on this path and never looked up; with one, the plies left are part of
+		// the key, so the search has no cycles to break
+		HashKey* ChildKeys = Current.ChildKeys;
+		Numbers* Children = Current.Children;
+		for (int i = 0; i < Moves.Count; ++i)
+		{
+			Pos.MakeMove(Moves.Moves[i]);
+			ChildKeys[i] = KeyFor(Pos, Remaining - 1);
+			Children[i] = !IsLimited() && Pos.IsRepetition(Ply + 1) ? Unknown : Numbers{};
+			Pos.UnmakeMove(Moves.Moves[i]);
+		}
+
+		const std::uint64_t StartNodes = Nodes;
+		for (;;)
+		{
+			// Children solved through a transposition since the last pass are picked up here
+			Numbers Node{ bOrNode ? Infinite : 0, bOrNode ? 0 : Infinite, 0 };
+			bool bIndependentDisproof = false;
+			int Best = -1;
+			std::uint32_t SecondBest = Infinite;
+			for (int i = 0; i < Moves.Count; ++i)
+			{
+				Numbers& Child = Children[i];
+				if (!Child.bPathDependent)
+				{
+					Lookup(ChildKeys[i], Child);
+				}
+				Node.bPathDependent = Node.bPathDependent || Child.bPathDependent;
+				bIndependentDisproof = bIndependentDisproof || (Child.Disproof == 0 && !Child.bPathDependent);
+
+				// The number this node minimises over its children and the one it sums
+				const std::uint32_t MinNumber = bOrNode ? Child.Proof : Child.Disproof;
+				const std::uint32_t BestNumber = Best < 0 ? Infinite : bOrNode ? Children[Best].Proof : Children[Best].Disproof;
+				if (Best < 0 || MinNumber < BestNumber)
+				{
+					SecondBest = BestNumber;
+					Best = i;
+				}
+				else if (MinNumber < SecondBest)
+				{
+					SecondBest = MinNumber;
+				}
+
+				if (bOrNode)
+				{
+					Node.Proof = std::min(Node.Proof, Child.Proof);
+					Node.Disproof = AddNumbers(Node.Disproof, Child.Disproof);
+				}
+				else
+				{
+					Node.Proof = AddNumbers(Node.Proof, Child.Proof);
+					Node.Disproof = std::min(Node.Disproof, Child.Disproof);
+				}
+			}
+
+			// An AND node refuted by any child that holds everywhere holds everywhere too;
+			// proofs never rest on an unknown child
+			if (!bOrNode && bIndependentDisproof)
+			{
+				Node.bPathDependent = false;
+			}
+			Node.bPathDependent = Node.bPathDependent && Node.Disproof == 0;
+
+			if (Node.Proof == 0)
+			{
+				// The quickest mate, against the slowest defence
+				Node.Distance = bOrNode ? MaxSolvePly : 0;
+				for (int i = 0; i < Moves.Count; ++i)
+				{
+					if (bOrNode && Children[i].Proof == 0) { Node.Distance = std::min(Node.Distance, Children[i].Distance + 1); }
+					if (!bOrNode) { Node.Distance = std::max(Node.Distance, Children[i].Distance + 1); }
+				}
+			}
+
+			if (Node.Proof >= ProofLimit || Node.Disproof >= DisproofLimit || bAborted)
+			{
+				Out = Node;
+				break;
+			}
+
+			// The child may use the slack left under this node's limits, but no
+			// more than it takes for its best sibling to become more promising
+			Numbers& Child = Children[Best];
+			std::uint32_t ChildProofLimit, ChildDisproofLimit;
+			if (bOrNode)
+			{
+				ChildProofLimit = std::min(ProofLimit, SecondBest + 1);
+				ChildDisproofLimit = std::min(Infinite, DisproofLimit - Node.Disproof + Child.Disproof);
+			}
+			else
+			{
+				ChildProofLimit = std::min(Infinite, ProofLimit - Node.Proof + Child.Proof);
+				ChildDisproofLimit = std::min(DisproofLimit, SecondBest + 1);
+			}
+
+			Pos.MakeMove(Moves.Moves[Best]);
+			Search(Pos, Ply + 1, Remaining - 1, ChildProofLimit, ChildDisproofLimit, Child);
+			Pos.UnmakeMove(Moves.Moves[Best]);
+		}
+
+		// A disproof that rests on a repetition or the ply horizon only holds on this path
+		if (!Out.bPathDependent)
+		{
+			Store(Key, Out, Nodes - StartNodes + 1);
+		}
+	}
+
+	// Follows the proven children: the attacker's quickest mate and the
+	// defender's longest resistance
+	void MateSolver::ExtractLine(Position Pos, int Remaining, List<Move>& OutLine) const
+	{
+		for (int Ply = 0; Ply < MaxSolvePly; ++Ply)
+		{
+			MoveList Moves;
+			GenerateLegalMoves(Pos, Moves);
+
+			const bool bOrNode = Pos.GetSideToMove() == Attacker;
+			Move Chosen = NullMove;
+			int ChosenDistance = bOrNode ? MaxSolvePly + 1 : -1;
+			for (Move Candidate : Moves)
+			{
+				Pos.MakeMove(Candidate);
+				Numbers Child;
+				const bool bFound = Lookup(KeyFor(Pos, Remaining - 1), Child) && Child.Proof == 0;
+				Pos.UnmakeMove(Candidate);
+
+				if (bFound && (bOrNode ? Child.Distance < ChosenDistance : Child.Distance > ChosenDistance))
+				{
+					Chosen = Candidate;
+					ChosenDistance = Child.Distance;
+				}
+			}
+			if (Chosen.IsNull()) { return; }
+
+			OutLine.push_back(Chosen);
+			Pos.MakeMove(Chosen);
+			--Remaining;
+		}
+	}
+}
@@ -0,0 +1,739 @@
+#include "Engine/Mcts.h"
+#include "Rules/MoveGen.h"
+#include <cmath>
+#include <new>
+
+namespace we
+{
+	namespace
+	{
+		constexpr std::int64_t ValueScale = 1 << 16;		// Fixed point of MctsNode::ValueSum
+		constexpr float Cpuct = 1.5f;
+		constexpr float FpuReduction = 0.25f;				// Unvisited children start this far below their parent
+		constexpr float ValueCentipawns = 400.0f;			// Value = tanh(score / ValueCentipawns)
+		constexpr float PriorCentipawns = 150.0f;			// Softmax temperature of the move priors
+		constexpr int PriorPieceValues[PieceTypeCount] = { 0, 100, 320, 330, 500, 900, 0 };
+		constexpr int CheckBonus = 150;
+		constexpr int MaxBatchSize = 64;
+		constexpr std::int64_t ReportIntervalMs = 1000;
+
+		float ScoreToValue(int Score) { return std::tanh(float(Score) / ValueCentipawns); }
+		int ValueToScore(float Value) { return int(std::atanh(std::clamp(Value, -0.999f, 0.999f)) * ValueCentipawns); }
+
+		float AverageValue(const MctsNode& Node)
+		{
+			const std::int32_t Visits = Node.Visits.load(std::memory_order_relaxed);
+			return Visits > 0 ? float(double(Node.ValueSum.load(std::memory_order_relaxed)) / (double(Visits) * ValueScale)) : 0.0f;
+		}
+
+		// Stands in for a policy network: a softmax over the material each move
+		// wins, saves or leaves where the opponent attacks it, with a bonus for
+		// checks. Mates in one are found on the way and marked in OutMates.
+		void ComputePriors(Position& Pos, const MoveList& Moves, float* OutPriors, bool* OutMates)
+		{
+			const EColor Us = Pos.GetSideToMove();
+			const EColor Them = ~Us;
+			float MaxLogit = -1e9f;
+			for (int i = 0; i < Moves.Size(); ++i)
+			{
+				const Move Candidate = Moves.Moves[i];
+				const int Moving = PriorPieceValues[TypeOf(Pos.PieceOn(Candidate.From()))];
+				int Gain = 0;
+				if (Candidate.IsCapture())
+				{
+					Gain += Candidate.Flag() == EnPassantCapture ? PriorPieceValues[Pawn] : PriorPieceValues[TypeOf(Pos.PieceOn(Candidate.To()))];
+				}
+				if (Candidate.IsPromotion())
+				{
+					Gain += PriorPieceValues[Candidate.PromotionType()] - PriorPieceValues[Pawn];
+				}
+
+				// A defended square only risks the difference to a cheaper attacker, roughly
+				const bool bThreatened = Pos.IsSquareAttacked(Candidate.From(), Them);
+				if (Pos.IsSquareAttacked(Candidate.To(), Them))
+				{
+					const bool bDefended = (Pos.AttackersTo(Candidate.To(), Pos.Pieces() ^ SquareBB(Candidate.From())) & Pos.Pieces(Us)) != 0;
+					Gain -= bDefended ? Moving / 2 : Moving;
+				}
+				else if (bThreatened)
+				{
+					Gain += Moving / 2;
+				}
+
+				Pos.MakeMove(Candidate);
+				OutMates[i] = false;
+				if (Pos.IsInCheck())
+				{
+					MoveList Replies;
+					GenerateLegalMoves(Pos, Replies);
+					OutMates[i] = Replies.Size() == 0;
+					Gain += OutMates[i] ? 10000 : CheckBonus;
+				}
+				Pos.UnmakeMove(Candidate);
+
+				OutPriors[i] = float(Gain) / PriorCentipawns;
+				MaxLogit = std::max(MaxLogit, OutPriors[i]);
+			}
+
+			float Sum = 0.0f;
+			for (int i = 0; i < Moves.Size(); ++i)
+			{
+				OutPriors[i] = std::exp(OutPriors[i] - MaxLogit);
+				Sum += OutPriors[i];
+			}
+			for (int i = 0; i < Moves.Size(); ++i)
+			{
+				OutPriors[i] /= Sum;
+			}
+		}
+
+		void CopyNode(const MctsNode& From, MctsNode& To)
+		{
+			To.LastMove = From.LastMove;
+			To.ChildCount = From.ChildCount;
+			To.State.store(From.State.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			To.TerminalValue = From.TerminalValue;
+			To.Prior = From.Prior;
+			To.Visits.store(From.Visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			To.ValueSum.store(From.ValueSum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+	}
+
+	// One selected playout waiting for its score
+	struct MctsEngine::Leaf
+	{
+		std::uint32_t Path[MaxPly];
+		int Length = 0;
+		float Value = 0.0f;						// From the side that played into the leaf
+		bool bPending = false;					// Scored with the rest of the batch
+		EColor SideToMove = White;
+		Nnue::Accumulator Acc;
+	};
+
+	// ----------------------------------------------------
+	// Node Arena
+	// ----------------------------------------------------
+	MctsArena::MctsArena()
+		: Nodes{}
+		, Capacity{ 0 }
+		, Used{ 0 }
+	{
+	}
+
+	void MctsArena::Resize(std::size_t MegaBytes)
+	{
+		const std::size_t Count = std::min<std::size_t>(MegaBytes * 1024 * 1024 / sizeof(MctsNode), InvalidNode - 1);
+		Nodes = Count ? std::make_unique<MctsNode[]>(Count) : nullptr;
+		Capacity = std::uint32_t(Count);
+		Clear();
+	}
+
+	std::uint32_t MctsArena::Allocate(std::uint32_t Count)
+	{
+		// Checked first so a full arena's counter stops growing
+		if (Used.load(std::memory_order_relaxed) >= Capacity) { return InvalidNode; }
+
+		const std::uint32_t First = Used.fetch_add(Count, std::memory_order_relaxed);
+		if (First >= Capacity || Capacity - First < Count) { return InvalidNode; }
+
+		for (std::uint32_t i = 0; i < Count; ++i)
+		{
+			new (&Nodes[First + i]) MctsNode{};
+		}
+		return First;
+	}
+
+	// ----------------------------------------------------
+	// PUCT Search
+	// ----------------------------------------------------
+	MctsEngine::MctsEngine()
+		: Arenas{}
+		, ActiveArena{ 0 }
+		, Root{ MctsArena::InvalidNode }
+		, RootPos{}
+		, bHasTree{ false }
+		, TreeMegaBytes{ 64 }
+		, ThreadCount{ 1 }
+		, BatchSize{ 8 }
+		, Network{ nullptr }
+		, MainThread{}
+		, bStopRequested{ false }
+		, bSearching{ false }
+		, bPondering{ false }
+		, Playouts{ 0 }
+		, TotalDepth{ 0 }
+		, MaxDepth{ 0 }
+		, ActiveLimits{}
+		, Timer{}
+		, NextReportMs{ 0 }
+		, LastResult{}
+		, LastStats{}
+	{
+	}
+
+	MctsEngine::~MctsEngine()
+	{
+		Stop();
+		Wait();
+	}
+
+	void MctsEngine::SetTreeSize(std::size_t MegaBytes)
+	{
+		Wait();
+		TreeMegaBytes = std::max<std::size_t>(MegaBytes, 1);
+		Arenas[0].Resize(0);
+		Arenas[1].Resize(0);
+		bHasTree = false;
+	}
+
+	void MctsEngine::SetThreadCount(int Count)
+	{
+		Wait();
+		ThreadCount = std::max(Count, 1);
+	}
+
+	void MctsEngine::SetBatchSize(int Size)
+	{
+		Wait();
+		BatchSize = std::clamp(Size, 1, MaxBatchSize);
+	}
+
+	void MctsEngine::NewGame()
+	{
+		Wait();
+		bHasTree = false;
+	}
+
+	void MctsEngine::Start(const Position& Pos, const SearchLimits& Limits)
+	{
+		Stop();
+		Wait();
+
+		// The arenas are only allocated once a search needs them
+		if (Arenas[0].GetCapacity() == 0)
+		{
+			Arenas[0].Resize(TreeMegaBytes);
+			Arenas[1].Resize(TreeMegaBytes);
+		}
+
+		bStopRequested = false;
+		bSearching = true;
+		bPondering = Limits.bPonder;
+		ActiveLimits = Limits;
+		Timer.Init(Limits, Pos.GetSideToMove());
+		NextReportMs = ReportIntervalMs;
+		Playouts = 0;
+		TotalDepth = 0;
+		MaxDepth = 0;
+
+		ReuseTree(Pos);
+		MainThread = std::thread(&MctsEngine::RunSearch, this);
+	}
+
+	// The clock has been running since Start(), so a long ponder can leave
+	// nothing to do but report the move already found
+	void MctsEngine::PonderHit()
+	{
+		if (!bPondering) { return; }
+
+		if (Timer.IsSoftLimitReached())
+		{
+			bStopRequested = true;
+		}
+		bPondering = false;
+	}
+
+	void MctsEngine::Wait()
+	{
+		if (MainThread.joinable())
+		{
+			MainThread.join();
+		}
+	}
+
+	SearchResult MctsEngine::Think(const Position& Pos, const SearchLimits& Limits)
+	{
+		Start(Pos, Limits);
+		Wait();
+		return LastResult;
+	}
+
+	SearchStats MctsEngine::GetStatistics() const
+	{
+		if (!bSearching) { return LastStats; }
+
+		SearchStats Stats;
+		Stats.Threads = ThreadCount;
+		Stats.TimeMs = Timer.GetElapsedMs();
+		Stats.Nodes = Playouts.load(std::memory_order_relaxed);
+		return Stats;
+	}
+
+	void MctsEngine::RunSearch()
+	{
+		// The root is expanded up front so a mate or stalemate needs no threads
+		MctsNode& RootNode = Tree()[Root];
+		if (RootNode.State.load(std::memory_order_relaxed) == MctsNode::Unexpanded)
+		{
+			Position Pos = RootPos;
+			RootNode.State.store(MctsNode::Expanding, std::memory_order_relaxed);
+			Expand(Pos, RootNode, 0);
+		}
+
+		if (RootNode.State.load(std::memory_order_acquire) == MctsNode::Expanded)
+		{
+			List<std::thread> Helpers;
+			for (int i = 1; i < ThreadCount; ++i)
+			{
+				Helpers.emplace_back(&MctsEngine::RunWorker, this, i);
+			}
+			RunWorker(0);
+			bStopRequested = true;
+			for (std::thread& Helper : Helpers)
+			{
+				Helper.join();
+			}
+		}
+		else
+		{
+			// A mated or stalemated root is only reported once the ponder ends
+			while (bPondering && !bStopRequested)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		ReportLines();
+
+		SearchResult Result;
+		const std::uint32_t Best = BestChild(Root);
+		if (Best != MctsArena::InvalidNode)
+		{
+			const List<Move> Reply = GetPv(Best);
+			Result.BestMove = Tree()[Best].LastMove;
+			Result.PonderMove = Reply.empty() ? NullMove : Reply[0];
+			Result.Score = ValueToScore(AverageValue(Tree()[Best]));
+		}
+		Result.Nodes = Playouts;
+		Result.Depth = Result.Nodes ? int(TotalDepth / Result.Nodes) : 0;
+
+		LastStats = GetStatistics();
+		LastResult = Result;
+		bSearching = false;
+		if (OnBestMove)
+		{
+			OnBestMove(Result);
+		}
+	}
+
+	void MctsEngine::RunWorker(int Index)
+	{
+		Position Pos = RootPos;
+		Evaluator Eval;
+		Eval.SetNetwork(Network);
+
+		List<Leaf> Batch(BatchSize);
+		const Nnue::Accumulator* PendingAccs[MaxBatchSize];
+		EColor PendingSides[MaxBatchSize];
+		int PendingScores[MaxBatchSize];
+
+		while (!bStopRequested.load(std::memory_order_relaxed))
+		{
+			// Virtual loss steers each selection away from the ones before it;
+			// a selection that runs into a node being expanded is dropped
+			int Count = 0;
+			int Pending = 0;
+			for (int Attempt = 0; Attempt < BatchSize; ++Attempt)
+			{
+				Leaf& Next = Batch[Count];
+				if (!SelectLeaf(Pos, Eval, Next)) { continue; }
+
+				if (Next.bPending)
+				{
+					PendingAccs[Pending] = &Next.Acc;
+					PendingSides[Pending] = Next.SideToMove;
+					++Pending;
+				}
+				++Count;
+			}
+
+			if (Pending > 0)
+			{
+				Eval.GetNetwork()->PropagateBatch(PendingAccs, PendingSides, Pending, PendingScores);
+			}
+
+			for (int i = 0, Slot = 0; i < Count; ++i)
+			{
+				Backup(Batch[i], Batch[i].bPending ? -ScoreToValue(PendingScores[Slot++]) : Batch[i].Value);
+			}
+
+			if (Count == 0)
+			{
+				std::this_thread::yield();
+			}
+			if (Index == 0)
+			{
+				CheckLimits();
+			}
+		}
+	}
+
+	bool MctsEngine::SelectLeaf(Position& Pos, Evaluator& Eval, Leaf& OutLeaf)
+	{
+		MctsArena& Nodes = Tree();
+		OutLeaf.Length = 0;
+		OutLeaf.bPending = false;
+
+		std::uint32_t Current = Root;
+		bool bCollided = false;
+		for (;;)
+		{
+			MctsNode& Node = Nodes[Current];
+			Node.Visits.fetch_add(1, std::memory_order_relaxed);
+			Node.ValueSum.fetch_sub(ValueScale, std::memory_order_relaxed);
+			OutLeaf.Path[OutLeaf.Length++] = Current;
+
+			std::uint8_t State = Node.State.load(std::memory_order_acquire);
+			if (State == MctsNode::Unexpanded && OutLeaf.Length < MaxPly
+				&& Node.State.compare_exchange_strong(State, MctsNode::Expanding, std::memory_order_acq_rel))
+			{
+				// This playout scores the new leaf itself, even though its children now exist
+				Expand(Pos, Node, OutLeaf.Length - 1);
+				State = Node.State.load(std::memory_order_relaxed) == MctsNode::Terminal ? MctsNode::Terminal : MctsNode::Unexpanded;
+			}
+
+			if (State == MctsNode::Expanding)
+			{
+				bCollided = true;
+				break;
+			}
+			if (State == MctsNode::Terminal)
+			{
+				OutLeaf.Value = float(Node.TerminalValue);
+				break;
+			}
+			if (State != MctsNode::Expanded || OutLeaf.Length == MaxPly)
+			{
+				// A fresh leaf, or the ply limit: score the position itself
+				if (Eval.IsUsingNetwork())
+				{
+					OutLeaf.Acc = Eval.GetAccumulator(Pos);
+					OutLeaf.SideToMove = Pos.GetSideToMove();
+					OutLeaf.bPending = true;
+				}
+				else
+				{
+					OutLeaf.Value = -ScoreToValue(Eval.Evaluate(Pos));
+				}
+				break;
+			}
+
+			Current = SelectChild(Node);
+			Pos.MakeMove(Nodes[Current].LastMove);
+		}
+
+		for (int i = OutLeaf.Length - 1; i > 0; --i)
+		{
+			Pos.UnmakeMove(Nodes[OutLeaf.Path[i]].LastMove);
+		}
+
+		if (bCollided)
+		{
+			CancelPlayout(OutLeaf.Path, OutLeaf.Length);
+			return false;
+		}
+
+		const int Depth = OutLeaf.Length - 1;
+		TotalDepth.fetch_add(std::uint64_t(Depth), std::memory_order_relaxed);
+		int Deepest = MaxDepth.load(std::memory_order_relaxed);
+		while (Depth > Deepest && !MaxDepth.compare_exchange_weak(Deepest, Depth, std::memory_order_relaxed))
+		{
+		}
+		return true;
+	}
+
+	// Called by the thread that moved Node to Expanding
+	void MctsEngine::Expand(Position& Pos, MctsNode& Node, int Ply)
+	{
+		if (Ply > 0 && (Pos.IsFiftyMoveDraw() || Pos.IsInsufficientMaterial() || Pos.IsRepetition(Ply)))
+		{
+			Node.TerminalValue = 0;
+			Node.State.store(MctsNode::Terminal, std::memory_order_release);
+			return;
+		}
+
+		MoveList Moves;
+		GenerateLegalMoves(Pos, Moves);
+		if (Moves.Size() == 0)
+		{
+			// Good for whoever played into a mate
+			Node.TerminalValue = Pos.IsInCheck() ? 1 : 0;
+			Node.State.store(MctsNode::Terminal, std::memory_order_release);
+			return;
+		}
+
+		// Once the arena is full the tree stops growing; playouts still refine it
+		const std::uint32_t First = Tree().Allocate(std::uint32_t(Moves.Size()));
+		if (First == MctsArena::InvalidNode)
+		{
+			Node.State.store(MctsNode::Unexpanded, std::memory_order_release);
+			return;
+		}
+
+		float Priors[MaxMoves];
+		bool bMates[MaxMoves];
+		ComputePriors(Pos, Moves, Priors, bMates);
+		for (int i = 0; i < Moves.Size(); ++i)
+		{
+			MctsNode& Child = Tree()[First + std::uint32_t(i)];
+			Child.LastMove = Moves.Moves[i];
+			Child.Prior = Priors[i];
+			if (bMates[i])
+			{
+				Child.TerminalValue = 1;
+				Child.State.store(MctsNode::Terminal, std::memory_order_relaxed);
+			}
+		}
+
+		Node.FirstChild = First;
+		Node.ChildCount = std::uint16_t(Moves.Size());
+		Node.State.store(MctsNode::Expanded, std::memory_order_release);
+	}
+
+	std::uint32_t MctsEngine::SelectChild(const MctsNode& Node) const
+	{
+		const MctsArena& Nodes = Tree();
+		const float SqrtVisits = std::sqrt(float(std::max(Node.Visits.load(std::memory_order_relaxed), 1)));
+
+		// The parent's value is seen from the other side, hence the sign
+		const float FirstPlayValue = -AverageValue(Node) - FpuReduction;
+
+		std::uint32_t Best = Node.FirstChild;
+		float BestScore = -1e9f;
+		for (std::uint32_t i = Node.FirstChild; i < Node.FirstChild + Node.ChildCount; ++i)
+		{
+			const MctsNode& Child = Nodes[i];
+			const std::int32_t Visits = Child.Visits.load(std::memory_order_relaxed);
+			const float Value = Visits > 0 ? AverageValue(Child) : FirstPlayValue;
+			const float Score = Value + Cpuct * Child.Prior * SqrtVisits / float(1 + Visits);
+			if (Score > BestScore)
+			{
+				BestScore = Score;
+				Best = i;
+			}
+		}
+		return Best;
+	}
+
+	// Replaces the virtual loss of every node on the path with the real value
+	void MctsEngine::Backup(const Leaf& Played, float Value)
+	{
+		MctsArena& Nodes = Tree();
+		for (int i = Played.Length - 1; i >= 0; --i)
+		{
+			Nodes[Played.Path[i]].ValueSum.fetch_add(std::llround((Value + 1.0f) * ValueScale), std::memory_order_relaxed);
+			Value = -Value;
+		}
+		Playouts.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void MctsEngine::CancelPlayout(const std::uint32_t* Path, int Length)
+	{
+		MctsArena& Nodes = Tree();
+		for (int i = 0; i < Length; ++i)
+		{
+			Nodes[Path[i]].Visits.fetch_sub(1, std::memory_order_relaxed);
+			Nodes[Path[i]].ValueSum.fetch_add(ValueScale, std::memory_order_relaxed);
+		}
+	}
+
+	// ----------------------------------------------------
+	// Tree Reuse
+	// ----------------------------------------------------
+	void MctsEngine::ReuseTree(const Position& Pos)
+	{
+		std::uint32_t Found = MctsArena::InvalidNode;
+		if (bHasTree)
+		{
+			const MctsArena& Nodes = Tree();
+			auto Matches = [&](std::uint32_t Node)
+			{
+				return Nodes[Node].State.load(std::memory_order_relaxed) != MctsNode::Terminal && RootPos.GetKey() == Pos.GetKey();
+			};
+
+			// The new root is usually our last move and the reply to it
+			if (Matches(Root)) { Found = Root; }
+			const MctsNode& OldRoot = Nodes[Root];
+			for (std::uint32_t i = 0; Found == MctsArena::InvalidNode && OldRoot.State.load(std::memory_order_relaxed) == MctsNode::Expanded && i < OldRoot.ChildCount; ++i)
+			{
+				const std::uint32_t Child = OldRoot.FirstChild + i;
+				RootPos.MakeMove(Nodes[Child].LastMove);
+				if (Matches(Child)) { Found = Child; }
+
+				const MctsNode& ChildNode = Nodes[Child];
+				for (std::uint32_t j = 0; Found == MctsArena::InvalidNode && ChildNode.State.load(std::memory_order_relaxed) == MctsNode::Expanded && j < ChildNode.ChildCount; ++j)
+				{
+					const std::uint32_t GrandChild = ChildNode.FirstChild + j;
+					RootPos.MakeMove(Nodes[GrandChild].LastMove);
+					if (Matches(GrandChild)) { Found = GrandChild; }
+					RootPos.UnmakeMove(Nodes[GrandChild].LastMove);
+				}
+				RootPos.UnmakeMove(Nodes[Child].LastMove);
+			}
+		}
+
+		if (Found == MctsArena::InvalidNode)
+		{
+			Tree().Clear();
+			Root = Tree().Allocate(1);
+		}
+		else if (Found != Root)
+		{
+			CopySubtree(Found);
+		}
+
+		RootPos = Pos;
+		bHasTree = true;
+	}
+
+	// Breadth first, so every copied block of children stays contiguous
+	void MctsEngine::CopySubtree(std::uint32_t From)
+	{
+		const MctsArena& Source = Tree();
+		MctsArena& Target = Arenas[ActiveArena ^ 1];
+		Target.Clear();
+
+		const std::uint32_t NewRoot = Target.Allocate(1);
+		CopyNode(Source[From], Target[NewRoot]);
+
+		List<std::pair<std::uint32_t, std::uint32_t>> Pending{ { From, NewRoot } };
+		for (std::size_t i = 0; i < Pending.size(); ++i)
+		{
+			const MctsNode& Original = Source[Pending[i].first];
+			MctsNode& Copy = Target[Pending[i].second];
+			if (Original.State.load(std::memory_order_relaxed) != MctsNode::Expanded) { continue; }
+
+			const std::uint32_t First = Target.Allocate(Original.ChildCount);
+			if (First == MctsArena::InvalidNode)
+			{
+				Copy.State.store(MctsNode::Unexpanded, std::memory_order_relaxed);
+				Copy.ChildCount = 0;
+				continue;
+			}
+
+			Copy.FirstChild = First;
+			for (std::uint32_t c = 0; c < Original.ChildCount; ++c)
+			{
+				CopyNode(Source[Original.FirstChild + c], Target[First + c]);
+				Pending.emplace_back(Original.FirstChild + c, First + c);
+			}
+		}
+
+		ActiveArena ^= 1;
+		Root = NewRoot;
+	}
+
+	// ----------------------------------------------------
+	// Limits and Reporting
+	// ----------------------------------------------------
+	// Main worker only, with the root expanded. A depth limit applies to the
+	// average playout depth. Playouts are short, so the search runs up to the
+	// soft limit rather than stopping between iterations like the Engine; while
+	// pondering nothing stops it but a ponderhit or stop.
+	void MctsEngine::CheckLimits()
+	{
+		const std::int64_t Elapsed = Timer.GetElapsedMs();
+		const std::uint64_t Done = Playouts.load(std::memory_order_relaxed);
+		// A mate in one at the root leaves nothing to search
+		const std::uint32_t Best = BestChild(Root);
+		const bool bProven = Tree()[Best].State.load(std::memory_order_relaxed) == MctsNode::Terminal && Tree()[Best].TerminalValue > 0;
+
+		const bool bLimitReached = bProven
+			|| (ActiveLimits.Nodes && Done >= ActiveLimits.Nodes)
+			|| (ActiveLimits.Depth && Done && TotalDepth.load(std::memory_order_relaxed) / Done >= std::uint64_t(ActiveLimits.Depth))
+			|| Timer.IsSoftLimitReached();
+		if (bLimitReached && !bPondering.load(std::memory_order_relaxed))
+		{
+			bStopRequested = true;
+		}
+
+		if (Elapsed >= NextReportMs)
+		{
+			ReportLines();
+			NextReportMs = Elapsed + ReportIntervalMs;
+		}
+	}
+
+	void MctsEngine::ReportLines()
+	{
+		const MctsNode& RootNode = Tree()[Root];
+		if (!OnInfo || RootNode.State.load(std::memory_order_acquire) != MctsNode::Expanded) { return; }
+
+		// Most visited first, as the best move is chosen
+		List<std::uint32_t> Children;
+		for (std::uint32_t i = 0; i < RootNode.ChildCount; ++i)
+		{
+			Children.push_back(RootNode.FirstChild + i);
+		}
+		const MctsArena& Nodes = Tree();
+		std::stable_sort(Children.begin(), Children.end(), [&Nodes](std::uint32_t A, std::uint32_t B)
+		{
+			return Nodes[A].Visits.load(std::memory_order_relaxed) > Nodes[B].Visits.load(std::memory_order_relaxed);
+		});
+
+		const std::uint64_t Done = Playouts.load(std::memory_order_relaxed);
+		const SearchStats Stats = GetStatistics();
+		const int Lines = std::min<int>(std::max(ActiveLimits.MultiPv, 1), int(Children.size()));
+		for (int Line = 0; Line < Lines; ++Line)
+		{
+			const MctsNode& Child = Nodes[Children[Line]];
+			if (Child.Visits.load(std::memory_order_relaxed) == 0) { break; }
+
+			SearchInfo Info;
+			Info.MultiPv = Line + 1;
+			Info.Depth = Done ? int(TotalDepth.load(std::memory_order_relaxed) / Done) : 0;
+			Info.SelDepth = MaxDepth.load(std::memory_order_relaxed);
+			Info.Score = ValueToScore(AverageValue(Child));
+			Info.Nodes = Done;
+			Info.TimeMs = Stats.TimeMs;
+			Info.Hashfull = Nodes.GetCapacity() ? int(std::uint64_t(Nodes.GetUsed()) * 1000 / Nodes.GetCapacity()) : 0;
+			Info.Stats = Stats;
+			Info.Pv.push_back(Child.LastMove);
+			for (Move Next : GetPv(Children[Line]))
+			{
+				Info.Pv.push_back(Next);
+			}
+			OnInfo(Info);
+		}
+	}
+
+	// Most visits wins; the value breaks ties
+	std::uint32_t MctsEngine::BestChild(std::uint32_t Node) const
+	{
+		const MctsNode& Parent = Tree()[Node];
+		if (Parent.State.load(std::memory_order_acquire) != MctsNode::Expanded) { return MctsArena::InvalidNode; }
+
+		std::uint32_t Best = Parent.FirstChild;
+		for (std::uint32_t i = Parent.FirstChild + 1; i < Parent.FirstChild + Parent.ChildCount; ++i)
+		{
+			const std::int32_t Visits = Tree()[i].Visits.load(std::memory_order_relaxed);
+			const std::int32_t BestVisits = Tree()[Best].Visits.load(std::memory_order_relaxed);
+			if (Visits > BestVisits || (Visits == BestVisits && AverageValue(Tree()[i]) > AverageValue(Tree()[Best])))
+			{
+				Best = i;
+			}
+		}
+		return Best;
+	}
+
+	List<Move> MctsEngine::GetPv(std::uint32_t Node) const
+	{
+		List<Move> Pv;
+		for (std::uint32_t Next = BestChild(Node); Next != MctsArena::InvalidNode && int(Pv.size()) < MaxPly; Next = BestChild(Next))
+		{
+			if (Tree()[Next].Visits.load(std::memory_order_relaxed) == 0) { break; }
+			Pv.push_back(Tree()[Next].LastMove);
+		}
+		return Pv;
+	}
+}
@@ -0,0 +1,373 @@
+#include "Engine/Nnue.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(CHESS_USE_AVX2)
+#include <immintrin.h>
+#elif defined(CHESS_USE_SSE41)
+#include <smmintrin.h>
+#endif
+
+namespace we
+{
+	namespace Nnue
+	{
+		namespace
+		{
+			struct FileHeader
+			{
+				char Magic[4];
+				std::uint32_t Version;
+				std::uint32_t InputSize;
+				std::uint32_t HiddenSize;
+				std::uint32_t Layer1Size;
+				std::uint32_t Layer2Size;
+				std::uint8_t Reserved[40];
+			};
+			static_assert(sizeof(FileHeader) == 64, "Network header must stay 64 bytes");
+
+			constexpr char Magic[4] = { 'W', 'E', 'N', 'N' };
+
+			// ----------------------------------------------------
+			// Vector Kernels
+			// ----------------------------------------------------
+			void AddRow(std::int16_t* Acc, const std::int16_t* Row)
+			{
+#if defined(CHESS_USE_AVX2)
+				for (int i = 0; i < HiddenSize; i += 16)
+				{
+					__m256i Sum = _mm256_add_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(Acc + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Row + i)));
+					_mm256_store_si256(reinterpret_cast<__m256i*>(Acc + i), Sum);
+				}
+#elif defined(CHESS_USE_SSE41)
+				for (int i = 0; i < HiddenSize; i += 8)
+				{
+					__m128i Sum = _mm_add_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(Acc + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(Row + i)));
+					_mm_store_si128(reinterpret_cast<__m128i*>(Acc + i), Sum);
+				}
+#else
+				for (int i = 0; i < HiddenSize; ++i) { Acc[i] += Row[i]; }
+#endif
+			}
+
+			void SubtractRow(std::int16_t* Acc, const std::int16_t* Row)
+			{
+#if defined(CHESS_USE_AVX2)
+				for (int i = 0; i < HiddenSize; i += 16)
+				{
+					__m256i Diff = _mm256_sub_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(Acc + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Row + i)));
+					_mm256_store_si256(reinterpret_cast<__m256i*>(Acc + i), Diff);
+				}
+#elif defined(CHESS_USE_SSE41)
+				for (int i = 0; i < HiddenSize; i += 8)
+				{
+					__m128i Diff = _mm_sub_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(Acc + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(Row + i)));
+					_mm_store_si128(reinterpret_cast<__m128i*>(Acc + i), Diff);
+				}
+#else
+				for (int i = 0; i < HiddenSize; ++i) { Acc[i] -= Row[i]; }
+#endif
+			}
+
+			// Clipped ReLU of one accumulator half into [0, ActivationMax] bytes
+			void ClipToBytes(const std::int16_t* In, std::uint8_t* Out)
+			{
+#if defined(CHESS_USE_AVX2)
+				const __m256i Zero = _mm256_setzero_si256();
+				for (int i = 0; i < HiddenSize; i += 32)
+				{
+					__m256i Low = _mm256_load_si256(reinterpret_cast<const __m256i*>(In + i));
+					__m256i High = _mm256_load_si256(reinterpret_cast<const __m256i*>(In + i + 16));
+					__m256i Packed = _mm256_max_epi8(_mm256_packs_epi16(Low, High), Zero);
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(Out + i), _mm256_permute4x64_epi64(Packed, 0xD8));
+				}
+#elif defined(CHESS_USE_SSE41)
+				const __m128i Zero = _mm_setzero_si128();
+				for (int i = 0; i < HiddenSize; i += 16)
+				{
+					__m128i Low = _mm_load_si128(reinterpret_cast<const __m128i*>(In + i));
+					__m128i High = _mm_load_si128(reinterpret_cast<const __m128i*>(In + i + 8));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(Out + i), _mm_max_epi8(_mm_packs_epi16(Low, High), Zero));
+				}
+#else
+				for (int i = 0; i < HiddenSize; ++i)
+				{
+					Out[i] = std::uint8_t(std::clamp<int>(In[i], 0, ActivationMax));
+				}
+#endif
+			}
+
+			// Dot product of unsigned activations with signed weights; Size is a multiple of 32
+			std::int32_t DotProduct(const std::uint8_t* In, const std::int8_t* Weights, int Size)
+			{
+#if defined(CHESS_USE_AVX2)
+				const __m256i Ones = _mm256_set1_epi16(1);
+				__m256i Sum = _mm256_setzero_si256();
+				for (int i = 0; i < Size; i += 32)
+				{
+					__m256i Products = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(In + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Weights + i)));
+					Sum = _mm256_add_epi32(Sum, _mm256_madd_epi16(Products, Ones));
+				}
+				__m128i Folded = _mm_add_epi32(_mm256_castsi256_si128(Sum), _mm256_extracti128_si256(Sum, 1));
+				Folded = _mm_add_epi32(Folded, _mm_shuffle_epi32(Folded, 0x4E));
+				Folded = _mm_add_epi32(Folded, _mm_shuffle_epi32(Folded, 0xB1));
+				return _mm_cvtsi128_si32(Folded);
+#elif defined(CHESS_USE_SSE41)
+				const __m128i Ones = _mm_set1_epi16(1);
+				__m128i Sum = _mm_setzero_si128();
+				for (int i = 0; i < Size; i += 16)
+				{
+					__m128i Products = _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(In + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(Weights + i)));
+					Sum = _mm_add_epi32(Sum, _mm_madd_epi16(Products, Ones));
+				}
+				Sum = _mm_add_epi32(Sum, _mm_shuffle_epi32(Sum, 0x4E));
+				Sum = _mm_add_epi32(Sum, _mm_shuffle_epi32(Sum, 0xB1));
+				return _mm_cvtsi128_si32(Sum);
+#else
+				std::int32_t Sum = 0;
+				for (int i = 0; i < Size; ++i)
+				{
+					Sum += std::int32_t(In[i]) * Weights[i];
+				}
+				return Sum;
+#endif
+			}
+
+			void DenseLayer(const std::uint8_t* In, int InSize, const std::int8_t* Weights, const std::int32_t* Biases, int OutSize, std::uint8_t* Out)
+			{
+				for (int Neuron = 0; Neuron < OutSize; ++Neuron)
+				{
+					const std::int32_t Sum = Biases[Neuron] + DotProduct(In, Weights + Neuron * InSize, InSize);
+					Out[Neuron] = std::uint8_t(std::clamp(Sum >> WeightShift, 0, ActivationMax));
+				}
+			}
+
+			// DenseLayer() for Count inputs laid out back to back; the batch is the
+			// inner loop so each weight row is loaded once
+			void DenseLayerBatch(const std::uint8_t* In, int InSize, const std::int8_t* Weights, const std::int32_t* Biases, int OutSize, std::uint8_t* Out, int Count)
+			{
+				for (int Neuron = 0; Neuron < OutSize; ++Neuron)
+				{
+					const std::int8_t* Row = Weights + Neuron * InSize;
+					for (int i = 0; i < Count; ++i)
+					{
+						const std::int32_t Sum = Biases[Neuron] + DotProduct(In + i * InSize, Row, InSize);
+						Out[i * OutSize + Neuron] = std::uint8_t(std::clamp(Sum >> WeightShift, 0, ActivationMax));
+					}
+				}
+			}
+
+			template<typename T>
+			const T* TakeArray(const std::uint8_t*& Cursor, std::size_t Count)
+			{
+				const T* Array = reinterpret_cast<const T*>(Cursor);
+				Cursor += Count * sizeof(T);
+				return Array;
+			}
+		}
+
+		int FeatureIndex(EColor Perspective, Square KingSq, EPiece Piece, Square Sq)
+		{
+			if (Perspective == Black)
+			{
+				KingSq = FlipRank(KingSq);
+				Sq = FlipRank(Sq);
+			}
+			const int PieceIndex = (TypeOf(Piece) - Pawn) * 2 + (ColorOf(Piece) != Perspective ? 1 : 0);
+			return KingSq * PieceSquareInputs + PieceIndex * 64 + Sq;
+		}
+
+		Network::Network()
+			: File{}
+			, FeatureBiases{ nullptr }
+			, FeatureWeights{ nullptr }
+			, Layer1Biases{ nullptr }
+			, Layer1Weights{ nullptr }
+			, Layer2Biases{ nullptr }
+			, Layer2Weights{ nullptr }
+			, OutputBias{ nullptr }
+			, OutputWeights{ nullptr }
+		{
+		}
+
+		std::size_t Network::GetFileSize()
+		{
+			return sizeof(FileHeader)
+				+ sizeof(std::int16_t) * HiddenSize
+				+ sizeof(std::int16_t) * std::size_t(InputSize) * HiddenSize
+				+ sizeof(std::int32_t) * Layer1Size
+				+ sizeof(std::int8_t) * Layer1Size * 2 * HiddenSize
+				+ sizeof(std::int32_t) * Layer2Size
+				+ sizeof(std::int8_t) * Layer2Size * Layer1Size
+				+ sizeof(std::int32_t)
+				+ sizeof(std::int8_t) * Layer2Size;
+		}
+
+		bool Network::LoadFromFile(const string& Path)
+		{
+			MappedFile NewFile;
+			if (!NewFile.Open(Path))
+			{
+				LOG("NNUE: could not map %s", Path.c_str());
+				return false;
+			}
+
+			if (!LoadFromMemory(NewFile.GetData(), NewFile.GetSize()))
+			{
+				LOG("NNUE: %s is not a compatible network", Path.c_str());
+				return false;
+			}
+
+			File = std::move(NewFile);
+			return true;
+		}
+
+		bool Network::LoadFromMemory(const void* Data, std::size_t Size)
+		{
+			if (!Data || Size != GetFileSize()) { return false; }
+
+			FileHeader Header;
+			std::memcpy(&Header, Data, sizeof(Header));
+			if (std::memcmp(Header.Magic, Magic, sizeof(Magic)) != 0
+				|| Header.Version != FileVersion
+				|| Header.InputSize != InputSize
+				|| Header.HiddenSize != HiddenSize
+				|| Header.Layer1Size != Layer1Size
+				|| Header.Layer2Size != Layer2Size)
+			{
+				return false;
+			}
+
+			const std::uint8_t* Cursor = static_cast<const std::uint8_t*>(Data) + sizeof(FileHeader);
+			FeatureBiases = TakeArray<std::int16_t>(Cursor, HiddenSize);
+			FeatureWeights = TakeArray<std::int16_t>(Cursor, std::size_t(InputSize) * HiddenSize);
+			Layer1Biases = TakeArray<std::int32_t>(Cursor, Layer1Size);
+			Layer1Weights = TakeArray<std::int8_t>(Cursor, Layer1Size * 2 * HiddenSize);
+			Layer2Biases = TakeArray<std::int32_t>(Cursor, Layer2Size);
+			Layer2Weights = TakeArray<std::int8_t>(Cursor, Layer2Size * Layer1Size);
+			OutputBias = TakeArray<std::int32_t>(Cursor, 1);
+			OutputWeights = TakeArray<std::int8_t>(Cursor, Layer2Size);
+			return true;
+		}
+
+		void Network::RefreshAccumulator(const Position& Pos, EColor Perspective, Accumulator& Acc) const
+		{
+			std::int16_t* Values = Acc.Values[Perspective];
+			std::memcpy(Values, FeatureBiases, sizeof(std::int16_t) * HiddenSize);
+
+			const Square KingSq = Pos.KingSquare(Perspective);
+			Bitboard Occupied = Pos.Pieces() & ~Pos.Pieces(King);
+			while (Occupied)
+			{
+				const Square Sq = PopLsb(Occupied);
+				AddRow(Values, FeatureWeights + std::size_t(FeatureIndex(Perspective, KingSq, Pos.PieceOn(Sq), Sq)) * HiddenSize);
+			}
+		}
+
+		void Network::UpdateAccumulator(const DirtyPieces& Dirty, Square KingSq, EColor Perspective, const Accumulator& From, Accumulator& To) const
+		{
+			std::int16_t* Values = To.Values[Perspective];
+			std::memcpy(Values, From.Values[Perspective], sizeof(std::int16_t) * HiddenSize);
+
+			for (int i = 0; i < Dirty.Count; ++i)
+			{
+				const EPiece Piece = Dirty.Piece[i];
+				if (TypeOf(Piece) == King) { continue; }
+
+				if (Dirty.From[i] != NoSquare)
+				{
+					SubtractRow(Values, FeatureWeights + std::size_t(FeatureIndex(Perspective, KingSq, Piece, Dirty.From[i])) * HiddenSize);
+				}
+				if (Dirty.To[i] != NoSquare)
+				{
+					AddRow(Values, FeatureWeights + std::size_t(FeatureIndex(Perspective, KingSq, Piece, Dirty.To[i])) * HiddenSize);
+				}
+			}
+		}
+
+		int Network::Propagate(const Accumulator& Acc, EColor SideToMove) const
+		{
+			alignas(64) std::uint8_t Input[2 * HiddenSize];
+			alignas(64) std::uint8_t Hidden1[Layer1Size];
+			alignas(64) std::uint8_t Hidden2[Layer2Size];
+
+			ClipToBytes(Acc.Values[SideToMove], Input);
+			ClipToBytes(Acc.Values[~SideToMove], Input + HiddenSize);
+
+			DenseLayer(Input, 2 * HiddenSize, Layer1Weights, Layer1Biases, Layer1Size, Hidden1);
+			DenseLayer(Hidden1, Layer1Size, Layer2Weights, Layer2Biases, Layer2Size, Hidden2);
+
+			return (*OutputBias + DotProduct(Hidden2, OutputWeights, Layer2Size)) / OutputScale;
+		}
+
+		void Network::PropagateBatch(const Accumulator* const* Accs, const EColor* SidesToMove, int Count, int* OutScores) const
+		{
+			constexpr int Chunk = 16;
+			alignas(64) std::uint8_t Input[Chunk][2 * HiddenSize];
+			alignas(64) std::uint8_t Hidden1[Chunk][Layer1Size];
+			alignas(64) std::uint8_t Hidden2[Chunk][Layer2Size];
+
+			for (int Base = 0; Base < Count; Base += Chunk)
+			{
+				const int Size = std::min(Chunk, Count - Base);
+				for (int i = 0; i < Size; ++i)
+				{
+					ClipToBytes(Accs[Base + i]->Values[SidesToMove[Base + i]], Input[i]);
+					ClipToBytes(Accs[Base + i]->Values[~SidesToMove[Base + i]], Input[i] + HiddenSize);
+				}
+
+				DenseLayerBatch(Input[0], 2 * HiddenSize, Layer1Weights, Layer1Biases, Layer1Size, Hidden1[0], Size);
+				DenseLayerBatch(Hidden1[0], Layer1Size, Layer2Weights, Layer2Biases, Layer2Size, Hidden2[0], Size);
+
+				for (int i = 0; i < Size; ++i)
+				{
+					OutScores[Base + i] = (*OutputBias + DotProduct(Hidden2[i], OutputWeights, Layer2Size)) / OutputScale;
+				}
+			}
+		}
+
+		List<std::uint8_t> Network::MakeRandomNetwork(std::uint64_t Seed)
+		{
+			auto NextRandom = [&Seed](int Range) -> int
+			{
+				Seed ^= Seed << 13;
+				Seed ^= Seed >> 7;
+				Seed ^= Seed << 17;
+				return int(Seed % std::uint64_t(2 * Range + 1)) - Range;
+			};
+
+			List<std::uint8_t> Data(GetFileSize(), 0);
+
+			FileHeader Header{};
+			std::memcpy(Header.Magic, Magic, sizeof(Magic));
+			Header.Version = FileVersion;
+			Header.InputSize = InputSize;
+			Header.HiddenSize = HiddenSize;
+			Header.Layer1Size = Layer1Size;
+			Header.Layer2Size = Layer2Size;
+			std::memcpy(Data.data(), &Header, sizeof(Header));
+
+			std::uint8_t* Cursor = Data.data() + sizeof(FileHeader);
+			auto Fill = [&Cursor, &NextRandom](auto Type, std::size_t Count, int Range)
+			{
+				using T = decltype(Type);
+				for (std::size_t i = 0; i < Count; ++i)
+				{
+					T Value = T(NextRandom(Range));
+					std::memcpy(Cursor, &Value, sizeof(T));
+					Cursor += sizeof(T);
+				}
+			};
+
+			Fill(std::int16_t{}, HiddenSize, 32);
+			Fill(std::int16_t{}, std::size_t(InputSize) * HiddenSize, 16);
+			Fill(std::int32_t{}, Layer1Size, 256);
+			Fill(std::int8_t{}, Layer1Size * 2 * HiddenSize, 16);
+			Fill(std::int32_t{}, Layer2Size, 256);
+			Fill(std::int8_t{}, Layer2Size * Layer1Size, 32);
+			Fill(std::int32_t{}, 1, 64);
+			Fill(std::int8_t{}, Layer2Size, 64);
+			return Data;
+		}
+	}
+}
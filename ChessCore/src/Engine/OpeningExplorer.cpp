@@ -0,0 +1,125 @@
+#include "Engine/OpeningExplorer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace we
+{
+	namespace
+	{
+		// Past this the range is small enough that halving is as quick
+		constexpr std::size_t InterpolationMinRange = 64;
+		constexpr int MaxInterpolationProbes = 8;
+	}
+
+	OpeningExplorer::OpeningExplorer()
+		: File{}
+		, RecordCount{ 0 }
+	{
+	}
+
+	bool OpeningExplorer::Open(const string& Path)
+	{
+		RecordCount = 0;
+		if (!File.Open(Path)) { return false; }
+
+		std::uint32_t RecordSize = 0;
+		if (File.GetSize() >= HeaderSize)
+		{
+			std::memcpy(&RecordSize, File.GetData() + sizeof(Magic), sizeof(RecordSize));
+		}
+		if (File.GetSize() < HeaderSize || std::memcmp(File.GetData(), Magic, sizeof(Magic)) != 0 || RecordSize != sizeof(ExplorerRecord)
+			|| (File.GetSize() - HeaderSize) % sizeof(ExplorerRecord) != 0)
+		{
+			LOG("%s is not an explorer index", Path.c_str());
+			File.Close();
+			return false;
+		}
+
+		RecordCount = (File.GetSize() - HeaderSize) / sizeof(ExplorerRecord);
+		return true;
+	}
+
+	int OpeningExplorer::GetMoves(const Position& Pos, ExplorerMove* OutMoves, int MaxMoves) const
+	{
+		if (!IsOpen()) { return 0; }
+
+		// Records are in move order, so every one is read before the most
+		// played are picked
+		const HashKey Key = Pos.GetKey();
+		List<ExplorerMove> Found;
+		for (std::size_t Index = LowerBound(Key); Index < RecordCount; ++Index)
+		{
+			const ExplorerRecord Record = ReadRecord(Index);
+			if (Record.Key != Key) { break; }
+
+			// A key collision shows up as a move that does not fit the position
+			const Move Played{ Record.MoveData };
+			if (Pos.IsPseudoLegal(Played) && Pos.IsLegal(Played))
+			{
+				Found.push_back(ExplorerMove{ Played, Record.WhiteWins, Record.Draws, Record.BlackWins });
+			}
+		}
+
+		std::stable_sort(Found.begin(), Found.end(), [](const ExplorerMove& A, const ExplorerMove& B) { return A.GetGames() > B.GetGames(); });
+		const int Count = std::min(int(Found.size()), std::max(MaxMoves, 0));
+		std::copy(Found.begin(), Found.begin() + Count, OutMoves);
+		return Count;
+	}
+
+	// Interpolation narrows the range while it pays, then a binary search
+	// finishes it, so a badly spread file still costs no more than log n
+	std::size_t OpeningExplorer::LowerBound(HashKey Key) const
+	{
+		std::size_t Low = 0;
+		std::size_t High = RecordCount;
+		HashKey LowKey = 0;
+		HashKey HighKey = ~HashKey(0);
+
+		for (int Probe = 0; Probe < MaxInterpolationProbes && High - Low > InterpolationMinRange; ++Probe)
+		{
+			if (Key <= LowKey || Key >= HighKey || HighKey <= LowKey) { break; }
+
+			const double Fraction = double(Key - LowKey) / double(HighKey - LowKey);
+			const std::size_t Mid = std::min(Low + std::size_t(Fraction * double(High - Low)), High - 1);
+			const HashKey MidKey = ReadKey(Mid);
+			if (MidKey < Key)
+			{
+				Low = Mid + 1;
+				LowKey = MidKey;
+			}
+			else
+			{
+				High = Mid;
+				HighKey = MidKey;
+			}
+		}
+
+		while (Low < High)
+		{
+			const std::size_t Mid = Low + (High - Low) / 2;
+			if (ReadKey(Mid) < Key)
+			{
+				Low = Mid + 1;
+			}
+			else
+			{
+				High = Mid;
+			}
+		}
+		return Low;
+	}
+
+	HashKey OpeningExplorer::ReadKey(std::size_t Index) const
+	{
+		HashKey Key;
+		std::memcpy(&Key, File.GetData() + HeaderSize + Index * sizeof(ExplorerRecord), sizeof(Key));
+		return Key;
+	}
+
+	ExplorerRecord OpeningExplorer::ReadRecord(std::size_t Index) const
+	{
+		ExplorerRecord Record;
+		std::memcpy(&Record, File.GetData() + HeaderSize + Index * sizeof(ExplorerRecord), sizeof(Record));
+		return Record;
+	}
+}
@@ -0,0 +1,132 @@
+#include "Engine/PawnHash.h"
+
+namespace we
+{
+	namespace
+	{
+		EvalScore EvaluatePawnsFor(const Position& Pos, EColor Us, Bitboard& OutPassed)
+		{
+			const EColor Them = ~Us;
+			const Bitboard OurPawns = Pos.Pieces(Us, Pawn);
+			const Bitboard TheirPawns = Pos.Pieces(Them, Pawn);
+
+			EvalScore Score;
+			OutPassed = 0;
+			Bitboard Pawns = OurPawns;
+			while (Pawns)
+			{
+				const Square Sq = PopLsb(Pawns);
+				const int File = FileOf(Sq);
+				const Bitboard Adjacent = Bitboards::AdjacentFiles[File];
+
+				if (Bitboards::ForwardFiles[Us][Sq] & OurPawns)
+				{
+					Score += EvalParams::DoubledPawn;
+				}
+
+				if (!(Adjacent & OurPawns))
+				{
+					Score += EvalParams::IsolatedPawn;
+				}
+				else
+				{
+					// No friendly pawn level with or behind us on a neighbouring file,
+					// and the stop square is held by an enemy pawn
+					const Bitboard Supporters = Adjacent & OurPawns & ~Bitboards::PassedPawnSpan[Us][Sq];
+					const Square Stop = Sq + PawnPush(Us);
+					if (!Supporters && (Bitboards::PawnAttacks[Us][Stop] & TheirPawns))
+					{
+						Score += EvalParams::BackwardPawn;
+					}
+				}
+
+				if (!(Bitboards::PassedPawnSpan[Us][Sq] & TheirPawns) && !(Bitboards::ForwardFiles[Us][Sq] & OurPawns))
+				{
+					Score += EvalParams::PassedPawn[RelativeRank(Us, Sq)];
+					OutPassed |= SquareBB(Sq);
+				}
+			}
+			return Score;
+		}
+
+		// Own pawns on the three files around the king, one and two ranks ahead
+		EvalScore EvaluateShield(const Position& Pos, EColor Us, Square KingSq)
+		{
+			const Bitboard OurPawns = Pos.Pieces(Us, Pawn);
+			const Bitboard Near = Bitboards::PassedPawnSpan[Us][KingSq] & Bitboards::KingAttacks[KingSq];
+			const Bitboard Far = Us == White ? Shift<8>(Near) : Shift<-8>(Near);
+
+			return EvalParams::PawnShield[0] * PopCount(Near & OurPawns) + EvalParams::PawnShield[1] * PopCount(Far & OurPawns);
+		}
+	}
+
+	const EvalScore& PawnEntry::GetShield(const Position& Pos, EColor Color)
+	{
+		const Square KingSq = Pos.KingSquare(Color);
+		if (ShieldKing[Color] != KingSq)
+		{
+			ShieldKing[Color] = KingSq;
+			Shield[Color] = EvaluateShield(Pos, Color, KingSq);
+		}
+		return Shield[Color];
+	}
+
+	// ----------------------------------------------------
+	// Pawn Hash Table
+	// ----------------------------------------------------
+	PawnHashTable::PawnHashTable()
+		: Entries{}
+		, Mask{ 0 }
+		, Probes{ 0 }
+		, Hits{ 0 }
+	{
+		Resize(DefaultEntries);
+	}
+
+	void PawnHashTable::Resize(std::size_t EntryCount)
+	{
+		std::size_t Size = 1;
+		while (Size * 2 <= EntryCount)
+		{
+			Size *= 2;
+		}
+
+		Entries.assign(Size, PawnEntry{});
+		Mask = Size - 1;
+	}
+
+	void PawnHashTable::Clear()
+	{
+		Entries.assign(Entries.size(), PawnEntry{});
+		ResetStats();
+	}
+
+	void PawnHashTable::ResetStats()
+	{
+		Probes.store(0, std::memory_order_relaxed);
+		Hits.store(0, std::memory_order_relaxed);
+	}
+
+	PawnEntry& PawnHashTable::Probe(const Position& Pos)
+	{
+		const HashKey Key = Pos.GetPawnKey();
+		PawnEntry& Entry = Entries[Key & Mask];
+		Increment(Probes);
+
+		if (Entry.Key == Key)
+		{
+			Increment(Hits);
+			return Entry;
+		}
+
+		EvaluateEntry(Pos, Entry);
+		return Entry;
+	}
+
+	void PawnHashTable::EvaluateEntry(const Position& Pos, PawnEntry& OutEntry)
+	{
+		OutEntry.Key = Pos.GetPawnKey();
+		OutEntry.Score = EvaluatePawnsFor(Pos, White, OutEntry.PassedPawns[White]) - EvaluatePawnsFor(Pos, Black, OutEntry.PassedPawns[Black]);
+		OutEntry.ShieldKing[White] = OutEntry.ShieldKing[Black] = NoSquare;
+	}
+}
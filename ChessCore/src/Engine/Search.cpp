@@ -0,0 +1,633 @@
+#include "Engine/Search.h"
+#include "Engine/Engine.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace we
+{
+	namespace
+	{
+		constexpr int TTMoveScore = 1 << 30;
+		constexpr int CaptureScore = 1 << 28;
+		constexpr int KillerScore = 1 << 27;
+		constexpr int HistoryMax = 1 << 14;
+		constexpr int AspirationWindow = 25;
+
+		struct ReductionTable
+		{
+			int Values[MaxPly + 1][MaxMoves];
+
+			ReductionTable()
+			{
+				for (int Depth = 0; Depth <= MaxPly; ++Depth)
+				{
+					for (int Count = 0; Count < MaxMoves; ++Count)
+					{
+						Values[Depth][Count] = Depth && Count ? int(0.75 + std::log(Depth) * std::log(Count) / 2.25) : 0;
+					}
+				}
+			}
+		};
+		const ReductionTable Reductions;
+
+		// Mate scores are stored relative to the node so they stay valid at any ply
+		int ScoreToTT(int Score, int Ply)
+		{
+			return Score >= ScoreMateInMaxPly ? Score + Ply : Score <= -ScoreMateInMaxPly ? Score - Ply : Score;
+		}
+
+		int ScoreFromTT(int Score, int Ply)
+		{
+			return Score >= ScoreMateInMaxPly ? Score - Ply : Score <= -ScoreMateInMaxPly ? Score + Ply : Score;
+		}
+
+		bool HasNonPawnMaterial(const Position& Pos, EColor Color)
+		{
+			return (Pos.Pieces(Color) & ~(Pos.Pieces(Pawn) | Pos.Pieces(King))) != 0;
+		}
+
+		int CapturedValue(const Position& Pos, Move InMove)
+		{
+			const EPieceType Victim = InMove.Flag() == EnPassantCapture ? Pawn : TypeOf(Pos.PieceOn(InMove.To()));
+			return EvalParams::PieceValue[Victim].Mg;
+		}
+	}
+
+	SearchWorker::SearchWorker(Engine& InOwner, int InIndex)
+		: Owner{ InOwner }
+		, Index{ InIndex }
+		, Pos{}
+		, Eval{}
+		, SearchMoves{ nullptr }
+		, RootMaterial{ 0 }
+		, Nodes{ 0 }
+		, Counters{}
+		, SelDepth{ 0 }
+		, CompletedDepth{ 0 }
+		, BestScore{ 0 }
+		, BestPv{}
+	{
+		ClearHistory();
+	}
+
+	void SearchWorker::ClearHistory()
+	{
+		std::memset(Killers, 0, sizeof(Killers));
+		std::memset(History, 0, sizeof(History));
+	}
+
+	// ----------------------------------------------------
+	// Iterative Deepening
+	// ----------------------------------------------------
+	void SearchWorker::Run(const Position& Root, const SearchLimits& Limits)
+	{
+		Pos = Root;
+		RootMaterial = Bitbase::MaterialKey(Root, White);
+		Eval.SetNetwork(Owner.Network);
+		SearchMoves = &Limits.SearchMoves;
+		Nodes.store(0, std::memory_order_relaxed);
+		Eval.GetPawnTable().ResetStats();
+		Counters.Reset();
+		CompletedDepth = 0;
+		BestScore = 0;
+		BestPv.clear();
+		std::memset(Killers, 0, sizeof(Killers));
+
+		const int MaxDepth = Limits.Depth > 0 ? std::min(Limits.Depth, MaxPly - 1) : MaxPly - 1;
+
+		MoveList RootMoves;
+		GenerateLegalMoves(Pos, RootMoves);
+		const int AllowedCount = int(std::count_if(RootMoves.begin(), RootMoves.end(), [this](Move Candidate) { return IsRootMoveAllowed(Candidate); }));
+		const int LineCount = std::max(std::min(Limits.MultiPv, AllowedCount), 1);
+		Lines.clear();
+		List<PvLine> Current;
+
+		// Helpers start one ply deeper every other thread so they do not all walk the same tree
+		for (int Depth = 1 + (Index & 1); Depth <= MaxDepth; ++Depth)
+		{
+			SelDepth = 0;
+			Current.clear();
+			ExcludedRootMoves.clear();
+
+			// Each further line searches the root without the moves of the lines before it
+			for (int Line = 0; Line < LineCount; ++Line)
+			{
+				const int Previous = Line < int(Lines.size()) ? Lines[Line].Score : BestScore;
+				int Alpha = -ScoreInfinite;
+				int Beta = ScoreInfinite;
+				int Window = AspirationWindow;
+				if (Depth >= 5 && !IsMateScore(Previous))
+				{
+					Alpha = std::max(Previous - Window, -ScoreInfinite);
+					Beta = std::min(Previous + Window, ScoreInfinite);
+				}
+
+				int Score = 0;
+				while (true)
+				{
+					Score = AlphaBeta(Alpha, Beta, Depth, 0, false);
+					if (Owner.IsStopRequested()) { break; }
+
+					if (Score <= Alpha)
+					{
+						Beta = (Alpha + Beta) / 2;
+						Alpha = std::max(Score - Window, -ScoreInfinite);
+					}
+					else if (Score >= Beta)
+					{
+						Beta = std::min(Score + Window, ScoreInfinite);
+					}
+					else
+					{
+						break;
+					}
+					Window *= 2;
+				}
+
+				if (PvLength[0] == 0) { break; }
+				Current.push_back(PvLine{ Score, List<Move>(PvTable[0], PvTable[0] + PvLength[0]) });
+				ExcludedRootMoves.push_back(PvTable[0][0]);
+				if (Owner.IsStopRequested()) { break; }
+			}
+
+			// A partial iteration is only trusted for its first move, which was searched with a full window
+			if (Owner.IsStopRequested() && CompletedDepth > 0) { break; }
+			if (Current.empty()) { break; }
+
+			std::stable_sort(Current.begin(), Current.end(), [](const PvLine& A, const PvLine& B) { return A.Score > B.Score; });
+			Lines = Current;
+			CompletedDepth = Depth;
+			BestScore = Lines[0].Score;
+			BestPv = Lines[0].Pv;
+
+			if (IsMainThread())
+			{
+				Owner.ReportIteration(*this);
+			}
+			if (Owner.IsStopRequested()) { break; }
+		}
+		ExcludedRootMoves.clear();
+	}
+
+	// ----------------------------------------------------
+	// Principal Variation Search
+	// ----------------------------------------------------
+	int SearchWorker::AlphaBeta(int Alpha, int Beta, int Depth, int Ply, bool bNullAllowed)
+	{
+		if (Depth <= 0)
+		{
+			return Quiescence(Alpha, Beta, Ply);
+		}
+
+		const bool bRoot = Ply == 0;
+		const bool bPvNode = Beta - Alpha > 1;
+		PvLength[Ply] = 0;
+
+		CountNode();
+		if (ShouldStop()) { return 0; }
+		SelDepth = std::max(SelDepth, Ply);
+
+		if (!bRoot)
+		{
+			if (Pos.IsFiftyMoveDraw() || Pos.IsInsufficientMaterial() || Pos.IsRepetition(Ply))
+			{
+				return ScoreDraw;
+			}
+			if (Ply >= MaxPly - 1)
+			{
+				return Pos.IsInCheck() ? ScoreDraw : EvaluateClamped();
+			}
+
+			// Mate distance pruning
+			Alpha = std::max(Alpha, MatedIn(Ply));
+			Beta = std::min(Beta, MateIn(Ply + 1));
+			if (Alpha >= Beta) { return Alpha; }
+
+			// Bitbase draws are final. Wins and losses only end the line after a
+			// conversion; inside the root's own ending the search still has to find the mate.
+			EWdl Wdl;
+			if (PopCount(Pos.Pieces()) <= Owner.Bitbases.GetMaxPieces() && Owner.Bitbases.Probe(Pos, Wdl))
+			{
+				if (Wdl == EWdl::Draw) { return ScoreDraw; }
+				if (Bitbase::MaterialKey(Pos, White) != RootMaterial)
+				{
+					if (Wdl == EWdl::Loss && Pos.IsInCheck() && !HasLegalMove(Pos)) { return MatedIn(Ply); }
+
+					const EColor Us = Pos.GetSideToMove();
+					return Wdl == EWdl::Win ? ScoreKnownWin - Ply + KnownWinProgress(Us) : -ScoreKnownWin + Ply - KnownWinProgress(~Us);
+				}
+			}
+
+			// Syzygy tables are only exact right after a zeroing move, when the
+			// fifty-move counter they assume matches the position's
+			Syzygy::EWdlScore TableWdl;
+			if (!Owner.bRootInTablebase && Pos.GetHalfmoveClock() == 0 && Owner.Tablebases.CanProbe(Pos) && Owner.Tablebases.ProbeWdl(Pos, TableWdl))
+			{
+				if (TableWdl == Syzygy::WdlWin) { return ScoreKnownWin - Ply; }
+				if (TableWdl == Syzygy::WdlLoss) { return -ScoreKnownWin + Ply; }
+				return ScoreDraw + TableWdl;
+			}
+		}
+
+		const HashKey Key = Pos.GetKey();
+		TTHit Hit;
+		const bool bTTHit = Owner.TT.Probe(Key, Hit);
+		Counters.Increment(SearchCounters::TTProbes);
+		if (bTTHit) { Counters.Increment(SearchCounters::TTHits); }
+		Move TTMove = bTTHit && Pos.IsPseudoLegal(Hit.BestMove) && Pos.IsLegal(Hit.BestMove) ? Hit.BestMove : NullMove;
+		if (bRoot && !TTMove.IsNull() && !IsRootMoveAllowed(TTMove))
+		{
+			TTMove = NullMove;
+		}
+
+		if (!bPvNode && bTTHit && Hit.Depth >= Depth)
+		{
+			const int TTScore = ScoreFromTT(Hit.Score, Ply);
+			if (Hit.Bound == BoundExact
+				|| (Hit.Bound == BoundLower && TTScore >= Beta)
+				|| (Hit.Bound == BoundUpper && TTScore <= Alpha))
+			{
+				return TTScore;
+			}
+		}
+
+		const bool bInCheck = Pos.IsInCheck();
+		int StaticEval = ScoreNone;
+		if (!bInCheck)
+		{
+			StaticEval = bTTHit && Hit.StaticEval != ScoreNone ? Hit.StaticEval : EvaluateClamped();
+		}
+		StaticEvals[Ply] = StaticEval;
+		const bool bImproving = !bInCheck && Ply >= 2 && StaticEvals[Ply - 2] != ScoreNone && StaticEval > StaticEvals[Ply - 2];
+
+		if (!bPvNode && !bInCheck)
+		{
+			// Reverse futility: far enough above beta that a shallow search will not drop below it
+			if (Depth <= 6 && StaticEval - 80 * (Depth - bImproving) >= Beta && Beta > -ScoreMateInMaxPly && Beta < ScoreMateInMaxPly)
+			{
+				return StaticEval;
+			}
+
+			// Null move: if passing still fails high, the position is good enough
+			if (bNullAllowed && Depth >= 3 && StaticEval >= Beta && HasNonPawnMaterial(Pos, Pos.GetSideToMove()))
+			{
+				const int Reduction = 3 + Depth / 4;
+				Counters.Increment(SearchCounters::NullMoveTries);
+				Pos.MakeNullMove();
+				const int NullScore = -AlphaBeta(-Beta, -Beta + 1, Depth - 1 - Reduction, Ply + 1, false);
+				Pos.UnmakeNullMove();
+
+				if (Owner.IsStopRequested()) { return 0; }
+				if (NullScore >= Beta)
+				{
+					Counters.Increment(SearchCounters::NullMoveCutoffs);
+					return NullScore >= ScoreMateInMaxPly ? Beta : NullScore;
+				}
+			}
+		}
+
+		// Without a hash move this node was never searched well; spend less on it.
+		// The root keeps its depth, as a Multi-PV line may only lack one because its move is excluded
+		if (!bRoot && Depth >= 4 && TTMove.IsNull())
+		{
+			--Depth;
+		}
+
+		MoveList Moves;
+		GenerateMoves(Pos, Moves);
+		int Scores[MaxMoves];
+		ScoreMoves(Moves, Scores, TTMove, Ply);
+
+		Move Quiets[MaxMoves];
+		int QuietCount = 0;
+		int BestValue = -ScoreInfinite;
+		Move BestMove = NullMove;
+		int MovesSearched = 0;
+		const int OriginalAlpha = Alpha;
+
+		for (int i = 0; i < Moves.Size(); ++i)
+		{
+			const Move Candidate = PickNext(Moves, Scores, i);
+			if (!Pos.IsLegal(Candidate)) { continue; }
+			if (bRoot && !IsRootMoveAllowed(Candidate)) { continue; }
+
+			++MovesSearched;
+			const bool bQuiet = Candidate.IsQuiet();
+
+			if (!bRoot && !bInCheck && bQuiet && BestValue > -ScoreMateInMaxPly)
+			{
+				// Late move pruning
+				if (Depth <= 3 && MovesSearched > 3 + Depth * Depth * (1 + bImproving))
+				{
+					continue;
+				}
+				// Futility pruning
+				if (Depth <= 4 && StaticEval + 100 + 90 * Depth <= Alpha)
+				{
+					continue;
+				}
+			}
+
+			Pos.MakeMove(Candidate);
+			Owner.TT.Prefetch(Pos.GetKey());
+
+			const int NewDepth = Depth - 1 + (Pos.IsInCheck() ? 1 : 0);
+			int Score;
+			if (MovesSearched == 1)
+			{
+				Score = -AlphaBeta(-Beta, -Alpha, NewDepth, Ply + 1, true);
+			}
+			else
+			{
+				int Reduction = 0;
+				if (Depth >= 3 && bQuiet && MovesSearched > 2 + bPvNode)
+				{
+					Reduction = Reductions.Values[std::min(Depth, MaxPly)][std::min(MovesSearched, MaxMoves - 1)];
+					Reduction += !bPvNode;
+					Reduction -= bImproving;
+					Reduction -= Candidate == Killers[Ply][0] || Candidate == Killers[Ply][1];
+					Reduction = std::clamp(Reduction, 0, NewDepth - 1);
+				}
+
+				Score = -AlphaBeta(-Alpha - 1, -Alpha, NewDepth - Reduction, Ply + 1, true);
+				if (Score > Alpha && Reduction > 0)
+				{
+					Score = -AlphaBeta(-Alpha - 1, -Alpha, NewDepth, Ply + 1, true);
+				}
+				if (Score > Alpha && Score < Beta)
+				{
+					Score = -AlphaBeta(-Beta, -Alpha, NewDepth, Ply + 1, true);
+				}
+			}
+
+			Pos.UnmakeMove(Candidate);
+			if (Owner.IsStopRequested()) { return 0; }
+
+			if (Score > BestValue)
+			{
+				BestValue = Score;
+				if (Score > Alpha)
+				{
+					BestMove = Candidate;
+					Alpha = Score;
+					UpdatePv(Ply, Candidate);
+
+					if (Score >= Beta)
+					{
+						Counters.Increment(SearchCounters::BetaCutoffs);
+						if (MovesSearched == 1) { Counters.Increment(SearchCounters::FirstMoveCutoffs); }
+						if (bQuiet)
+						{
+							UpdateQuietStats(Candidate, Quiets, QuietCount, Depth, Ply);
+						}
+						break;
+					}
+				}
+			}
+
+			if (bQuiet && QuietCount < MaxMoves)
+			{
+				Quiets[QuietCount++] = Candidate;
+			}
+		}
+
+		if (MovesSearched == 0)
+		{
+			return bInCheck ? MatedIn(Ply) : ScoreDraw;
+		}
+
+		// A root searched without its best lines would overwrite the main line's entry
+		if (!bRoot || ExcludedRootMoves.empty())
+		{
+			const EBound Bound = BestValue >= Beta ? BoundLower : BestValue > OriginalAlpha ? BoundExact : BoundUpper;
+			Owner.TT.Store(Key, BestMove, ScoreToTT(BestValue, Ply), StaticEval, Depth, Bound);
+		}
+		return BestValue;
+	}
+
+	// ----------------------------------------------------
+	// Quiescence
+	// ----------------------------------------------------
+	int SearchWorker::Quiescence(int Alpha, int Beta, int Ply)
+	{
+		const bool bPvNode = Beta - Alpha > 1;
+		PvLength[Ply] = 0;
+
+		CountNode();
+		Counters.Increment(SearchCounters::QNodes);
+		if (ShouldStop()) { return 0; }
+		SelDepth = std::max(SelDepth, Ply);
+
+		if (Pos.IsInsufficientMaterial() || Pos.IsRepetition(Ply))
+		{
+			return ScoreDraw;
+		}
+
+		const bool bInCheck = Pos.IsInCheck();
+		if (Ply >= MaxPly - 1)
+		{
+			return bInCheck ? ScoreDraw : EvaluateClamped();
+		}
+
+		const HashKey Key = Pos.GetKey();
+		TTHit Hit;
+		const bool bTTHit = Owner.TT.Probe(Key, Hit);
+		Counters.Increment(SearchCounters::TTProbes);
+		if (bTTHit) { Counters.Increment(SearchCounters::TTHits); }
+		if (!bPvNode && bTTHit)
+		{
+			const int TTScore = ScoreFromTT(Hit.Score, Ply);
+			if (Hit.Bound == BoundExact
+				|| (Hit.Bound == BoundLower && TTScore >= Beta)
+				|| (Hit.Bound == BoundUpper && TTScore <= Alpha))
+			{
+				return TTScore;
+			}
+		}
+
+		int StaticEval = ScoreNone;
+		int BestValue = -ScoreInfinite;
+		if (!bInCheck)
+		{
+			StaticEval = bTTHit && Hit.StaticEval != ScoreNone ? Hit.StaticEval : EvaluateClamped();
+			BestValue = StaticEval;
+			if (BestValue >= Beta) { return BestValue; }
+			Alpha = std::max(Alpha, BestValue);
+		}
+
+		// In check every evasion is searched, otherwise only captures and queen promotions
+		MoveList Moves;
+		GenerateMoves(Pos, Moves, bInCheck ? EMoveGenType::All : EMoveGenType::Captures);
+		int Scores[MaxMoves];
+		const Move TTMove = bTTHit && Pos.IsPseudoLegal(Hit.BestMove) && Pos.IsLegal(Hit.BestMove) ? Hit.BestMove : NullMove;
+		ScoreMoves(Moves, Scores, TTMove, Ply);
+
+		Move BestMove = NullMove;
+		int MovesSearched = 0;
+		const int OriginalAlpha = Alpha;
+
+		for (int i = 0; i < Moves.Size(); ++i)
+		{
+			const Move Candidate = PickNext(Moves, Scores, i);
+			if (!Pos.IsLegal(Candidate)) { continue; }
+			++MovesSearched;
+
+			// Delta pruning: even winning the piece cannot lift us to alpha
+			if (!bInCheck && !Candidate.IsPromotion() && StaticEval + CapturedValue(Pos, Candidate) + 200 <= Alpha)
+			{
+				continue;
+			}
+
+			Pos.MakeMove(Candidate);
+			const int Score = -Quiescence(-Beta, -Alpha, Ply + 1);
+			Pos.UnmakeMove(Candidate);
+			if (Owner.IsStopRequested()) { return 0; }
+
+			if (Score > BestValue)
+			{
+				BestValue = Score;
+				if (Score > Alpha)
+				{
+					BestMove = Candidate;
+					Alpha = Score;
+					UpdatePv(Ply, Candidate);
+					if (Score >= Beta) { break; }
+				}
+			}
+		}
+
+		if (bInCheck && MovesSearched == 0)
+		{
+			return MatedIn(Ply);
+		}
+
+		const EBound Bound = BestValue >= Beta ? BoundLower : BestValue > OriginalAlpha ? BoundExact : BoundUpper;
+		Owner.TT.Store(Key, BestMove, ScoreToTT(BestValue, Ply), StaticEval, 0, Bound);
+		return BestValue;
+	}
+
+	int SearchWorker::KnownWinProgress(EColor Winner) const
+	{
+		// Drive the defending king to the edge, bring the kings together and push pawns
+		const Square Defender = Pos.KingSquare(~Winner);
+		const Square Attacker = Pos.KingSquare(Winner);
+		const int EdgeDistance = std::max(3 - FileOf(Defender), FileOf(Defender) - 4) + std::max(3 - RankOf(Defender), RankOf(Defender) - 4);
+		const int KingDistance = std::max(std::abs(FileOf(Defender) - FileOf(Attacker)), std::abs(RankOf(Defender) - RankOf(Attacker)));
+
+		int Progress = 40 * EdgeDistance + 20 * (7 - KingDistance);
+		for (Bitboard Pawns = Pos.Pieces(Winner, Pawn); Pawns; )
+		{
+			Progress += 30 * RelativeRank(Winner, PopLsb(Pawns));
+		}
+		return Progress;
+	}
+
+	int SearchWorker::EvaluateClamped()
+	{
+		return std::clamp(Eval.Evaluate(Pos), -ScoreMateInMaxPly + 1, ScoreMateInMaxPly - 1);
+	}
+
+	// ----------------------------------------------------
+	// Move Ordering
+	// ----------------------------------------------------
+	void SearchWorker::ScoreMoves(const MoveList& Moves, int* Scores, Move TTMove, int Ply) const
+	{
+		const EColor Us = Pos.GetSideToMove();
+		for (int i = 0; i < Moves.Size(); ++i)
+		{
+			const Move Candidate = Moves.Moves[i];
+			if (Candidate == TTMove)
+			{
+				Scores[i] = TTMoveScore;
+			}
+			else if (Candidate.IsCapture() || Candidate.IsPromotion())
+			{
+				// Most valuable victim, least valuable attacker
+				const int Victim = Candidate.IsCapture() ? CapturedValue(Pos, Candidate) : 0;
+				const int Promotion = Candidate.IsPromotion() ? EvalParams::PieceValue[Candidate.PromotionType()].Mg : 0;
+				Scores[i] = CaptureScore + (Victim + Promotion) * 8 - TypeOf(Pos.PieceOn(Candidate.From()));
+			}
+			else if (Candidate == Killers[Ply][0])
+			{
+				Scores[i] = KillerScore + 1;
+			}
+			else if (Candidate == Killers[Ply][1])
+			{
+				Scores[i] = KillerScore;
+			}
+			else
+			{
+				Scores[i] = History[Us][Candidate.From()][Candidate.To()];
+			}
+		}
+	}
+
+	Move SearchWorker::PickNext(MoveList& Moves, int* Scores, int Index)
+	{
+		int Best = Index;
+		for (int i = Index + 1; i < Moves.Size(); ++i)
+		{
+			if (Scores[i] > Scores[Best])
+			{
+				Best = i;
+			}
+		}
+		std::swap(Moves.Moves[Index], Moves.Moves[Best]);
+		std::swap(Scores[Index], Scores[Best]);
+		return Moves.Moves[Index];
+	}
+
+	void SearchWorker::UpdateQuietStats(Move Best, const Move* Quiets, int QuietCount, int Depth, int Ply)
+	{
+		if (Killers[Ply][0] != Best)
+		{
+			Killers[Ply][1] = Killers[Ply][0];
+			Killers[Ply][0] = Best;
+		}
+
+		const EColor Us = Pos.GetSideToMove();
+		const int Bonus = std::min(Depth * Depth, 400);
+		auto Apply = [](int& Entry, int Delta)
+		{
+			Entry += Delta - Entry * std::abs(Delta) / HistoryMax;
+		};
+
+		Apply(History[Us][Best.From()][Best.To()], Bonus);
+		for (int i = 0; i < QuietCount; ++i)
+		{
+			Apply(History[Us][Quiets[i].From()][Quiets[i].To()], -Bonus);
+		}
+	}
+
+	void SearchWorker::UpdatePv(int Ply, Move BestMove)
+	{
+		PvTable[Ply][0] = BestMove;
+		const int ChildLength = Ply + 1 <= MaxPly ? PvLength[Ply + 1] : 0;
+		for (int i = 0; i < ChildLength && i + 1 < MaxPly; ++i)
+		{
+			PvTable[Ply][i + 1] = PvTable[Ply + 1][i];
+		}
+		PvLength[Ply] = std::min(ChildLength + 1, MaxPly);
+	}
+
+	bool SearchWorker::IsRootMoveAllowed(Move Candidate) const
+	{
+		return (SearchMoves->empty() || std::find(SearchMoves->begin(), SearchMoves->end(), Candidate) != SearchMoves->end())
+			&& std::find(ExcludedRootMoves.begin(), ExcludedRootMoves.end(), Candidate) == ExcludedRootMoves.end();
+	}
+
+	// The clock is read every 256 nodes, well under a millisecond of search,
+	// so the hard limit is never overrun by more than that; the helpers only
+	// poll the stop flag the main thread sets
+	bool SearchWorker::ShouldStop()
+	{
+		if (IsMainThread() && (GetNodes() & 255) == 0)
+		{
+			return Owner.CheckLimits();
+		}
+		return Owner.IsStopRequested();
+	}
+}
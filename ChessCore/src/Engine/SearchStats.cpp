@@ -0,0 +1,87 @@
+#include "Engine/SearchStats.h"
+#include <cmath>
+#include <sstream>
+
+namespace we
+{
+	void SearchStats::Accumulate(const SearchStats& Other)
+	{
+		TimeMs += Other.TimeMs;
+		Nodes += Other.Nodes;
+		QNodes += Other.QNodes;
+		TTProbes += Other.TTProbes;
+		TTHits += Other.TTHits;
+		BetaCutoffs += Other.BetaCutoffs;
+		FirstMoveCutoffs += Other.FirstMoveCutoffs;
+		NullMoveTries += Other.NullMoveTries;
+		NullMoveCutoffs += Other.NullMoveCutoffs;
+	}
+
+	double SearchStats::BranchingFactor() const
+	{
+		double LogSum = 0.0;
+		int Steps = 0;
+		for (std::size_t i = 1; i < Iterations.size(); ++i)
+		{
+			if (Iterations[i - 1].Nodes == 0 || Iterations[i].Nodes == 0) { continue; }
+			LogSum += std::log(double(Iterations[i].Nodes) / Iterations[i - 1].Nodes);
+			++Steps;
+		}
+		return Steps ? std::exp(LogSum / Steps) : 0.0;
+	}
+
+	string SearchStats::ToJson() const
+	{
+		std::ostringstream Json;
+		Json << "{\"threads\":" << Threads
+			<< ",\"time_ms\":" << TimeMs
+			<< ",\"nodes\":" << Nodes
+			<< ",\"qnodes\":" << QNodes
+			<< ",\"nps\":" << NodesPerSecond()
+			<< ",\"tt_probes\":" << TTProbes
+			<< ",\"tt_hits\":" << TTHits
+			<< ",\"tt_hit_rate\":" << TTHitRate()
+			<< ",\"beta_cutoffs\":" << BetaCutoffs
+			<< ",\"first_move_cutoff_rate\":" << FirstMoveCutoffRate()
+			<< ",\"null_move_tries\":" << NullMoveTries
+			<< ",\"null_move_cutoffs\":" << NullMoveCutoffs
+			<< ",\"branching_factor\":" << BranchingFactor()
+			<< ",\"iterations\":[";
+
+		for (std::size_t i = 0; i < Iterations.size(); ++i)
+		{
+			Json << (i ? "," : "") << "{\"depth\":" << Iterations[i].Depth
+				<< ",\"time_ms\":" << Iterations[i].TimeMs
+				<< ",\"nodes\":" << Iterations[i].Nodes << "}";
+		}
+		Json << "]}";
+		return Json.str();
+	}
+
+	// ----------------------------------------------------
+	// Per-Thread Counters
+	// ----------------------------------------------------
+	SearchCounters::SearchCounters()
+	{
+		Reset();
+	}
+
+	void SearchCounters::Reset()
+	{
+		for (auto& Value : Values)
+		{
+			Value.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	void SearchCounters::AddTo(SearchStats& OutStats) const
+	{
+		OutStats.QNodes += Values[QNodes].load(std::memory_order_relaxed);
+		OutStats.TTProbes += Values[TTProbes].load(std::memory_order_relaxed);
+		OutStats.TTHits += Values[TTHits].load(std::memory_order_relaxed);
+		OutStats.BetaCutoffs += Values[BetaCutoffs].load(std::memory_order_relaxed);
+		OutStats.FirstMoveCutoffs += Values[FirstMoveCutoffs].load(std::memory_order_relaxed);
+		OutStats.NullMoveTries += Values[NullMoveTries].load(std::memory_order_relaxed);
+		OutStats.NullMoveCutoffs += Values[NullMoveCutoffs].load(std::memory_order_relaxed);
+	}
+}
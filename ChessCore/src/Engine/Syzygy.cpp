@@ -0,0 +1,1102 @@
+#include "Engine/Syzygy.h"
+#include "IO/MappedFile.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+
+// Probing follows the reference Syzygy layout: pieces are grouped and mapped
+// to a combinatorial index, and every table holds canonical Huffman codes over
+// a recursive-pairing symbol tree. Multi-byte values are read with explicit
+// byte order, so the code does not rely on the host's endianness or alignment.
+namespace we
+{
+	namespace
+	{
+		enum ETableType : int
+		{
+			TableWdl,
+			TableDtz
+		};
+
+		enum ETableFlag : std::uint8_t
+		{
+			FlagStm = 1,
+			FlagMapped = 2,
+			FlagWinPlies = 4,
+			FlagLossPlies = 8,
+			FlagWide = 16,
+			FlagSingleValue = 128
+		};
+
+		constexpr std::uint8_t WdlMagic[4] = { 0x71, 0xE8, 0x23, 0x5D };
+		constexpr std::uint8_t DtzMagic[4] = { 0xD7, 0x66, 0x0C, 0xA5 };
+		constexpr const char* PieceLetters = " PNBRQK";
+
+		std::uint16_t ReadLittle16(const std::uint8_t* Bytes) { return std::uint16_t(Bytes[0] | Bytes[1] << 8); }
+		std::uint32_t ReadLittle32(const std::uint8_t* Bytes) { return std::uint32_t(ReadLittle16(Bytes)) | std::uint32_t(ReadLittle16(Bytes + 2)) << 16; }
+
+		std::uint32_t ReadBig32(const std::uint8_t* Bytes)
+		{
+			return std::uint32_t(Bytes[0]) << 24 | std::uint32_t(Bytes[1]) << 16 | std::uint32_t(Bytes[2]) << 8 | Bytes[3];
+		}
+
+		std::uint64_t ReadBig64(const std::uint8_t* Bytes) { return std::uint64_t(ReadBig32(Bytes)) << 32 | ReadBig32(Bytes + 4); }
+
+		int OffA1H8(Square Sq) { return RankOf(Sq) - FileOf(Sq); }
+		Square FlipDiagonal(Square Sq) { return ((Sq >> 3) | (Sq << 3)) & 63; }
+
+		// Captures and pawn moves are not stored in DTZ tables, but their
+		// distance follows from the WDL value of the position they lead to
+		int DtzBeforeZeroing(int Wdl)
+		{
+			return Wdl == Syzygy::WdlWin ? 1
+				: Wdl == Syzygy::WdlCursedWin ? 101
+				: Wdl == Syzygy::WdlBlessedLoss ? -101
+				: Wdl == Syzygy::WdlLoss ? -1
+				: 0;
+		}
+
+		int SignOf(int Value) { return (0 < Value) - (Value < 0); }
+
+		std::uint64_t MaterialKey(const int (&Counts)[ColorCount][PieceTypeCount])
+		{
+			std::uint64_t Key = 0;
+			for (int Color = White; Color <= Black; ++Color)
+			{
+				for (int Type = Pawn; Type <= Queen; ++Type)
+				{
+					Key |= std::uint64_t(Counts[Color][Type]) << (4 * (Color * 5 + Type - Pawn));
+				}
+			}
+			return Key;
+		}
+
+		std::uint64_t MaterialKey(const Position& Pos)
+		{
+			int Counts[ColorCount][PieceTypeCount] = {};
+			for (int Color = White; Color <= Black; ++Color)
+			{
+				for (int Type = Pawn; Type <= Queen; ++Type)
+				{
+					Counts[Color][Type] = Pos.PieceCount(EColor(Color), EPieceType(Type));
+				}
+			}
+			return MaterialKey(Counts);
+		}
+
+		// ------------------------------------------------
+		// Index Encoding Tables
+		// ------------------------------------------------
+		struct EncodingTables
+		{
+			int MapPawns[64] = {};
+			int MapB1H1H7[64] = {};
+			int MapA1D1D4[64] = {};
+			int MapKK[10][64] = {};
+			int Binomial[6][64] = {};		// [k][n]: ways to choose k of n squares
+			int LeadPawnIdx[6][64] = {};	// [lead pawn count][square]
+			int LeadPawnsSize[6][4] = {};	// [lead pawn count][file a..d]
+
+			EncodingTables()
+			{
+				Bitboards::Init();
+
+				int Code = 0;
+				for (Square Sq = 0; Sq < 64; ++Sq)
+				{
+					if (OffA1H8(Sq) < 0) { MapB1H1H7[Sq] = Code++; }
+				}
+
+				// The a1-d1-d4 triangle, with the diagonal squares encoded last
+				List<Square> Diagonal;
+				Code = 0;
+				for (Square Sq = 0; Sq <= MakeSquare(3, 3); ++Sq)
+				{
+					if (OffA1H8(Sq) < 0 && FileOf(Sq) <= 3) { MapA1D1D4[Sq] = Code++; }
+					else if (!OffA1H8(Sq) && FileOf(Sq) <= 3) { Diagonal.push_back(Sq); }
+				}
+				for (Square Sq : Diagonal) { MapA1D1D4[Sq] = Code++; }
+
+				// The 462 legal king pairs with the first king in the triangle; a first
+				// king on the diagonal keeps the second on or below it
+				List<std::pair<int, Square>> BothOnDiagonal;
+				Code = 0;
+				for (int Index = 0; Index < 10; ++Index)
+				{
+					for (Square First = 0; First <= MakeSquare(3, 3); ++First)
+					{
+						if (MapA1D1D4[First] != Index || (!Index && First != MakeSquare(1, 0))) { continue; }
+
+						for (Square Second = 0; Second < 64; ++Second)
+						{
+							if ((Bitboards::KingAttacks[First] | SquareBB(First)) & SquareBB(Second)) { continue; }
+							if (!OffA1H8(First) && OffA1H8(Second) > 0) { continue; }
+
+							if (!OffA1H8(First) && !OffA1H8(Second))
+							{
+								BothOnDiagonal.emplace_back(Index, Second);
+							}
+							else
+							{
+								MapKK[Index][Second] = Code++;
+							}
+						}
+					}
+				}
+				for (const auto& Pair : BothOnDiagonal) { MapKK[Pair.first][Pair.second] = Code++; }
+
+				Binomial[0][0] = 1;
+				for (int N = 1; N < 64; ++N)
+				{
+					for (int K = 0; K < 6 && K <= N; ++K)
+					{
+						Binomial[K][N] = (K > 0 ? Binomial[K - 1][N - 1] : 0) + (K < N ? Binomial[K][N - 1] : 0);
+					}
+				}
+
+				// MapPawns[] gives a2-h7 the number of squares left to the other pawns when
+				// that square holds the leading pawn (the one nearest the edge, lowest rank)
+				int AvailableSquares = 47;
+				for (int LeadPawns = 1; LeadPawns <= 5; ++LeadPawns)
+				{
+					for (int File = 0; File <= 3; ++File)
+					{
+						int Index = 0;
+						for (int Rank = 1; Rank <= 6; ++Rank)
+						{
+							const Square Sq = MakeSquare(File, Rank);
+							if (LeadPawns == 1)
+							{
+								MapPawns[Sq] = AvailableSquares--;
+								MapPawns[Sq ^ 7] = AvailableSquares--;
+							}
+							LeadPawnIdx[LeadPawns][Sq] = Index;
+							Index += Binomial[LeadPawns - 1][MapPawns[Sq]];
+						}
+						LeadPawnsSize[LeadPawns][File] = Index;
+					}
+				}
+			}
+		};
+
+		const EncodingTables& Encoding()
+		{
+			static const EncodingTables Tables;
+			return Tables;
+		}
+	}
+
+	namespace Syzygy
+	{
+		// ------------------------------------------------
+		// Decompression Data for One Table Slice
+		// ------------------------------------------------
+		// A file holds one slice per side to move (WDL only) and per leading pawn
+		// file (tables with pawns).
+		struct PairsData
+		{
+			std::uint8_t Flags = 0;
+			int MaxSymLen = 0;
+			int MinSymLen = 0;
+			std::uint32_t NumBlocks = 0;
+			std::size_t BlockSize = 0;
+			std::size_t Span = 0;						// A sparse index entry every Span values
+			const std::uint8_t* LowestSym = nullptr;	// Little-endian u16 per symbol length
+			const std::uint8_t* Btree = nullptr;		// 3 bytes per symbol: left and right 12-bit children
+			const std::uint8_t* BlockLength = nullptr;	// Little-endian u16 per block: values stored minus one
+			std::uint32_t BlockLengthSize = 0;
+			const std::uint8_t* SparseIndex = nullptr;	// 6 bytes per entry: block u32 and offset u16
+			std::size_t SparseIndexSize = 0;
+			const std::uint8_t* Data = nullptr;
+			List<std::uint64_t> Base64;
+			List<std::uint8_t> SymLen;
+			EPiece Pieces[MaxPieces] = {};
+			std::uint64_t GroupIdx[MaxPieces + 1] = {};
+			int GroupLen[MaxPieces + 1] = {};
+			std::uint32_t MapIdx[4] = {};				// DTZ value map offsets: win, loss, cursed win, blessed loss
+
+			int LeftSymbol(int Sym) const { return ((Btree[3 * Sym + 1] & 0xF) << 8) | Btree[3 * Sym]; }
+			int RightSymbol(int Sym) const { return (Btree[3 * Sym + 2] << 4) | (Btree[3 * Sym + 1] >> 4); }
+			int GetBlockLength(std::uint32_t Block) const { return ReadLittle16(BlockLength + 2 * Block); }
+		};
+
+		struct TableFile
+		{
+			std::atomic<bool> bReady{ false };
+			bool bMapped = false;
+			MappedFile File;
+			const std::uint8_t* Map = nullptr;
+			PairsData Items[2][4];		// [side to move][leading pawn file]
+		};
+
+		struct Table
+		{
+			string Name;				// File name without extension, "KRvK"
+			std::uint64_t Key = 0;		// Material key with the named first side as White
+			std::uint64_t Key2 = 0;		// ...and as Black
+			int PieceCount = 0;
+			bool bHasPawns = false;
+			bool bHasUniquePieces = false;
+			std::uint8_t PawnCount[2] = { 0, 0 };	// [leading colour / other colour]
+			TableFile Files[2];			// [ETableType]
+
+			PairsData* Get(int Type, int Stm, int File) { return &Files[Type].Items[Type == TableWdl ? Stm : 0][bHasPawns ? File : 0]; }
+		};
+	}
+
+	namespace
+	{
+		using namespace Syzygy;
+
+		// ------------------------------------------------
+		// Table Setup (runs once per file, under the map lock)
+		// ------------------------------------------------
+		// Pieces sharing a group are encoded together: KRvKN groups as (KRK)(N),
+		// KNNvK as (KK)(NN), and with pawns the leading pawns always come first.
+		void SetGroups(const Table& Entry, PairsData& D, const int Order[2], int File)
+		{
+			const EncodingTables& Enc = Encoding();
+			int N = 0;
+			int FirstLen = Entry.bHasPawns ? 0 : Entry.bHasUniquePieces ? 3 : 2;
+			D.GroupLen[N] = 1;
+
+			for (int i = 1; i < Entry.PieceCount; ++i)
+			{
+				if (--FirstLen > 0 || D.Pieces[i] == D.Pieces[i - 1])
+				{
+					D.GroupLen[N]++;
+				}
+				else
+				{
+					D.GroupLen[++N] = 1;
+				}
+			}
+			D.GroupLen[++N] = 0;
+
+			// Groups are multiplied together in the per-table order; the leading group is
+			// at Order[0] and the other side's pawns, if any, at Order[1]
+			const bool bBothPawns = Entry.bHasPawns && Entry.PawnCount[1];
+			int Next = bBothPawns ? 2 : 1;
+			int FreeSquares = 64 - D.GroupLen[0] - (bBothPawns ? D.GroupLen[1] : 0);
+			std::uint64_t Index = 1;
+
+			for (int K = 0; Next < N || K == Order[0] || K == Order[1]; ++K)
+			{
+				if (K == Order[0])
+				{
+					D.GroupIdx[0] = Index;
+					Index *= Entry.bHasPawns ? Enc.LeadPawnsSize[D.GroupLen[0]][File]
+						: Entry.bHasUniquePieces ? 31332 : 462;
+				}
+				else if (K == Order[1])
+				{
+					D.GroupIdx[1] = Index;
+					Index *= Enc.Binomial[D.GroupLen[1]][48 - D.GroupLen[0]];
+				}
+				else
+				{
+					D.GroupIdx[Next] = Index;
+					Index *= Enc.Binomial[D.GroupLen[Next]][FreeSquares];
+					FreeSquares -= D.GroupLen[Next++];
+				}
+			}
+			D.GroupIdx[N] = Index;
+		}
+
+		std::uint8_t SetSymLen(PairsData& D, int Sym, List<bool>& Visited)
+		{
+			Visited[Sym] = true;
+			const int Right = D.RightSymbol(Sym);
+			if (Right == 0xFFF) { return 0; }
+
+			const int Left = D.LeftSymbol(Sym);
+			if (!Visited[Left]) { D.SymLen[Left] = SetSymLen(D, Left, Visited); }
+			if (!Visited[Right]) { D.SymLen[Right] = SetSymLen(D, Right, Visited); }
+			return std::uint8_t(D.SymLen[Left] + D.SymLen[Right] + 1);
+		}
+
+		const std::uint8_t* SetSizes(PairsData& D, const std::uint8_t* Data)
+		{
+			D.Flags = *Data++;
+			if (D.Flags & FlagSingleValue)
+			{
+				D.MinSymLen = *Data++;		// The single stored value
+				return Data;
+			}
+
+			const std::uint64_t TableSize = D.GroupIdx[std::find(D.GroupLen, D.GroupLen + MaxPieces, 0) - D.GroupLen];
+
+			D.BlockSize = std::size_t(1) << *Data++;
+			D.Span = std::size_t(1) << *Data++;
+			D.SparseIndexSize = std::size_t((TableSize + D.Span - 1) / D.Span);
+			const int Padding = *Data++;
+			D.NumBlocks = ReadLittle32(Data);
+			Data += 4;
+			D.BlockLengthSize = D.NumBlocks + Padding;
+			D.MaxSymLen = *Data++;
+			D.MinSymLen = *Data++;
+			D.LowestSym = Data;
+			D.Base64.assign(D.MaxSymLen - D.MinSymLen + 1, 0);
+
+			// Canonical Huffman: longer codes have lower values, so Base64[] holds the
+			// lowest code of each length left-aligned in 64 bits, in decreasing order
+			for (int i = int(D.Base64.size()) - 2; i >= 0; --i)
+			{
+				D.Base64[i] = (D.Base64[i + 1] + ReadLittle16(D.LowestSym + 2 * i) - ReadLittle16(D.LowestSym + 2 * (i + 1))) / 2;
+			}
+			for (std::size_t i = 0; i < D.Base64.size(); ++i)
+			{
+				D.Base64[i] <<= 64 - i - D.MinSymLen;
+			}
+
+			Data += D.Base64.size() * 2;
+			D.SymLen.assign(ReadLittle16(Data), 0);
+			Data += 2;
+			D.Btree = Data;
+
+			List<bool> Visited(D.SymLen.size(), false);
+			for (int Sym = 0; Sym < int(D.SymLen.size()); ++Sym)
+			{
+				if (!Visited[Sym]) { D.SymLen[Sym] = SetSymLen(D, Sym, Visited); }
+			}
+			return Data + D.SymLen.size() * 3 + (D.SymLen.size() & 1);
+		}
+
+		const std::uint8_t* AlignTo(const std::uint8_t* Data, std::uintptr_t Alignment)
+		{
+			return Data + ((Alignment - std::uintptr_t(Data) % Alignment) % Alignment);
+		}
+
+		const std::uint8_t* SetDtzMap(Table& Entry, const std::uint8_t* Data, int MaxFile)
+		{
+			const std::uint8_t* Map = Data;
+			Entry.Files[TableDtz].Map = Map;
+
+			for (int File = 0; File <= MaxFile; ++File)
+			{
+				PairsData& D = *Entry.Get(TableDtz, 0, File);
+				if (!(D.Flags & FlagMapped)) { continue; }
+
+				if (D.Flags & FlagWide)
+				{
+					Data = AlignTo(Data, 2);
+					for (int i = 0; i < 4; ++i)
+					{
+						D.MapIdx[i] = std::uint32_t(Data - Map + 2);
+						Data += 2 * ReadLittle16(Data) + 2;
+					}
+				}
+				else
+				{
+					for (int i = 0; i < 4; ++i)
+					{
+						D.MapIdx[i] = std::uint32_t(Data - Map + 1);
+						Data += *Data + 1;
+					}
+				}
+			}
+			return AlignTo(Data, 2);
+		}
+
+		void SetupTable(Table& Entry, int Type, const std::uint8_t* Data)
+		{
+			Data++;		// Split and pawn flags, already known from the material
+
+			const int Sides = Type == TableWdl && Entry.Key != Entry.Key2 ? 2 : 1;
+			const int MaxFile = Entry.bHasPawns ? 3 : 0;
+			const bool bBothPawns = Entry.bHasPawns && Entry.PawnCount[1];
+
+			for (int File = 0; File <= MaxFile; ++File)
+			{
+				for (int i = 0; i < Sides; ++i)
+				{
+					*Entry.Get(Type, i, File) = PairsData{};
+				}
+
+				const int Order[2][2] = {
+					{ Data[0] & 0xF, bBothPawns ? Data[1] & 0xF : 0xF },
+					{ Data[0] >> 4, bBothPawns ? Data[1] >> 4 : 0xF }
+				};
+				Data += 1 + bBothPawns;
+
+				for (int K = 0; K < Entry.PieceCount; ++K, ++Data)
+				{
+					for (int i = 0; i < Sides; ++i)
+					{
+						Entry.Get(Type, i, File)->Pieces[K] = EPiece(i ? *Data >> 4 : *Data & 0xF);
+					}
+				}
+
+				for (int i = 0; i < Sides; ++i)
+				{
+					SetGroups(Entry, *Entry.Get(Type, i, File), Order[i], File);
+				}
+			}
+
+			Data = AlignTo(Data, 2);
+			for (int File = 0; File <= MaxFile; ++File)
+			{
+				for (int i = 0; i < Sides; ++i)
+				{
+					Data = SetSizes(*Entry.Get(Type, i, File), Data);
+				}
+			}
+
+			if (Type == TableDtz)
+			{
+				Data = SetDtzMap(Entry, Data, MaxFile);
+			}
+
+			for (int File = 0; File <= MaxFile; ++File)
+			{
+				for (int i = 0; i < Sides; ++i)
+				{
+					PairsData& D = *Entry.Get(Type, i, File);
+					D.SparseIndex = Data;
+					Data += D.SparseIndexSize * 6;
+				}
+			}
+			for (int File = 0; File <= MaxFile; ++File)
+			{
+				for (int i = 0; i < Sides; ++i)
+				{
+					PairsData& D = *Entry.Get(Type, i, File);
+					D.BlockLength = Data;
+					Data += D.BlockLengthSize * 2;
+				}
+			}
+			for (int File = 0; File <= MaxFile; ++File)
+			{
+				for (int i = 0; i < Sides; ++i)
+				{
+					PairsData& D = *Entry.Get(Type, i, File);
+					Data = AlignTo(Data, 64);
+					D.Data = Data;
+					Data += std::size_t(D.NumBlocks) * D.BlockSize;
+				}
+			}
+		}
+
+		// ------------------------------------------------
+		// Decompression
+		// ------------------------------------------------
+		int DecompressPairs(const PairsData& D, std::uint64_t Index)
+		{
+			if (D.Flags & FlagSingleValue) { return D.MinSymLen; }
+
+			// The sparse index points near the value; walk neighbouring blocks from there
+			const std::uint8_t* Sparse = D.SparseIndex + 6 * std::size_t(Index / D.Span);
+			std::uint32_t Block = ReadLittle32(Sparse);
+			int Offset = ReadLittle16(Sparse + 4) + int(Index % D.Span) - int(D.Span / 2);
+
+			while (Offset < 0)
+			{
+				Offset += D.GetBlockLength(--Block) + 1;
+			}
+			while (Offset > D.GetBlockLength(Block))
+			{
+				Offset -= D.GetBlockLength(Block++) + 1;
+			}
+
+			const std::uint8_t* Ptr = D.Data + std::uint64_t(Block) * D.BlockSize;
+			std::uint64_t Buffer = ReadBig64(Ptr);
+			Ptr += 8;
+			int BufferBits = 64;
+			int Sym = 0;
+
+			while (true)
+			{
+				int Length = 0;
+				while (Buffer < D.Base64[Length])
+				{
+					++Length;
+				}
+
+				Sym = int((Buffer - D.Base64[Length]) >> (64 - Length - D.MinSymLen));
+				Sym += ReadLittle16(D.LowestSym + 2 * Length);
+				if (Offset < D.SymLen[Sym] + 1) { break; }
+
+				Offset -= D.SymLen[Sym] + 1;
+				Length += D.MinSymLen;
+				Buffer <<= Length;
+				BufferBits -= Length;
+				if (BufferBits <= 32)
+				{
+					BufferBits += 32;
+					Buffer |= std::uint64_t(ReadBig32(Ptr)) << (64 - BufferBits);
+					Ptr += 4;
+				}
+			}
+
+			// Expand the pair tree down to the leaf holding our value
+			while (D.SymLen[Sym])
+			{
+				const int Left = D.LeftSymbol(Sym);
+				if (Offset < D.SymLen[Left] + 1)
+				{
+					Sym = Left;
+				}
+				else
+				{
+					Offset -= D.SymLen[Left] + 1;
+					Sym = D.RightSymbol(Sym);
+				}
+			}
+			return D.LeftSymbol(Sym);
+		}
+
+		// DTZ values are stored by frequency rank per WDL class; map them back to plies
+		int MapDtzScore(Table& Entry, int File, int Value, int Wdl)
+		{
+			static constexpr int WdlMap[] = { 1, 3, 0, 2, 0 };
+			const PairsData& D = *Entry.Get(TableDtz, 0, File);
+			const std::uint8_t* Map = Entry.Files[TableDtz].Map;
+
+			if (D.Flags & FlagMapped)
+			{
+				const std::uint32_t Offset = D.MapIdx[WdlMap[Wdl + 2]];
+				Value = D.Flags & FlagWide ? ReadLittle16(Map + Offset + 2 * Value) : Map[Offset + Value];
+			}
+
+			if ((Wdl == WdlWin && !(D.Flags & FlagWinPlies))
+				|| (Wdl == WdlLoss && !(D.Flags & FlagLossPlies))
+				|| Wdl == WdlCursedWin
+				|| Wdl == WdlBlessedLoss)
+			{
+				Value *= 2;
+			}
+			return Value + 1;
+		}
+	}
+
+	// ----------------------------------------------------
+	// Tablebase Set
+	// ----------------------------------------------------
+	SyzygyTablebases::SyzygyTablebases()
+		: Paths{}
+		, Tables{}
+		, TablesByKey{}
+		, MaxCardinality{ 0 }
+		, MapMutex{}
+	{
+	}
+
+	SyzygyTablebases::~SyzygyTablebases() = default;
+
+	int SyzygyTablebases::Init(const string& InPaths)
+	{
+		Paths.clear();
+		Tables.clear();
+		TablesByKey.clear();
+		MaxCardinality = 0;
+
+#ifdef _WIN32
+		constexpr char Separator = ';';
+#else
+		constexpr char Separator = ':';
+#endif
+		std::size_t Start = 0;
+		while (Start <= InPaths.size())
+		{
+			const std::size_t End = std::min(InPaths.find(Separator, Start), InPaths.size());
+			if (End > Start) { Paths.push_back(InPaths.substr(Start, End - Start)); }
+			Start = End + 1;
+		}
+		if (Paths.empty()) { return 0; }
+
+		Encoding();
+
+		// Every material split with the stronger or equal side first, up to seven pieces
+		for (int P1 = Pawn; P1 < King; ++P1)
+		{
+			AddTable({ King, EPieceType(P1), King });
+
+			for (int P2 = Pawn; P2 <= P1; ++P2)
+			{
+				AddTable({ King, EPieceType(P1), EPieceType(P2), King });
+				AddTable({ King, EPieceType(P1), King, EPieceType(P2) });
+
+				for (int P3 = Pawn; P3 < King; ++P3)
+				{
+					AddTable({ King, EPieceType(P1), EPieceType(P2), King, EPieceType(P3) });
+				}
+
+				for (int P3 = Pawn; P3 <= P2; ++P3)
+				{
+					AddTable({ King, EPieceType(P1), EPieceType(P2), EPieceType(P3), King });
+
+					for (int P4 = Pawn; P4 <= P3; ++P4)
+					{
+						AddTable({ King, EPieceType(P1), EPieceType(P2), EPieceType(P3), EPieceType(P4), King });
+
+						for (int P5 = Pawn; P5 <= P4; ++P5)
+						{
+							AddTable({ King, EPieceType(P1), EPieceType(P2), EPieceType(P3), EPieceType(P4), EPieceType(P5), King });
+						}
+						for (int P5 = Pawn; P5 < King; ++P5)
+						{
+							AddTable({ King, EPieceType(P1), EPieceType(P2), EPieceType(P3), EPieceType(P4), King, EPieceType(P5) });
+						}
+					}
+
+					for (int P4 = Pawn; P4 < King; ++P4)
+					{
+						AddTable({ King, EPieceType(P1), EPieceType(P2), EPieceType(P3), King, EPieceType(P4) });
+
+						for (int P5 = Pawn; P5 <= P4; ++P5)
+						{
+							AddTable({ King, EPieceType(P1), EPieceType(P2), EPieceType(P3), King, EPieceType(P4), EPieceType(P5) });
+						}
+					}
+				}
+
+				for (int P3 = Pawn; P3 <= P1; ++P3)
+				{
+					for (int P4 = Pawn; P4 <= (P1 == P3 ? P2 : P3); ++P4)
+					{
+						AddTable({ King, EPieceType(P1), EPieceType(P2), King, EPieceType(P3), EPieceType(P4) });
+					}
+				}
+			}
+		}
+
+		LOG("Found %zu Syzygy tablebases, up to %d pieces", Tables.size(), MaxCardinality);
+		return int(Tables.size());
+	}
+
+	void SyzygyTablebases::AddTable(const List<EPieceType>& Pieces)
+	{
+		string Name;
+		int Counts[ColorCount][PieceTypeCount] = {};
+		int Color = -1;
+		for (EPieceType Type : Pieces)
+		{
+			if (Type == King)
+			{
+				if (++Color == Black) { Name += 'v'; }
+			}
+			Name += PieceLetters[Type];
+			++Counts[Color][Type];
+		}
+
+		// Only the WDL file decides whether a table is available
+		const bool bFound = std::any_of(Paths.begin(), Paths.end(), [&Name](const string& Path)
+		{
+			std::error_code Error;
+			return std::filesystem::is_regular_file(Path + "/" + Name + ".rtbw", Error);
+		});
+		if (!bFound) { return; }
+
+		unique<Table> Entry = std::make_unique<Table>();
+		Entry->Name = Name;
+		Entry->PieceCount = int(Pieces.size());
+		Entry->bHasPawns = Counts[White][Pawn] + Counts[Black][Pawn] > 0;
+		Entry->Key = MaterialKey(Counts);
+		std::swap(Counts[White], Counts[Black]);
+		Entry->Key2 = MaterialKey(Counts);
+		std::swap(Counts[White], Counts[Black]);
+
+		for (int Side = White; Side <= Black; ++Side)
+		{
+			for (int Type = Pawn; Type <= Queen; ++Type)
+			{
+				Entry->bHasUniquePieces |= Counts[Side][Type] == 1;
+			}
+		}
+
+		// The leading colour is the one with fewer pawns, which compresses better
+		const bool bWhiteLeads = !Counts[Black][Pawn] || (Counts[White][Pawn] && Counts[Black][Pawn] >= Counts[White][Pawn]);
+		Entry->PawnCount[0] = std::uint8_t(Counts[bWhiteLeads ? White : Black][Pawn]);
+		Entry->PawnCount[1] = std::uint8_t(Counts[bWhiteLeads ? Black : White][Pawn]);
+
+		MaxCardinality = std::max(MaxCardinality, Entry->PieceCount);
+		TablesByKey[Entry->Key] = Entry.get();
+		TablesByKey[Entry->Key2] = Entry.get();
+		Tables.push_back(std::move(Entry));
+	}
+
+	bool SyzygyTablebases::MapTable(Syzygy::Table& Entry, int Type) const
+	{
+		TableFile& File = Entry.Files[Type];
+		if (File.bReady.load(std::memory_order_acquire)) { return File.bMapped; }
+
+		std::lock_guard<std::mutex> Lock{ MapMutex };
+		if (File.bReady.load(std::memory_order_relaxed)) { return File.bMapped; }
+
+		const string FileName = Entry.Name + (Type == TableWdl ? ".rtbw" : ".rtbz");
+		for (const string& Path : Paths)
+		{
+			if (File.File.Open(Path + "/" + FileName)) { break; }
+		}
+
+		const std::uint8_t* Magic = Type == TableWdl ? WdlMagic : DtzMagic;
+		if (File.File.IsOpen())
+		{
+			if (File.File.GetSize() > 4 && std::memcmp(File.File.GetData(), Magic, 4) == 0)
+			{
+				SetupTable(Entry, Type, File.File.GetData() + 4);
+				File.bMapped = true;
+			}
+			else
+			{
+				LOG("Corrupted Syzygy table %s", FileName.c_str());
+				File.File.Close();
+			}
+		}
+
+		File.bReady.store(true, std::memory_order_release);
+		return File.bMapped;
+	}
+
+	// ----------------------------------------------------
+	// Raw Table Lookup
+	// ----------------------------------------------------
+	int SyzygyTablebases::ProbeTable(const Position& Pos, int Type, int Wdl, Syzygy::EProbeState& State) const
+	{
+		if (PopCount(Pos.Pieces()) == 2) { return WdlDraw; }
+
+		const std::uint64_t Key = MaterialKey(Pos);
+		const auto Found = TablesByKey.find(Key);
+		if (Found == TablesByKey.end() || !MapTable(*Found->second, Type))
+		{
+			State = ProbeFail;
+			return 0;
+		}
+
+		Table& Entry = *Found->second;
+		const EncodingTables& Enc = Encoding();
+		const auto PawnOrder = [&Enc](Square A, Square B) { return Enc.MapPawns[A] < Enc.MapPawns[B]; };
+
+		// Tables are stored with the first named side as White. Symmetric tables
+		// only hold White to move, so Black to move is probed colour flipped too.
+		const bool bSymmetricBlackToMove = Entry.Key == Entry.Key2 && Pos.GetSideToMove() == Black;
+		const bool bBlackStronger = Key != Entry.Key;
+		const bool bFlip = bSymmetricBlackToMove || bBlackStronger;
+		const int FlipColor = bFlip ? 8 : 0;
+		const int FlipSquares = bFlip ? 56 : 0;
+		const int Stm = int(bFlip) ^ int(Pos.GetSideToMove());
+
+		Square Squares[MaxPieces];
+		EPiece Pieces[MaxPieces];
+		int Size = 0;
+		int LeadPawnCount = 0;
+		Bitboard LeadPawns = 0;
+		int TableFileIndex = 0;
+
+		// Tables with pawns are split by the file of the leading pawn
+		if (Entry.bHasPawns)
+		{
+			const EPiece LeadPiece = EPiece(Entry.Get(Type, 0, 0)->Pieces[0] ^ FlipColor);
+			LeadPawns = Pos.Pieces(ColorOf(LeadPiece), Pawn);
+			for (Bitboard B = LeadPawns; B; )
+			{
+				Squares[Size++] = PopLsb(B) ^ FlipSquares;
+			}
+			LeadPawnCount = Size;
+
+			std::swap(Squares[0], *std::max_element(Squares, Squares + LeadPawnCount, PawnOrder));
+			TableFileIndex = std::min(FileOf(Squares[0]), 7 - FileOf(Squares[0]));
+		}
+
+		// DTZ tables store a single side to move
+		if (Type == TableDtz)
+		{
+			const std::uint8_t Flags = Entry.Get(Type, Stm, TableFileIndex)->Flags;
+			if ((Flags & FlagStm) != Stm && !(Entry.Key == Entry.Key2 && !Entry.bHasPawns))
+			{
+				State = ProbeChangeStm;
+				return 0;
+			}
+		}
+
+		for (Bitboard B = Pos.Pieces() ^ LeadPawns; B; )
+		{
+			const Square Sq = PopLsb(B);
+			Squares[Size] = Sq ^ FlipSquares;
+			Pieces[Size++] = EPiece(Pos.PieceOn(Sq) ^ FlipColor);
+		}
+
+		const PairsData& D = *Entry.Get(Type, Stm, TableFileIndex);
+
+		// Reorder the pieces into the sequence the table was generated with
+		for (int i = LeadPawnCount; i < Size - 1; ++i)
+		{
+			for (int j = i + 1; j < Size; ++j)
+			{
+				if (D.Pieces[i] == Pieces[j])
+				{
+					std::swap(Pieces[i], Pieces[j]);
+					std::swap(Squares[i], Squares[j]);
+					break;
+				}
+			}
+		}
+
+		// The leading piece goes to files a-d
+		if (FileOf(Squares[0]) > 3)
+		{
+			for (int i = 0; i < Size; ++i) { Squares[i] ^= 7; }
+		}
+
+		std::uint64_t Index = 0;
+		if (Entry.bHasPawns)
+		{
+			Index = Enc.LeadPawnIdx[LeadPawnCount][Squares[0]];
+			std::stable_sort(Squares + 1, Squares + LeadPawnCount, PawnOrder);
+			for (int i = 1; i < LeadPawnCount; ++i)
+			{
+				Index += Enc.Binomial[i][Enc.MapPawns[Squares[i]]];
+			}
+		}
+		else
+		{
+			// Without pawns the leading piece also goes below rank 5 and below the a1-h8 diagonal
+			if (RankOf(Squares[0]) > 3)
+			{
+				for (int i = 0; i < Size; ++i) { Squares[i] ^= 56; }
+			}
+
+			for (int i = 0; i < D.GroupLen[0]; ++i)
+			{
+				if (!OffA1H8(Squares[i])) { continue; }
+				if (OffA1H8(Squares[i]) > 0)
+				{
+					for (int j = i; j < Size; ++j) { Squares[j] = FlipDiagonal(Squares[j]); }
+				}
+				break;
+			}
+
+			if (Entry.bHasUniquePieces)
+			{
+				const int Adjust1 = Squares[1] > Squares[0];
+				const int Adjust2 = (Squares[2] > Squares[0]) + (Squares[2] > Squares[1]);
+
+				if (OffA1H8(Squares[0]))
+				{
+					Index = (std::uint64_t(Enc.MapA1D1D4[Squares[0]]) * 63 + (Squares[1] - Adjust1)) * 62 + Squares[2] - Adjust2;
+				}
+				else if (OffA1H8(Squares[1]))
+				{
+					Index = (6 * 63 + RankOf(Squares[0]) * 28 + Enc.MapB1H1H7[Squares[1]]) * 62 + Squares[2] - Adjust2;
+				}
+				else if (OffA1H8(Squares[2]))
+				{
+					Index = 6 * 63 * 62 + 4 * 28 * 62 + RankOf(Squares[0]) * 7 * 28 + (RankOf(Squares[1]) - Adjust1) * 28 + Enc.MapB1H1H7[Squares[2]];
+				}
+				else
+				{
+					Index = 6 * 63 * 62 + 4 * 28 * 62 + 4 * 7 * 28 + RankOf(Squares[0]) * 7 * 6 + (RankOf(Squares[1]) - Adjust1) * 6 + (RankOf(Squares[2]) - Adjust2);
+				}
+			}
+			else
+			{
+				Index = Enc.MapKK[Enc.MapA1D1D4[Squares[0]]][Squares[1]];
+			}
+		}
+
+		// Remaining groups: each sorted by square, with squares already taken by
+		// earlier groups skipped
+		Index *= D.GroupIdx[0];
+		Square* GroupSquares = Squares + D.GroupLen[0];
+		bool bRemainingPawns = Entry.bHasPawns && Entry.PawnCount[1];
+
+		for (int Next = 1; D.GroupLen[Next]; ++Next)
+		{
+			std::stable_sort(GroupSquares, GroupSquares + D.GroupLen[Next]);
+			std::uint64_t GroupIndex = 0;
+			for (int i = 0; i < D.GroupLen[Next]; ++i)
+			{
+				const int Adjust = int(std::count_if(Squares, GroupSquares, [&](Square Sq) { return GroupSquares[i] > Sq; }));
+				GroupIndex += Enc.Binomial[i + 1][GroupSquares[i] - Adjust - 8 * bRemainingPawns];
+			}
+
+			bRemainingPawns = false;
+			Index += GroupIndex * D.GroupIdx[Next];
+			GroupSquares += D.GroupLen[Next];
+		}
+
+		const int Value = DecompressPairs(D, Index);
+		return Type == TableWdl ? Value - 2 : MapDtzScore(Entry, TableFileIndex, Value, Wdl);
+	}
+
+	// ----------------------------------------------------
+	// WDL and DTZ Probes
+	// ----------------------------------------------------
+	// Tables store "don't care" values wherever a capture (or, for DTZ, a pawn
+	// move) decides the result, and nothing for en passant, so those moves are
+	// searched and combined with the stored value.
+	int SyzygyTablebases::SearchWdl(Position& Pos, Syzygy::EProbeState& State, bool bCheckZeroingMoves) const
+	{
+		MoveList Moves;
+		GenerateLegalMoves(Pos, Moves);
+
+		int BestValue = WdlLoss;
+		int ZeroingCount = 0;
+		for (Move Candidate : Moves)
+		{
+			if (!Candidate.IsCapture() && (!bCheckZeroingMoves || TypeOf(Pos.PieceOn(Candidate.From())) != Pawn)) { continue; }
+
+			++ZeroingCount;
+			Pos.MakeMove(Candidate);
+			const int Value = -SearchWdl(Pos, State, false);
+			Pos.UnmakeMove(Candidate);
+
+			if (State == ProbeFail) { return WdlDraw; }
+			if (Value > BestValue)
+			{
+				BestValue = Value;
+				if (Value >= WdlWin)
+				{
+					State = ProbeZeroingBestMove;
+					return Value;
+				}
+			}
+		}
+
+		const bool bNoMoreMoves = ZeroingCount && ZeroingCount == Moves.Size();
+		int Value = BestValue;
+		if (!bNoMoreMoves)
+		{
+			Value = ProbeTable(Pos, TableWdl, WdlDraw, State);
+			if (State == ProbeFail) { return WdlDraw; }
+		}
+
+		if (BestValue >= Value)
+		{
+			State = BestValue > WdlDraw || bNoMoreMoves ? ProbeZeroingBestMove : ProbeOk;
+			return BestValue;
+		}
+		State = ProbeOk;
+		return Value;
+	}
+
+	int SyzygyTablebases::ProbeDtzScore(Position& Pos, Syzygy::EProbeState& State) const
+	{
+		State = ProbeOk;
+		const int Wdl = SearchWdl(Pos, State, true);
+		if (State == ProbeFail || Wdl == WdlDraw) { return 0; }
+		if (State == ProbeZeroingBestMove) { return DtzBeforeZeroing(Wdl); }
+
+		int Dtz = ProbeTable(Pos, TableDtz, Wdl, State);
+		if (State == ProbeFail) { return 0; }
+		if (State != ProbeChangeStm)
+		{
+			return (Dtz + 100 * (Wdl == WdlBlessedLoss || Wdl == WdlCursedWin)) * SignOf(Wdl);
+		}
+
+		// The table holds the other side to move: take the best reply one ply deeper
+		MoveList Moves;
+		GenerateLegalMoves(Pos, Moves);
+
+		int MinDtz = 0xFFFF;
+		for (Move Candidate : Moves)
+		{
+			const bool bZeroing = Candidate.IsCapture() || TypeOf(Pos.PieceOn(Candidate.From())) == Pawn;
+
+			Pos.MakeMove(Candidate);
+			Dtz = bZeroing ? -DtzBeforeZeroing(SearchWdl(Pos, State, false)) : -ProbeDtzScore(Pos, State);
+
+			if (Dtz == 1 && Pos.IsInCheck() && !HasLegalMove(Pos))
+			{
+				MinDtz = 1;
+			}
+			if (!bZeroing)
+			{
+				Dtz += SignOf(Dtz);
+			}
+			if (Dtz < MinDtz && SignOf(Dtz) == SignOf(Wdl))
+			{
+				MinDtz = Dtz;
+			}
+			Pos.UnmakeMove(Candidate);
+
+			if (State == ProbeFail) { return 0; }
+		}
+		return MinDtz == 0xFFFF ? -1 : MinDtz;
+	}
+
+	bool SyzygyTablebases::ProbeWdl(Position& Pos, Syzygy::EWdlScore& OutWdl) const
+	{
+		if (!CanProbe(Pos)) { return false; }
+
+		EProbeState State = ProbeOk;
+		const int Wdl = SearchWdl(Pos, State, false);
+		if (State == ProbeFail) { return false; }
+
+		OutWdl = EWdlScore(Wdl);
+		return true;
+	}
+
+	bool SyzygyTablebases::ProbeDtz(Position& Pos, int& OutDtz) const
+	{
+		if (!CanProbe(Pos)) { return false; }
+
+		EProbeState State = ProbeOk;
+		OutDtz = ProbeDtzScore(Pos, State);
+		return State != ProbeFail;
+	}
+
+	bool SyzygyTablebases::ProbeRoot(Position& Pos, Syzygy::RootProbe& OutProbe) const
+	{
+		if (!CanProbe(Pos)) { return false; }
+
+		MoveList Moves;
+		GenerateLegalMoves(Pos, Moves);
+		if (Moves.Size() == 0) { return false; }
+
+		const int Rule50 = Pos.GetHalfmoveClock();
+		int BestRank = INT_MIN;
+		OutProbe.BestMoves.clear();
+
+		for (Move Candidate : Moves)
+		{
+			EProbeState State = ProbeOk;
+			int Dtz = 0;
+
+			Pos.MakeMove(Candidate);
+			if (Pos.GetHalfmoveClock() == 0)
+			{
+				Dtz = DtzBeforeZeroing(-SearchWdl(Pos, State, false));
+			}
+			else if (!Pos.IsRepetition(0))
+			{
+				Dtz = -ProbeDtzScore(Pos, State);
+				Dtz += SignOf(Dtz);
+			}
+
+			// A mating move always counts as one ply
+			if (Dtz == 2 && Pos.IsInCheck() && !HasLegalMove(Pos))
+			{
+				Dtz = 1;
+			}
+			Pos.UnmakeMove(Candidate);
+
+			if (State == ProbeFail) { return false; }
+
+			// Safe wins by shortest DTZ, then wins the fifty-move rule may spoil,
+			// draws, and finally losses by longest DTZ
+			const int Rank = Dtz > 0 ? (Dtz + Rule50 <= 99 ? 20000 : 10000) - Dtz
+				: Dtz < 0 ? (-Dtz + Rule50 <= 99 ? -20000 : -10000) - Dtz
+				: 0;
+
+			if (Rank > BestRank)
+			{
+				BestRank = Rank;
+				OutProbe.BestMoves.clear();
+				OutProbe.Dtz = Dtz;
+			}
+			if (Rank == BestRank)
+			{
+				OutProbe.BestMoves.push_back(Candidate);
+			}
+		}
+
+		OutProbe.Wdl = OutProbe.Dtz > 0 ? (BestRank > 10000 ? WdlWin : WdlCursedWin)
+			: OutProbe.Dtz < 0 ? (BestRank < -10000 ? WdlLoss : WdlBlessedLoss)
+			: WdlDraw;
+		return true;
+	}
+}
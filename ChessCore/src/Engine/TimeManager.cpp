@@ -0,0 +1,61 @@
+#include "Engine/TimeManager.h"
+#include <algorithm>
+
+namespace we
+{
+	namespace
+	{
+		constexpr std::int64_t MoveOverheadMs = 30;		// GUI and frame latency between moves
+		constexpr int DefaultMovesToGo = 30;
+		constexpr int MaxMovesToGo = 50;
+	}
+
+	TimeManager::TimeManager()
+		: StartTime{}
+		, SoftLimitUs{ 0 }
+		, HardLimitUs{ 0 }
+	{
+	}
+
+	void TimeManager::Init(const SearchLimits& Limits, EColor Us)
+	{
+		StartTime = std::chrono::steady_clock::now();
+		SoftLimitUs = 0;
+		HardLimitUs = 0;
+		if (Limits.bInfinite) { return; }
+
+		if (Limits.MoveTime > 0)
+		{
+			SoftLimitUs = HardLimitUs = Limits.MoveTime * 1000;
+			return;
+		}
+
+		const std::int64_t Remaining = Limits.Time[Us];
+		if (Remaining <= 0) { return; }
+
+		const int MovesToGo = Limits.MovesToGo > 0 ? std::min(Limits.MovesToGo, MaxMovesToGo) : DefaultMovesToGo;
+		const std::int64_t Available = std::max<std::int64_t>(Remaining - MoveOverheadMs, 1);
+
+		// Most of the increment is spent at once; the rest builds a reserve
+		const std::int64_t SoftMs = Available / MovesToGo + Limits.Increment[Us] * 3 / 4;
+		const std::int64_t HardMs = std::min(Available, SoftMs * 4);
+		SoftLimitUs = std::clamp<std::int64_t>(SoftMs, 1, HardMs) * 1000;
+		HardLimitUs = HardMs * 1000;
+	}
+
+	std::int64_t TimeManager::GetElapsedUs() const
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - StartTime).count();
+	}
+
+	bool TimeManager::CanStartIteration(std::int64_t LastIterationMs) const
+	{
+		if (!HardLimitUs) { return true; }
+
+		const std::int64_t Elapsed = GetElapsedUs();
+		if (Elapsed >= SoftLimitUs) { return false; }
+
+		// A fixed move time is always used up in full
+		return SoftLimitUs == HardLimitUs || Elapsed + LastIterationMs * 1000 * 2 <= HardLimitUs;
+	}
+}
@@ -0,0 +1,152 @@
+#include "Engine/TranspositionTable.h"
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace we
+{
+	namespace
+	{
+		// Data layout: move 0-15, score 16-31, static eval 32-47, depth 48-55, bound 56-57, generation 58-63
+		Move UnpackMove(std::uint64_t Data) { return Move{ std::uint16_t(Data & 0xFFFF) }; }
+		int UnpackScore(std::uint64_t Data) { return std::int16_t((Data >> 16) & 0xFFFF); }
+		int UnpackEval(std::uint64_t Data) { return std::int16_t((Data >> 32) & 0xFFFF); }
+		int UnpackDepth(std::uint64_t Data) { return int((Data >> 48) & 0xFF); }
+		EBound UnpackBound(std::uint64_t Data) { return EBound((Data >> 56) & 3); }
+		int UnpackGeneration(std::uint64_t Data) { return int(Data >> 58); }
+	}
+
+	TranspositionTable::TranspositionTable()
+		: Buckets{}
+		, BucketCount{ 0 }
+		, SizeMegaBytes{ 0 }
+		, Generation{ 0 }
+	{
+		Resize(16);
+	}
+
+	void TranspositionTable::Resize(std::size_t MegaBytes)
+	{
+		MegaBytes = std::max<std::size_t>(MegaBytes, 1);
+
+		// Power of two bucket count so indexing is a mask
+		std::size_t Count = 1;
+		while (Count * 2 * sizeof(Bucket) <= MegaBytes * 1024 * 1024)
+		{
+			Count *= 2;
+		}
+
+		Buckets = std::make_unique<Bucket[]>(Count);
+		BucketCount = Count;
+		SizeMegaBytes = MegaBytes;
+		Generation = 0;
+	}
+
+	void TranspositionTable::Clear()
+	{
+		for (std::size_t i = 0; i < BucketCount; ++i)
+		{
+			for (Entry& Slot : Buckets[i].Entries)
+			{
+				Slot.KeyXorData.store(0, std::memory_order_relaxed);
+				Slot.Data.store(0, std::memory_order_relaxed);
+			}
+		}
+		Generation = 0;
+	}
+
+	bool TranspositionTable::Probe(HashKey Key, TTHit& OutHit) const
+	{
+		const Bucket& Target = BucketFor(Key);
+		for (const Entry& Slot : Target.Entries)
+		{
+			const std::uint64_t Data = Slot.Data.load(std::memory_order_relaxed);
+			if ((Slot.KeyXorData.load(std::memory_order_relaxed) ^ Data) != Key || Data == 0) { continue; }
+
+			OutHit.BestMove = UnpackMove(Data);
+			OutHit.Score = UnpackScore(Data);
+			OutHit.StaticEval = UnpackEval(Data);
+			OutHit.Depth = UnpackDepth(Data);
+			OutHit.Bound = UnpackBound(Data);
+			return true;
+		}
+		return false;
+	}
+
+	void TranspositionTable::Store(HashKey Key, Move BestMove, int Score, int StaticEval, int Depth, EBound Bound)
+	{
+		Bucket& Target = BucketFor(Key);
+		Entry* Replace = &Target.Entries[0];
+		int ReplaceWorth = 1 << 30;
+
+		for (Entry& Slot : Target.Entries)
+		{
+			const std::uint64_t Data = Slot.Data.load(std::memory_order_relaxed);
+			if ((Slot.KeyXorData.load(std::memory_order_relaxed) ^ Data) == Key)
+			{
+				// Keep a deeper result for the same position unless this one is exact
+				if (Bound != BoundExact && Depth + 3 < UnpackDepth(Data) && UnpackGeneration(Data) == Generation)
+				{
+					return;
+				}
+				if (BestMove.IsNull())
+				{
+					BestMove = UnpackMove(Data);
+				}
+				Replace = &Slot;
+				break;
+			}
+
+			// Prefer overwriting shallow entries from old searches
+			const int Age = (Generation - UnpackGeneration(Data)) & GenerationMask;
+			const int Worth = UnpackDepth(Data) - 8 * Age;
+			if (Worth < ReplaceWorth)
+			{
+				ReplaceWorth = Worth;
+				Replace = &Slot;
+			}
+		}
+
+		const std::uint64_t Data = Pack(BestMove, Score, StaticEval, Depth, Bound, Generation);
+		Replace->KeyXorData.store(Key ^ Data, std::memory_order_relaxed);
+		Replace->Data.store(Data, std::memory_order_relaxed);
+	}
+
+	void TranspositionTable::Prefetch(HashKey Key) const
+	{
+#if defined(_MSC_VER)
+		_mm_prefetch(reinterpret_cast<const char*>(&BucketFor(Key)), _MM_HINT_T0);
+#else
+		__builtin_prefetch(&BucketFor(Key));
+#endif
+	}
+
+	int TranspositionTable::Hashfull() const
+	{
+		const std::size_t Samples = std::min<std::size_t>(BucketCount, 1000 / BucketSize + 1);
+		int Used = 0;
+		int Total = 0;
+		for (std::size_t i = 0; i < Samples; ++i)
+		{
+			for (const Entry& Slot : Buckets[i].Entries)
+			{
+				const std::uint64_t Data = Slot.Data.load(std::memory_order_relaxed);
+				Used += Data != 0 && UnpackGeneration(Data) == Generation;
+				++Total;
+			}
+		}
+		return Total ? Used * 1000 / Total : 0;
+	}
+
+	std::uint64_t TranspositionTable::Pack(Move BestMove, int Score, int StaticEval, int Depth, EBound Bound, int InGeneration)
+	{
+		return std::uint64_t(BestMove.Data)
+			| std::uint64_t(std::uint16_t(std::int16_t(Score))) << 16
+			| std::uint64_t(std::uint16_t(std::int16_t(StaticEval))) << 32
+			| std::uint64_t(std::clamp(Depth, 0, 255)) << 48
+			| std::uint64_t(Bound) << 56
+			| std::uint64_t(InGeneration) << 58;
+	}
+}
@@ -0,0 +1,386 @@
+#include "Engine/UciEngine.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+namespace we
+{
+	namespace
+	{
+		constexpr int IdleWaitMs = 10;					// Longest the I/O thread sleeps with nothing to do
+		constexpr auto QuitGracePeriod = std::chrono::seconds(1);
+	}
+
+	UciEngine::UciEngine()
+		: Process{}
+		, IoThread{}
+		, bRunning{ false }
+		, bUciOk{ false }
+		, bQuitRequested{ false }
+		, PendingSearches{ 0 }
+		, bPondering{ false }
+		, Lock{}
+		, Outbox{}
+		, HandshakeBytes{ 0 }
+		, Roots{}
+		, LastInfo{}
+		, LastResult{}
+		, Name{}
+		, SentMultiPv{ 1 }
+	{
+	}
+
+	UciEngine::~UciEngine()
+	{
+		Quit();
+	}
+
+	bool UciEngine::Launch(const string& Path, const List<string>& Arguments)
+	{
+		Quit();
+		if (!Process.Launch(Path, Arguments))
+		{
+			LOG("Cannot start engine %s", Path.c_str());
+			return false;
+		}
+
+		bRunning = true;
+		bUciOk = false;
+		bQuitRequested = false;
+		SentMultiPv = 1;
+		{
+			std::lock_guard<std::mutex> Guard{ Lock };
+			Outbox = "uci\n";
+			HandshakeBytes = Outbox.size();
+		}
+		Send("isready");
+		IoThread = std::thread(&UciEngine::RunIo, this);
+		return true;
+	}
+
+	void UciEngine::Quit()
+	{
+		if (!IoThread.joinable()) { return; }
+
+		Send("quit");
+		bQuitRequested = true;
+		IoThread.join();
+		Process.Terminate();
+		FinishSearches();
+	}
+
+	string UciEngine::GetName() const
+	{
+		std::lock_guard<std::mutex> Guard{ Lock };
+		return Name;
+	}
+
+	// ----------------------------------------------------
+	// Commands
+	// ----------------------------------------------------
+	void UciEngine::Send(const string& Command)
+	{
+		std::lock_guard<std::mutex> Guard{ Lock };
+		Outbox += Command;
+		Outbox += '\n';
+	}
+
+	void UciEngine::SetOption(const string& OptionName, const string& Value)
+	{
+		Send("setoption name " + OptionName + " value " + Value);
+	}
+
+	void UciEngine::NewGame()
+	{
+		Send("ucinewgame");
+		Send("isready");
+	}
+
+	void UciEngine::Start(const Position& Pos, const SearchLimits& Limits)
+	{
+		std::lock_guard<std::mutex> Guard{ Lock };
+		if (!bRunning)
+		{
+			LastResult = SearchResult{};
+			return;
+		}
+		if (!Roots.empty())
+		{
+			Outbox += "stop\n";
+		}
+		if (Limits.MultiPv != SentMultiPv)
+		{
+			Outbox += "setoption name MultiPV value " + std::to_string(Limits.MultiPv) + "\n";
+			SentMultiPv = Limits.MultiPv;
+		}
+		Outbox += "position fen " + Pos.GetFen() + "\n";
+		Outbox += FormatGo(Limits) + "\n";
+
+		Roots.push_back(Pos);
+		LastInfo = SearchInfo{};
+		bPondering = Limits.bPonder;
+		PendingSearches = int(Roots.size());
+	}
+
+	void UciEngine::Stop()
+	{
+		if (PendingSearches > 0)
+		{
+			Send("stop");
+		}
+	}
+
+	void UciEngine::PonderHit()
+	{
+		if (bPondering.exchange(false))
+		{
+			Send("ponderhit");
+		}
+	}
+
+	SearchResult UciEngine::GetLastResult() const
+	{
+		std::lock_guard<std::mutex> Guard{ Lock };
+		return LastResult;
+	}
+
+	string UciEngine::FormatGo(const SearchLimits& Limits)
+	{
+		std::ostringstream Go;
+		Go << "go";
+		if (Limits.bPonder) { Go << " ponder"; }
+		if (Limits.bInfinite) { Go << " infinite"; }
+		if (Limits.Time[White] > 0) { Go << " wtime " << Limits.Time[White]; }
+		if (Limits.Time[Black] > 0) { Go << " btime " << Limits.Time[Black]; }
+		if (Limits.Increment[White] > 0) { Go << " winc " << Limits.Increment[White]; }
+		if (Limits.Increment[Black] > 0) { Go << " binc " << Limits.Increment[Black]; }
+		if (Limits.MovesToGo > 0) { Go << " movestogo " << Limits.MovesToGo; }
+		if (Limits.MoveTime > 0) { Go << " movetime " << Limits.MoveTime; }
+		if (Limits.Depth > 0) { Go << " depth " << Limits.Depth; }
+		if (Limits.Nodes > 0) { Go << " nodes " << Limits.Nodes; }
+		if (!Limits.SearchMoves.empty())
+		{
+			Go << " searchmoves";
+			for (Move Each : Limits.SearchMoves)
+			{
+				Go << " " << MoveToUci(Each);
+			}
+		}
+		return Go.str();
+	}
+
+	// ----------------------------------------------------
+	// I/O Thread
+	// ----------------------------------------------------
+	// Writes whatever the pipe accepts, then idles until output arrives; a
+	// short wait keeps queued commands moving without a wake-up mechanism.
+	// Nothing after "uci" goes out before the engine answers uciok, as an
+	// engine may drop options and searches sent during its handshake.
+	void UciEngine::RunIo()
+	{
+		string Partial;
+		char Buffer[4096];
+		std::chrono::steady_clock::time_point QuitDeadline{};
+		bool bClosed = false;
+
+		while (!bClosed)
+		{
+			bool bNothingToWrite = true;
+			{
+				std::lock_guard<std::mutex> Guard{ Lock };
+				const std::size_t Ready = bUciOk ? Outbox.size() : std::min(Outbox.size(), HandshakeBytes);
+				if (Ready > 0)
+				{
+					const std::ptrdiff_t Written = Process.Write(Outbox.data(), Ready);
+					if (Written < 0)
+					{
+						Outbox.clear();
+						HandshakeBytes = 0;
+					}
+					else
+					{
+						Outbox.erase(0, std::size_t(Written));
+						HandshakeBytes -= std::min(HandshakeBytes, std::size_t(Written));
+					}
+				}
+				bNothingToWrite = bUciOk ? Outbox.empty() : HandshakeBytes == 0;
+			}
+
+			// An engine that never answers uciok never takes "quit" either
+			if (bQuitRequested && bNothingToWrite)
+			{
+				const auto Now = std::chrono::steady_clock::now();
+				if (QuitDeadline == std::chrono::steady_clock::time_point{}) { QuitDeadline = Now + QuitGracePeriod; }
+				if (Now >= QuitDeadline) { break; }
+			}
+
+			Process.WaitReadable(bNothingToWrite ? IdleWaitMs : 1);
+			for (;;)
+			{
+				const std::ptrdiff_t BytesRead = Process.Read(Buffer, sizeof(Buffer));
+				if (BytesRead == 0) { break; }
+				if (BytesRead < 0)
+				{
+					bClosed = true;
+					break;
+				}
+				Partial.append(Buffer, std::size_t(BytesRead));
+			}
+
+			std::size_t LineStart = 0;
+			for (std::size_t LineEnd = Partial.find('\n'); LineEnd != string::npos; LineEnd = Partial.find('\n', LineStart))
+			{
+				string Line = Partial.substr(LineStart, LineEnd - LineStart);
+				if (!Line.empty() && Line.back() == '\r') { Line.pop_back(); }
+				HandleLine(Line);
+				LineStart = LineEnd + 1;
+			}
+			Partial.erase(0, LineStart);
+		}
+
+		if (bClosed && !bQuitRequested)
+		{
+			LOG("External engine exited");
+		}
+		bRunning = false;
+		FinishSearches();
+	}
+
+	// A search the engine can no longer answer ends without a move
+	void UciEngine::FinishSearches()
+	{
+		std::lock_guard<std::mutex> Guard{ Lock };
+		if (!Roots.empty())
+		{
+			LastResult = SearchResult{};
+			Roots.clear();
+		}
+		bPondering = false;
+		PendingSearches = 0;
+	}
+
+	void UciEngine::HandleLine(const string& Line)
+	{
+		std::istringstream Tokens{ Line };
+		string Command;
+		Tokens >> Command;
+
+		if (Command == "info")
+		{
+			SearchInfo Info;
+			{
+				// Lines of a stopped search still arriving are dropped
+				std::lock_guard<std::mutex> Guard{ Lock };
+				if (Roots.size() != 1 || !ParseInfo(Line, Roots.front(), Info)) { return; }
+				if (Info.MultiPv == 1)
+				{
+					LastInfo = Info;
+				}
+			}
+			if (OnInfo)
+			{
+				OnInfo(Info);
+			}
+		}
+		else if (Command == "bestmove")
+		{
+			string BestText, PonderWord, PonderText;
+			Tokens >> BestText >> PonderWord >> PonderText;
+
+			SearchResult Result;
+			{
+				std::lock_guard<std::mutex> Guard{ Lock };
+				if (Roots.empty()) { return; }
+
+				const Position Root = Roots.front();
+				Roots.erase(Roots.begin());
+				if (!Roots.empty())
+				{
+					PendingSearches = int(Roots.size());
+					return;
+				}
+
+				Result.BestMove = ParseUciMove(Root, BestText);
+				if (!Result.BestMove.IsNull() && PonderWord == "ponder")
+				{
+					Position AfterBest = Root;
+					AfterBest.MakeMove(Result.BestMove);
+					Result.PonderMove = ParseUciMove(AfterBest, PonderText);
+				}
+				Result.Score = LastInfo.Score;
+				Result.Depth = LastInfo.Depth;
+				Result.Nodes = LastInfo.Nodes;
+				LastResult = Result;
+				bPondering = false;
+				PendingSearches = 0;
+			}
+			if (OnBestMove)
+			{
+				OnBestMove(Result);
+			}
+		}
+		else if (Command == "id")
+		{
+			string Field;
+			Tokens >> Field;
+			if (Field == "name")
+			{
+				std::lock_guard<std::mutex> Guard{ Lock };
+				std::getline(Tokens >> std::ws, Name);
+			}
+		}
+		else if (Command == "uciok")
+		{
+			bUciOk = true;
+		}
+	}
+
+	// Only lines carrying a score and a principal variation are reported
+	bool UciEngine::ParseInfo(const string& Line, const Position& Root, SearchInfo& OutInfo) const
+	{
+		std::istringstream Tokens{ Line };
+		string Token;
+		Tokens >> Token;
+
+		bool bHasScore = false;
+		while (Tokens >> Token)
+		{
+			if (Token == "depth") { Tokens >> OutInfo.Depth; }
+			else if (Token == "seldepth") { Tokens >> OutInfo.SelDepth; }
+			else if (Token == "multipv") { Tokens >> OutInfo.MultiPv; }
+			else if (Token == "nodes") { Tokens >> OutInfo.Nodes; }
+			else if (Token == "time") { Tokens >> OutInfo.TimeMs; }
+			else if (Token == "hashfull") { Tokens >> OutInfo.Hashfull; }
+			else if (Token == "string") { return false; }
+			else if (Token == "score")
+			{
+				string Kind;
+				int Value = 0;
+				Tokens >> Kind >> Value;
+				if (Kind == "cp")
+				{
+					OutInfo.Score = Value;
+				}
+				else if (Kind == "mate")
+				{
+					OutInfo.Score = Value > 0 ? MateIn(2 * Value - 1) : MatedIn(-2 * Value);
+				}
+				bHasScore = Kind == "cp" || Kind == "mate";
+			}
+			else if (Token == "pv")
+			{
+				// The rest of the line; a move that does not parse ends the line there
+				Position Walk = Root;
+				while (Tokens >> Token)
+				{
+					const Move Next = ParseUciMove(Walk, Token);
+					if (Next.IsNull()) { break; }
+					OutInfo.Pv.push_back(Next);
+					Walk.MakeMove(Next);
+				}
+			}
+		}
+		return bHasScore && !OutInfo.Pv.empty();
+	}
+}
@@ -0,0 +1,302 @@
+#include "IO/ChildProcess.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace we
+{
+	ChildProcess::ChildProcess()
+	{
+		Reset();
+	}
+
+	ChildProcess::~ChildProcess()
+	{
+		Terminate();
+	}
+
+	void ChildProcess::Reset()
+	{
+		bLaunched = false;
+#ifdef _WIN32
+		ProcessHandle = nullptr;
+		InputWrite = nullptr;
+		OutputRead = nullptr;
+#else
+		ProcessId = -1;
+		InputWrite = -1;
+		OutputRead = -1;
+#endif
+	}
+
+#ifdef _WIN32
+	bool ChildProcess::Launch(const string& Path, const List<string>& Arguments)
+	{
+		Terminate();
+
+		SECURITY_ATTRIBUTES Inherit{ sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE };
+		HANDLE InputRead = nullptr;
+		HANDLE OutputWrite = nullptr;
+		if (!CreatePipe(&InputRead, reinterpret_cast<HANDLE*>(&InputWrite), &Inherit, 0)) { return false; }
+		if (!CreatePipe(reinterpret_cast<HANDLE*>(&OutputRead), &OutputWrite, &Inherit, 0))
+		{
+			CloseHandle(InputRead);
+			ClosePipes();
+			return false;
+		}
+
+		// Only the child's ends are inherited; our write end never blocks
+		SetHandleInformation(InputWrite, HANDLE_FLAG_INHERIT, 0);
+		SetHandleInformation(OutputRead, HANDLE_FLAG_INHERIT, 0);
+		DWORD Mode = PIPE_NOWAIT;
+		SetNamedPipeHandleState(InputWrite, &Mode, nullptr, nullptr);
+
+		string CommandLine = "\"" + Path + "\"";
+		for (const string& Argument : Arguments)
+		{
+			CommandLine += " \"" + Argument + "\"";
+		}
+
+		STARTUPINFOA Startup{};
+		Startup.cb = sizeof(Startup);
+		Startup.dwFlags = STARTF_USESTDHANDLES;
+		Startup.hStdInput = InputRead;
+		Startup.hStdOutput = OutputWrite;
+		Startup.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+
+		PROCESS_INFORMATION Info{};
+		const BOOL bCreated = CreateProcessA(nullptr, CommandLine.data(), nullptr, nullptr, TRUE, CREATE_NO_WINDOW, nullptr, nullptr, &Startup, &Info);
+		CloseHandle(InputRead);
+		CloseHandle(OutputWrite);
+		if (!bCreated)
+		{
+			ClosePipes();
+			return false;
+		}
+
+		CloseHandle(Info.hThread);
+		ProcessHandle = Info.hProcess;
+		bLaunched = true;
+		return true;
+	}
+
+	void ChildProcess::Terminate()
+	{
+		if (ProcessHandle)
+		{
+			if (WaitForSingleObject(ProcessHandle, 0) == WAIT_TIMEOUT)
+			{
+				TerminateProcess(ProcessHandle, 1);
+			}
+			CloseHandle(ProcessHandle);
+		}
+		ClosePipes();
+		Reset();
+	}
+
+	bool ChildProcess::WaitForExit(int TimeoutMs)
+	{
+		return !ProcessHandle || WaitForSingleObject(ProcessHandle, DWORD(TimeoutMs)) == WAIT_OBJECT_0;
+	}
+
+	void ChildProcess::ClosePipes()
+	{
+		if (InputWrite) { CloseHandle(InputWrite); }
+		if (OutputRead) { CloseHandle(OutputRead); }
+		InputWrite = nullptr;
+		OutputRead = nullptr;
+	}
+
+	// Anonymous pipes cannot be waited on, so only bytes already in the pipe are read
+	std::ptrdiff_t ChildProcess::Read(char* Buffer, std::size_t Size)
+	{
+		if (!OutputRead) { return -1; }
+
+		DWORD Available = 0;
+		if (!PeekNamedPipe(OutputRead, nullptr, 0, nullptr, &Available, nullptr)) { return -1; }
+		if (Available == 0) { return 0; }
+
+		DWORD BytesRead = 0;
+		if (!ReadFile(OutputRead, Buffer, DWORD(std::min<std::size_t>(Size, Available)), &BytesRead, nullptr)) { return -1; }
+		return std::ptrdiff_t(BytesRead);
+	}
+
+	std::ptrdiff_t ChildProcess::Write(const char* Data, std::size_t Size)
+	{
+		if (!InputWrite) { return -1; }
+
+		DWORD Written = 0;
+		if (!WriteFile(InputWrite, Data, DWORD(Size), &Written, nullptr)) { return -1; }
+		return std::ptrdiff_t(Written);
+	}
+
+	bool ChildProcess::WaitReadable(int TimeoutMs)
+	{
+		const auto Deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TimeoutMs);
+		for (;;)
+		{
+			DWORD Available = 0;
+			if (!OutputRead || !PeekNamedPipe(OutputRead, nullptr, 0, nullptr, &Available, nullptr) || Available > 0) { return true; }
+			if (std::chrono::steady_clock::now() >= Deadline) { return false; }
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+#else
+	bool ChildProcess::Launch(const string& Path, const List<string>& Arguments)
+	{
+		Terminate();
+
+		int Input[2];
+		int Output[2];
+		if (pipe(Input) != 0) { return false; }
+		if (pipe(Output) != 0)
+		{
+			close(Input[0]);
+			close(Input[1]);
+			return false;
+		}
+
+		posix_spawn_file_actions_t Actions;
+		posix_spawn_file_actions_init(&Actions);
+		posix_spawn_file_actions_adddup2(&Actions, Input[0], STDIN_FILENO);
+		posix_spawn_file_actions_adddup2(&Actions, Output[1], STDOUT_FILENO);
+		posix_spawn_file_actions_addclose(&Actions, Input[1]);
+		posix_spawn_file_actions_addclose(&Actions, Output[0]);
+
+		List<char*> Argv;
+		Argv.push_back(const_cast<char*>(Path.c_str()));
+		for (const string& Argument : Arguments)
+		{
+			Argv.push_back(const_cast<char*>(Argument.c_str()));
+		}
+		Argv.push_back(nullptr);
+
+		pid_t Child = -1;
+		const int Error = posix_spawnp(&Child, Path.c_str(), &Actions, nullptr, Argv.data(), environ);
+		posix_spawn_file_actions_destroy(&Actions);
+		close(Input[0]);
+		close(Output[1]);
+		if (Error != 0)
+		{
+			close(Input[1]);
+			close(Output[0]);
+			return false;
+		}
+
+		for (int Descriptor : { Input[1], Output[0] })
+		{
+			fcntl(Descriptor, F_SETFL, fcntl(Descriptor, F_GETFL) | O_NONBLOCK);
+			fcntl(Descriptor, F_SETFD, FD_CLOEXEC);
+		}
+#ifdef F_SETNOSIGPIPE
+		fcntl(Input[1], F_SETNOSIGPIPE, 1);
+#endif
+
+		ProcessId = Child;
+		InputWrite = Input[1];
+		OutputRead = Output[0];
+		bLaunched = true;
+		return true;
+	}
+
+	void ChildProcess::Terminate()
+	{
+		ClosePipes();
+		if (ProcessId > 0 && waitpid(ProcessId, nullptr, WNOHANG) == 0)
+		{
+			kill(ProcessId, SIGKILL);
+			waitpid(ProcessId, nullptr, 0);
+		}
+		Reset();
+	}
+
+	bool ChildProcess::WaitForExit(int TimeoutMs)
+	{
+		const auto Deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TimeoutMs);
+		while (ProcessId > 0)
+		{
+			const pid_t Reaped = waitpid(ProcessId, nullptr, WNOHANG);
+			if (Reaped == ProcessId || (Reaped < 0 && errno == ECHILD))
+			{
+				ProcessId = -1;
+				break;
+			}
+			if (std::chrono::steady_clock::now() >= Deadline) { return false; }
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+
+	void ChildProcess::ClosePipes()
+	{
+		if (InputWrite >= 0) { close(InputWrite); }
+		if (OutputRead >= 0) { close(OutputRead); }
+		InputWrite = -1;
+		OutputRead = -1;
+	}
+
+	std::ptrdiff_t ChildProcess::Read(char* Buffer, std::size_t Size)
+	{
+		if (OutputRead < 0) { return -1; }
+
+		const ssize_t BytesRead = read(OutputRead, Buffer, Size);
+		if (BytesRead > 0) { return BytesRead; }
+		return BytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+	}
+
+	std::ptrdiff_t ChildProcess::Write(const char* Data, std::size_t Size)
+	{
+		if (InputWrite < 0) { return -1; }
+
+#ifdef F_SETNOSIGPIPE
+		const ssize_t Written = write(InputWrite, Data, Size);
+		const int WriteError = errno;
+#else
+		// A child that dies mid-write must show up as a failed write, not kill
+		// us. SIGPIPE is held back on this thread only and the one the write
+		// raised is consumed, so the application keeps its own handler.
+		sigset_t PipeSignal;
+		sigset_t Previous;
+		sigset_t Pending;
+		sigemptyset(&PipeSignal);
+		sigaddset(&PipeSignal, SIGPIPE);
+		pthread_sigmask(SIG_BLOCK, &PipeSignal, &Previous);
+		const bool bAlreadyPending = sigpending(&Pending) == 0 && sigismember(&Pending, SIGPIPE);
+
+		const ssize_t Written = write(InputWrite, Data, Size);
+		const int WriteError = errno;
+		if (Written < 0 && WriteError == EPIPE && !bAlreadyPending)
+		{
+			const timespec NoWait{ 0, 0 };
+			while (sigtimedwait(&PipeSignal, nullptr, &NoWait) < 0 && errno == EINTR) {}
+		}
+		pthread_sigmask(SIG_SETMASK, &Previous, nullptr);
+#endif
+		if (Written >= 0) { return Written; }
+		return WriteError == EAGAIN || WriteError == EWOULDBLOCK || WriteError == EINTR ? 0 : -1;
+	}
+
+	bool ChildProcess::WaitReadable(int TimeoutMs)
+	{
+		if (OutputRead < 0) { return true; }
+
+		pollfd Request{ OutputRead, POLLIN, 0 };
+		return poll(&Request, 1, TimeoutMs) > 0;
+	}
+#endif
+}
@@ -0,0 +1,118 @@
+#include "IO/Epd.h"
+#include "Rules/MoveGen.h"
+#include <fstream>
+#include <sstream>
+
+namespace we
+{
+	const List<string>* EpdRecord::FindOperation(const string& Opcode) const
+	{
+		for (const auto& Operation : Operations)
+		{
+			if (Operation.first == Opcode) { return &Operation.second; }
+		}
+		return nullptr;
+	}
+
+	string EpdRecord::GetId() const
+	{
+		const List<string>* Id = FindOperation("id");
+		return Id && !Id->empty() ? Id->front() : string{};
+	}
+
+	List<Move> EpdRecord::GetMoves(const string& Opcode) const
+	{
+		List<Move> Moves;
+		const List<string>* Operands = FindOperation(Opcode);
+		if (!Operands) { return Moves; }
+
+		Position Pos;
+		Pos.SetFromFen(Fen);
+		for (const string& Operand : *Operands)
+		{
+			const Move Parsed = ParseSanMove(Pos, Operand);
+			if (!Parsed.IsNull()) { Moves.push_back(Parsed); }
+		}
+		return Moves;
+	}
+
+	bool ParseEpdLine(const string& Line, EpdRecord& OutRecord)
+	{
+		std::istringstream Fields(Line);
+		string Board[4];
+		for (string& Field : Board)
+		{
+			if (!(Fields >> Field)) { return false; }
+		}
+		if (Board[0][0] == '#') { return false; }
+
+		EpdRecord Record;
+		string Rest;
+		std::getline(Fields, Rest);
+
+		// Operands are split on blanks except inside quotes; ';' ends an operation
+		List<string> Tokens;
+		string Token;
+		bool bQuoted = false;
+		bool bHadQuote = false;
+		auto EndToken = [&]()
+		{
+			if (!Token.empty() || bHadQuote) { Tokens.push_back(Token); }
+			Token.clear();
+			bHadQuote = false;
+		};
+		auto EndOperation = [&]()
+		{
+			EndToken();
+			if (!Tokens.empty())
+			{
+				Record.Operations.emplace_back(Tokens.front(), List<string>(Tokens.begin() + 1, Tokens.end()));
+			}
+			Tokens.clear();
+		};
+
+		for (char Each : Rest)
+		{
+			if (Each == '"') { bQuoted = !bQuoted; bHadQuote = true; }
+			else if (bQuoted) { Token += Each; }
+			else if (Each == ';') { EndOperation(); }
+			else if (Each == ' ' || Each == '\t' || Each == '\r') { EndToken(); }
+			else { Token += Each; }
+		}
+		EndOperation();
+
+		const List<string>* HalfMoves = Record.FindOperation("hmvc");
+		const List<string>* FullMoves = Record.FindOperation("fmvn");
+		Record.Fen = Board[0] + " " + Board[1] + " " + Board[2] + " " + Board[3];
+		Record.Fen += " " + (HalfMoves && !HalfMoves->empty() ? HalfMoves->front() : string{ "0" });
+		Record.Fen += " " + (FullMoves && !FullMoves->empty() ? FullMoves->front() : string{ "1" });
+
+		Position Check;
+		if (!Check.SetFromFen(Record.Fen)) { return false; }
+
+		OutRecord = std::move(Record);
+		return true;
+	}
+
+	List<EpdRecord> LoadEpdFile(const string& Path)
+	{
+		List<EpdRecord> Records;
+		std::ifstream File(Path);
+		if (!File)
+		{
+			LOG("Cannot open EPD file %s", Path.c_str());
+			return Records;
+		}
+
+		string Line;
+		EpdRecord Record;
+		while (std::getline(File, Line))
+		{
+			if (ParseEpdLine(Line, Record))
+			{
+				Records.push_back(std::move(Record));
+			}
+		}
+		return Records;
+	}
+}
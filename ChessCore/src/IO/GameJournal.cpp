@@ -0,0 +1,353 @@
+#include "IO/GameJournal.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace we
+{
+	namespace
+	{
+		constexpr char Magic[8] = { 'W', 'E', 'J', 'O', 'U', 'R', 'N', '1' };
+		constexpr std::size_t HeaderSize = 16;				// Magic, reserved
+
+		enum EEntryType : std::uint8_t
+		{
+			EntryStart = 1,				// Followed by the start position
+			EntryMove = 2,				// Value: the mover's clock in ms
+			EntrySnapshot = 3,			// Followed by the position after the moves so far
+			EntryEnd = 4
+		};
+
+		struct JournalEntry
+		{
+			std::uint8_t Type = 0;
+			std::uint8_t Check = 0;
+			std::uint16_t MoveData = 0;
+			std::int32_t Value = 0;
+		};
+
+		static_assert(sizeof(JournalEntry) == 8, "JournalEntry must stay an 8-byte record");
+
+		bool HasSnapshot(std::uint8_t Type)
+		{
+			return Type == EntryStart || Type == EntrySnapshot;
+		}
+
+		// FNV-1a over the entry, with its check byte cleared, and its snapshot
+		std::uint8_t ComputeCheck(JournalEntry Entry, const PackedPosition* Snapshot)
+		{
+			Entry.Check = 0;
+			std::uint32_t Hash = 2166136261u;
+			auto Mix = [&Hash](const void* Bytes, std::size_t Size)
+			{
+				for (std::size_t i = 0; i < Size; ++i)
+				{
+					Hash = (Hash ^ static_cast<const std::uint8_t*>(Bytes)[i]) * 16777619u;
+				}
+			};
+			Mix(&Entry, sizeof(Entry));
+			if (Snapshot)
+			{
+				Mix(Snapshot, sizeof(PackedPosition));
+			}
+			return std::uint8_t(Hash ^ Hash >> 8 ^ Hash >> 16 ^ Hash >> 24);
+		}
+
+		bool SyncToDisk(std::FILE* File)
+		{
+			if (std::fflush(File) != 0) { return false; }
+#ifdef _WIN32
+			return _commit(_fileno(File)) == 0;
+#else
+			return fsync(fileno(File)) == 0;
+#endif
+		}
+
+		PackedPosition PackSnapshot(const Position& Pos)
+		{
+			return PackedPosition::Pack(Pos, 0, PackedPosition::Draw);
+		}
+	}
+
+	GameJournal::GameJournal()
+		: Path{}
+		, bRecording{ false }
+		, Plies{ 0 }
+		, Writer{}
+		, Lock{}
+		, Wake{}
+		, Pending{}
+		, bTruncate{ false }
+		, bStopWriter{ false }
+	{
+	}
+
+	GameJournal::~GameJournal()
+	{
+		Close();
+	}
+
+	void GameJournal::Open(const string& InPath)
+	{
+		Close();
+		Path = InPath;
+		bStopWriter = false;
+		Writer = std::thread(&GameJournal::RunWriter, this);
+	}
+
+	void GameJournal::Close()
+	{
+		if (!Writer.joinable()) { return; }
+
+		{
+			std::lock_guard<std::mutex> Guard{ Lock };
+			bStopWriter = true;
+		}
+		Wake.notify_one();
+		Writer.join();
+		bRecording = false;
+	}
+
+	// ----------------------------------------------------
+	// Recording
+	// ----------------------------------------------------
+	void GameJournal::Begin(const Position& Start)
+	{
+		if (!IsOpen()) { return; }
+
+		{
+			std::lock_guard<std::mutex> Guard{ Lock };
+			Pending.clear();
+			bTruncate = true;
+		}
+		bRecording = true;
+		Plies = 0;
+		const PackedPosition Snapshot = PackSnapshot(Start);
+		Queue(EntryStart, 0, 0, &Snapshot);
+	}
+
+	void GameJournal::Record(Move Played, std::int64_t MoverClockMs, const Position& After)
+	{
+		if (!bRecording) { return; }
+
+		Queue(EntryMove, Played.Data, std::int32_t(std::clamp<std::int64_t>(MoverClockMs, 0, 0x7FFFFFFF)), nullptr);
+		if (++Plies % SnapshotInterval == 0)
+		{
+			const PackedPosition Snapshot = PackSnapshot(After);
+			Queue(EntrySnapshot, 0, Plies, &Snapshot);
+		}
+	}
+
+	void GameJournal::Finish()
+	{
+		if (!bRecording) { return; }
+
+		Queue(EntryEnd, 0, Plies, nullptr);
+		bRecording = false;
+	}
+
+	void GameJournal::Queue(std::uint8_t Type, std::uint16_t MoveData, std::int32_t Value, const PackedPosition* Snapshot)
+	{
+		JournalEntry Entry;
+		Entry.Type = Type;
+		Entry.MoveData = MoveData;
+		Entry.Value = Value;
+		Entry.Check = ComputeCheck(Entry, Snapshot);
+
+		{
+			std::lock_guard<std::mutex> Guard{ Lock };
+			const std::uint8_t* EntryBytes = reinterpret_cast<const std::uint8_t*>(&Entry);
+			Pending.insert(Pending.end(), EntryBytes, EntryBytes + sizeof(Entry));
+			if (Snapshot)
+			{
+				const std::uint8_t* SnapshotBytes = reinterpret_cast<const std::uint8_t*>(Snapshot);
+				Pending.insert(Pending.end(), SnapshotBytes, SnapshotBytes + sizeof(PackedPosition));
+			}
+		}
+		Wake.notify_one();
+	}
+
+	// One write and one sync for everything queued since the last batch
+	void GameJournal::RunWriter()
+	{
+		std::FILE* Output = nullptr;
+		List<std::uint8_t> Batch;
+
+		std::unique_lock<std::mutex> Guard{ Lock };
+		for (;;)
+		{
+			Wake.wait(Guard, [this]() { return bStopWriter || bTruncate || !Pending.empty(); });
+			const bool bStopping = bStopWriter;
+			const bool bRestart = bTruncate;
+			bTruncate = false;
+			Batch.swap(Pending);
+			Guard.unlock();
+
+			if (bRestart)
+			{
+				if (Output)
+				{
+					std::fclose(Output);
+				}
+				Output = std::fopen(Path.c_str(), "wb");
+				char Header[HeaderSize] = {};
+				std::memcpy(Header, Magic, sizeof(Magic));
+				if (!Output || std::fwrite(Header, 1, HeaderSize, Output) != HeaderSize)
+				{
+					LOG("Cannot write game journal %s", Path.c_str());
+				}
+			}
+
+			// Entries queued without a file are dropped, so the queue cannot grow forever
+			if (Output && !Batch.empty())
+			{
+				const bool bWritten = std::fwrite(Batch.data(), 1, Batch.size(), Output) == Batch.size();
+				if (!SyncToDisk(Output) || !bWritten)
+				{
+					LOG("Cannot write game journal %s", Path.c_str());
+				}
+			}
+			Batch.clear();
+
+			Guard.lock();
+			if (bStopping && Pending.empty() && !bTruncate) { break; }
+		}
+
+		if (Output)
+		{
+			std::fclose(Output);
+		}
+	}
+
+	// ----------------------------------------------------
+	// Recovery
+	// ----------------------------------------------------
+	bool GameJournal::Recover(const string& Path, JournalRecovery& Out)
+	{
+		List<std::uint8_t> Bytes;
+		if (std::FILE* Input = std::fopen(Path.c_str(), "rb"))
+		{
+			std::uint8_t Block[1 << 14];
+			std::size_t Read = 0;
+			while ((Read = std::fread(Block, 1, sizeof(Block), Input)) > 0)
+			{
+				Bytes.insert(Bytes.end(), Block, Block + Read);
+			}
+			std::fclose(Input);
+		}
+		if (Bytes.size() < HeaderSize || std::memcmp(Bytes.data(), Magic, sizeof(Magic)) != 0) { return false; }
+
+		// Entries up to the first torn or unexpected one
+		PackedPosition Start;
+		bool bStarted = false;
+		List<Move> Moves;
+		List<std::int32_t> Clocks;
+		List<std::pair<std::size_t, PackedPosition>> Snapshots;		// Taken after this many moves
+		for (std::size_t Offset = HeaderSize; Offset + sizeof(JournalEntry) <= Bytes.size(); )
+		{
+			JournalEntry Entry;
+			std::memcpy(&Entry, Bytes.data() + Offset, sizeof(Entry));
+			const std::size_t Size = sizeof(Entry) + (HasSnapshot(Entry.Type) ? sizeof(PackedPosition) : 0);
+			if (Offset + Size > Bytes.size()) { break; }
+
+			PackedPosition Snapshot;
+			if (HasSnapshot(Entry.Type))
+			{
+				std::memcpy(&Snapshot, Bytes.data() + Offset + sizeof(Entry), sizeof(Snapshot));
+			}
+			if (Entry.Check != ComputeCheck(Entry, HasSnapshot(Entry.Type) ? &Snapshot : nullptr)) { break; }
+			if ((Entry.Type == EntryStart) == bStarted) { break; }
+
+			if (Entry.Type == EntryEnd) { return false; }
+			if (Entry.Type == EntryStart)
+			{
+				Start = Snapshot;
+				bStarted = true;
+			}
+			else if (Entry.Type == EntryMove)
+			{
+				Moves.push_back(Move{ Entry.MoveData });
+				Clocks.push_back(Entry.Value);
+			}
+			else if (Entry.Type == EntrySnapshot)
+			{
+				Snapshots.emplace_back(Moves.size(), Snapshot);
+			}
+			else
+			{
+				break;
+			}
+			Offset += Size;
+		}
+		if (!bStarted || Moves.empty() || !Start.Unpack(Out.Final)) { return false; }
+
+		// A snapshot that disagrees with the moves, or a move that does not fit,
+		// means the moves before the snapshot cannot be trusted. A snapshot that
+		// does not decode is passed over.
+		std::size_t First = 0;
+		std::size_t NextSnapshot = 0;
+		auto ResumeFrom = [&](std::size_t SnapshotIndex)
+		{
+			Position Resumed;
+			if (!Snapshots[SnapshotIndex].second.Unpack(Resumed)) { return false; }
+			Out.Final = Resumed;
+			First = Snapshots[SnapshotIndex].first;
+			NextSnapshot = SnapshotIndex + 1;
+			Out.Game.Begin(Out.Final);
+			Out.bFromSnapshot = true;
+			return true;
+		};
+
+		Out.Game.Begin(Out.Final);
+		Out.bFromSnapshot = false;
+		for (std::size_t Ply = 0; ; ++Ply)
+		{
+			if (NextSnapshot < Snapshots.size() && Snapshots[NextSnapshot].first == Ply)
+			{
+				const PackedPosition Expected = PackSnapshot(Out.Final);
+				if (std::memcmp(&Expected, &Snapshots[NextSnapshot].second, sizeof(PackedPosition)) == 0 || !ResumeFrom(NextSnapshot))
+				{
+					++NextSnapshot;
+				}
+			}
+			if (Ply == Moves.size()) { break; }
+
+			const Move Next = Moves[Ply];
+			if (!Out.Final.IsPseudoLegal(Next) || !Out.Final.IsLegal(Next))
+			{
+				// Skip to the next snapshot, or keep what has been played so far
+				while (NextSnapshot < Snapshots.size() && !ResumeFrom(NextSnapshot))
+				{
+					++NextSnapshot;
+				}
+				if (First <= Ply)
+				{
+					break;
+				}
+				Ply = First - 1;
+				continue;
+			}
+			Out.Final.MakeMove(Next);
+			Out.Game.Append(Next);
+		}
+		if (Out.Game.GetPlyCount() == 0) { return false; }
+
+		Out.MoverClocksMs.assign(Clocks.begin() + std::ptrdiff_t(First), Clocks.begin() + std::ptrdiff_t(First) + Out.Game.GetPlyCount());
+		Out.ClockMs[White] = Out.ClockMs[Black] = -1;
+		EColor Mover = Out.Final.GetSideToMove();
+		for (int i = Out.Game.GetPlyCount() - 1; i >= 0 && (Out.ClockMs[White] < 0 || Out.ClockMs[Black] < 0); --i)
+		{
+			Mover = ~Mover;
+			if (Out.ClockMs[Mover] < 0)
+			{
+				Out.ClockMs[Mover] = Out.MoverClocksMs[std::size_t(i)];
+			}
+		}
+		return true;
+	}
+}
@@ -0,0 +1,135 @@
+#include "IO/MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace we
+{
+	MappedFile::MappedFile()
+	{
+		Reset();
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& Other) noexcept
+	{
+		Reset();
+		*this = std::move(Other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& Other) noexcept
+	{
+		if (this != &Other)
+		{
+			Close();
+			Data = Other.Data;
+			Size = Other.Size;
+#ifdef _WIN32
+			FileHandle = Other.FileHandle;
+			MappingHandle = Other.MappingHandle;
+#else
+			FileDescriptor = Other.FileDescriptor;
+#endif
+			Other.Reset();
+		}
+		return *this;
+	}
+
+	void MappedFile::Reset()
+	{
+		Data = nullptr;
+		Size = 0;
+#ifdef _WIN32
+		FileHandle = INVALID_HANDLE_VALUE;
+		MappingHandle = nullptr;
+#else
+		FileDescriptor = -1;
+#endif
+	}
+
+#ifdef _WIN32
+	bool MappedFile::Open(const string& Path)
+	{
+		Close();
+
+		FileHandle = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (FileHandle == INVALID_HANDLE_VALUE) { return false; }
+
+		LARGE_INTEGER FileSize;
+		if (!GetFileSizeEx(FileHandle, &FileSize) || FileSize.QuadPart == 0)
+		{
+			Close();
+			return false;
+		}
+
+		MappingHandle = CreateFileMappingA(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!MappingHandle)
+		{
+			Close();
+			return false;
+		}
+
+		Data = static_cast<const std::uint8_t*>(MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0));
+		if (!Data)
+		{
+			Close();
+			return false;
+		}
+
+		Size = static_cast<std::size_t>(FileSize.QuadPart);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (Data) { UnmapViewOfFile(Data); }
+		if (MappingHandle) { CloseHandle(MappingHandle); }
+		if (FileHandle != INVALID_HANDLE_VALUE) { CloseHandle(FileHandle); }
+		Reset();
+	}
+#else
+	bool MappedFile::Open(const string& Path)
+	{
+		Close();
+
+		FileDescriptor = open(Path.c_str(), O_RDONLY);
+		if (FileDescriptor < 0) { return false; }
+
+		struct stat FileStat;
+		if (fstat(FileDescriptor, &FileStat) != 0 || FileStat.st_size == 0)
+		{
+			Close();
+			return false;
+		}
+
+		void* Mapping = mmap(nullptr, static_cast<std::size_t>(FileStat.st_size), PROT_READ, MAP_SHARED, FileDescriptor, 0);
+		if (Mapping == MAP_FAILED)
+		{
+			Close();
+			return false;
+		}
+
+		madvise(Mapping, static_cast<std::size_t>(FileStat.st_size), MADV_RANDOM);
+		Data = static_cast<const std::uint8_t*>(Mapping);
+		Size = static_cast<std::size_t>(FileStat.st_size);
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (Data) { munmap(const_cast<std::uint8_t*>(Data), Size); }
+		if (FileDescriptor >= 0) { close(FileDescriptor); }
+		Reset();
+	}
+#endif
+}
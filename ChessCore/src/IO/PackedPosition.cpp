@@ -0,0 +1,98 @@
+#include "IO/PackedPosition.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+
+namespace we
+{
+	namespace
+	{
+		constexpr const char* PieceChars = " PNBRQK  pnbrqk";
+	}
+
+	PackedPosition PackedPosition::Pack(const Position& Pos, int WhiteScore, EResult InResult)
+	{
+		PackedPosition Packed;
+		Packed.Occupied = Pos.Pieces();
+
+		int Index = 0;
+		Bitboard Occupied = Packed.Occupied;
+		while (Occupied && Index < 32)
+		{
+			const Square Sq = PopLsb(Occupied);
+			Packed.Pieces[Index / 2] |= std::uint8_t(Pos.PieceOn(Sq) << (4 * (Index & 1)));
+			++Index;
+		}
+
+		Packed.Flags = std::uint8_t(Pos.GetSideToMove() | (Pos.GetCastlingRights() << 1));
+		Packed.EnPassant = std::uint8_t(Pos.GetEnPassant());
+		Packed.HalfmoveClock = std::uint8_t(std::min(Pos.GetHalfmoveClock(), 255));
+		Packed.Result = InResult;
+		Packed.FullmoveNumber = std::uint16_t(std::min(Pos.GetGamePly() / 2 + 1, 65535));
+		Packed.Score = std::int16_t(std::clamp(WhiteScore, -32767, 32767));
+		return Packed;
+	}
+
+	bool PackedPosition::Unpack(Position& OutPos) const
+	{
+		return OutPos.SetFromFen(ToFen());
+	}
+
+	string PackedPosition::ToFen() const
+	{
+		char Board[64] = {};
+		int Index = 0;
+		Bitboard Remaining = Occupied;
+		while (Remaining && Index < 32)
+		{
+			const Square Sq = PopLsb(Remaining);
+			Board[Sq] = PieceChars[(Pieces[Index / 2] >> (4 * (Index & 1))) & 15];
+			++Index;
+		}
+
+		string Fen;
+		for (int Rank = 7; Rank >= 0; --Rank)
+		{
+			int Empty = 0;
+			for (int File = 0; File < 8; ++File)
+			{
+				const char Piece = Board[MakeSquare(File, Rank)];
+				if (!Piece)
+				{
+					++Empty;
+					continue;
+				}
+				if (Empty) { Fen += char('0' + Empty); Empty = 0; }
+				Fen += Piece;
+			}
+			if (Empty) { Fen += char('0' + Empty); }
+			if (Rank > 0) { Fen += '/'; }
+		}
+
+		Fen += GetSideToMove() == White ? " w " : " b ";
+		const int Rights = Flags >> 1;
+		if (Rights == NoCastling) { Fen += '-'; }
+		if (Rights & WhiteKingSide) { Fen += 'K'; }
+		if (Rights & WhiteQueenSide) { Fen += 'Q'; }
+		if (Rights & BlackKingSide) { Fen += 'k'; }
+		if (Rights & BlackQueenSide) { Fen += 'q'; }
+
+		Fen += EnPassant < NoSquare ? " " + SquareToString(EnPassant) : " -";
+		Fen += " " + std::to_string(HalfmoveClock) + " " + std::to_string(FullmoveNumber);
+		return Fen;
+	}
+
+	void PackedPosition::UnpackPieces(Position& OutPos) const
+	{
+		EPiece PieceList[32];
+		Square Squares[32];
+		int Count = 0;
+		Bitboard Remaining = Occupied;
+		while (Remaining && Count < 32)
+		{
+			Squares[Count] = PopLsb(Remaining);
+			PieceList[Count] = EPiece((Pieces[Count / 2] >> (4 * (Count & 1))) & 15);
+			++Count;
+		}
+		OutPos.SetFromPieces(PieceList, Squares, Count, GetSideToMove());
+	}
+}
@@ -0,0 +1,127 @@
+#include "IO/Pgn.h"
+#include "Rules/MoveGen.h"
+#include <ctime>
+
+namespace we
+{
+	namespace
+	{
+		constexpr const char* SevenTagRoster[] = { "Event", "Site", "Date", "Round", "White", "Black", "Result" };
+		constexpr std::size_t LineWidth = 80;
+
+		string EscapeTag(const string& Value)
+		{
+			string Escaped;
+			for (char Each : Value)
+			{
+				if (Each == '"' || Each == '\\') { Escaped += '\\'; }
+				Escaped += Each;
+			}
+			return Escaped;
+		}
+
+		void AppendToken(string& Text, std::size_t& LineLength, const string& Token)
+		{
+			if (LineLength > 0 && LineLength + 1 + Token.size() > LineWidth)
+			{
+				Text += '\n';
+				LineLength = 0;
+			}
+			else if (LineLength > 0)
+			{
+				Text += ' ';
+				++LineLength;
+			}
+			Text += Token;
+			LineLength += Token.size();
+		}
+	}
+
+	void PgnGame::SetTag(const string& Name, const string& Value)
+	{
+		for (auto& Tag : Tags)
+		{
+			if (Tag.first == Name)
+			{
+				Tag.second = Value;
+				return;
+			}
+		}
+		Tags.emplace_back(Name, Value);
+	}
+
+	const string* PgnGame::FindTag(const string& Name) const
+	{
+		for (const auto& Tag : Tags)
+		{
+			if (Tag.first == Name) { return &Tag.second; }
+		}
+		return nullptr;
+	}
+
+	string FormatPgn(const PgnGame& Game)
+	{
+		string Text;
+		for (const char* Name : SevenTagRoster)
+		{
+			const string* Value = Game.FindTag(Name);
+			const string Shown = string(Name) == "Result" ? Game.Result : Value ? *Value : "?";
+			Text += "[" + string(Name) + " \"" + EscapeTag(Shown) + "\"]\n";
+		}
+
+		const bool bCustomStart = !Game.StartFen.empty() && Game.StartFen != Position::StartFen;
+		for (const auto& Tag : Game.Tags)
+		{
+			bool bRoster = Tag.first == "FEN" || Tag.first == "SetUp";
+			for (const char* Name : SevenTagRoster)
+			{
+				bRoster |= Tag.first == Name;
+			}
+			if (!bRoster)
+			{
+				Text += "[" + Tag.first + " \"" + EscapeTag(Tag.second) + "\"]\n";
+			}
+		}
+		if (bCustomStart)
+		{
+			Text += "[SetUp \"1\"]\n[FEN \"" + Game.StartFen + "\"]\n";
+		}
+		Text += '\n';
+
+		Position Pos;
+		Pos.SetFromFen(bCustomStart ? Game.StartFen : Position::StartFen);
+
+		// Move numbers continue from the FEN's fullmove counter
+		std::size_t LineLength = 0;
+		for (std::size_t i = 0; i < Game.Moves.size(); ++i)
+		{
+			const int MoveNumber = Pos.GetGamePly() / 2 + 1;
+			if (Pos.GetSideToMove() == White)
+			{
+				AppendToken(Text, LineLength, std::to_string(MoveNumber) + ".");
+			}
+			else if (i == 0)
+			{
+				AppendToken(Text, LineLength, std::to_string(MoveNumber) + "...");
+			}
+
+			AppendToken(Text, LineLength, MoveToSan(Pos, Game.Moves[i]));
+			if (i < Game.Comments.size() && !Game.Comments[i].empty())
+			{
+				AppendToken(Text, LineLength, "{" + Game.Comments[i] + "}");
+			}
+			Pos.MakeMove(Game.Moves[i]);
+		}
+		AppendToken(Text, LineLength, Game.Result);
+		Text += "\n\n";
+		return Text;
+	}
+
+	string CurrentPgnDate()
+	{
+		const std::time_t Now = std::time(nullptr);
+		char Date[16];
+		std::strftime(Date, sizeof(Date), "%Y.%m.%d", std::localtime(&Now));
+		return Date;
+	}
+}
@@ -0,0 +1,397 @@
+#include "IO/PgnReader.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace we
+{
+	namespace
+	{
+		constexpr std::size_t MinChunkBytes = 1 << 20;		// Smaller inputs are not worth a thread
+
+		bool IsSpace(char Each) { return Each == ' ' || Each == '\t' || Each == '\n' || Each == '\r'; }
+		bool IsDigit(char Each) { return Each >= '0' && Each <= '9'; }
+		bool EndsToken(char Each) { return IsSpace(Each) || Each == '{' || Each == '}' || Each == '(' || Each == ')' || Each == ';' || Each == '$' || Each == '['; }
+		bool IsResult(std::string_view Token) { return Token == "1-0" || Token == "0-1" || Token == "1/2-1/2" || Token == "*"; }
+
+		string Unescape(std::string_view Value)
+		{
+			string Plain;
+			for (std::size_t i = 0; i < Value.size(); ++i)
+			{
+				if (Value[i] == '\\' && i + 1 < Value.size()) { ++i; }
+				Plain += Value[i];
+			}
+			return Plain;
+		}
+
+		// A line that opens a tag pair, [Name "...
+		bool IsTagPairLine(std::string_view Text, std::size_t First, std::size_t LineEnd)
+		{
+			std::size_t Cursor = First + 1;
+			const std::size_t NameStart = Cursor;
+			while (Cursor < LineEnd && (IsDigit(Text[Cursor]) || Text[Cursor] == '_'
+				|| (Text[Cursor] >= 'A' && Text[Cursor] <= 'Z') || (Text[Cursor] >= 'a' && Text[Cursor] <= 'z'))) { ++Cursor; }
+			if (Cursor == NameStart) { return false; }
+			while (Cursor < LineEnd && Text[Cursor] == ' ') { ++Cursor; }
+			return Cursor < LineEnd && Text[Cursor] == '"';
+		}
+
+		// A tag pair right after a blank line, so a wrapped comment such as
+		// "[%clk 0:01:00] }" in movetext is never taken for the next game. The
+		// search only starts at the line after From, so it never cuts into a
+		// tag section; games not separated by a blank line just stay together.
+		std::size_t FindGameStart(std::string_view Text, std::size_t From)
+		{
+			std::size_t LineStart = Text.rfind('\n', From > 0 ? From - 1 : 0);
+			LineStart = LineStart == std::string_view::npos ? 0 : LineStart + 1;
+
+			bool bPreviousWasBlank = false;
+			while (LineStart < Text.size())
+			{
+				std::size_t LineEnd = Text.find('\n', LineStart);
+				LineEnd = LineEnd == std::string_view::npos ? Text.size() : LineEnd;
+
+				std::size_t First = LineStart;
+				while (First < LineEnd && IsSpace(Text[First])) { ++First; }
+				const bool bBlank = First == LineEnd;
+				if (!bBlank && bPreviousWasBlank && LineStart >= From && Text[First] == '[' && IsTagPairLine(Text, First, LineEnd))
+				{
+					return LineStart;
+				}
+				bPreviousWasBlank = bBlank;
+				LineStart = LineEnd + 1;
+			}
+			return Text.size();
+		}
+
+		// Parses one part of the input; the position and lists are reused
+		// from game to game so the steady state allocates nothing
+		class ChunkParser
+		{
+		public:
+			ChunkParser(std::string_view InText, const std::function<void(const PgnGameView&)>& InOnGame)
+				: Text{ InText }
+				, OnGame{ InOnGame }
+			{
+				StartPosition.SetFromFen(Position::StartFen);
+			}
+
+			void Run(std::size_t Begin, std::size_t End)
+			{
+				Cursor = Begin;
+				Limit = End;
+				while (Cursor < Limit)
+				{
+					ParseGame();
+				}
+			}
+
+			PgnImportStats Stats;
+			List<PgnError> Errors;
+
+		private:
+			void SkipSpace()
+			{
+				while (Cursor < Limit && IsSpace(Text[Cursor])) { ++Cursor; }
+			}
+
+			void SkipPast(char Terminator)
+			{
+				while (Cursor < Limit && Text[Cursor] != Terminator) { ++Cursor; }
+				if (Cursor < Limit) { ++Cursor; }
+			}
+
+			void Fail(const string& Message)
+			{
+				if (ErrorMessage.empty()) { ErrorMessage = Message; }
+			}
+
+			bool ParseTag()
+			{
+				const std::size_t LineEnd = std::min(Limit, Text.find('\n', Cursor));
+				++Cursor;
+				while (Cursor < LineEnd && Text[Cursor] == ' ') { ++Cursor; }
+				const std::size_t NameStart = Cursor;
+				while (Cursor < LineEnd && !IsSpace(Text[Cursor]) && Text[Cursor] != '"' && Text[Cursor] != ']') { ++Cursor; }
+				const std::string_view Name = Text.substr(NameStart, Cursor - NameStart);
+				while (Cursor < LineEnd && Text[Cursor] == ' ') { ++Cursor; }
+
+				bool bValid = !Name.empty() && Cursor < LineEnd && Text[Cursor] == '"';
+				const std::size_t ValueStart = ++Cursor;
+				while (bValid && Cursor < LineEnd && Text[Cursor] != '"')
+				{
+					Cursor += Text[Cursor] == '\\' ? 2 : 1;
+				}
+				bValid = bValid && Cursor < LineEnd;
+				const std::string_view Value = bValid ? Text.substr(ValueStart, Cursor - ValueStart) : std::string_view{};
+
+				Cursor = LineEnd;
+				if (!bValid) { return false; }
+
+				View.Tags.emplace_back(Name, Value);
+				if (Name == "FEN") { View.StartFen = Value; }
+				return true;
+			}
+
+			void SkipVariation()
+			{
+				int Depth = 0;
+				while (Cursor < Limit)
+				{
+					const char Each = Text[Cursor++];
+					if (Each == '(') { ++Depth; }
+					else if (Each == ')' && --Depth == 0) { return; }
+					else if (Each == '{') { SkipPast('}'); }
+				}
+				Fail("unterminated variation");
+			}
+
+			void PlayToken(std::string_view Token)
+			{
+				// "12." or "12..." before the move, possibly without a space
+				if ((IsDigit(Token[0]) && Token.substr(0, 3) != "0-0") || Token[0] == '.')
+				{
+					std::size_t Skip = 0;
+					while (Skip < Token.size() && IsDigit(Token[Skip])) { ++Skip; }
+					while (Skip < Token.size() && Token[Skip] == '.') { ++Skip; }
+					Token.remove_prefix(Skip);
+					if (Token.empty()) { return; }
+				}
+				if (!ErrorMessage.empty()) { return; }
+
+				const Move Parsed = ParseSanMove(Pos, Token);
+				if (Parsed.IsNull())
+				{
+					Fail("illegal or ambiguous move \"" + string(Token) + "\" at ply " + std::to_string(View.Moves.size() + 1));
+					return;
+				}
+				View.Moves.push_back(Parsed);
+				Pos.MakeMove(Parsed);
+			}
+
+			void ParseGame()
+			{
+				SkipSpace();
+				if (Cursor >= Limit) { return; }
+
+				View.Offset = Cursor;
+				View.Tags.clear();
+				View.Moves.clear();
+				View.StartFen = {};
+				View.Result = "*";
+				ErrorMessage.clear();
+
+				while (Cursor < Limit && Text[Cursor] == '[')
+				{
+					if (!ParseTag()) { Fail("malformed tag"); }
+					SkipSpace();
+				}
+
+				if (View.StartFen.empty())
+				{
+					Pos = StartPosition;
+				}
+				else if (!Pos.SetFromFen(string(View.StartFen)))
+				{
+					Fail("invalid FEN");
+				}
+
+				// Ends at a result, at the next tag section or at the end of the part
+				bool bAnyMovetext = false;
+				while (Cursor < Limit)
+				{
+					SkipSpace();
+					if (Cursor >= Limit || Text[Cursor] == '[') { break; }
+
+					const char Each = Text[Cursor];
+					bAnyMovetext = true;
+					if (Each == '{') { SkipPast('}'); }
+					else if (Each == ';') { SkipPast('\n'); }
+					else if (Each == '%' && (Cursor == 0 || Text[Cursor - 1] == '\n')) { SkipPast('\n'); }
+					else if (Each == '(') { SkipVariation(); }
+					else if (Each == ')' || Each == '}')
+					{
+						Fail(string("unexpected '") + Each + "'");
+						++Cursor;
+					}
+					else if (Each == '$')
+					{
+						++Cursor;
+						while (Cursor < Limit && IsDigit(Text[Cursor])) { ++Cursor; }
+					}
+					else
+					{
+						const std::size_t TokenStart = Cursor;
+						while (Cursor < Limit && !EndsToken(Text[Cursor])) { ++Cursor; }
+						const std::string_view Token = Text.substr(TokenStart, Cursor - TokenStart);
+						if (IsResult(Token))
+						{
+							View.Result = Token;
+							break;
+						}
+						PlayToken(Token);
+					}
+				}
+
+				if (View.Tags.empty() && !bAnyMovetext) { return; }
+				if (!ErrorMessage.empty())
+				{
+					++Stats.Malformed;
+					if (Errors.size() < PgnReader::MaxErrorsKept)
+					{
+						Errors.push_back(PgnError{ View.Offset, ErrorMessage });
+					}
+					return;
+				}
+
+				++Stats.Games;
+				Stats.Moves += View.Moves.size();
+				OnGame(View);
+			}
+
+			std::string_view Text;
+			const std::function<void(const PgnGameView&)>& OnGame;
+			std::size_t Cursor = 0;
+			std::size_t Limit = 0;
+			Position StartPosition;
+			Position Pos;
+			PgnGameView View;
+			string ErrorMessage;
+		};
+	}
+
+	// ----------------------------------------------------
+	// Game View
+	// ----------------------------------------------------
+	std::string_view PgnGameView::FindTag(std::string_view Name) const
+	{
+		for (const auto& Tag : Tags)
+		{
+			if (Tag.first == Name) { return Tag.second; }
+		}
+		return {};
+	}
+
+	PgnGame PgnGameView::ToGame() const
+	{
+		PgnGame Game;
+		for (const auto& Tag : Tags)
+		{
+			if (Tag.first != "Result")
+			{
+				Game.SetTag(string(Tag.first), Unescape(Tag.second));
+			}
+		}
+		Game.StartFen = string(StartFen);
+		Game.Moves = Moves;
+		Game.Result = string(Result);
+		return Game;
+	}
+
+	// ----------------------------------------------------
+	// Reader
+	// ----------------------------------------------------
+	bool PgnReader::Open(const string& Path)
+	{
+		Errors.clear();
+		if (!File.Open(Path))
+		{
+			LOG("Cannot open %s", Path.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	PgnImportStats PgnReader::Read(const std::function<void(const PgnGameView&)>& OnGame, int Threads)
+	{
+		const std::string_view Text{ reinterpret_cast<const char*>(File.GetData()), File.GetSize() };
+		return Parse(Text, OnGame, Threads, &Errors);
+	}
+
+	PgnImportStats PgnReader::Parse(std::string_view Text, const std::function<void(const PgnGameView&)>& OnGame, int Threads,
+		List<PgnError>* OutErrors)
+	{
+		const auto Start = std::chrono::steady_clock::now();
+		if (Threads <= 0)
+		{
+			Threads = std::max(1, int(std::thread::hardware_concurrency()));
+		}
+		const std::size_t PartCount = std::max<std::size_t>(1, std::min<std::size_t>(std::size_t(Threads), Text.size() / MinChunkBytes));
+
+		List<std::size_t> Bounds{ 0 };
+		for (std::size_t i = 1; i < PartCount; ++i)
+		{
+			Bounds.push_back(std::max(Bounds.back(), FindGameStart(Text, Text.size() / PartCount * i)));
+		}
+		Bounds.push_back(Text.size());
+
+		List<unique<ChunkParser>> Parsers;
+		List<std::thread> Workers;
+		for (std::size_t i = 0; i < PartCount; ++i)
+		{
+			Parsers.push_back(std::make_unique<ChunkParser>(Text, OnGame));
+			if (PartCount == 1)
+			{
+				Parsers.back()->Run(Bounds[i], Bounds[i + 1]);
+			}
+			else
+			{
+				Workers.emplace_back(&ChunkParser::Run, Parsers.back().get(), Bounds[i], Bounds[i + 1]);
+			}
+		}
+		for (std::thread& Worker : Workers)
+		{
+			Worker.join();
+		}
+
+		PgnImportStats Stats;
+		Stats.Bytes = Text.size();
+		for (const auto& Parser : Parsers)
+		{
+			Stats.Games += Parser->Stats.Games;
+			Stats.Malformed += Parser->Stats.Malformed;
+			Stats.Moves += Parser->Stats.Moves;
+			if (OutErrors)
+			{
+				OutErrors->insert(OutErrors->end(), Parser->Errors.begin(), Parser->Errors.end());
+			}
+		}
+		if (OutErrors && OutErrors->size() > MaxErrorsKept)
+		{
+			OutErrors->resize(MaxErrorsKept);
+		}
+		Stats.TimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - Start).count();
+		return Stats;
+	}
+
+	List<PgnGame> LoadPgnFile(const string& Path, List<PgnError>* OutErrors)
+	{
+		PgnReader Reader;
+		if (!Reader.Open(Path)) { return {}; }
+
+		std::mutex Lock;
+		List<std::pair<std::size_t, PgnGame>> Found;
+		Reader.Read([&Lock, &Found](const PgnGameView& View)
+		{
+			PgnGame Game = View.ToGame();
+			std::lock_guard<std::mutex> Guard{ Lock };
+			Found.emplace_back(View.Offset, std::move(Game));
+		});
+
+		std::sort(Found.begin(), Found.end(), [](const auto& A, const auto& B) { return A.first < B.first; });
+		List<PgnGame> Games;
+		Games.reserve(Found.size());
+		for (auto& Each : Found)
+		{
+			Games.push_back(std::move(Each.second));
+		}
+		if (OutErrors)
+		{
+			*OutErrors = Reader.GetErrors();
+		}
+		return Games;
+	}
+}
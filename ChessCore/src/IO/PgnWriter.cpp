@@ -0,0 +1,100 @@
+#include "IO/PgnWriter.h"
+
+namespace we
+{
+	namespace
+	{
+		constexpr std::size_t WriteBufferBytes = 1 << 16;
+	}
+
+	PgnWriter::PgnWriter()
+		: Path{}
+		, Writer{}
+		, Lock{}
+		, Wake{}
+		, Pending{}
+		, bStopWriter{ false }
+	{
+	}
+
+	PgnWriter::~PgnWriter()
+	{
+		Close();
+	}
+
+	void PgnWriter::Open(const string& InPath)
+	{
+		Close();
+		Path = InPath;
+		bStopWriter = false;
+		Writer = std::thread(&PgnWriter::RunWriter, this);
+	}
+
+	void PgnWriter::Close()
+	{
+		if (!Writer.joinable()) { return; }
+
+		{
+			std::lock_guard<std::mutex> Guard{ Lock };
+			bStopWriter = true;
+		}
+		Wake.notify_one();
+		Writer.join();
+	}
+
+	void PgnWriter::Write(PgnGame Game)
+	{
+		if (!IsOpen()) { return; }
+
+		{
+			std::lock_guard<std::mutex> Guard{ Lock };
+			Pending.push_back(std::move(Game));
+		}
+		Wake.notify_one();
+	}
+
+	void PgnWriter::RunWriter()
+	{
+		std::FILE* Output = std::fopen(Path.c_str(), "ab");
+		if (!Output)
+		{
+			LOG("Cannot write games to %s", Path.c_str());
+		}
+		else
+		{
+			std::setvbuf(Output, nullptr, _IOFBF, WriteBufferBytes);
+		}
+
+		std::unique_lock<std::mutex> Guard{ Lock };
+		for (;;)
+		{
+			Wake.wait(Guard, [this]() { return bStopWriter || !Pending.empty(); });
+			const bool bStopping = bStopWriter;
+			List<PgnGame> Batch;
+			Batch.swap(Pending);
+			Guard.unlock();
+
+			// Games queued without a file are dropped, so the queue cannot grow forever
+			if (Output && !Batch.empty())
+			{
+				for (const PgnGame& Game : Batch)
+				{
+					const string Text = FormatPgn(Game);
+					std::fwrite(Text.data(), 1, Text.size(), Output);
+				}
+				if (std::fflush(Output) != 0)
+				{
+					LOG("Cannot write games to %s", Path.c_str());
+				}
+			}
+
+			Guard.lock();
+			if (bStopping && Pending.empty()) { break; }
+		}
+
+		if (Output)
+		{
+			std::fclose(Output);
+		}
+	}
+}
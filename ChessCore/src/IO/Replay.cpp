@@ -0,0 +1,201 @@
+#include "IO/Replay.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace we
+{
+	namespace
+	{
+		constexpr char Magic[8] = { 'W', 'E', 'R', 'E', 'P', 'L', 'A', 'Y' };
+		constexpr std::size_t HeaderSize = 16;				// Magic, keyframe interval, reserved, ply count
+		constexpr int MaxKeyframeInterval = 1024;
+
+		int KeyframeCountFor(int PlyCount, int Interval)
+		{
+			return PlyCount / Interval + 1;
+		}
+	}
+
+	Replay::Replay(int InKeyframeInterval)
+		: KeyframeInterval{ std::clamp(InKeyframeInterval, 1, MaxKeyframeInterval) }
+		, Keyframes{}
+		, Moves{}
+		, Tail{}
+	{
+		Keyframes.push_back(PackedPosition::Pack(Tail, 0, PackedPosition::Draw));
+	}
+
+	// ----------------------------------------------------
+	// Recording
+	// ----------------------------------------------------
+	void Replay::Begin(const Position& Start)
+	{
+		Tail = Start;
+		Moves.clear();
+		Keyframes.clear();
+		Keyframes.push_back(PackedPosition::Pack(Tail, 0, PackedPosition::Draw));
+	}
+
+	void Replay::Append(Move InMove)
+	{
+		Tail.MakeMove(InMove);
+		Moves.push_back(InMove);
+		if (Moves.size() % std::size_t(KeyframeInterval) == 0)
+		{
+			Keyframes.push_back(PackedPosition::Pack(Tail, 0, PackedPosition::Draw));
+		}
+	}
+
+	// ----------------------------------------------------
+	// Files
+	// ----------------------------------------------------
+	bool Replay::Save(const string& Path) const
+	{
+		std::FILE* Output = std::fopen(Path.c_str(), "wb");
+		if (!Output)
+		{
+			LOG("Cannot write replay %s", Path.c_str());
+			return false;
+		}
+
+		char Header[HeaderSize] = {};
+		const std::uint16_t Interval = std::uint16_t(KeyframeInterval);
+		const std::uint32_t PlyCount = std::uint32_t(Moves.size());
+		std::memcpy(Header, Magic, sizeof(Magic));
+		std::memcpy(Header + 8, &Interval, sizeof(Interval));
+		std::memcpy(Header + 12, &PlyCount, sizeof(PlyCount));
+
+		List<std::uint16_t> Stream(Moves.size());
+		std::transform(Moves.begin(), Moves.end(), Stream.begin(), [](Move Each) { return Each.Data; });
+
+		bool bWritten = std::fwrite(Header, 1, HeaderSize, Output) == HeaderSize;
+		bWritten = bWritten && std::fwrite(Keyframes.data(), sizeof(PackedPosition), Keyframes.size(), Output) == Keyframes.size();
+		bWritten = bWritten && std::fwrite(Stream.data(), sizeof(std::uint16_t), Stream.size(), Output) == Stream.size();
+		bWritten = std::fclose(Output) == 0 && bWritten;
+		if (!bWritten)
+		{
+			LOG("Cannot write replay %s", Path.c_str());
+		}
+		return bWritten;
+	}
+
+	bool Replay::Load(const string& Path)
+	{
+		std::FILE* Input = std::fopen(Path.c_str(), "rb");
+		if (!Input)
+		{
+			LOG("Cannot open replay %s", Path.c_str());
+			return false;
+		}
+
+		char Header[HeaderSize] = {};
+		std::uint16_t Interval = 0;
+		std::uint32_t PlyCount = 0;
+		bool bRead = std::fread(Header, 1, HeaderSize, Input) == HeaderSize && std::memcmp(Header, Magic, sizeof(Magic)) == 0;
+		std::memcpy(&Interval, Header + 8, sizeof(Interval));
+		std::memcpy(&PlyCount, Header + 12, sizeof(PlyCount));
+		bRead = bRead && Interval > 0 && Interval <= MaxKeyframeInterval;
+
+		// A corrupt header must not size the buffers, so the sizes it implies
+		// have to add up to the file's before anything is allocated
+		std::error_code Error;
+		const std::uintmax_t FileSize = std::filesystem::file_size(Path, Error);
+		bRead = bRead && !Error && PlyCount <= FileSize / sizeof(std::uint16_t)
+			&& HeaderSize + std::uintmax_t(KeyframeCountFor(int(PlyCount), Interval)) * sizeof(PackedPosition) + std::uintmax_t(PlyCount) * sizeof(std::uint16_t) == FileSize;
+
+		List<PackedPosition> InKeyframes;
+		List<std::uint16_t> Stream;
+		if (bRead)
+		{
+			InKeyframes.resize(std::size_t(KeyframeCountFor(int(PlyCount), Interval)));
+			Stream.resize(PlyCount);
+			bRead = std::fread(InKeyframes.data(), sizeof(PackedPosition), InKeyframes.size(), Input) == InKeyframes.size()
+				&& std::fread(Stream.data(), sizeof(std::uint16_t), Stream.size(), Input) == Stream.size();
+		}
+		std::fclose(Input);
+
+		Position Start;
+		if (!bRead || !InKeyframes[0].Unpack(Start))
+		{
+			LOG("%s is not a replay", Path.c_str());
+			return false;
+		}
+
+		// Only the moves after the last keyframe are played here, so recording
+		// can carry on; the others are checked as a cursor plays them
+		KeyframeInterval = Interval;
+		Keyframes = std::move(InKeyframes);
+		Moves.resize(Stream.size());
+		std::transform(Stream.begin(), Stream.end(), Moves.begin(), [](std::uint16_t Raw) { return Move{ Raw }; });
+
+		ReplayCursor End{ *this };
+		if (!End.Seek(GetPlyCount()))
+		{
+			LOG("%s holds an illegal move", Path.c_str());
+			Begin(Start);
+			return false;
+		}
+		Tail = End.GetPosition();
+		return true;
+	}
+
+	// ----------------------------------------------------
+	// Replay Cursor
+	// ----------------------------------------------------
+	ReplayCursor::ReplayCursor(const Replay& InSource)
+		: Source{ &InSource }
+		, Pos{}
+		, Ply{ -1 }
+		, BasePly{ 0 }
+	{
+	}
+
+	bool ReplayCursor::DecodeKeyframe(int Index)
+	{
+		Ply = -1;
+		if (!Source->GetKeyframes()[Index].Unpack(Pos)) { return false; }
+
+		Ply = BasePly = Index * Source->GetKeyframeInterval();
+		return true;
+	}
+
+	bool ReplayCursor::Seek(int TargetPly)
+	{
+		if (TargetPly < 0 || TargetPly > Source->GetPlyCount()) { return false; }
+
+		const List<Move>& Moves = Source->GetMoves();
+		const int Interval = Source->GetKeyframeInterval();
+		const int Keyframe = TargetPly / Interval;
+
+		// Unmake back while the history reaches, else start over from a keyframe
+		// unless the current ply is already past it on the way to the target
+		if (Ply >= 0 && TargetPly < Ply && TargetPly >= BasePly && Ply - TargetPly <= Interval)
+		{
+			while (Ply > TargetPly)
+			{
+				--Ply;
+				Pos.UnmakeMove(Moves[Ply]);
+			}
+			return true;
+		}
+		if (Ply < 0 || TargetPly < Ply || Ply < Keyframe * Interval)
+		{
+			if (!DecodeKeyframe(Keyframe)) { return false; }
+		}
+
+		while (Ply < TargetPly)
+		{
+			const Move Next = Moves[Ply];
+			if (!Pos.IsPseudoLegal(Next) || !Pos.IsLegal(Next))
+			{
+				Ply = -1;
+				return false;
+			}
+			Pos.MakeMove(Next);
+			++Ply;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,111 @@
+#include "Match/ChessClock.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace we
+{
+	ChessClock::ChessClock()
+		: RemainingUs{ 0, 0 }
+		, IncrementUs{ 0 }
+		, RunningSide{ White }
+		, bRunning{ false }
+		, TurnStart{}
+	{
+	}
+
+	void ChessClock::Reset(std::int64_t BaseMs, std::int64_t IncrementMs)
+	{
+		RemainingUs[White] = RemainingUs[Black] = BaseMs * 1000;
+		IncrementUs = IncrementMs * 1000;
+		RunningSide = White;
+		bRunning = false;
+	}
+
+	void ChessClock::Start(EColor Side)
+	{
+		Settle();
+		RunningSide = Side;
+		bRunning = true;
+		TurnStart = std::chrono::steady_clock::now();
+	}
+
+	void ChessClock::Press(EColor Mover)
+	{
+		const bool bMoverRunning = bRunning && RunningSide == Mover;
+		Settle();
+		if (bMoverRunning && RemainingUs[Mover] > 0)
+		{
+			RemainingUs[Mover] += IncrementUs;
+		}
+		Start(~Mover);
+	}
+
+	void ChessClock::Stop()
+	{
+		Settle();
+		bRunning = false;
+	}
+
+	void ChessClock::SetRemainingMs(EColor Side, std::int64_t Ms)
+	{
+		RemainingUs[Side] = Ms * 1000;
+	}
+
+	// Moves the running side's elapsed time into its remaining time
+	void ChessClock::Settle()
+	{
+		if (!bRunning) { return; }
+
+		const auto Now = std::chrono::steady_clock::now();
+		RemainingUs[RunningSide] -= std::chrono::duration_cast<std::chrono::microseconds>(Now - TurnStart).count();
+		TurnStart = Now;
+	}
+
+	std::int64_t ChessClock::GetRemainingUs(EColor Side) const
+	{
+		if (!bRunning || Side != RunningSide) { return RemainingUs[Side]; }
+
+		const auto Elapsed = std::chrono::steady_clock::now() - TurnStart;
+		return RemainingUs[Side] - std::chrono::duration_cast<std::chrono::microseconds>(Elapsed).count();
+	}
+
+	std::int64_t ChessClock::GetRemainingMs(EColor Side) const
+	{
+		return std::max<std::int64_t>(GetRemainingUs(Side), 0) / 1000;
+	}
+
+	void ChessClock::FillLimits(SearchLimits& Limits) const
+	{
+		Limits.MoveTime = 0;
+		for (EColor Side : { White, Black })
+		{
+			// A search must never be handed an empty clock, or it would not be timed at all
+			Limits.Time[Side] = std::max<std::int64_t>(GetRemainingMs(Side), 1);
+			Limits.Increment[Side] = GetIncrementMs();
+		}
+	}
+
+	string ChessClock::Format(std::int64_t Ms)
+	{
+		char Text[32];
+		Ms = std::max<std::int64_t>(Ms, 0);
+		if (Ms < 20000)
+		{
+			std::snprintf(Text, sizeof(Text), "%lld.%lld", static_cast<long long>(Ms / 1000), static_cast<long long>(Ms / 100 % 10));
+		}
+		else
+		{
+			const long long Seconds = static_cast<long long>(Ms / 1000);
+			std::snprintf(Text, sizeof(Text), "%lld:%02lld", Seconds / 60, Seconds % 60);
+		}
+		return Text;
+	}
+
+	string ChessClock::FormatPgn(std::int64_t Ms)
+	{
+		char Text[32];
+		const long long Seconds = static_cast<long long>(std::max<std::int64_t>(Ms, 0) / 1000);
+		std::snprintf(Text, sizeof(Text), "%lld:%02lld:%02lld", Seconds / 3600, Seconds / 60 % 60, Seconds % 60);
+		return Text;
+	}
+}
@@ -0,0 +1,84 @@
+#include "Match/MatchStats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace we
+{
+	namespace
+	{
+		// Keeps a 100% or 0% score from sending the Elo to infinity
+		constexpr double ScoreEpsilon = 1e-6;
+	}
+
+	double EloToScore(double Elo)
+	{
+		return 1.0 / (1.0 + std::pow(10.0, -Elo / 400.0));
+	}
+
+	double ScoreToElo(double Score)
+	{
+		Score = std::clamp(Score, ScoreEpsilon, 1.0 - ScoreEpsilon);
+		return -400.0 * std::log10(1.0 / Score - 1.0);
+	}
+
+	// ----------------------------------------------------
+	// Match Score
+	// ----------------------------------------------------
+	double MatchScore::Variance() const
+	{
+		if (!Games()) { return 0.0; }
+
+		const double Mean = Score();
+		return (Wins * (1.0 - Mean) * (1.0 - Mean) + Draws * (0.5 - Mean) * (0.5 - Mean) + Losses * Mean * Mean) / Games();
+	}
+
+	double MatchScore::Elo() const
+	{
+		return ScoreToElo(Score());
+	}
+
+	double MatchScore::EloError95() const
+	{
+		if (!Games()) { return 0.0; }
+
+		const double Margin = 1.959964 * std::sqrt(Variance() / Games());
+		return (ScoreToElo(Score() + Margin) - ScoreToElo(Score() - Margin)) / 2.0;
+	}
+
+	double MatchScore::LikelihoodOfSuperiority() const
+	{
+		if (Wins + Losses == 0) { return 0.5; }
+		return 0.5 * (1.0 + std::erf((Wins - Losses) / std::sqrt(2.0 * (Wins + Losses))));
+	}
+
+	// ----------------------------------------------------
+	// SPRT
+	// ----------------------------------------------------
+	double SprtTest::LowerBound() const
+	{
+		return std::log(Beta / (1.0 - Alpha));
+	}
+
+	double SprtTest::UpperBound() const
+	{
+		return std::log((1.0 - Beta) / Alpha);
+	}
+
+	double SprtTest::LogLikelihoodRatio(const MatchScore& Score) const
+	{
+		const double Variance = Score.Variance();
+		if (Variance <= 0.0) { return 0.0; }
+
+		const double Score0 = EloToScore(Elo0);
+		const double Score1 = EloToScore(Elo1);
+		return Score.Games() * (Score1 - Score0) * (2.0 * Score.Score() - Score0 - Score1) / (2.0 * Variance);
+	}
+
+	ESprtState SprtTest::Evaluate(const MatchScore& Score) const
+	{
+		const double Llr = LogLikelihoodRatio(Score);
+		if (Llr >= UpperBound()) { return ESprtState::AcceptH1; }
+		if (Llr <= LowerBound()) { return ESprtState::AcceptH0; }
+		return ESprtState::Running;
+	}
+}
@@ -0,0 +1,250 @@
+#include "Match/SelfPlay.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+namespace we
+{
+	const char* ResultToString(EGameResult Result)
+	{
+		switch (Result)
+		{
+		case EGameResult::WhiteWins: return "1-0";
+		case EGameResult::BlackWins: return "0-1";
+		case EGameResult::Draw: return "1/2-1/2";
+		default: return "*";
+		}
+	}
+
+	const char* TerminationToString(ETermination Termination)
+	{
+		switch (Termination)
+		{
+		case ETermination::Checkmate: return "checkmate";
+		case ETermination::Stalemate: return "stalemate";
+		case ETermination::Repetition: return "threefold repetition";
+		case ETermination::FiftyMoves: return "fifty-move rule";
+		case ETermination::InsufficientMaterial: return "insufficient material";
+		case ETermination::Tablebase: return "tablebase adjudication";
+		case ETermination::TimeForfeit: return "time forfeit";
+		case ETermination::IllegalMove: return "illegal move";
+		case ETermination::MaxPlies: return "move limit";
+		default: return "unterminated";
+		}
+	}
+
+	// ----------------------------------------------------
+	// Time Control
+	// ----------------------------------------------------
+	bool TimeControl::Parse(const string& Text)
+	{
+		*this = TimeControl{};
+		BaseMs = IncrementMs = 0;
+
+		const std::size_t Equals = Text.find('=');
+		try
+		{
+			if (Equals != string::npos)
+			{
+				const string Key = Text.substr(0, Equals);
+				const string Value = Text.substr(Equals + 1);
+				if (Key == "movetime") { MoveTimeMs = std::stoll(Value); }
+				else if (Key == "nodes") { Nodes = std::stoull(Value); }
+				else if (Key == "depth") { Depth = std::stoi(Value); }
+				else { return false; }
+				return true;
+			}
+
+			const std::size_t Plus = Text.find('+');
+			BaseMs = std::int64_t(std::stod(Text.substr(0, Plus)) * 1000.0);
+			IncrementMs = Plus == string::npos ? 0 : std::int64_t(std::stod(Text.substr(Plus + 1)) * 1000.0);
+		}
+		catch (const std::exception&)
+		{
+			return false;
+		}
+		return BaseMs > 0;
+	}
+
+	string TimeControl::ToPgnTag() const
+	{
+		if (MoveTimeMs) { return "1/" + std::to_string(MoveTimeMs / 1000.0); }
+		if (!UsesClock()) { return "-"; }
+
+		std::ostringstream Tag;
+		Tag << BaseMs / 1000.0;
+		if (IncrementMs)
+		{
+			Tag << '+' << IncrementMs / 1000.0;
+		}
+		return Tag.str();
+	}
+
+	// ----------------------------------------------------
+	// Games
+	// ----------------------------------------------------
+	PgnGame GameRecord::ToPgn(const string& WhiteName, const string& BlackName) const
+	{
+		PgnGame Game;
+		Game.SetTag("White", WhiteName);
+		Game.SetTag("Black", BlackName);
+		Game.SetTag("Termination", TerminationToString(Termination));
+		Game.SetTag("PlyCount", std::to_string(Moves.size()));
+		Game.StartFen = StartFen;
+		Game.Moves = Moves;
+		Game.Result = ResultToString(Result);
+		return Game;
+	}
+
+	ETermination Adjudicate(Position& Pos, const SyzygyTablebases* Tablebases, EGameResult& OutResult)
+	{
+		const EColor Us = Pos.GetSideToMove();
+		const EGameResult UsWin = Us == White ? EGameResult::WhiteWins : EGameResult::BlackWins;
+		const EGameResult UsLoss = Us == White ? EGameResult::BlackWins : EGameResult::WhiteWins;
+
+		// Mate on the move that completes the fifty moves still counts, so it is checked first
+		if (!HasLegalMove(Pos))
+		{
+			OutResult = Pos.IsInCheck() ? UsLoss : EGameResult::Draw;
+			return Pos.IsInCheck() ? ETermination::Checkmate : ETermination::Stalemate;
+		}
+
+		OutResult = EGameResult::Draw;
+		if (Pos.IsRepetition(0)) { return ETermination::Repetition; }
+		if (Pos.IsFiftyMoveDraw()) { return ETermination::FiftyMoves; }
+		if (Pos.IsInsufficientMaterial()) { return ETermination::InsufficientMaterial; }
+
+		Syzygy::EWdlScore Wdl;
+		if (Tablebases && Tablebases->CanProbe(Pos) && Tablebases->ProbeWdl(Pos, Wdl))
+		{
+			OutResult = Wdl == Syzygy::WdlWin ? UsWin : Wdl == Syzygy::WdlLoss ? UsLoss : EGameResult::Draw;
+			return ETermination::Tablebase;
+		}
+
+		OutResult = EGameResult::None;
+		return ETermination::None;
+	}
+
+	GameRecord PlayGame(Engine& WhitePlayer, Engine& BlackPlayer, const string& StartFen, const GameSettings& Settings)
+	{
+		GameRecord Record;
+		Record.StartFen = StartFen;
+
+		Position Pos;
+		if (!Pos.SetFromFen(StartFen))
+		{
+			LOG("Skipping game from invalid FEN: %s", StartFen.c_str());
+			return Record;
+		}
+
+		WhitePlayer.NewGame();
+		if (&BlackPlayer != &WhitePlayer)
+		{
+			BlackPlayer.NewGame();
+		}
+
+		const TimeControl& Clock = Settings.Clock;
+		std::int64_t Remaining[ColorCount] = { Clock.BaseMs, Clock.BaseMs };
+
+		while (true)
+		{
+			Record.Termination = Adjudicate(Pos, Settings.Tablebases, Record.Result);
+			if (Record.Termination != ETermination::None) { break; }
+
+			if (int(Record.Moves.size()) >= Settings.MaxPlies)
+			{
+				Record.Result = EGameResult::Draw;
+				Record.Termination = ETermination::MaxPlies;
+				break;
+			}
+
+			const EColor Us = Pos.GetSideToMove();
+			const EGameResult Forfeit = Us == White ? EGameResult::BlackWins : EGameResult::WhiteWins;
+			Engine& Player = Us == White ? WhitePlayer : BlackPlayer;
+
+			SearchLimits Limits;
+			Limits.MoveTime = Clock.MoveTimeMs;
+			Limits.Nodes = Clock.Nodes;
+			Limits.Depth = Clock.Depth;
+			if (Clock.UsesClock())
+			{
+				Limits.Time[White] = Remaining[White];
+				Limits.Time[Black] = Remaining[Black];
+				Limits.Increment[White] = Limits.Increment[Black] = Clock.IncrementMs;
+			}
+
+			const auto Begin = std::chrono::steady_clock::now();
+			const SearchResult Result = Player.Think(Pos, Limits);
+			const std::int64_t Elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - Begin).count();
+
+			if (Clock.UsesClock())
+			{
+				Remaining[Us] -= Elapsed;
+				if (Remaining[Us] < -Settings.TimeMarginMs)
+				{
+					// A flag only loses if the opponent has anything left to mate with
+					const bool bBareKing = Pos.Pieces(~Us) == SquareBB(Pos.KingSquare(~Us));
+					Record.Result = bBareKing ? EGameResult::Draw : Forfeit;
+					Record.Termination = ETermination::TimeForfeit;
+					break;
+				}
+				Remaining[Us] = std::max<std::int64_t>(Remaining[Us], 0) + Clock.IncrementMs;
+			}
+
+			MoveList Legal;
+			GenerateLegalMoves(Pos, Legal);
+			if (std::find(Legal.begin(), Legal.end(), Result.BestMove) == Legal.end())
+			{
+				Record.Result = Forfeit;
+				Record.Termination = ETermination::IllegalMove;
+				break;
+			}
+
+			Pos.MakeMove(Result.BestMove);
+			Record.Moves.push_back(Result.BestMove);
+			Record.MoveTimesMs.push_back(Elapsed);
+		}
+		return Record;
+	}
+
+	// ----------------------------------------------------
+	// Opening Suites
+	// ----------------------------------------------------
+	List<string> LoadOpenings(const string& Path)
+	{
+		List<string> Openings;
+		std::ifstream File(Path);
+		if (!File)
+		{
+			LOG("Cannot open opening suite %s", Path.c_str());
+			return Openings;
+		}
+
+		string Line;
+		while (std::getline(File, Line))
+		{
+			std::istringstream Fields(Line);
+			List<string> Tokens;
+			string Token;
+			while (Tokens.size() < 6 && Fields >> Token)
+			{
+				Tokens.push_back(Token);
+			}
+			if (Tokens.size() < 4 || Tokens[0][0] == '#') { continue; }
+
+			// EPD has no move counters; whatever follows the first four fields is an operation
+			const bool bFen = Tokens.size() == 6 && std::all_of(Tokens[4].begin(), Tokens[4].end(), ::isdigit) && std::all_of(Tokens[5].begin(), Tokens[5].end(), ::isdigit);
+			string Fen = Tokens[0] + " " + Tokens[1] + " " + Tokens[2] + " " + Tokens[3];
+			Fen += bFen ? " " + Tokens[4] + " " + Tokens[5] : " 0 1";
+
+			Position Check;
+			if (Check.SetFromFen(Fen))
+			{
+				Openings.push_back(Fen);
+			}
+		}
+		return Openings;
+	}
+}
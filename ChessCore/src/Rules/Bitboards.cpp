@@ -0,0 +1,154 @@
+#include "Rules/Bitboards.h"
+#include <mutex>
+
+namespace we
+{
+	namespace Bitboards
+	{
+		Bitboard PawnAttacks[ColorCount][64];
+		Bitboard KnightAttacks[64];
+		Bitboard KingAttacks[64];
+		Bitboard Between[64][64];
+		Bitboard Line[64][64];
+		Bitboard AdjacentFiles[8];
+		Bitboard ForwardFiles[ColorCount][64];
+		Bitboard PassedPawnSpan[ColorCount][64];
+
+		namespace
+		{
+			// ----------------------------------------------------
+			// Ray Tables (N, NE, E, SE, S, SW, W, NW)
+			// ----------------------------------------------------
+			enum EDirection { North, NorthEast, East, SouthEast, South, SouthWest, West, NorthWest, DirectionCount };
+
+			constexpr int FileStep[DirectionCount] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+			constexpr int RankStep[DirectionCount] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+			constexpr bool bIsPositive[DirectionCount] = { true, true, true, false, false, false, false, true };
+
+			Bitboard Rays[DirectionCount][64];
+
+			Bitboard RayAttacks(EDirection Dir, Square Sq, Bitboard Occupied)
+			{
+				Bitboard Attacks = Rays[Dir][Sq];
+				Bitboard Blockers = Attacks & Occupied;
+				if (Blockers)
+				{
+					Square Blocker = bIsPositive[Dir] ? Lsb(Blockers) : Msb(Blockers);
+					Attacks ^= Rays[Dir][Blocker];
+				}
+				return Attacks;
+			}
+
+			Bitboard StepAttacks(Square Sq, const int (*Steps)[2], int StepCount)
+			{
+				Bitboard Attacks = 0;
+				for (int i = 0; i < StepCount; ++i)
+				{
+					int File = FileOf(Sq) + Steps[i][0];
+					int Rank = RankOf(Sq) + Steps[i][1];
+					if (File >= 0 && File < 8 && Rank >= 0 && Rank < 8)
+					{
+						Attacks |= SquareBB(MakeSquare(File, Rank));
+					}
+				}
+				return Attacks;
+			}
+
+			void InitTables()
+			{
+				static constexpr int KnightSteps[8][2] = { {1,2},{2,1},{2,-1},{1,-2},{-1,-2},{-2,-1},{-2,1},{-1,2} };
+				static constexpr int KingSteps[8][2] = { {0,1},{1,1},{1,0},{1,-1},{0,-1},{-1,-1},{-1,0},{-1,1} };
+				static constexpr int WhitePawnSteps[2][2] = { {-1,1},{1,1} };
+				static constexpr int BlackPawnSteps[2][2] = { {-1,-1},{1,-1} };
+
+				for (Square Sq = 0; Sq < 64; ++Sq)
+				{
+					for (int Dir = 0; Dir < DirectionCount; ++Dir)
+					{
+						Bitboard Ray = 0;
+						int File = FileOf(Sq) + FileStep[Dir];
+						int Rank = RankOf(Sq) + RankStep[Dir];
+						while (File >= 0 && File < 8 && Rank >= 0 && Rank < 8)
+						{
+							Ray |= SquareBB(MakeSquare(File, Rank));
+							File += FileStep[Dir];
+							Rank += RankStep[Dir];
+						}
+						Rays[Dir][Sq] = Ray;
+					}
+
+					KnightAttacks[Sq] = StepAttacks(Sq, KnightSteps, 8);
+					KingAttacks[Sq] = StepAttacks(Sq, KingSteps, 8);
+					PawnAttacks[White][Sq] = StepAttacks(Sq, WhitePawnSteps, 2);
+					PawnAttacks[Black][Sq] = StepAttacks(Sq, BlackPawnSteps, 2);
+				}
+
+				for (int File = 0; File < 8; ++File)
+				{
+					AdjacentFiles[File] = (File > 0 ? FileBB(File - 1) : 0) | (File < 7 ? FileBB(File + 1) : 0);
+				}
+
+				for (Square Sq = 0; Sq < 64; ++Sq)
+				{
+					ForwardFiles[White][Sq] = Rays[North][Sq];
+					ForwardFiles[Black][Sq] = Rays[South][Sq];
+
+					for (EColor Color : { White, Black })
+					{
+						Bitboard Span = ForwardFiles[Color][Sq];
+						Span |= Shift<1>(Span) | Shift<-1>(Span);
+						PassedPawnSpan[Color][Sq] = Span;
+					}
+
+					for (Square To = 0; To < 64; ++To)
+					{
+						Between[Sq][To] = 0;
+						Line[Sq][To] = 0;
+						if (Sq == To) { continue; }
+
+						for (int Dir = 0; Dir < DirectionCount; ++Dir)
+						{
+							if (Rays[Dir][Sq] & SquareBB(To))
+							{
+								int Opposite = (Dir + 4) % DirectionCount;
+								Between[Sq][To] = Rays[Dir][Sq] & Rays[Opposite][To];
+								Line[Sq][To] = Rays[Dir][Sq] | Rays[Opposite][Sq] | SquareBB(Sq);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		void Init()
+		{
+			static std::once_flag InitFlag;
+			std::call_once(InitFlag, InitTables);
+		}
+
+		Bitboard BishopAttacks(Square Sq, Bitboard Occupied)
+		{
+			return RayAttacks(NorthEast, Sq, Occupied) | RayAttacks(SouthEast, Sq, Occupied)
+				| RayAttacks(SouthWest, Sq, Occupied) | RayAttacks(NorthWest, Sq, Occupied);
+		}
+
+		Bitboard RookAttacks(Square Sq, Bitboard Occupied)
+		{
+			return RayAttacks(North, Sq, Occupied) | RayAttacks(East, Sq, Occupied)
+				| RayAttacks(South, Sq, Occupied) | RayAttacks(West, Sq, Occupied);
+		}
+
+		Bitboard Attacks(EPieceType Type, Square Sq, Bitboard Occupied)
+		{
+			switch (Type)
+			{
+			case Knight: return KnightAttacks[Sq];
+			case Bishop: return BishopAttacks(Sq, Occupied);
+			case Rook:   return RookAttacks(Sq, Occupied);
+			case Queen:  return QueenAttacks(Sq, Occupied);
+			case King:   return KingAttacks[Sq];
+			default:     return 0;
+			}
+		}
+	}
+}
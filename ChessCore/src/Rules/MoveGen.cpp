@@ -0,0 +1,385 @@
+#include "Rules/MoveGen.h"
+
+namespace we
+{
+	namespace
+	{
+		void AddPromotions(MoveList& Moves, Square From, Square To, bool bCapture, EMoveGenType Type)
+		{
+			const int Base = bCapture ? KnightPromotionCapture : KnightPromotion;
+
+			// Queen promotions always count as tactical; under-promotions follow the capture flag
+			if (Type != EMoveGenType::Quiets)
+			{
+				Moves.Add(Move{ From, To, EMoveFlag(Base + 3) });
+			}
+
+			const bool bUnderPromotions = Type == EMoveGenType::All || (Type == EMoveGenType::Captures) == bCapture;
+			if (!bUnderPromotions) { return; }
+
+			for (int Offset = 0; Offset < 3; ++Offset)
+			{
+				Moves.Add(Move{ From, To, EMoveFlag(Base + Offset) });
+			}
+		}
+
+		void GeneratePawnMoves(const Position& Pos, MoveList& Moves, EMoveGenType Type)
+		{
+			const EColor Us = Pos.GetSideToMove();
+			const EColor Them = ~Us;
+			const int Push = PawnPush(Us);
+			const Bitboard Empty = ~Pos.Pieces();
+			const Bitboard Enemies = Pos.Pieces(Them);
+			const Bitboard PromotionRank = RankBB(Us == White ? 7 : 0);
+			const Bitboard DoublePushRank = RankBB(Us == White ? 3 : 4);
+
+			Bitboard Pawns = Pos.Pieces(Us, Pawn);
+			while (Pawns)
+			{
+				const Square From = PopLsb(Pawns);
+				const Square OneStep = From + Push;
+
+				if (Empty & SquareBB(OneStep))
+				{
+					if (SquareBB(OneStep) & PromotionRank)
+					{
+						AddPromotions(Moves, From, OneStep, false, Type);
+					}
+					else if (Type != EMoveGenType::Captures)
+					{
+						Moves.Add(Move{ From, OneStep });
+
+						const Square TwoStep = OneStep + Push;
+						if ((SquareBB(TwoStep) & DoublePushRank) && (Empty & SquareBB(TwoStep)))
+						{
+							Moves.Add(Move{ From, TwoStep, DoublePawnPush });
+						}
+					}
+				}
+
+				Bitboard Targets = Bitboards::PawnAttacks[Us][From] & Enemies;
+				while (Targets)
+				{
+					const Square To = PopLsb(Targets);
+					if (SquareBB(To) & PromotionRank)
+					{
+						AddPromotions(Moves, From, To, true, Type);
+					}
+					else if (Type != EMoveGenType::Quiets)
+					{
+						Moves.Add(Move{ From, To, CaptureMove });
+					}
+				}
+
+				const Square EpSquare = Pos.GetEnPassant();
+				if (EpSquare != NoSquare && Type != EMoveGenType::Quiets
+					&& (Bitboards::PawnAttacks[Us][From] & SquareBB(EpSquare)))
+				{
+					Moves.Add(Move{ From, EpSquare, EnPassantCapture });
+				}
+			}
+		}
+
+		void GeneratePieceMoves(const Position& Pos, MoveList& Moves, EMoveGenType Type)
+		{
+			const EColor Us = Pos.GetSideToMove();
+			const Bitboard Occupied = Pos.Pieces();
+			const Bitboard Enemies = Pos.Pieces(~Us);
+			const Bitboard Empty = ~Occupied;
+
+			for (EPieceType PieceType : { Knight, Bishop, Rook, Queen, King })
+			{
+				Bitboard Movers = Pos.Pieces(Us, PieceType);
+				while (Movers)
+				{
+					const Square From = PopLsb(Movers);
+					const Bitboard Attacks = Bitboards::Attacks(PieceType, From, Occupied);
+
+					if (Type != EMoveGenType::Quiets)
+					{
+						Bitboard Captures = Attacks & Enemies;
+						while (Captures)
+						{
+							Moves.Add(Move{ From, PopLsb(Captures), CaptureMove });
+						}
+					}
+
+					if (Type != EMoveGenType::Captures)
+					{
+						Bitboard Quiets = Attacks & Empty;
+						while (Quiets)
+						{
+							Moves.Add(Move{ From, PopLsb(Quiets) });
+						}
+					}
+				}
+			}
+		}
+
+		void GenerateCastling(const Position& Pos, MoveList& Moves)
+		{
+			const EColor Us = Pos.GetSideToMove();
+			const Square KingFrom = MakeSquare(4, Us == White ? 0 : 7);
+
+			if (Pos.CanCastle(Us == White ? WhiteKingSide : BlackKingSide))
+			{
+				Moves.Add(Move{ KingFrom, KingFrom + 2, KingCastle });
+			}
+			if (Pos.CanCastle(Us == White ? WhiteQueenSide : BlackQueenSide))
+			{
+				Moves.Add(Move{ KingFrom, KingFrom - 2, QueenCastle });
+			}
+		}
+	}
+
+	// ----------------------------------------------------
+	// Move Generation
+	// ----------------------------------------------------
+	void GenerateMoves(const Position& Pos, MoveList& Moves, EMoveGenType Type)
+	{
+		GeneratePawnMoves(Pos, Moves, Type);
+		GeneratePieceMoves(Pos, Moves, Type);
+
+		if (Type != EMoveGenType::Captures)
+		{
+			GenerateCastling(Pos, Moves);
+		}
+	}
+
+	void GenerateLegalMoves(const Position& Pos, MoveList& Moves)
+	{
+		MoveList Pseudo;
+		GenerateMoves(Pos, Pseudo);
+
+		for (Move Candidate : Pseudo)
+		{
+			if (Pos.IsLegal(Candidate))
+			{
+				Moves.Add(Candidate);
+			}
+		}
+	}
+
+	bool HasLegalMove(const Position& Pos)
+	{
+		MoveList Pseudo;
+		GenerateMoves(Pos, Pseudo);
+
+		for (Move Candidate : Pseudo)
+		{
+			if (Pos.IsLegal(Candidate))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	std::uint64_t Perft(Position& Pos, int Depth)
+	{
+		MoveList Moves;
+		GenerateLegalMoves(Pos, Moves);
+
+		if (Depth <= 1)
+		{
+			return Depth == 1 ? Moves.Size() : 1;
+		}
+
+		std::uint64_t Nodes = 0;
+		for (Move Candidate : Moves)
+		{
+			Pos.MakeMove(Candidate);
+			Nodes += Perft(Pos, Depth - 1);
+			Pos.UnmakeMove(Candidate);
+		}
+		return Nodes;
+	}
+
+	// ----------------------------------------------------
+	// Coordinate Notation
+	// ----------------------------------------------------
+	string SquareToString(Square Sq)
+	{
+		return string{ char('a' + FileOf(Sq)), char('1' + RankOf(Sq)) };
+	}
+
+	string MoveToUci(Move InMove)
+	{
+		if (InMove.IsNull()) { return "0000"; }
+
+		string Text = SquareToString(InMove.From()) + SquareToString(InMove.To());
+		if (InMove.IsPromotion())
+		{
+			Text += " nbrq"[InMove.PromotionType() - Pawn];
+		}
+		return Text;
+	}
+
+	Move ParseUciMove(const Position& Pos, const string& Text)
+	{
+		MoveList Moves;
+		GenerateLegalMoves(Pos, Moves);
+
+		for (Move Candidate : Moves)
+		{
+			if (MoveToUci(Candidate) == Text)
+			{
+				return Candidate;
+			}
+		}
+		return NullMove;
+	}
+
+	// ----------------------------------------------------
+	// Standard Algebraic Notation
+	// ----------------------------------------------------
+	string MoveToSan(Position& Pos, Move InMove)
+	{
+		if (InMove.IsNull()) { return "--"; }
+
+		const Square From = InMove.From();
+		const Square To = InMove.To();
+		const EPieceType Type = TypeOf(Pos.PieceOn(From));
+		string Text;
+
+		if (InMove.IsCastle())
+		{
+			Text = InMove.Flag() == KingCastle ? "O-O" : "O-O-O";
+		}
+		else if (Type == Pawn)
+		{
+			if (InMove.IsCapture())
+			{
+				Text += char('a' + FileOf(From));
+				Text += 'x';
+			}
+			Text += SquareToString(To);
+			if (InMove.IsPromotion())
+			{
+				Text += '=';
+				Text += " PNBRQK"[InMove.PromotionType()];
+			}
+		}
+		else
+		{
+			Text += " PNBRQK"[Type];
+
+			// Name the file, else the rank, else both, of the other pieces that could go there
+			MoveList Moves;
+			GenerateLegalMoves(Pos, Moves);
+			bool bAmbiguous = false, bSameFile = false, bSameRank = false;
+			for (Move Other : Moves)
+			{
+				if (Other.To() != To || Other.From() == From || TypeOf(Pos.PieceOn(Other.From())) != Type) { continue; }
+				bAmbiguous = true;
+				bSameFile |= FileOf(Other.From()) == FileOf(From);
+				bSameRank |= RankOf(Other.From()) == RankOf(From);
+			}
+			if (bAmbiguous)
+			{
+				if (!bSameFile)
+				{
+					Text += char('a' + FileOf(From));
+				}
+				else if (!bSameRank)
+				{
+					Text += char('1' + RankOf(From));
+				}
+				else
+				{
+					Text += SquareToString(From);
+				}
+			}
+
+			if (InMove.IsCapture())
+			{
+				Text += 'x';
+			}
+			Text += SquareToString(To);
+		}
+
+		Pos.MakeMove(InMove);
+		if (Pos.IsInCheck())
+		{
+			Text += HasLegalMove(Pos) ? '+' : '#';
+		}
+		Pos.UnmakeMove(InMove);
+		return Text;
+	}
+
+	Move ParseSanMove(const Position& Pos, std::string_view Text)
+	{
+		// Copied to the stack, since the parser calls this once per token
+		char Buffer[16];
+		std::size_t Length = 0;
+		for (char Each : Text)
+		{
+			if (Each != 'x' && Each != '=' && Each != '+' && Each != '#' && Each != '!' && Each != '?')
+			{
+				if (Length == sizeof(Buffer)) { return NullMove; }
+				Buffer[Length++] = Each;
+			}
+		}
+		std::string_view San{ Buffer, Length };
+
+		// Legality is only checked for the few moves that match the text
+		MoveList Moves;
+		GenerateMoves(Pos, Moves);
+
+		if (San == "O-O" || San == "0-0" || San == "O-O-O" || San == "0-0-0")
+		{
+			const EMoveFlag Flag = San.size() == 3 ? KingCastle : QueenCastle;
+			for (Move Candidate : Moves)
+			{
+				if (Candidate.Flag() == Flag && Pos.IsLegal(Candidate)) { return Candidate; }
+			}
+			return NullMove;
+		}
+
+		constexpr std::string_view PieceLetters = "PNBRQK";
+		EPieceType Type = Pawn;
+		if (!San.empty() && PieceLetters.find(San.front()) != std::string_view::npos)
+		{
+			Type = EPieceType(Pawn + PieceLetters.find(San.front()));
+			San.remove_prefix(1);
+		}
+
+		EPieceType Promotion = NoPieceType;
+		if (!San.empty() && PieceLetters.find(San.back()) != std::string_view::npos)
+		{
+			Promotion = EPieceType(Pawn + PieceLetters.find(San.back()));
+			San.remove_suffix(1);
+		}
+
+		if (San.size() < 2 || San.size() > 4) { return ParseUciMove(Pos, string(Text)); }
+
+		const std::string_view Target = San.substr(San.size() - 2);
+		if (Target[0] < 'a' || Target[0] > 'h' || Target[1] < '1' || Target[1] > '8') { return NullMove; }
+		const Square To = MakeSquare(Target[0] - 'a', Target[1] - '1');
+
+		// Whatever precedes the target square narrows down the origin
+		int FromFile = -1;
+		int FromRank = -1;
+		for (std::size_t i = 0; i + 2 < San.size(); ++i)
+		{
+			if (San[i] >= 'a' && San[i] <= 'h') { FromFile = San[i] - 'a'; }
+			else if (San[i] >= '1' && San[i] <= '8') { FromRank = San[i] - '1'; }
+			else { return NullMove; }
+		}
+
+		Move Found = NullMove;
+		for (Move Candidate : Moves)
+		{
+			if (Candidate.To() != To || TypeOf(Pos.PieceOn(Candidate.From())) != Type) { continue; }
+			if (FromFile >= 0 && FileOf(Candidate.From()) != FromFile) { continue; }
+			if (FromRank >= 0 && RankOf(Candidate.From()) != FromRank) { continue; }
+			if (Candidate.IsPromotion() && Candidate.PromotionType() != (Promotion == NoPieceType ? Queen : Promotion)) { continue; }
+			if (!Candidate.IsPromotion() && Promotion != NoPieceType) { continue; }
+			if (!Pos.IsLegal(Candidate)) { continue; }
+
+			if (!Found.IsNull()) { return NullMove; }
+			Found = Candidate;
+		}
+		return Found;
+	}
+}
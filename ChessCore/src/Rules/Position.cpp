@@ -0,0 +1,645 @@
+#include "Rules/Position.h"
+#include "Rules/Zobrist.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <sstream>
+
+namespace we
+{
+	namespace
+	{
+		// Castling rights that survive a move touching each square
+		int CastlingMask[64];
+
+		struct CastlingMaskInit
+		{
+			CastlingMaskInit()
+			{
+				for (int& Mask : CastlingMask) { Mask = AllCastling; }
+				CastlingMask[MakeSquare(4, 0)] &= ~(WhiteKingSide | WhiteQueenSide);
+				CastlingMask[MakeSquare(7, 0)] &= ~WhiteKingSide;
+				CastlingMask[MakeSquare(0, 0)] &= ~WhiteQueenSide;
+				CastlingMask[MakeSquare(4, 7)] &= ~(BlackKingSide | BlackQueenSide);
+				CastlingMask[MakeSquare(7, 7)] &= ~BlackKingSide;
+				CastlingMask[MakeSquare(0, 7)] &= ~BlackQueenSide;
+			}
+		} CastlingMaskInitializer;
+
+		// Serials are unique across positions and threads without sharing a counter
+		std::uint64_t NewStateSerial()
+		{
+			static std::atomic<std::uint64_t> NextThreadTag{ 0 };
+			thread_local const std::uint64_t ThreadTag = ++NextThreadTag << 40;
+			thread_local std::uint64_t Counter = 0;
+			return ThreadTag | ++Counter;
+		}
+
+		constexpr const char* PieceChars = " PNBRQK  pnbrqk";
+
+		EvalScore PieceSquareScore(EPiece Piece, Square Sq)
+		{
+			EPieceType Type = TypeOf(Piece);
+			if (ColorOf(Piece) == White)
+			{
+				return EvalParams::PieceValue[Type] + EvalParams::PieceSquare[Type][FlipRank(Sq)];
+			}
+			return -(EvalParams::PieceValue[Type] + EvalParams::PieceSquare[Type][Sq]);
+		}
+	}
+
+	Position::Position()
+		: Board{}
+		, ByType{}
+		, ByColor{}
+		, SideToMove{ White }
+		, GamePly{ 0 }
+		, History{}
+	{
+		Bitboards::Init();
+		Zobrist::Init();
+		History.reserve(1024);
+		SetFromFen(StartFen);
+	}
+
+	// ----------------------------------------------------
+	// FEN
+	// ----------------------------------------------------
+	bool Position::SetFromFen(const string& Fen)
+	{
+		Clear();
+
+		std::istringstream Stream{ Fen };
+		string Placement, Side, Castling, EnPassant;
+		int Halfmove = 0;
+		int Fullmove = 1;
+
+		Stream >> Placement >> Side >> Castling >> EnPassant;
+		if (Placement.empty()) { return false; }
+		if (!(Stream >> Halfmove)) { Halfmove = 0; }
+		if (!(Stream >> Fullmove)) { Fullmove = 1; }
+
+		int File = 0;
+		int Rank = 7;
+		for (char C : Placement)
+		{
+			// Every rank must account for exactly eight files
+			if (C == '/')
+			{
+				if (File != 8 || Rank == 0) { return false; }
+				File = 0;
+				--Rank;
+			}
+			else if (C >= '1' && C <= '8')
+			{
+				File += C - '0';
+				if (File > 8) { return false; }
+			}
+			else
+			{
+				const char* Found = std::strchr(PieceChars, C);
+				if (!Found || C == ' ' || File > 7) { return false; }
+				PutPiece(EPiece(Found - PieceChars), MakeSquare(File, Rank));
+				++File;
+			}
+		}
+		if (Rank != 0 || File != 8) { return false; }
+
+		if (PopCount(Pieces(White, King)) != 1 || PopCount(Pieces(Black, King)) != 1) { return false; }
+		if (Pieces(Pawn) & (Rank1BB | Rank8BB)) { return false; }
+
+		// The side that just moved cannot have left its own king in check
+		SideToMove = (Side == "b") ? Black : White;
+		if (IsSquareAttacked(KingSquare(~SideToMove), SideToMove)) { return false; }
+
+		StateInfo& NewState = State();
+		for (char C : Castling)
+		{
+			switch (C)
+			{
+			case 'K': NewState.CastlingRights |= WhiteKingSide; break;
+			case 'Q': NewState.CastlingRights |= WhiteQueenSide; break;
+			case 'k': NewState.CastlingRights |= BlackKingSide; break;
+			case 'q': NewState.CastlingRights |= BlackQueenSide; break;
+			default: break;
+			}
+		}
+
+		// A right whose king or rook has left its home square can never be used
+		for (EColor Color : { White, Black })
+		{
+			const int HomeRank = Color == White ? 0 : 7;
+			const int KingSide = Color == White ? WhiteKingSide : BlackKingSide;
+			const int QueenSide = Color == White ? WhiteQueenSide : BlackQueenSide;
+			if (PieceOn(MakeSquare(4, HomeRank)) != MakePiece(Color, King))
+			{
+				NewState.CastlingRights &= ~(KingSide | QueenSide);
+			}
+			if (PieceOn(MakeSquare(7, HomeRank)) != MakePiece(Color, Rook))
+			{
+				NewState.CastlingRights &= ~KingSide;
+			}
+			if (PieceOn(MakeSquare(0, HomeRank)) != MakePiece(Color, Rook))
+			{
+				NewState.CastlingRights &= ~QueenSide;
+			}
+		}
+
+		if (!EnPassant.empty() && EnPassant != "-")
+		{
+			if (EnPassant.size() != 2 || EnPassant[0] < 'a' || EnPassant[0] > 'h' || EnPassant[1] < '1' || EnPassant[1] > '8') { return false; }
+
+			// Only the square behind a pawn that just moved two squares counts
+			Square EpSquare = MakeSquare(EnPassant[0] - 'a', EnPassant[1] - '1');
+			if (RelativeRank(SideToMove, EpSquare) == 5 && (Bitboards::PawnAttacks[~SideToMove][EpSquare] & Pieces(SideToMove, Pawn)))
+			{
+				NewState.EnPassant = EpSquare;
+			}
+		}
+
+		NewState.HalfmoveClock = Halfmove;
+		GamePly = std::max(2 * (Fullmove - 1), 0) + (SideToMove == Black ? 1 : 0);
+
+		NewState.Key ^= Zobrist::Castling[NewState.CastlingRights];
+		if (NewState.EnPassant != NoSquare)
+		{
+			NewState.Key ^= Zobrist::EnPassantFile[FileOf(NewState.EnPassant)];
+		}
+		if (SideToMove == Black)
+		{
+			NewState.Key ^= Zobrist::SideToMove;
+		}
+
+		UpdateCheckInfo();
+		return true;
+	}
+
+	void Position::SetFromPieces(const EPiece* InPieces, const Square* Squares, int Count, EColor InSideToMove)
+	{
+		Clear();
+		for (int i = 0; i < Count; ++i)
+		{
+			PutPiece(InPieces[i], Squares[i]);
+		}
+
+		SideToMove = InSideToMove;
+		if (SideToMove == Black)
+		{
+			State().Key ^= Zobrist::SideToMove;
+		}
+		UpdateCheckInfo();
+	}
+
+	string Position::GetFen() const
+	{
+		std::ostringstream Stream;
+
+		for (int Rank = 7; Rank >= 0; --Rank)
+		{
+			int Empty = 0;
+			for (int File = 0; File < 8; ++File)
+			{
+				EPiece Piece = Board[MakeSquare(File, Rank)];
+				if (Piece == NoPiece)
+				{
+					++Empty;
+					continue;
+				}
+				if (Empty) { Stream << Empty; Empty = 0; }
+				Stream << PieceChars[Piece];
+			}
+			if (Empty) { Stream << Empty; }
+			if (Rank > 0) { Stream << '/'; }
+		}
+
+		Stream << (SideToMove == White ? " w " : " b ");
+
+		int Rights = State().CastlingRights;
+		if (Rights == NoCastling) { Stream << '-'; }
+		if (Rights & WhiteKingSide) { Stream << 'K'; }
+		if (Rights & WhiteQueenSide) { Stream << 'Q'; }
+		if (Rights & BlackKingSide) { Stream << 'k'; }
+		if (Rights & BlackQueenSide) { Stream << 'q'; }
+
+		Square EpSquare = State().EnPassant;
+		if (EpSquare == NoSquare) { Stream << " -"; }
+		else { Stream << ' ' << char('a' + FileOf(EpSquare)) << char('1' + RankOf(EpSquare)); }
+
+		Stream << ' ' << State().HalfmoveClock << ' ' << (GamePly / 2 + 1);
+		return Stream.str();
+	}
+
+	// ----------------------------------------------------
+	// Make / Unmake
+	// ----------------------------------------------------
+	void Position::MakeMove(Move InMove)
+	{
+		History.push_back(History.back());
+		StateInfo& NewState = History.back();
+
+		const EColor Us = SideToMove;
+		const EColor Them = ~Us;
+		const Square From = InMove.From();
+		const Square To = InMove.To();
+		const EPiece Piece = Board[From];
+		const EMoveFlag Flag = InMove.Flag();
+
+		NewState.HalfmoveClock++;
+		NewState.PliesFromNull++;
+		NewState.Captured = NoPiece;
+		NewState.Serial = NewStateSerial();
+		NewState.Dirty.Count = 0;
+		NewState.Key ^= Zobrist::SideToMove;
+
+		if (NewState.EnPassant != NoSquare)
+		{
+			NewState.Key ^= Zobrist::EnPassantFile[FileOf(NewState.EnPassant)];
+			NewState.EnPassant = NoSquare;
+		}
+
+		if (InMove.IsCastle())
+		{
+			Square RookFrom = (Flag == KingCastle) ? From + 3 : From - 4;
+			Square RookTo = (Flag == KingCastle) ? From + 1 : From - 1;
+			NewState.Dirty.Add(Piece, From, To);
+			NewState.Dirty.Add(Board[RookFrom], RookFrom, RookTo);
+			MovePiece(From, To);
+			MovePiece(RookFrom, RookTo);
+		}
+		else
+		{
+			if (InMove.IsCapture())
+			{
+				Square CaptureSquare = (Flag == EnPassantCapture) ? To - PawnPush(Us) : To;
+				NewState.Captured = Board[CaptureSquare];
+				NewState.Dirty.Add(NewState.Captured, CaptureSquare, NoSquare);
+				RemovePiece(CaptureSquare);
+				NewState.HalfmoveClock = 0;
+			}
+
+			if (InMove.IsPromotion())
+			{
+				NewState.Dirty.Add(Piece, From, NoSquare);
+				NewState.Dirty.Add(MakePiece(Us, InMove.PromotionType()), NoSquare, To);
+			}
+			else
+			{
+				NewState.Dirty.Add(Piece, From, To);
+			}
+
+			MovePiece(From, To);
+
+			if (TypeOf(Piece) == Pawn)
+			{
+				NewState.HalfmoveClock = 0;
+
+				if (Flag == DoublePawnPush)
+				{
+					Square EpSquare = From + PawnPush(Us);
+					if (Bitboards::PawnAttacks[Us][EpSquare] & Pieces(Them, Pawn))
+					{
+						NewState.EnPassant = EpSquare;
+						NewState.Key ^= Zobrist::EnPassantFile[FileOf(EpSquare)];
+					}
+				}
+				else if (InMove.IsPromotion())
+				{
+					RemovePiece(To);
+					PutPiece(MakePiece(Us, InMove.PromotionType()), To);
+				}
+			}
+		}
+
+		int NewRights = NewState.CastlingRights & CastlingMask[From] & CastlingMask[To];
+		if (NewRights != NewState.CastlingRights)
+		{
+			NewState.Key ^= Zobrist::Castling[NewState.CastlingRights] ^ Zobrist::Castling[NewRights];
+			NewState.CastlingRights = NewRights;
+		}
+
+		SideToMove = Them;
+		++GamePly;
+		UpdateCheckInfo();
+	}
+
+	void Position::UnmakeMove(Move InMove)
+	{
+		const EPiece Captured = State().Captured;
+
+		// The board helpers also patch the key and scores of the current state,
+		// which is about to be discarded, so the restored state stays untouched
+		SideToMove = ~SideToMove;
+		--GamePly;
+
+		const EColor Us = SideToMove;
+		const Square From = InMove.From();
+		const Square To = InMove.To();
+		const EMoveFlag Flag = InMove.Flag();
+
+		if (InMove.IsCastle())
+		{
+			Square RookFrom = (Flag == KingCastle) ? From + 3 : From - 4;
+			Square RookTo = (Flag == KingCastle) ? From + 1 : From - 1;
+			MovePiece(To, From);
+			MovePiece(RookTo, RookFrom);
+		}
+		else
+		{
+			if (InMove.IsPromotion())
+			{
+				RemovePiece(To);
+				PutPiece(MakePiece(Us, Pawn), To);
+			}
+
+			MovePiece(To, From);
+
+			if (Captured != NoPiece)
+			{
+				Square CaptureSquare = (Flag == EnPassantCapture) ? To - PawnPush(Us) : To;
+				PutPiece(Captured, CaptureSquare);
+			}
+		}
+
+		History.pop_back();
+	}
+
+	void Position::MakeNullMove()
+	{
+		History.push_back(History.back());
+		StateInfo& NewState = History.back();
+
+		NewState.Key ^= Zobrist::SideToMove;
+		if (NewState.EnPassant != NoSquare)
+		{
+			NewState.Key ^= Zobrist::EnPassantFile[FileOf(NewState.EnPassant)];
+			NewState.EnPassant = NoSquare;
+		}
+		NewState.HalfmoveClock++;
+		NewState.PliesFromNull = 0;
+		NewState.Captured = NoPiece;
+		NewState.Serial = NewStateSerial();
+		NewState.Dirty.Count = 0;
+
+		SideToMove = ~SideToMove;
+		++GamePly;
+		UpdateCheckInfo();
+	}
+
+	void Position::UnmakeNullMove()
+	{
+		SideToMove = ~SideToMove;
+		--GamePly;
+		History.pop_back();
+	}
+
+	// ----------------------------------------------------
+	// Board Helpers
+	// ----------------------------------------------------
+	void Position::Clear()
+	{
+		for (EPiece& Piece : Board) { Piece = NoPiece; }
+		for (Bitboard& B : ByType) { B = 0; }
+		for (Bitboard& B : ByColor) { B = 0; }
+		SideToMove = White;
+		GamePly = 0;
+		History.clear();
+		History.emplace_back();
+		History.back().PawnKey = Zobrist::NoPawns;
+		History.back().Serial = NewStateSerial();
+	}
+
+	void Position::PutPiece(EPiece Piece, Square Sq)
+	{
+		Board[Sq] = Piece;
+		ByType[TypeOf(Piece)] |= SquareBB(Sq);
+		ByColor[ColorOf(Piece)] |= SquareBB(Sq);
+
+		StateInfo& Current = State();
+		Current.Key ^= Zobrist::PieceSquare[Piece][Sq];
+		if (TypeOf(Piece) == Pawn) { Current.PawnKey ^= Zobrist::PieceSquare[Piece][Sq]; }
+		Current.PsqScore += PieceSquareScore(Piece, Sq);
+		Current.Phase += EvalParams::PhaseWeight[TypeOf(Piece)];
+	}
+
+	void Position::RemovePiece(Square Sq)
+	{
+		EPiece Piece = Board[Sq];
+		Board[Sq] = NoPiece;
+		ByType[TypeOf(Piece)] ^= SquareBB(Sq);
+		ByColor[ColorOf(Piece)] ^= SquareBB(Sq);
+
+		StateInfo& Current = State();
+		Current.Key ^= Zobrist::PieceSquare[Piece][Sq];
+		if (TypeOf(Piece) == Pawn) { Current.PawnKey ^= Zobrist::PieceSquare[Piece][Sq]; }
+		Current.PsqScore -= PieceSquareScore(Piece, Sq);
+		Current.Phase -= EvalParams::PhaseWeight[TypeOf(Piece)];
+	}
+
+	void Position::MovePiece(Square From, Square To)
+	{
+		EPiece Piece = Board[From];
+		Bitboard FromTo = SquareBB(From) | SquareBB(To);
+		Board[From] = NoPiece;
+		Board[To] = Piece;
+		ByType[TypeOf(Piece)] ^= FromTo;
+		ByColor[ColorOf(Piece)] ^= FromTo;
+
+		StateInfo& Current = State();
+		Current.Key ^= Zobrist::PieceSquare[Piece][From] ^ Zobrist::PieceSquare[Piece][To];
+		if (TypeOf(Piece) == Pawn) { Current.PawnKey ^= Zobrist::PieceSquare[Piece][From] ^ Zobrist::PieceSquare[Piece][To]; }
+		Current.PsqScore += PieceSquareScore(Piece, To) - PieceSquareScore(Piece, From);
+	}
+
+	void Position::UpdateCheckInfo()
+	{
+		StateInfo& Current = State();
+		const EColor Us = SideToMove;
+		const EColor Them = ~Us;
+		const Square KingSq = KingSquare(Us);
+
+		Current.Checkers = AttackersTo(KingSq) & Pieces(Them);
+
+		Bitboard Snipers = (Bitboards::RookAttacks(KingSq, 0) & (Pieces(Them, Rook) | Pieces(Them, Queen)))
+			| (Bitboards::BishopAttacks(KingSq, 0) & (Pieces(Them, Bishop) | Pieces(Them, Queen)));
+
+		Current.Pinned = 0;
+		const Bitboard Occupied = Pieces();
+		while (Snipers)
+		{
+			Square Sniper = PopLsb(Snipers);
+			Bitboard Blockers = Bitboards::Between[KingSq][Sniper] & Occupied;
+			if (Blockers && !MoreThanOne(Blockers))
+			{
+				Current.Pinned |= Blockers & Pieces(Us);
+			}
+		}
+	}
+
+	// ----------------------------------------------------
+	// Attack Queries
+	// ----------------------------------------------------
+	Bitboard Position::AttackersTo(Square Sq, Bitboard Occupied) const
+	{
+		return (Bitboards::PawnAttacks[Black][Sq] & Pieces(White, Pawn))
+			| (Bitboards::PawnAttacks[White][Sq] & Pieces(Black, Pawn))
+			| (Bitboards::KnightAttacks[Sq] & Pieces(Knight))
+			| (Bitboards::RookAttacks(Sq, Occupied) & (Pieces(Rook) | Pieces(Queen)))
+			| (Bitboards::BishopAttacks(Sq, Occupied) & (Pieces(Bishop) | Pieces(Queen)))
+			| (Bitboards::KingAttacks[Sq] & Pieces(King));
+	}
+
+	bool Position::IsSquareAttacked(Square Sq, EColor Attacker) const
+	{
+		return (AttackersTo(Sq) & Pieces(Attacker)) != 0;
+	}
+
+	bool Position::CanCastle(ECastlingRights Right) const
+	{
+		if (!(State().CastlingRights & Right) || IsInCheck()) { return false; }
+
+		const bool bKingSide = (Right == WhiteKingSide || Right == BlackKingSide);
+		const EColor Us = (Right == WhiteKingSide || Right == WhiteQueenSide) ? White : Black;
+		const Square KingFrom = MakeSquare(4, Us == White ? 0 : 7);
+		const Square RookFrom = bKingSide ? KingFrom + 3 : KingFrom - 4;
+		const Square KingTo = bKingSide ? KingFrom + 2 : KingFrom - 2;
+
+		if (Board[RookFrom] != MakePiece(Us, Rook)) { return false; }
+		if (Bitboards::Between[KingFrom][RookFrom] & Pieces()) { return false; }
+
+		const int Step = bKingSide ? 1 : -1;
+		for (Square Sq = KingFrom + Step; ; Sq += Step)
+		{
+			if (IsSquareAttacked(Sq, ~Us)) { return false; }
+			if (Sq == KingTo) { break; }
+		}
+		return true;
+	}
+
+	bool Position::IsLegal(Move InMove) const
+	{
+		const EColor Us = SideToMove;
+		const Square From = InMove.From();
+		const Square To = InMove.To();
+		const Square KingSq = KingSquare(Us);
+
+		if (InMove.Flag() == EnPassantCapture)
+		{
+			Square CaptureSquare = To - PawnPush(Us);
+			Bitboard Occupied = (Pieces() ^ SquareBB(From) ^ SquareBB(CaptureSquare)) | SquareBB(To);
+			return !(Bitboards::RookAttacks(KingSq, Occupied) & (Pieces(~Us, Rook) | Pieces(~Us, Queen)))
+				&& !(Bitboards::BishopAttacks(KingSq, Occupied) & (Pieces(~Us, Bishop) | Pieces(~Us, Queen)))
+				&& !(Bitboards::KnightAttacks[KingSq] & Pieces(~Us, Knight) & ~SquareBB(To))
+				&& !(Bitboards::PawnAttacks[Us][KingSq] & Pieces(~Us, Pawn) & ~SquareBB(CaptureSquare));
+		}
+
+		if (TypeOf(Board[From]) == King)
+		{
+			// Castling paths are fully verified during generation
+			if (InMove.IsCastle()) { return true; }
+			return !(AttackersTo(To, Pieces() ^ SquareBB(From)) & Pieces(~Us));
+		}
+
+		if (MoreThanOne(State().Checkers)) { return false; }
+
+		if (State().Checkers)
+		{
+			// A single check must be captured or blocked
+			Square Checker = Lsb(State().Checkers);
+			if (!((Bitboards::Between[KingSq][Checker] | SquareBB(Checker)) & SquareBB(To))) { return false; }
+		}
+
+		return !(State().Pinned & SquareBB(From)) || (Bitboards::Line[From][To] & SquareBB(KingSq));
+	}
+
+	bool Position::IsPseudoLegal(Move InMove) const
+	{
+		if (InMove.IsNull()) { return false; }
+
+		const EColor Us = SideToMove;
+		const Square From = InMove.From();
+		const Square To = InMove.To();
+		const EPiece Piece = Board[From];
+		const EPiece Target = Board[To];
+		const EMoveFlag Flag = InMove.Flag();
+
+		if (Piece == NoPiece || ColorOf(Piece) != Us) { return false; }
+		if (Target != NoPiece && (ColorOf(Target) == Us || TypeOf(Target) == King)) { return false; }
+
+		if (InMove.IsCastle())
+		{
+			if (TypeOf(Piece) != King) { return false; }
+			ECastlingRights Right = Us == White
+				? (Flag == KingCastle ? WhiteKingSide : WhiteQueenSide)
+				: (Flag == KingCastle ? BlackKingSide : BlackQueenSide);
+			return From == MakeSquare(4, Us == White ? 0 : 7)
+				&& To == (Flag == KingCastle ? From + 2 : From - 2)
+				&& CanCastle(Right);
+		}
+
+		if (Flag == EnPassantCapture)
+		{
+			return TypeOf(Piece) == Pawn
+				&& To == State().EnPassant
+				&& (Bitboards::PawnAttacks[Us][From] & SquareBB(To));
+		}
+
+		if (InMove.IsCapture() != (Target != NoPiece)) { return false; }
+
+		if (TypeOf(Piece) == Pawn)
+		{
+			if ((RelativeRank(Us, To) == 7) != InMove.IsPromotion()) { return false; }
+
+			if (InMove.IsCapture())
+			{
+				return (Bitboards::PawnAttacks[Us][From] & SquareBB(To)) != 0;
+			}
+
+			if (Flag == DoublePawnPush)
+			{
+				return RelativeRank(Us, From) == 1
+					&& To == From + 2 * PawnPush(Us)
+					&& Board[From + PawnPush(Us)] == NoPiece;
+			}
+
+			return To == From + PawnPush(Us);
+		}
+
+		if (Flag != QuietMove && Flag != CaptureMove) { return false; }
+		return (Bitboards::Attacks(TypeOf(Piece), From, Pieces()) & SquareBB(To)) != 0;
+	}
+
+	// ----------------------------------------------------
+	// Draw Detection
+	// ----------------------------------------------------
+	bool Position::IsRepetition(int SearchPly) const
+	{
+		const StateInfo& Current = State();
+		const int End = std::min({ Current.HalfmoveClock, Current.PliesFromNull, int(History.size()) - 1 });
+
+		int Count = 0;
+		for (int Distance = 4; Distance <= End; Distance += 2)
+		{
+			if (History[History.size() - 1 - Distance].Key == Current.Key)
+			{
+				// Once inside the search tree a single repetition is enough
+				if (Distance <= SearchPly || ++Count >= 2)
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	bool Position::IsInsufficientMaterial() const
+	{
+		if (Pieces(Pawn) | Pieces(Rook) | Pieces(Queen)) { return false; }
+
+		const Bitboard Minors = Pieces(Knight) | Pieces(Bishop);
+		if (!MoreThanOne(Minors)) { return true; }
+
+		// Any number of bishops that all live on one square colour cannot mate
+		const Bitboard Bishops = Pieces(Bishop);
+		return !Pieces(Knight) && (!(Bishops & DarkSquaresBB) || !(Bishops & ~DarkSquaresBB));
+	}
+}
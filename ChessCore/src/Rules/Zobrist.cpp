@@ -0,0 +1,71 @@
+#include "Rules/Zobrist.h"
+#include <mutex>
+
+namespace we
+{
+	namespace Zobrist
+	{
+		HashKey PieceSquare[PieceCount][64];
+		HashKey Castling[16];
+		HashKey EnPassantFile[8];
+		HashKey SideToMove;
+		HashKey NoPawns;
+
+		namespace
+		{
+			// SplitMix64 with a fixed seed so keys are identical across runs and builds
+			HashKey NextRandom(HashKey& Seed)
+			{
+				HashKey Z = (Seed += 0x9E3779B97F4A7C15ULL);
+				Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+				Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBULL;
+				return Z ^ (Z >> 31);
+			}
+
+			void InitKeys()
+			{
+				HashKey Seed = 1070372;
+
+				for (int Piece = 0; Piece < PieceCount; ++Piece)
+				{
+					for (Square Sq = 0; Sq < 64; ++Sq)
+					{
+						PieceSquare[Piece][Sq] = NextRandom(Seed);
+					}
+				}
+
+				HashKey RightKeys[4];
+				for (HashKey& Key : RightKeys)
+				{
+					Key = NextRandom(Seed);
+				}
+
+				for (int Rights = 0; Rights < 16; ++Rights)
+				{
+					Castling[Rights] = 0;
+					for (int Bit = 0; Bit < 4; ++Bit)
+					{
+						if (Rights & (1 << Bit))
+						{
+							Castling[Rights] ^= RightKeys[Bit];
+						}
+					}
+				}
+
+				for (HashKey& Key : EnPassantFile)
+				{
+					Key = NextRandom(Seed);
+				}
+
+				SideToMove = NextRandom(Seed);
+				NoPawns = NextRandom(Seed);
+			}
+		}
+
+		void Init()
+		{
+			static std::once_flag InitFlag;
+			std::call_once(InitFlag, InitKeys);
+		}
+	}
+}
@@ -0,0 +1,291 @@
+#include "Tuning/EvalTrace.h"
+#include <cmath>
+#include <cstdio>
+
+namespace we
+{
+	namespace EvalTuning
+	{
+		namespace
+		{
+			enum EBlock : int
+			{
+				BlockPieceValue,
+				BlockPieceSquare,
+				BlockKnightMobility,
+				BlockBishopMobility,
+				BlockRookMobility,
+				BlockQueenMobility,
+				BlockPassedPawn,
+				BlockDoubledPawn,
+				BlockIsolatedPawn,
+				BlockBackwardPawn,
+				BlockPassedPawnFree,
+				BlockPawnShield,
+				BlockBishopPair,
+				BlockTempo
+			};
+
+			List<ParamBlock> MakeParamBlocks()
+			{
+				List<ParamBlock> Blocks = {
+					{ "PieceValue", EvalParams::PieceValue, PieceTypeCount, 0, true },
+					{ "PieceSquare", &EvalParams::PieceSquare[0][0], PieceTypeCount * 64, 0, true },
+					{ "KnightMobility", EvalParams::KnightMobility, 9, 0, true },
+					{ "BishopMobility", EvalParams::BishopMobility, 14, 0, true },
+					{ "RookMobility", EvalParams::RookMobility, 15, 0, true },
+					{ "QueenMobility", EvalParams::QueenMobility, 28, 0, true },
+					{ "PassedPawn", EvalParams::PassedPawn, 8, 0, true },
+					{ "DoubledPawn", &EvalParams::DoubledPawn, 1, 0, false },
+					{ "IsolatedPawn", &EvalParams::IsolatedPawn, 1, 0, false },
+					{ "BackwardPawn", &EvalParams::BackwardPawn, 1, 0, false },
+					{ "PassedPawnFree", &EvalParams::PassedPawnFree, 1, 0, false },
+					{ "PawnShield", EvalParams::PawnShield, 2, 0, true },
+					{ "BishopPair", &EvalParams::BishopPair, 1, 0, false },
+					{ "Tempo", &EvalParams::Tempo, 1, 0, false }
+				};
+
+				int Offset = 0;
+				for (ParamBlock& Block : Blocks)
+				{
+					Block.Offset = Offset;
+					Offset += Block.Count;
+				}
+				return Blocks;
+			}
+
+			int ParamIndex(EBlock Block, int Entry)
+			{
+				return GetParamBlocks()[Block].Offset + Entry;
+			}
+
+			void TracePawns(const Position& Pos, EColor Us, int Sign, EvalTrace& Trace)
+			{
+				const EColor Them = ~Us;
+				const Bitboard OurPawns = Pos.Pieces(Us, Pawn);
+				const Bitboard TheirPawns = Pos.Pieces(Them, Pawn);
+				const Bitboard Empty = ~Pos.Pieces();
+
+				Bitboard Pawns = OurPawns;
+				while (Pawns)
+				{
+					const Square Sq = PopLsb(Pawns);
+					const Bitboard Adjacent = Bitboards::AdjacentFiles[FileOf(Sq)];
+
+					if (Bitboards::ForwardFiles[Us][Sq] & OurPawns)
+					{
+						Trace.Add(ParamIndex(BlockDoubledPawn, 0), Sign);
+					}
+
+					if (!(Adjacent & OurPawns))
+					{
+						Trace.Add(ParamIndex(BlockIsolatedPawn, 0), Sign);
+					}
+					else
+					{
+						const Bitboard Supporters = Adjacent & OurPawns & ~Bitboards::PassedPawnSpan[Us][Sq];
+						const Square Stop = Sq + PawnPush(Us);
+						if (!Supporters && (Bitboards::PawnAttacks[Us][Stop] & TheirPawns))
+						{
+							Trace.Add(ParamIndex(BlockBackwardPawn, 0), Sign);
+						}
+					}
+
+					if (!(Bitboards::PassedPawnSpan[Us][Sq] & TheirPawns) && !(Bitboards::ForwardFiles[Us][Sq] & OurPawns))
+					{
+						Trace.Add(ParamIndex(BlockPassedPawn, RelativeRank(Us, Sq)), Sign);
+						if (SquareBB(Sq + PawnPush(Us)) & Empty)
+						{
+							Trace.Add(ParamIndex(BlockPassedPawnFree, 0), Sign);
+						}
+					}
+				}
+
+				const Square KingSq = Pos.KingSquare(Us);
+				const Bitboard Near = Bitboards::PassedPawnSpan[Us][KingSq] & Bitboards::KingAttacks[KingSq];
+				const Bitboard Far = Us == White ? Shift<8>(Near) : Shift<-8>(Near);
+				Trace.Add(ParamIndex(BlockPawnShield, 0), Sign * PopCount(Near & OurPawns));
+				Trace.Add(ParamIndex(BlockPawnShield, 1), Sign * PopCount(Far & OurPawns));
+			}
+
+			void TraceMobility(const Position& Pos, EColor Us, int Sign, EvalTrace& Trace)
+			{
+				const EColor Them = ~Us;
+				const Bitboard Occupied = Pos.Pieces();
+				const Bitboard TheirPawns = Pos.Pieces(Them, Pawn);
+				const Bitboard PawnAttacked = Them == White
+					? Shift<9>(TheirPawns) | Shift<7>(TheirPawns)
+					: Shift<-9>(TheirPawns) | Shift<-7>(TheirPawns);
+				const Bitboard SafeArea = ~(Pos.Pieces(Us) | PawnAttacked);
+
+				const EBlock Blocks[] = { BlockKnightMobility, BlockBishopMobility, BlockRookMobility, BlockQueenMobility };
+				for (EPieceType Type : { Knight, Bishop, Rook, Queen })
+				{
+					const EBlock Block = Blocks[Type - Knight];
+					Bitboard Pieces = Pos.Pieces(Us, Type);
+					while (Pieces)
+					{
+						const int Count = PopCount(Bitboards::Attacks(Type, PopLsb(Pieces), Occupied) & SafeArea);
+						Trace.Add(ParamIndex(Block, std::min(Count, GetParamBlocks()[Block].Count - 1)), Sign);
+					}
+				}
+			}
+
+			string FormatScore(const EvalScore& Score)
+			{
+				char Text[32];
+				std::snprintf(Text, sizeof(Text), "{%3d,%3d}", Score.Mg, Score.Eg);
+				return Text;
+			}
+
+			// Eight entries to a line, indented like the hand-written tables
+			string FormatArray(const EvalScore* Scores, int Count, const string& Indent)
+			{
+				string Text = "{\n";
+				for (int i = 0; i < Count; ++i)
+				{
+					Text += i % 8 == 0 ? Indent + "\t" : " ";
+					Text += FormatScore(Scores[i]);
+					Text += i + 1 < Count ? (i % 8 == 7 ? ",\n" : ",") : "\n";
+				}
+				return Text + Indent + "}";
+			}
+
+			string FormatPieceSquare(const EvalScore* Scores)
+			{
+				constexpr const char* TypeNames[PieceTypeCount] = { "", "Pawn", "Knight", "Bishop", "Rook", "Queen", "King" };
+				string Text = "{\n\t\t\t{},\n";
+				for (int Type = Pawn; Type < PieceTypeCount; ++Type)
+				{
+					Text += "\t\t\t{ // " + string(TypeNames[Type]) + "\n";
+					for (int Row = 0; Row < 8; ++Row)
+					{
+						Text += "\t\t\t\t";
+						for (int Column = 0; Column < 8; ++Column)
+						{
+							Text += FormatScore(Scores[Type * 64 + Row * 8 + Column]);
+							Text += Column < 7 ? ", " : Row < 7 ? ",\n" : "\n";
+						}
+					}
+					Text += Type + 1 < PieceTypeCount ? "\t\t\t},\n" : "\t\t\t}\n";
+				}
+				return Text + "\t\t}";
+			}
+		}
+
+		const List<ParamBlock>& GetParamBlocks()
+		{
+			static const List<ParamBlock> Blocks = MakeParamBlocks();
+			return Blocks;
+		}
+
+		int GetParamCount()
+		{
+			const ParamBlock& Last = GetParamBlocks().back();
+			return Last.Offset + Last.Count;
+		}
+
+		List<EvalScore> GetDefaultParams()
+		{
+			List<EvalScore> Params;
+			for (const ParamBlock& Block : GetParamBlocks())
+			{
+				Params.insert(Params.end(), Block.Defaults, Block.Defaults + Block.Count);
+			}
+			return Params;
+		}
+
+		// ----------------------------------------------------
+		// Evaluation Trace
+		// ----------------------------------------------------
+		void TraceEvaluation(const Position& Pos, EvalTrace& OutTrace)
+		{
+			OutTrace.TermCount = 0;
+			OutTrace.Phase = std::min(Pos.GetPhase(), EvalParams::MaxPhase);
+
+			// Material and piece-square terms, as Position accumulates them
+			Bitboard Occupied = Pos.Pieces();
+			while (Occupied)
+			{
+				const Square Sq = PopLsb(Occupied);
+				const EPiece Piece = Pos.PieceOn(Sq);
+				const EPieceType Type = TypeOf(Piece);
+				const bool bWhite = ColorOf(Piece) == White;
+				const int Sign = bWhite ? 1 : -1;
+				OutTrace.Add(ParamIndex(BlockPieceValue, Type), Sign);
+				OutTrace.Add(ParamIndex(BlockPieceSquare, Type * 64 + (bWhite ? FlipRank(Sq) : Sq)), Sign);
+			}
+
+			TracePawns(Pos, White, 1, OutTrace);
+			TracePawns(Pos, Black, -1, OutTrace);
+			TraceMobility(Pos, White, 1, OutTrace);
+			TraceMobility(Pos, Black, -1, OutTrace);
+
+			if (MoreThanOne(Pos.Pieces(White, Bishop))) { OutTrace.Add(ParamIndex(BlockBishopPair, 0), 1); }
+			if (MoreThanOne(Pos.Pieces(Black, Bishop))) { OutTrace.Add(ParamIndex(BlockBishopPair, 0), -1); }
+
+			OutTrace.Add(ParamIndex(BlockTempo, 0), Pos.GetSideToMove() == White ? 1 : -1);
+		}
+
+		double EvaluateTrace(const EvalTrace& Trace, const double* Weights)
+		{
+			double Mg = 0.0;
+			double Eg = 0.0;
+			for (int i = 0; i < Trace.TermCount; ++i)
+			{
+				const EvalTrace::Term& Term = Trace.Terms[i];
+				Mg += Term.Count * Weights[2 * Term.Index];
+				Eg += Term.Count * Weights[2 * Term.Index + 1];
+			}
+			return (Mg * Trace.Phase + Eg * (EvalParams::MaxPhase - Trace.Phase)) / EvalParams::MaxPhase;
+		}
+
+		// ----------------------------------------------------
+		// Header Generation
+		// ----------------------------------------------------
+		string RegenerateEvalParams(const string& Template, const List<EvalScore>& Params)
+		{
+			if (int(Params.size()) != GetParamCount()) { return {}; }
+
+			string Text = Template;
+			for (const ParamBlock& Block : GetParamBlocks())
+			{
+				const string Declaration = "constexpr EvalScore " + string(Block.Name) + (Block.bArray ? "[" : " ");
+				const std::size_t Start = Text.find(Declaration);
+				const std::size_t Equals = Start == string::npos ? string::npos : Text.find('=', Start);
+				if (Equals == string::npos)
+				{
+					LOG("EvalParams template has no %s", Block.Name);
+					return {};
+				}
+
+				// The initialiser ends at the first ';' outside any braces
+				std::size_t End = Equals;
+				int Depth = 0;
+				while (End < Text.size() && !(Text[End] == ';' && Depth == 0))
+				{
+					Depth += Text[End] == '{' ? 1 : Text[End] == '}' ? -1 : 0;
+					++End;
+				}
+				if (End == Text.size()) { return {}; }
+
+				const EvalScore* Values = Params.data() + Block.Offset;
+				string Initialiser;
+				if (!Block.bArray)
+				{
+					Initialiser = "{ " + std::to_string(Values[0].Mg) + ", " + std::to_string(Values[0].Eg) + " }";
+				}
+				else if (Block.Count == PieceTypeCount * 64)
+				{
+					Initialiser = FormatPieceSquare(Values);
+				}
+				else
+				{
+					Initialiser = FormatArray(Values, Block.Count, "\t\t");
+				}
+				Text.replace(Equals, End - Equals, "= " + Initialiser);
+			}
+			return Text;
+		}
+	}
+}
@@ -0,0 +1,375 @@
+#include "Tuning/TexelTuner.h"
+#include "Tuning/EvalTrace.h"
+#include "Engine/Evaluation.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace we
+{
+	namespace
+	{
+		constexpr int MaxQuietPly = 32;
+		constexpr int QuietInfinite = 32001;
+
+		// Captures-only search that keeps its principal variation, so the
+		// position at the end of it can be played out on the board
+		class QuietResolver
+		{
+		public:
+			int Resolve(Position& Pos)
+			{
+				const int Score = Search(Pos, -QuietInfinite, QuietInfinite, 0);
+				for (int i = 0; i < PvLength[0]; ++i)
+				{
+					Pos.MakeMove(Pv[0][i]);
+				}
+				return Score;
+			}
+
+		private:
+			int Search(Position& Pos, int Alpha, int Beta, int Ply)
+			{
+				PvLength[Ply] = 0;
+				const int StandPat = Eval.EvaluateClassical(Pos);
+				if (Ply >= MaxQuietPly || StandPat >= Beta) { return StandPat; }
+				Alpha = std::max(Alpha, StandPat);
+
+				// Most valuable victim first, cheapest attacker breaking ties
+				MoveList Moves;
+				GenerateMoves(Pos, Moves, EMoveGenType::Captures);
+				int Scores[MaxMoves];
+				for (int i = 0; i < Moves.Size(); ++i)
+				{
+					const Move Candidate = Moves.Moves[i];
+					const EPieceType Victim = Candidate.Flag() == EnPassantCapture ? Pawn : TypeOf(Pos.PieceOn(Candidate.To()));
+					Scores[i] = EvalParams::PieceValue[Victim].Mg * 8 - TypeOf(Pos.PieceOn(Candidate.From()));
+				}
+
+				for (int i = 0; i < Moves.Size(); ++i)
+				{
+					const int Best = int(std::max_element(Scores + i, Scores + Moves.Size()) - Scores);
+					std::swap(Scores[i], Scores[Best]);
+					std::swap(Moves.Moves[i], Moves.Moves[Best]);
+
+					const Move Candidate = Moves.Moves[i];
+					if (!Pos.IsLegal(Candidate)) { continue; }
+
+					Pos.MakeMove(Candidate);
+					const int Score = -Search(Pos, -Beta, -Alpha, Ply + 1);
+					Pos.UnmakeMove(Candidate);
+
+					if (Score > Alpha)
+					{
+						Alpha = Score;
+						Pv[Ply][0] = Candidate;
+						std::memcpy(&Pv[Ply][1], Pv[Ply + 1], sizeof(Move) * PvLength[Ply + 1]);
+						PvLength[Ply] = PvLength[Ply + 1] + 1;
+						if (Score >= Beta) { break; }
+					}
+				}
+				return Alpha;
+			}
+
+			Evaluator Eval;
+			Move Pv[MaxQuietPly + 2][MaxQuietPly + 2];
+			int PvLength[MaxQuietPly + 2] = {};
+		};
+
+		bool ParseResult(string Token, PackedPosition::EResult& OutResult)
+		{
+			Token.erase(std::remove_if(Token.begin(), Token.end(), [](char C) { return C == '"' || C == '[' || C == ']' || C == ';'; }), Token.end());
+			if (Token == "1-0" || Token == "1.0") { OutResult = PackedPosition::WhiteWins; return true; }
+			if (Token == "0-1" || Token == "0.0") { OutResult = PackedPosition::BlackWins; return true; }
+			if (Token == "1/2-1/2" || Token == "0.5") { OutResult = PackedPosition::Draw; return true; }
+			return false;
+		}
+
+		bool IsNumber(const string& Token)
+		{
+			return !Token.empty() && std::all_of(Token.begin(), Token.end(), [](char C) { return C >= '0' && C <= '9'; });
+		}
+
+		bool ParseCorpusLine(const char* Begin, const char* End, string& OutFen, PackedPosition::EResult& OutResult)
+		{
+			List<string> Tokens;
+			const char* Cursor = Begin;
+			while (Cursor < End)
+			{
+				while (Cursor < End && (*Cursor == ' ' || *Cursor == '\t' || *Cursor == '\r')) { ++Cursor; }
+				const char* TokenStart = Cursor;
+				while (Cursor < End && *Cursor != ' ' && *Cursor != '\t' && *Cursor != '\r') { ++Cursor; }
+				if (Cursor > TokenStart) { Tokens.emplace_back(TokenStart, Cursor); }
+			}
+			if (Tokens.size() < 5) { return false; }
+
+			// The result is the last token after the position that reads as one
+			const bool bClocks = Tokens.size() >= 7 && IsNumber(Tokens[4]) && IsNumber(Tokens[5]);
+			const std::size_t FirstExtra = bClocks ? 6 : 4;
+			bool bFound = false;
+			for (std::size_t i = FirstExtra; i < Tokens.size(); ++i)
+			{
+				bFound |= ParseResult(Tokens[i], OutResult);
+			}
+			if (!bFound) { return false; }
+
+			OutFen = Tokens[0] + " " + Tokens[1] + " " + Tokens[2] + " " + Tokens[3] + (bClocks ? " " + Tokens[4] + " " + Tokens[5] : " 0 1");
+			return true;
+		}
+
+		void PackChunk(const char* Begin, const char* End, List<PackedPosition>& OutRecords, CorpusStats& OutStats)
+		{
+			QuietResolver Resolver;
+			Position Pos;
+			string Fen;
+			while (Begin < End)
+			{
+				const char* LineEnd = static_cast<const char*>(std::memchr(Begin, '\n', End - Begin));
+				if (!LineEnd) { LineEnd = End; }
+
+				++OutStats.Lines;
+				PackedPosition::EResult Result = PackedPosition::Draw;
+				if (ParseCorpusLine(Begin, LineEnd, Fen, Result) && Pos.SetFromFen(Fen) && !Pos.IsInCheck())
+				{
+					const int Score = Resolver.Resolve(Pos);
+					OutRecords.push_back(PackedPosition::Pack(Pos, Pos.GetSideToMove() == White ? Score : -Score, Result));
+					++OutStats.Packed;
+				}
+				else
+				{
+					++OutStats.Skipped;
+				}
+				Begin = LineEnd + 1;
+			}
+		}
+	}
+
+	// ----------------------------------------------------
+	// Corpus Preparation
+	// ----------------------------------------------------
+	CorpusStats PackCorpus(const string& TextPath, const string& PackedPath, int Threads)
+	{
+		CorpusStats Total;
+		MappedFile Text;
+		if (!Text.Open(TextPath))
+		{
+			LOG("Cannot map corpus %s", TextPath.c_str());
+			return Total;
+		}
+
+		// Chunk boundaries move forward to the next line start
+		const char* Data = reinterpret_cast<const char*>(Text.GetData());
+		const std::size_t Size = Text.GetSize();
+		Threads = std::max(Threads, 1);
+		List<const char*> Bounds{ Data };
+		for (int i = 1; i < Threads; ++i)
+		{
+			const char* Split = std::max(Data + Size * i / Threads, Bounds.back());
+			const char* Newline = static_cast<const char*>(std::memchr(Split, '\n', Data + Size - Split));
+			Bounds.push_back(Newline ? Newline + 1 : Data + Size);
+		}
+		Bounds.push_back(Data + Size);
+
+		List<List<PackedPosition>> Records(Threads);
+		List<CorpusStats> Stats(Threads);
+		List<std::thread> Workers;
+		for (int i = 0; i < Threads; ++i)
+		{
+			Workers.emplace_back(PackChunk, Bounds[i], Bounds[i + 1], std::ref(Records[i]), std::ref(Stats[i]));
+		}
+		for (std::thread& Worker : Workers)
+		{
+			Worker.join();
+		}
+
+		std::ofstream Out(PackedPath, std::ios::binary);
+		if (!Out)
+		{
+			LOG("Cannot write %s", PackedPath.c_str());
+			return Total;
+		}
+		for (int i = 0; i < Threads; ++i)
+		{
+			Out.write(reinterpret_cast<const char*>(Records[i].data()), std::streamsize(Records[i].size() * sizeof(PackedPosition)));
+			Total.Lines += Stats[i].Lines;
+			Total.Packed += Stats[i].Packed;
+			Total.Skipped += Stats[i].Skipped;
+		}
+		return Total;
+	}
+
+	// ----------------------------------------------------
+	// Texel Tuner
+	// ----------------------------------------------------
+	TexelTuner::TexelTuner()
+		: Corpus{}
+		, Weights{}
+		, ScalingK{ 1.0 }
+	{
+		for (const EvalScore& Param : EvalTuning::GetDefaultParams())
+		{
+			Weights.push_back(Param.Mg);
+			Weights.push_back(Param.Eg);
+		}
+	}
+
+	bool TexelTuner::Open(const string& PackedPath)
+	{
+		return Corpus.Open(PackedPath) && GetPositionCount() > 0;
+	}
+
+	double TexelTuner::Accumulate(std::size_t Begin, std::size_t End, double K, double* OutGradient) const
+	{
+		const PackedPosition* Records = GetRecords();
+		const double Slope = std::log(10.0) * K / 400.0;
+		Position Pos;
+		EvalTuning::EvalTrace Trace;
+		double Error = 0.0;
+
+		for (std::size_t i = Begin; i < End; ++i)
+		{
+			Records[i].UnpackPieces(Pos);
+			EvalTuning::TraceEvaluation(Pos, Trace);
+
+			const double Eval = EvalTuning::EvaluateTrace(Trace, Weights.data());
+			const double Predicted = 1.0 / (1.0 + std::pow(10.0, -K * Eval / 400.0));
+			const double Residual = Records[i].GetResultScore() - Predicted;
+			Error += Residual * Residual;
+			if (!OutGradient) { continue; }
+
+			// d(R - S)^2 / dEval, split between the midgame and endgame weights by phase
+			const double Step = -2.0 * Residual * Predicted * (1.0 - Predicted) * Slope;
+			const double MgShare = Step * Trace.Phase / EvalParams::MaxPhase;
+			const double EgShare = Step - MgShare;
+			for (int t = 0; t < Trace.TermCount; ++t)
+			{
+				const EvalTuning::EvalTrace::Term& Term = Trace.Terms[t];
+				OutGradient[2 * Term.Index] += MgShare * Term.Count;
+				OutGradient[2 * Term.Index + 1] += EgShare * Term.Count;
+			}
+		}
+		return Error;
+	}
+
+	double TexelTuner::ParallelPass(double K, int Threads, List<double>* OutGradient) const
+	{
+		const std::size_t Count = GetPositionCount();
+		Threads = std::max(1, std::min<int>(Threads, int(Count)));
+
+		List<double> Errors(Threads, 0.0);
+		List<List<double>> Gradients(Threads);
+		List<std::thread> Workers;
+		for (int i = 0; i < Threads; ++i)
+		{
+			if (OutGradient)
+			{
+				Gradients[i].assign(Weights.size(), 0.0);
+			}
+			Workers.emplace_back([this, i, Threads, Count, K, &Errors, &Gradients, OutGradient]()
+			{
+				Errors[i] = Accumulate(Count * i / Threads, Count * (i + 1) / Threads, K, OutGradient ? Gradients[i].data() : nullptr);
+			});
+		}
+		for (std::thread& Worker : Workers)
+		{
+			Worker.join();
+		}
+
+		double Error = 0.0;
+		if (OutGradient)
+		{
+			OutGradient->assign(Weights.size(), 0.0);
+		}
+		for (int i = 0; i < Threads; ++i)
+		{
+			Error += Errors[i];
+			for (std::size_t w = 0; OutGradient && w < Weights.size(); ++w)
+			{
+				(*OutGradient)[w] += Gradients[i][w] / double(Count);
+			}
+		}
+		return Error / double(Count);
+	}
+
+	double TexelTuner::ComputeError(double K, int Threads) const
+	{
+		return ParallelPass(K, Threads, nullptr);
+	}
+
+	double TexelTuner::FitScalingConstant(int Threads)
+	{
+		const double InvPhi = (std::sqrt(5.0) - 1.0) / 2.0;
+		double Low = 0.1;
+		double High = 3.0;
+		double Left = High - InvPhi * (High - Low);
+		double Right = Low + InvPhi * (High - Low);
+		double LeftError = ComputeError(Left, Threads);
+		double RightError = ComputeError(Right, Threads);
+
+		for (int Iteration = 0; Iteration < 24; ++Iteration)
+		{
+			if (LeftError < RightError)
+			{
+				High = Right;
+				Right = Left;
+				RightError = LeftError;
+				Left = High - InvPhi * (High - Low);
+				LeftError = ComputeError(Left, Threads);
+			}
+			else
+			{
+				Low = Left;
+				Left = Right;
+				LeftError = RightError;
+				Right = Low + InvPhi * (High - Low);
+				RightError = ComputeError(Right, Threads);
+			}
+		}
+		ScalingK = (Low + High) / 2.0;
+		return ScalingK;
+	}
+
+	// Adam on the full-batch gradient; weights the corpus never exercises keep a zero gradient and stay put
+	void TexelTuner::Run(const TunerSettings& Settings, const std::function<void(int Epoch, double Error)>& OnEpoch)
+	{
+		constexpr double Beta1 = 0.9;
+		constexpr double Beta2 = 0.999;
+		constexpr double Epsilon = 1e-8;
+
+		ScalingK = Settings.ScalingK > 0.0 ? Settings.ScalingK : FitScalingConstant(Settings.Threads);
+
+		List<double> Gradient;
+		List<double> Momentum(Weights.size(), 0.0);
+		List<double> Velocity(Weights.size(), 0.0);
+		for (int Epoch = 1; Epoch <= Settings.Epochs; ++Epoch)
+		{
+			const double Error = ParallelPass(ScalingK, Settings.Threads, &Gradient);
+			const double Correction1 = 1.0 - std::pow(Beta1, Epoch);
+			const double Correction2 = 1.0 - std::pow(Beta2, Epoch);
+			for (std::size_t w = 0; w < Weights.size(); ++w)
+			{
+				Momentum[w] = Beta1 * Momentum[w] + (1.0 - Beta1) * Gradient[w];
+				Velocity[w] = Beta2 * Velocity[w] + (1.0 - Beta2) * Gradient[w] * Gradient[w];
+				Weights[w] -= Settings.LearningRate * (Momentum[w] / Correction1) / (std::sqrt(Velocity[w] / Correction2) + Epsilon);
+			}
+
+			if (OnEpoch)
+			{
+				OnEpoch(Epoch, Error);
+			}
+		}
+	}
+
+	List<EvalScore> TexelTuner::GetParams() const
+	{
+		List<EvalScore> Params;
+		for (std::size_t w = 0; w + 1 < Weights.size(); w += 2)
+		{
+			Params.emplace_back(int(std::lround(Weights[w])), int(std::lround(Weights[w + 1])));
+		}
+		return Params;
+	}
+}
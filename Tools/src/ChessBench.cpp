@@ -0,0 +1,105 @@
+#include "Engine/Benchmark.h"
+#include "Engine/Engine.h"
+#include "Engine/Nnue.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+	void PrintResult(const char* Label, const we::EvalBenchmarkResult& Result)
+	{
+		LOG("%s: %llu calls in %.3f s (%.0f calls/s, checksum %lld)", Label,
+			static_cast<unsigned long long>(Result.Calls), Result.Seconds,
+			Result.CallsPerSecond(), static_cast<long long>(Result.Checksum));
+	}
+
+	// Fixed-depth searches of the first bench positions, reporting the merged
+	// telemetry so runs with different thread counts can be compared
+	we::SearchStats BenchmarkSearch(int Threads, int Depth, const we::string& TelemetryLog)
+	{
+		we::Engine Searcher;
+		Searcher.SetThreadCount(Threads);
+		Searcher.SetHashSize(64);
+		Searcher.SetBookEnabled(false);
+		Searcher.SetTelemetryLog(TelemetryLog);
+		Searcher.OnInfo = [](const we::SearchInfo& Info) { std::printf("%s\n", we::FormatUciInfo(Info).c_str()); };
+
+		we::SearchStats Total;
+		Total.Threads = Threads;
+		const we::List<we::string>& Fens = we::GetBenchPositions();
+		for (std::size_t i = 0; i < Fens.size() && i < 4; ++i)
+		{
+			we::Position Pos;
+			Pos.SetFromFen(Fens[i]);
+			we::SearchLimits Limits;
+			Limits.Depth = Depth;
+
+			Searcher.NewGame();
+			Searcher.Think(Pos, Limits);
+			const we::SearchStats Stats = Searcher.GetStatistics();
+			std::printf("%s\n", we::FormatUciStats(Stats).c_str());
+
+			Total.Accumulate(Stats);
+		}
+		return Total;
+	}
+
+	void PrintSearch(const we::SearchStats& Stats)
+	{
+		LOG("Search, %d thread(s): %llu nodes in %lld ms (%llu nps), %.1f%% TT hits, %.1f%% first-move cutoffs, %.1f%% null-move cutoffs",
+			Stats.Threads, static_cast<unsigned long long>(Stats.Nodes), static_cast<long long>(Stats.TimeMs),
+			static_cast<unsigned long long>(Stats.NodesPerSecond()), Stats.TTHitRate() * 100.0,
+			Stats.FirstMoveCutoffRate() * 100.0, Stats.NullMoveSuccessRate() * 100.0);
+	}
+}
+
+// Usage: chess_bench [--telemetry log.jsonl] [network.nnue]
+// Without a network file a randomly weighted one is generated; its scores are
+// meaningless but the inference cost is the same as a trained net's. With
+// --telemetry every bench search appends its statistics as one JSON line.
+int main(int argc, char** argv)
+{
+	we::string TelemetryLog;
+	if (argc > 2 && std::strcmp(argv[1], "--telemetry") == 0)
+	{
+		TelemetryLog = argv[2];
+		argc -= 2;
+		argv += 2;
+	}
+
+	we::EvalBenchmarkResult EvalResult = we::BenchmarkEvaluation();
+	PrintResult("Evaluation", EvalResult);
+
+	// The checksums must match: the pawn hash only caches, it never changes a score
+	const we::EvalBenchmarkResult Uncached = we::BenchmarkTreeEvaluation(3, false);
+	const we::EvalBenchmarkResult Cached = we::BenchmarkTreeEvaluation(3, true);
+	PrintResult("Tree, no pawn hash", Uncached);
+	PrintResult("Tree, pawn hash", Cached);
+	LOG("Pawn hash: %.1f%% hits, %.2fx the uncached evaluation", Cached.PawnHashHitRate() * 100.0, Cached.CallsPerSecond() / Uncached.CallsPerSecond());
+
+	const int Threads = std::max(1, int(std::thread::hardware_concurrency()));
+	const we::SearchStats Single = BenchmarkSearch(1, 11, TelemetryLog);
+	const we::SearchStats Parallel = BenchmarkSearch(Threads, 11, TelemetryLog);
+	PrintSearch(Single);
+	PrintSearch(Parallel);
+	LOG("Search scales to %.2fx the single thread nps", double(Parallel.NodesPerSecond()) / std::max<std::uint64_t>(Single.NodesPerSecond(), 1));
+
+	we::Nnue::Network Network;
+	we::List<std::uint8_t> RandomWeights;
+	if (argc > 1)
+	{
+		if (!Network.LoadFromFile(argv[1])) { return 1; }
+	}
+	else
+	{
+		RandomWeights = we::Nnue::Network::MakeRandomNetwork(20240601);
+		Network.LoadFromMemory(RandomWeights.data(), RandomWeights.size());
+	}
+
+	we::EvalBenchmarkResult NnueResult = we::BenchmarkEvaluation(1000000, &Network);
+	PrintResult("NNUE", NnueResult);
+	LOG("NNUE runs at %.2fx the hand-crafted evaluation", NnueResult.CallsPerSecond() / EvalResult.CallsPerSecond());
+	return 0;
+}
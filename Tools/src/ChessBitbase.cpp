@@ -0,0 +1,116 @@
+#include "Engine/Bitbase.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+// Usage:
+//   chess_bitbase build <out dir> [threads = all] [signatures = KPK KRK KQK]
+//     writes <signature>.bb for every requested ending and the endings it converts into
+//   chess_bitbase probe <dir> <fen>
+namespace
+{
+	int Build(const we::string& Directory, int ThreadCount, const we::List<we::string>& Signatures)
+	{
+		we::BitbaseSet Tables;
+		we::BitbaseGenerator Generator{ Tables, ThreadCount };
+		we::List<we::BitbaseGenerator::Stats> Stats;
+
+		for (const we::string& Signature : Signatures)
+		{
+			if (!Generator.Generate(Signature, Stats))
+			{
+				LOG("Cannot generate %s: expected something like KQKR with at most %d pieces", Signature.c_str(), we::Bitbase::MaxPieces);
+				return 1;
+			}
+		}
+
+		std::size_t TotalPositions = 0;
+		double TotalSeconds = 0.0;
+		for (const we::BitbaseGenerator::Stats& Table : Stats)
+		{
+			const we::string Path = Directory + "/" + Table.Signature + ".bb";
+			we::Bitbase::Material Parsed;
+			we::Bitbase::Material::Parse(Table.Signature, Parsed);
+			if (!Tables.Find(Parsed)->Save(Path))
+			{
+				LOG("Could not write %s", Path.c_str());
+				return 1;
+			}
+
+			LOG("%-6s %10zu positions  %9zu wins %9zu draws %9zu losses  %3d passes  %7.2f s  %10.0f pos/s",
+				Table.Signature.c_str(), Table.Positions, Table.Wins, Table.Draws, Table.Losses, Table.Passes, Table.Seconds, Table.PositionsPerSecond());
+			TotalPositions += Table.Positions;
+			TotalSeconds += Table.Seconds;
+		}
+
+		LOG("%zu tables, %zu positions in %.2f s on %d threads (%.0f positions/s)",
+			Stats.size(), TotalPositions, TotalSeconds, ThreadCount, TotalSeconds > 0.0 ? TotalPositions / TotalSeconds : 0.0);
+		return 0;
+	}
+
+	int Probe(const we::string& Directory, const we::string& Fen)
+	{
+		we::BitbaseSet Tables;
+		const int Loaded = Tables.LoadDirectory(Directory);
+
+		we::Position Pos;
+		if (!Pos.SetFromFen(Fen))
+		{
+			LOG("Invalid FEN: %s", Fen.c_str());
+			return 1;
+		}
+
+		we::EWdl Wdl;
+		if (!Tables.Probe(Pos, Wdl))
+		{
+			LOG("No bitbase among %d loaded tables covers this position", Loaded);
+			return 1;
+		}
+
+		LOG("%s for the side to move", Wdl == we::EWdl::Win ? "Win" : Wdl == we::EWdl::Loss ? "Loss" : "Draw");
+
+		we::MoveList Moves;
+		we::GenerateLegalMoves(Pos, Moves);
+		for (we::Move Candidate : Moves)
+		{
+			Pos.MakeMove(Candidate);
+			we::EWdl Child = we::EWdl::Draw;
+			Tables.Probe(Pos, Child);
+			Pos.UnmakeMove(Candidate);
+			LOG("  %s %s", we::MoveToUci(Candidate).c_str(), Child == we::EWdl::Loss ? "wins" : Child == we::EWdl::Win ? "loses" : "draws");
+		}
+		return 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const we::string Command = argc > 1 ? argv[1] : "";
+	if (Command == "build" && argc >= 3)
+	{
+		const int ThreadCount = argc > 3 ? std::atoi(argv[3]) : int(std::thread::hardware_concurrency());
+		we::List<we::string> Signatures;
+		for (int i = 4; i < argc; ++i)
+		{
+			Signatures.push_back(argv[i]);
+		}
+		if (Signatures.empty())
+		{
+			Signatures = { "KPK", "KRK", "KQK" };
+		}
+		return Build(argv[2], std::max(ThreadCount, 1), Signatures);
+	}
+	if (Command == "probe" && argc >= 4)
+	{
+		we::string Fen;
+		for (int i = 3; i < argc; ++i)
+		{
+			Fen += (i > 3 ? " " : "") + we::string(argv[i]);
+		}
+		return Probe(argv[2], Fen);
+	}
+
+	LOG("Usage: chess_bitbase build <out dir> [threads] [signatures...] | chess_bitbase probe <dir> <fen>");
+	return 1;
+}
@@ -0,0 +1,151 @@
+#include "Engine/OpeningBook.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+// Usage:
+//   chess_book build <games.txt> <book.bin> [max plies = 20]
+//     games.txt holds one game per line as coordinate moves from the start position
+//   chess_book probe <book.bin> [fen]
+namespace
+{
+	struct BuildEntry
+	{
+		we::HashKey Key;
+		std::uint16_t Move;
+		std::uint32_t Count;
+	};
+
+	void WriteBigEndian(std::uint8_t* Out, std::uint64_t Value, int Count)
+	{
+		for (int i = Count - 1; i >= 0; --i)
+		{
+			Out[i] = std::uint8_t(Value & 0xFF);
+			Value >>= 8;
+		}
+	}
+
+	int Build(const char* GamesPath, const char* BookPath, int MaxPlies)
+	{
+		std::ifstream Games{ GamesPath };
+		if (!Games)
+		{
+			LOG("Could not open %s", GamesPath);
+			return 1;
+		}
+
+		we::Dictionary<we::HashKey, we::Dictionary<std::uint16_t, std::uint32_t>> Counts;
+		we::string Line;
+		int GameCount = 0;
+		while (std::getline(Games, Line))
+		{
+			we::Position Pos;
+			std::istringstream Tokens{ Line };
+			we::string Token;
+			for (int Ply = 0; Ply < MaxPlies && Tokens >> Token; ++Ply)
+			{
+				const we::Move Parsed = we::ParseUciMove(Pos, Token);
+				if (Parsed.IsNull()) { break; }
+
+				++Counts[we::OpeningBook::ComputeKey(Pos)][we::OpeningBook::EncodeMove(Parsed)];
+				Pos.MakeMove(Parsed);
+			}
+			++GameCount;
+		}
+
+		we::List<BuildEntry> Entries;
+		for (const auto& PositionCounts : Counts)
+		{
+			for (const auto& MoveCount : PositionCounts.second)
+			{
+				Entries.push_back(BuildEntry{ PositionCounts.first, MoveCount.first, MoveCount.second });
+			}
+		}
+		std::sort(Entries.begin(), Entries.end(), [](const BuildEntry& A, const BuildEntry& B)
+		{
+			return A.Key != B.Key ? A.Key < B.Key : A.Count > B.Count;
+		});
+
+		FILE* Out = std::fopen(BookPath, "wb");
+		if (!Out)
+		{
+			LOG("Could not create %s", BookPath);
+			return 1;
+		}
+		for (const BuildEntry& Entry : Entries)
+		{
+			std::uint8_t Bytes[we::OpeningBook::EntrySize] = {};
+			WriteBigEndian(Bytes, Entry.Key, 8);
+			WriteBigEndian(Bytes + 8, Entry.Move, 2);
+			WriteBigEndian(Bytes + 10, std::min<std::uint32_t>(Entry.Count, 0xFFFF), 2);
+			std::fwrite(Bytes, sizeof(Bytes), 1, Out);
+		}
+		std::fclose(Out);
+
+		LOG("%d games, %zu positions, %zu entries written to %s", GameCount, Counts.size(), Entries.size(), BookPath);
+		return 0;
+	}
+
+	int Probe(const char* BookPath, const we::string& Fen)
+	{
+		we::OpeningBook Book;
+		if (!Book.Open(BookPath))
+		{
+			LOG("Could not open %s", BookPath);
+			return 1;
+		}
+
+		we::Position Pos;
+		if (!Pos.SetFromFen(Fen))
+		{
+			LOG("Invalid FEN: %s", Fen.c_str());
+			return 1;
+		}
+
+		we::BookMove Moves[we::MaxMoves];
+		constexpr int Lookups = 100000;
+		int Count = 0;
+		const auto Start = std::chrono::steady_clock::now();
+		for (int i = 0; i < Lookups; ++i)
+		{
+			Count = Book.GetMoves(Pos, Moves, we::MaxMoves);
+		}
+		const double Micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - Start).count() / Lookups;
+
+		for (int i = 0; i < Count; ++i)
+		{
+			LOG("%s %d", we::MoveToUci(Moves[i].BookedMove).c_str(), Moves[i].Weight);
+		}
+		LOG("%d book moves, %.2f us per lookup over %zu entries", Count, Micros, Book.GetEntryCount());
+		return 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const we::string Command = argc > 1 ? argv[1] : "";
+	if (Command == "build" && argc >= 4)
+	{
+		return Build(argv[2], argv[3], argc > 4 ? std::atoi(argv[4]) : 20);
+	}
+	if (Command == "probe" && argc >= 3)
+	{
+		we::string Fen = we::Position::StartFen;
+		if (argc > 3)
+		{
+			Fen.clear();
+			for (int i = 3; i < argc; ++i)
+			{
+				Fen += (i > 3 ? " " : "") + we::string(argv[i]);
+			}
+		}
+		return Probe(argv[2], Fen);
+	}
+
+	LOG("Usage: chess_book build <games.txt> <book.bin> [max plies] | chess_book probe <book.bin> [fen]");
+	return 1;
+}
@@ -0,0 +1,281 @@
+#include "Match/SelfPlay.h"
+#include "IO/PackedPosition.h"
+#include "Engine/Nnue.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+// Usage: chess_datagen <output.bin> [options]
+//   --positions N      stops once this many are generated (default 1000000)
+//   --threads N        games played at once (default: hardware threads)
+//   --depth N          search depth per move (default 8), or --nodes N
+//   --random-plies N   random moves before the engine takes over (default 8)
+//   --openings file    FEN or EPD start positions (default: start position)
+//   --network file     NNUE network for the engine
+//   --syzygy path      adjudicates tablebase positions
+//   --seed N           (default 1)
+// Appends 32-byte PackedPosition records with the search score and the game
+// result, both from White's side, so the file feeds chess_tune directly.
+// Positions in check or where the best move captures or promotes are left
+// out, as their static evaluation says little about the score.
+namespace
+{
+	constexpr std::size_t BufferRecords = 1 << 16;		// 2 MB per thread between writes
+	constexpr int OpeningScoreLimit = 300;				// Random openings this unbalanced are dropped
+	constexpr int ResignScore = 2500;
+	constexpr int ResignPlies = 6;
+	constexpr int DrawScore = 10;
+	constexpr int DrawPlies = 12;
+	constexpr int DrawMinPly = 80;
+	constexpr int MaxGamePlies = 400;
+
+	struct GeneratorConfig
+	{
+		we::string OutputPath;
+		std::uint64_t Positions = 1000000;
+		int Threads = std::max(1, int(std::thread::hardware_concurrency()));
+		we::SearchLimits Limits;
+		int RandomPlies = 8;
+		we::string OpeningsPath;
+		we::string NetworkPath;
+		we::string SyzygyPath;
+		std::uint64_t Seed = 1;
+	};
+
+	struct GeneratorState
+	{
+		std::FILE* Output = nullptr;
+		std::mutex OutputLock;
+		std::atomic<std::uint64_t> Generated{ 0 };		// Counted per game, ahead of the writes
+		std::atomic<std::uint64_t> Written{ 0 };
+		std::atomic<std::uint64_t> Games{ 0 };
+		std::atomic<bool> bStop{ false };
+	};
+
+	std::uint64_t NextRandom(std::uint64_t& State)
+	{
+		std::uint64_t Z = (State += 0x9E3779B97F4A7C15ULL);
+		Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBULL;
+		return Z ^ (Z >> 31);
+	}
+
+	// One large sequential write per full buffer; the lock only orders the appends
+	void FlushBuffer(GeneratorState& State, we::List<we::PackedPosition>& Buffer)
+	{
+		if (Buffer.empty()) { return; }
+
+		std::lock_guard<std::mutex> Guard{ State.OutputLock };
+		if (std::fwrite(Buffer.data(), sizeof(we::PackedPosition), Buffer.size(), State.Output) != Buffer.size())
+		{
+			LOG("Write failed; stopping");
+			State.bStop = true;
+		}
+		State.Written += Buffer.size();
+		Buffer.clear();
+	}
+
+	// Plays the random plies; false when the game ends during them
+	bool PlayRandomOpening(we::Position& Pos, int Plies, std::uint64_t& RandomState)
+	{
+		for (int i = 0; i < Plies; ++i)
+		{
+			we::MoveList Moves;
+			we::GenerateLegalMoves(Pos, Moves);
+			if (Moves.Count == 0) { return false; }
+			Pos.MakeMove(Moves.Moves[NextRandom(RandomState) % std::uint64_t(Moves.Count)]);
+		}
+		we::MoveList Moves;
+		we::GenerateLegalMoves(Pos, Moves);
+		return Moves.Count > 0;
+	}
+
+	// Appends the positions of one game, labelled once its result is known
+	void PlayGame(we::Engine& Player, const we::string& Opening, const GeneratorConfig& Config, const we::SyzygyTablebases* Tablebases,
+		std::uint64_t& RandomState, we::List<we::PackedPosition>& OutRecords)
+	{
+		we::Position Pos;
+		if (!Pos.SetFromFen(Opening) || !PlayRandomOpening(Pos, Config.RandomPlies, RandomState)) { return; }
+
+		Player.NewGame();
+		const std::size_t FirstRecord = OutRecords.size();
+		we::EGameResult Result = we::EGameResult::None;
+		int ResignCount = 0;
+		int DrawCount = 0;
+
+		for (int Ply = 0; Ply < MaxGamePlies && Result == we::EGameResult::None; ++Ply)
+		{
+			if (we::Adjudicate(Pos, Tablebases, Result) != we::ETermination::None) { break; }
+
+			const we::SearchResult Found = Player.Think(Pos, Config.Limits);
+			if (Found.BestMove.IsNull())
+			{
+				OutRecords.resize(FirstRecord);
+				return;
+			}
+
+			const int WhiteScore = Pos.GetSideToMove() == we::White ? Found.Score : -Found.Score;
+			if (Ply == 0 && std::abs(WhiteScore) > OpeningScoreLimit) { return; }
+
+			const bool bQuiet = !Pos.IsInCheck() && !Found.BestMove.IsCapture() && !Found.BestMove.IsPromotion();
+			if (bQuiet && !we::IsMateScore(Found.Score))
+			{
+				OutRecords.push_back(we::PackedPosition::Pack(Pos, WhiteScore, we::PackedPosition::Draw));
+			}
+
+			// Adjudicated on score so won and dead drawn endings do not dominate the data
+			ResignCount = std::abs(Found.Score) >= ResignScore ? ResignCount + 1 : 0;
+			DrawCount = Ply >= DrawMinPly && std::abs(Found.Score) <= DrawScore ? DrawCount + 1 : 0;
+			if (ResignCount >= ResignPlies)
+			{
+				Result = WhiteScore > 0 ? we::EGameResult::WhiteWins : we::EGameResult::BlackWins;
+			}
+			else if (DrawCount >= DrawPlies)
+			{
+				Result = we::EGameResult::Draw;
+			}
+			Pos.MakeMove(Found.BestMove);
+		}
+
+		const we::PackedPosition::EResult Outcome = Result == we::EGameResult::WhiteWins ? we::PackedPosition::WhiteWins
+			: Result == we::EGameResult::BlackWins ? we::PackedPosition::BlackWins : we::PackedPosition::Draw;
+		for (std::size_t i = FirstRecord; i < OutRecords.size(); ++i)
+		{
+			OutRecords[i].Result = Outcome;
+		}
+	}
+
+	void RunWorker(int Index, const GeneratorConfig& Config, const we::List<we::string>& Openings, const we::SyzygyTablebases* Tablebases,
+		const we::Nnue::Network* Network, GeneratorState& State)
+	{
+		we::Engine Player;
+		Player.SetThreadCount(1);
+		Player.SetHashSize(8);
+		Player.SetBookEnabled(false);
+		Player.SetNetwork(Network);
+
+		std::uint64_t RandomState = Config.Seed * 0x2545F4914F6CDD1DULL + std::uint64_t(Index);
+		we::List<we::PackedPosition> Buffer;
+		Buffer.reserve(BufferRecords);
+
+		while (!State.bStop && State.Generated < Config.Positions)
+		{
+			const we::string& Opening = Openings[NextRandom(RandomState) % Openings.size()];
+			const std::size_t Before = Buffer.size();
+			PlayGame(Player, Opening, Config, Tablebases, RandomState, Buffer);
+			State.Generated += Buffer.size() - Before;
+			++State.Games;
+			if (Buffer.size() >= BufferRecords)
+			{
+				FlushBuffer(State, Buffer);
+			}
+		}
+		FlushBuffer(State, Buffer);
+	}
+
+	bool ParseArguments(int argc, char** argv, GeneratorConfig& Config)
+	{
+		Config.Limits.Depth = 8;
+		for (int i = 1; i < argc; ++i)
+		{
+			const we::string Option = argv[i];
+			const bool bHasValue = i + 1 < argc;
+			if (Option == "--positions" && bHasValue) { Config.Positions = std::strtoull(argv[++i], nullptr, 10); }
+			else if (Option == "--threads" && bHasValue) { Config.Threads = std::max(1, std::atoi(argv[++i])); }
+			else if (Option == "--depth" && bHasValue) { Config.Limits.Depth = std::max(1, std::atoi(argv[++i])); Config.Limits.Nodes = 0; }
+			else if (Option == "--nodes" && bHasValue) { Config.Limits.Nodes = std::strtoull(argv[++i], nullptr, 10); Config.Limits.Depth = 0; }
+			else if (Option == "--random-plies" && bHasValue) { Config.RandomPlies = std::max(0, std::atoi(argv[++i])); }
+			else if (Option == "--openings" && bHasValue) { Config.OpeningsPath = argv[++i]; }
+			else if (Option == "--network" && bHasValue) { Config.NetworkPath = argv[++i]; }
+			else if (Option == "--syzygy" && bHasValue) { Config.SyzygyPath = argv[++i]; }
+			else if (Option == "--seed" && bHasValue) { Config.Seed = std::strtoull(argv[++i], nullptr, 10); }
+			else if (Option[0] != '-' && Config.OutputPath.empty()) { Config.OutputPath = Option; }
+			else
+			{
+				LOG("Unknown option %s", Option.c_str());
+				return false;
+			}
+		}
+		if (Config.OutputPath.empty())
+		{
+			LOG("Usage: chess_datagen <output.bin> [--positions N] [--threads N] [--depth N | --nodes N] [--random-plies N] [--openings file] [--network file] [--syzygy path] [--seed N]");
+			return false;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	GeneratorConfig Config;
+	if (!ParseArguments(argc, argv, Config)) { return 1; }
+
+	we::unique<we::Nnue::Network> Network;
+	if (!Config.NetworkPath.empty())
+	{
+		Network = std::make_unique<we::Nnue::Network>();
+		if (!Network->LoadFromFile(Config.NetworkPath)) { return 1; }
+	}
+
+	we::List<we::string> Openings;
+	if (!Config.OpeningsPath.empty())
+	{
+		Openings = we::LoadOpenings(Config.OpeningsPath);
+		if (Openings.empty()) { return 1; }
+	}
+	else
+	{
+		Openings.push_back(we::Position::StartFen);
+	}
+
+	we::SyzygyTablebases Tablebases;
+	if (!Config.SyzygyPath.empty())
+	{
+		LOG("Found %d tablebase files", Tablebases.Init(Config.SyzygyPath));
+	}
+
+	GeneratorState State;
+	State.Output = std::fopen(Config.OutputPath.c_str(), "ab");
+	if (!State.Output)
+	{
+		LOG("Cannot write %s", Config.OutputPath.c_str());
+		return 1;
+	}
+
+	LOG("Generating %llu positions on %d thread(s) into %s", static_cast<unsigned long long>(Config.Positions), Config.Threads, Config.OutputPath.c_str());
+	const auto Start = std::chrono::steady_clock::now();
+	auto Elapsed = [&Start]() { return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count(); };
+
+	we::List<std::thread> Workers;
+	for (int i = 0; i < Config.Threads; ++i)
+	{
+		Workers.emplace_back(RunWorker, i, std::cref(Config), std::cref(Openings), Tablebases.GetMaxPieces() > 0 ? &Tablebases : nullptr,
+			Network.get(), std::ref(State));
+	}
+
+	double NextReport = 10.0;
+	while (State.Generated < Config.Positions && !State.bStop)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		if (Elapsed() >= NextReport)
+		{
+			LOG("%llu positions (%llu written), %llu games, %.0f positions/s", static_cast<unsigned long long>(State.Generated.load()),
+				static_cast<unsigned long long>(State.Written.load()), static_cast<unsigned long long>(State.Games.load()), State.Generated / Elapsed());
+			NextReport += 10.0;
+		}
+	}
+	for (std::thread& Worker : Workers)
+	{
+		Worker.join();
+	}
+	std::fclose(State.Output);
+
+	LOG("Wrote %llu positions from %llu games in %.1f s, %.0f positions/s", static_cast<unsigned long long>(State.Written.load()),
+		static_cast<unsigned long long>(State.Games.load()), Elapsed(), State.Written / std::max(Elapsed(), 0.001));
+	return State.bStop ? 1 : 0;
+}
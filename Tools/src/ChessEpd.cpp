@@ -0,0 +1,304 @@
+#include "Engine/Engine.h"
+#include "IO/Epd.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+
+// Usage: chess_epd <suite.epd> [options]
+//   --time ms         per position (default 1000)
+//   --depth N         fixed depth instead of a time limit
+//   --threads N       (default 1)
+//   --hash MB         (default 16)
+//   --bitbases dir    bitbases the search probes
+//   --report file     writes a JSON report of every position and the totals
+//   --min-solved N    exits with 1 when fewer are solved
+// A position is solved when the best move is one of its "bm" moves and none of
+// its "am" moves. Its time to solution is the point from which every reported
+// line kept a correct move up to the end of the search. With --depth and one
+// thread the node total is reproducible, so the suite doubles as a regression
+// check of both the answers and the speed.
+namespace
+{
+	// Upper bounds of the time-to-solution histogram, in milliseconds
+	constexpr std::int64_t SolveBuckets[] = { 10, 100, 500, 1000, 5000, 10000, 60000 };
+	constexpr int BucketCount = int(sizeof(SolveBuckets) / sizeof(SolveBuckets[0])) + 1;
+
+	struct SuiteConfig
+	{
+		we::string Path;
+		we::string ReportPath;
+		int TimeMs = 1000;
+		int Depth = 0;
+		int Threads = 1;
+		std::size_t HashMb = 16;
+		we::string BitbasePath;
+		int MinSolved = -1;
+	};
+
+	struct PositionResult
+	{
+		we::string Id;
+		we::string Fen;
+		we::string Expected;			// "bm Qg6" / "am Nxe5", as in the suite
+		we::string Found;				// SAN
+		bool bSolved = false;
+		std::int64_t SolveMs = -1;
+		int SolveDepth = 0;
+		int Depth = 0;
+		std::uint64_t Nodes = 0;
+		std::int64_t TimeMs = 0;
+	};
+
+	bool IsCorrect(we::Move Candidate, const we::List<we::Move>& Best, const we::List<we::Move>& Avoid)
+	{
+		if (Candidate.IsNull()) { return false; }
+		if (!Best.empty() && std::find(Best.begin(), Best.end(), Candidate) == Best.end()) { return false; }
+		return std::find(Avoid.begin(), Avoid.end(), Candidate) == Avoid.end();
+	}
+
+	int BucketOf(std::int64_t Ms)
+	{
+		int Bucket = 0;
+		while (Bucket < BucketCount - 1 && Ms > SolveBuckets[Bucket]) { ++Bucket; }
+		return Bucket;
+	}
+
+	we::string EscapeJson(const we::string& Text)
+	{
+		we::string Escaped;
+		for (char Each : Text)
+		{
+			if (Each == '"' || Each == '\\') { Escaped += '\\'; }
+			Escaped += Each;
+		}
+		return Escaped;
+	}
+
+	PositionResult SolvePosition(we::Engine& Searcher, const we::EpdRecord& Record, const SuiteConfig& Config)
+	{
+		PositionResult Result;
+		Result.Id = Record.GetId();
+		Result.Fen = Record.Fen;
+
+		const we::List<we::Move> Best = Record.GetMoves("bm");
+		const we::List<we::Move> Avoid = Record.GetMoves("am");
+		for (const char* Opcode : { "bm", "am" })
+		{
+			if (const we::List<we::string>* Operands = Record.FindOperation(Opcode))
+			{
+				Result.Expected += (Result.Expected.empty() ? "" : "; ") + we::string(Opcode);
+				for (const we::string& Operand : *Operands)
+				{
+					Result.Expected += " " + Operand;
+				}
+			}
+		}
+
+		// Called from the main search thread; Think() joins it before returning
+		Searcher.OnInfo = [&](const we::SearchInfo& Info)
+		{
+			if (Info.Pv.empty()) { return; }
+			if (!IsCorrect(Info.Pv.front(), Best, Avoid))
+			{
+				Result.SolveMs = -1;
+			}
+			else if (Result.SolveMs < 0)
+			{
+				Result.SolveMs = Info.TimeMs;
+				Result.SolveDepth = Info.Depth;
+			}
+		};
+
+		we::SearchLimits Limits;
+		if (Config.Depth > 0)
+		{
+			Limits.Depth = Config.Depth;
+		}
+		else
+		{
+			Limits.MoveTime = Config.TimeMs;
+		}
+
+		we::Position Pos;
+		Pos.SetFromFen(Record.Fen);
+		Searcher.NewGame();
+		const we::SearchResult Found = Searcher.Think(Pos, Limits);
+		const we::SearchStats Stats = Searcher.GetStatistics();
+
+		Result.Found = Found.BestMove.IsNull() ? "(none)" : we::MoveToSan(Pos, Found.BestMove);
+		Result.Depth = Found.Depth;
+		Result.Nodes = Stats.Nodes;
+		Result.TimeMs = Stats.TimeMs;
+		Result.bSolved = (!Best.empty() || !Avoid.empty()) && IsCorrect(Found.BestMove, Best, Avoid);
+		if (!Result.bSolved)
+		{
+			Result.SolveMs = -1;
+			Result.SolveDepth = 0;
+		}
+		else if (Result.SolveMs < 0)
+		{
+			Result.SolveMs = Result.TimeMs;
+			Result.SolveDepth = Result.Depth;
+		}
+		return Result;
+	}
+
+	bool WriteReport(const SuiteConfig& Config, const we::List<PositionResult>& Results, int Solved, std::uint64_t Nodes, std::int64_t TimeMs, const int* Histogram)
+	{
+		std::ofstream Report(Config.ReportPath);
+		if (!Report)
+		{
+			LOG("Cannot write %s", Config.ReportPath.c_str());
+			return false;
+		}
+
+		Report << "{\"suite\":\"" << EscapeJson(Config.Path) << "\""
+			<< ",\"depth\":" << Config.Depth
+			<< ",\"time_ms_limit\":" << (Config.Depth > 0 ? 0 : Config.TimeMs)
+			<< ",\"threads\":" << Config.Threads
+			<< ",\"hash_mb\":" << Config.HashMb
+			<< ",\"positions\":" << Results.size()
+			<< ",\"solved\":" << Solved
+			<< ",\"nodes\":" << Nodes
+			<< ",\"time_ms\":" << TimeMs
+			<< ",\"nps\":" << (TimeMs > 0 ? Nodes * 1000 / std::uint64_t(TimeMs) : Nodes * 1000)
+			<< ",\"solve_time_histogram\":[";
+		for (int i = 0; i < BucketCount; ++i)
+		{
+			Report << (i ? "," : "") << "{\"max_ms\":";
+			if (i < BucketCount - 1) { Report << SolveBuckets[i]; } else { Report << "null"; }
+			Report << ",\"count\":" << Histogram[i] << "}";
+		}
+		Report << "],\"results\":[\n";
+
+		for (std::size_t i = 0; i < Results.size(); ++i)
+		{
+			const PositionResult& Each = Results[i];
+			Report << "{\"id\":\"" << EscapeJson(Each.Id) << "\""
+				<< ",\"fen\":\"" << Each.Fen << "\""
+				<< ",\"expected\":\"" << EscapeJson(Each.Expected) << "\""
+				<< ",\"found\":\"" << Each.Found << "\""
+				<< ",\"solved\":" << (Each.bSolved ? "true" : "false")
+				<< ",\"solve_ms\":" << Each.SolveMs
+				<< ",\"solve_depth\":" << Each.SolveDepth
+				<< ",\"depth\":" << Each.Depth
+				<< ",\"nodes\":" << Each.Nodes
+				<< ",\"time_ms\":" << Each.TimeMs << "}"
+				<< (i + 1 < Results.size() ? ",\n" : "\n");
+		}
+		Report << "]}\n";
+		return true;
+	}
+
+	bool ParseArguments(int argc, char** argv, SuiteConfig& Config)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const we::string Option = argv[i];
+			const bool bHasValue = i + 1 < argc;
+			if (Option == "--time" && bHasValue) { Config.TimeMs = std::max(1, std::atoi(argv[++i])); }
+			else if (Option == "--depth" && bHasValue) { Config.Depth = std::atoi(argv[++i]); }
+			else if (Option == "--threads" && bHasValue) { Config.Threads = std::max(1, std::atoi(argv[++i])); }
+			else if (Option == "--hash" && bHasValue) { Config.HashMb = std::size_t(std::max(1, std::atoi(argv[++i]))); }
+			else if (Option == "--bitbases" && bHasValue) { Config.BitbasePath = argv[++i]; }
+			else if (Option == "--report" && bHasValue) { Config.ReportPath = argv[++i]; }
+			else if (Option == "--min-solved" && bHasValue) { Config.MinSolved = std::atoi(argv[++i]); }
+			else if (Option[0] != '-' && Config.Path.empty()) { Config.Path = Option; }
+			else
+			{
+				LOG("Unknown option %s", Option.c_str());
+				return false;
+			}
+		}
+		if (Config.Path.empty())
+		{
+			LOG("Usage: chess_epd <suite.epd> [--time ms | --depth N] [--threads N] [--hash MB] [--bitbases dir] [--report file] [--min-solved N]");
+			return false;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	SuiteConfig Config;
+	if (!ParseArguments(argc, argv, Config)) { return 1; }
+
+	const we::List<we::EpdRecord> Suite = we::LoadEpdFile(Config.Path);
+	if (Suite.empty()) { return 1; }
+
+	we::Engine Searcher;
+	Searcher.SetThreadCount(Config.Threads);
+	Searcher.SetHashSize(Config.HashMb);
+	Searcher.SetBookEnabled(false);
+	if (!Config.BitbasePath.empty())
+	{
+		LOG("Found %d bitbase files", Searcher.LoadBitbases(Config.BitbasePath));
+	}
+
+	if (Config.Depth > 0)
+	{
+		LOG("%zu positions from %s at depth %d on %d thread(s)", Suite.size(), Config.Path.c_str(), Config.Depth, Config.Threads);
+	}
+	else
+	{
+		LOG("%zu positions from %s at %d ms on %d thread(s)", Suite.size(), Config.Path.c_str(), Config.TimeMs, Config.Threads);
+	}
+
+	we::List<PositionResult> Results;
+	int Solved = 0;
+	std::uint64_t TotalNodes = 0;
+	std::int64_t TotalMs = 0;
+	int Histogram[BucketCount] = {};
+	we::List<std::int64_t> SolveTimes;
+
+	for (std::size_t i = 0; i < Suite.size(); ++i)
+	{
+		const PositionResult Result = SolvePosition(Searcher, Suite[i], Config);
+		TotalNodes += Result.Nodes;
+		TotalMs += Result.TimeMs;
+		if (Result.bSolved)
+		{
+			++Solved;
+			++Histogram[BucketOf(Result.SolveMs)];
+			SolveTimes.push_back(Result.SolveMs);
+		}
+
+		LOG("%4zu %-16s %-8s %-20s %s  %6lld ms  depth %2d  %10llu nodes", i + 1, Result.Id.c_str(), Result.Found.c_str(), Result.Expected.c_str(),
+			Result.bSolved ? "ok  " : "FAIL", static_cast<long long>(Result.bSolved ? Result.SolveMs : Result.TimeMs), Result.Depth,
+			static_cast<unsigned long long>(Result.Nodes));
+		Results.push_back(Result);
+	}
+
+	LOG("----------------------------------------------------");
+	LOG("Solved %d / %zu", Solved, Suite.size());
+	if (!SolveTimes.empty())
+	{
+		std::sort(SolveTimes.begin(), SolveTimes.end());
+		LOG("Time to solution: median %lld ms, 90th percentile %lld ms, max %lld ms", static_cast<long long>(SolveTimes[SolveTimes.size() / 2]),
+			static_cast<long long>(SolveTimes[SolveTimes.size() * 9 / 10]), static_cast<long long>(SolveTimes.back()));
+		for (int i = 0; i < BucketCount; ++i)
+		{
+			if (i < BucketCount - 1)
+			{
+				LOG("  <= %6lld ms  %4d", static_cast<long long>(SolveBuckets[i]), Histogram[i]);
+			}
+			else
+			{
+				LOG("   > %6lld ms  %4d", static_cast<long long>(SolveBuckets[i - 1]), Histogram[i]);
+			}
+		}
+	}
+	LOG("Nodes %llu, time %lld ms, %llu nps", static_cast<unsigned long long>(TotalNodes), static_cast<long long>(TotalMs),
+		static_cast<unsigned long long>(TotalMs > 0 ? TotalNodes * 1000 / std::uint64_t(TotalMs) : TotalNodes * 1000));
+
+	if (!Config.ReportPath.empty() && !WriteReport(Config, Results, Solved, TotalNodes, TotalMs, Histogram)) { return 1; }
+	if (Config.MinSolved >= 0 && Solved < Config.MinSolved)
+	{
+		LOG("Regression: %d solved, expected at least %d", Solved, Config.MinSolved);
+		return 1;
+	}
+	return 0;
+}
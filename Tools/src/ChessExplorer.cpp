@@ -0,0 +1,461 @@
+#include "Engine/OpeningExplorer.h"
+#include "IO/PgnReader.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+// Usage:
+//   chess_explorer build <index.bin> <games.pgn>... [options]
+//     --plies N       plies of each game that are indexed (default 40)
+//     --memory MB     sort memory shared by the threads (default 1024)
+//     --threads N     (default: hardware threads)
+//     --min-games N   leaves out moves played in fewer games (default 1)
+//   chess_explorer probe <index.bin> [fen]
+// The build is an external sort-merge. Every parsing thread gathers records
+// for its own games, and whenever its share of the memory fills it sorts
+// them, adds up duplicates and writes a sorted run next to the index. The
+// runs are merged in one pass at the end, so the archive never has to fit
+// in memory, and the finished index replaces the old one only once complete.
+namespace
+{
+	constexpr std::size_t MegaByte = 1024 * 1024;
+	constexpr std::size_t MergeBlockRecords = 1 << 16;			// Read from each run at a time, at most
+	constexpr std::size_t OutputBlockRecords = 1 << 16;
+
+	struct BuildConfig
+	{
+		we::string IndexPath;
+		we::List<we::string> Inputs;
+		int MaxPlies = 40;
+		std::size_t MemoryMb = 1024;
+		int Threads = std::max(1, int(std::thread::hardware_concurrency()));
+		std::uint64_t MinGames = 1;
+	};
+
+	// Each parsing thread fills its own buffer; the lock only guards the lookup.
+	// The reader starts new threads for every input, so the buffers are handed
+	// back after each one and reused, keeping their number at the thread count.
+	struct ThreadBuffer
+	{
+		we::List<we::ExplorerRecord> Records;
+		we::Position Pos;
+	};
+
+	struct SortState
+	{
+		const BuildConfig* Config = nullptr;
+		std::size_t RunRecords = 0;
+		we::Position Start;
+		std::mutex Lock;
+		we::List<we::unique<ThreadBuffer>> Buffers;
+		we::Dictionary<std::thread::id, ThreadBuffer*> Owners;
+		we::List<we::string> Runs;
+		std::atomic<std::uint64_t> Games{ 0 };
+		std::atomic<std::uint64_t> Positions{ 0 };
+		std::atomic<bool> bFailed{ false };
+	};
+
+	bool RecordLess(const we::ExplorerRecord& A, const we::ExplorerRecord& B)
+	{
+		return A.Key != B.Key ? A.Key < B.Key : A.MoveData < B.MoveData;
+	}
+
+	bool SameEntry(const we::ExplorerRecord& A, const we::ExplorerRecord& B)
+	{
+		return A.Key == B.Key && A.MoveData == B.MoveData;
+	}
+
+	std::uint32_t SaturatingAdd(std::uint32_t A, std::uint32_t B)
+	{
+		return std::uint32_t(std::min<std::uint64_t>(std::uint64_t(A) + B, 0xFFFFFFFFULL));
+	}
+
+	void AddCounts(we::ExplorerRecord& Into, const we::ExplorerRecord& From)
+	{
+		Into.WhiteWins = SaturatingAdd(Into.WhiteWins, From.WhiteWins);
+		Into.Draws = SaturatingAdd(Into.Draws, From.Draws);
+		Into.BlackWins = SaturatingAdd(Into.BlackWins, From.BlackWins);
+	}
+
+	// ----------------------------------------------------
+	// Sort Phase
+	// ----------------------------------------------------
+	void WriteRun(SortState& State, we::List<we::ExplorerRecord>& Records)
+	{
+		if (Records.empty()) { return; }
+
+		std::sort(Records.begin(), Records.end(), RecordLess);
+		std::size_t Kept = 0;
+		for (const we::ExplorerRecord& Record : Records)
+		{
+			if (Kept > 0 && SameEntry(Records[Kept - 1], Record))
+			{
+				AddCounts(Records[Kept - 1], Record);
+			}
+			else
+			{
+				Records[Kept++] = Record;
+			}
+		}
+
+		we::string Path;
+		{
+			std::lock_guard<std::mutex> Guard{ State.Lock };
+			Path = State.Config->IndexPath + ".run" + std::to_string(State.Runs.size());
+			State.Runs.push_back(Path);
+		}
+
+		bool bWritten = false;
+		if (std::FILE* Output = std::fopen(Path.c_str(), "wb"))
+		{
+			bWritten = std::fwrite(Records.data(), sizeof(we::ExplorerRecord), Kept, Output) == Kept;
+			bWritten = std::fclose(Output) == 0 && bWritten;
+		}
+		if (!bWritten)
+		{
+			LOG("Cannot write run %s", Path.c_str());
+			State.bFailed = true;
+		}
+		Records.clear();
+	}
+
+	ThreadBuffer& GetThreadBuffer(SortState& State)
+	{
+		std::lock_guard<std::mutex> Guard{ State.Lock };
+		ThreadBuffer*& Buffer = State.Owners[std::this_thread::get_id()];
+		if (!Buffer)
+		{
+			if (State.Owners.size() > State.Buffers.size())
+			{
+				State.Buffers.push_back(std::make_unique<ThreadBuffer>());
+				State.Buffers.back()->Records.reserve(State.RunRecords);
+			}
+			Buffer = State.Buffers[State.Owners.size() - 1].get();
+		}
+		return *Buffer;
+	}
+
+	// Called on the reader's threads
+	void CollectGame(SortState& State, const we::PgnGameView& Game)
+	{
+		const bool bWhiteWins = Game.Result == "1-0";
+		const bool bBlackWins = Game.Result == "0-1";
+		if (!bWhiteWins && !bBlackWins && Game.Result != "1/2-1/2") { return; }
+
+		ThreadBuffer& Buffer = GetThreadBuffer(State);
+		Buffer.Pos = State.Start;
+		if (!Game.StartFen.empty() && !Buffer.Pos.SetFromFen(we::string(Game.StartFen))) { return; }
+
+		const std::size_t Plies = std::min(Game.Moves.size(), std::size_t(State.Config->MaxPlies));
+		for (std::size_t Ply = 0; Ply < Plies; ++Ply)
+		{
+			we::ExplorerRecord Record;
+			Record.Key = Buffer.Pos.GetKey();
+			Record.MoveData = Game.Moves[Ply].Data;
+			Record.WhiteWins = bWhiteWins ? 1 : 0;
+			Record.BlackWins = bBlackWins ? 1 : 0;
+			Record.Draws = !bWhiteWins && !bBlackWins ? 1 : 0;
+			Buffer.Records.push_back(Record);
+			Buffer.Pos.MakeMove(Game.Moves[Ply]);
+		}
+		++State.Games;
+		State.Positions += Plies;
+
+		// Sorted on this thread, so the runs are made as parallel as the parsing
+		if (Buffer.Records.size() >= State.RunRecords)
+		{
+			WriteRun(State, Buffer.Records);
+		}
+	}
+
+	// ----------------------------------------------------
+	// Merge Phase
+	// ----------------------------------------------------
+	struct RunReader
+	{
+		std::FILE* File = nullptr;
+		we::List<we::ExplorerRecord> Block;
+		std::size_t Next = 0;
+
+		bool Refill()
+		{
+			Block.resize(Block.capacity());
+			Block.resize(std::fread(Block.data(), sizeof(we::ExplorerRecord), Block.size(), File));
+			Next = 0;
+			return !Block.empty();
+		}
+	};
+
+	struct MergeStats
+	{
+		std::uint64_t Records = 0;
+		std::uint64_t Positions = 0;
+	};
+
+	bool MergeRuns(const BuildConfig& Config, const we::List<we::string>& Runs, MergeStats& OutStats)
+	{
+		const std::size_t BlockRecords = std::clamp<std::size_t>(Config.MemoryMb * MegaByte / sizeof(we::ExplorerRecord) / std::max<std::size_t>(Runs.size(), 1),
+			1024, MergeBlockRecords);
+
+		we::List<RunReader> Readers(Runs.size());
+		using HeapEntry = std::pair<we::ExplorerRecord, std::size_t>;
+		auto HeapGreater = [](const HeapEntry& A, const HeapEntry& B) { return RecordLess(B.first, A.first); };
+		std::priority_queue<HeapEntry, we::List<HeapEntry>, decltype(HeapGreater)> Heap{ HeapGreater };
+
+		bool bFailed = false;
+		for (std::size_t i = 0; i < Runs.size() && !bFailed; ++i)
+		{
+			Readers[i].File = std::fopen(Runs[i].c_str(), "rb");
+			Readers[i].Block.reserve(BlockRecords);
+			bFailed = Readers[i].File == nullptr;
+			if (!bFailed && Readers[i].Refill())
+			{
+				Heap.push(HeapEntry{ Readers[i].Block[Readers[i].Next++], i });
+			}
+		}
+
+		const we::string TempPath = Config.IndexPath + ".tmp";
+		std::FILE* Output = bFailed ? nullptr : std::fopen(TempPath.c_str(), "wb");
+		if (Output)
+		{
+			char Header[we::OpeningExplorer::HeaderSize] = {};
+			const std::uint32_t RecordSize = sizeof(we::ExplorerRecord);
+			std::memcpy(Header, we::OpeningExplorer::Magic, sizeof(we::OpeningExplorer::Magic));
+			std::memcpy(Header + sizeof(we::OpeningExplorer::Magic), &RecordSize, sizeof(RecordSize));
+			bFailed = std::fwrite(Header, 1, sizeof(Header), Output) != sizeof(Header);
+		}
+		else
+		{
+			bFailed = true;
+		}
+
+		we::List<we::ExplorerRecord> Pending;
+		Pending.reserve(OutputBlockRecords);
+		auto FlushPending = [&Pending, &Output, &bFailed]()
+		{
+			bFailed = bFailed || std::fwrite(Pending.data(), sizeof(we::ExplorerRecord), Pending.size(), Output) != Pending.size();
+			Pending.clear();
+		};
+
+		we::ExplorerRecord Current;
+		bool bHasCurrent = false;
+		we::HashKey LastKey = 0;
+		auto Emit = [&](const we::ExplorerRecord& Record)
+		{
+			if (Record.GetGames() < Config.MinGames) { return; }
+			if (OutStats.Records == 0 || Record.Key != LastKey)
+			{
+				++OutStats.Positions;
+				LastKey = Record.Key;
+			}
+			++OutStats.Records;
+			Pending.push_back(Record);
+			if (Pending.size() >= OutputBlockRecords)
+			{
+				FlushPending();
+			}
+		};
+
+		while (!bFailed && !Heap.empty())
+		{
+			const HeapEntry Top = Heap.top();
+			Heap.pop();
+
+			RunReader& Reader = Readers[Top.second];
+			if (Reader.Next < Reader.Block.size() || Reader.Refill())
+			{
+				Heap.push(HeapEntry{ Reader.Block[Reader.Next++], Top.second });
+			}
+
+			if (bHasCurrent && SameEntry(Current, Top.first))
+			{
+				AddCounts(Current, Top.first);
+			}
+			else
+			{
+				if (bHasCurrent)
+				{
+					Emit(Current);
+				}
+				Current = Top.first;
+				bHasCurrent = true;
+			}
+		}
+		if (bHasCurrent && !bFailed)
+		{
+			Emit(Current);
+		}
+		if (Output)
+		{
+			FlushPending();
+			bFailed = std::fclose(Output) != 0 || bFailed;
+		}
+
+		for (RunReader& Reader : Readers)
+		{
+			if (Reader.File)
+			{
+				std::fclose(Reader.File);
+			}
+		}
+
+		// The old index stays in place until the new one is whole
+		if (!bFailed)
+		{
+			std::remove(Config.IndexPath.c_str());
+			bFailed = std::rename(TempPath.c_str(), Config.IndexPath.c_str()) != 0;
+		}
+		if (bFailed)
+		{
+			LOG("Cannot write %s", Config.IndexPath.c_str());
+			std::remove(TempPath.c_str());
+		}
+		return !bFailed;
+	}
+
+	// ----------------------------------------------------
+	// Commands
+	// ----------------------------------------------------
+	int Build(const BuildConfig& Config)
+	{
+		const auto Start = std::chrono::steady_clock::now();
+		auto ElapsedMs = [&Start]() { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count(); };
+
+		SortState State;
+		State.Config = &Config;
+		State.RunRecords = std::max<std::size_t>(Config.MemoryMb * MegaByte / sizeof(we::ExplorerRecord) / std::size_t(Config.Threads), 1024);
+
+		for (const we::string& Input : Config.Inputs)
+		{
+			we::PgnReader Reader;
+			if (!Reader.Open(Input))
+			{
+				State.bFailed = true;
+				break;
+			}
+			const we::PgnImportStats Stats = Reader.Read([&State](const we::PgnGameView& Game) { CollectGame(State, Game); }, Config.Threads);
+			LOG("%s: %llu games, %llu malformed", Input.c_str(), static_cast<unsigned long long>(Stats.Games), static_cast<unsigned long long>(Stats.Malformed));
+			State.Owners.clear();
+		}
+
+		// Whatever each thread still holds becomes a last run, sorted in parallel
+		we::List<std::thread> Flushers;
+		for (we::unique<ThreadBuffer>& Buffer : State.Buffers)
+		{
+			Flushers.emplace_back([&State, &Buffer]() { WriteRun(State, Buffer->Records); });
+		}
+		for (std::thread& Flusher : Flushers)
+		{
+			Flusher.join();
+		}
+		State.Buffers.clear();
+		const double SortMs = ElapsedMs();
+		LOG("Sorted %llu positions from %llu games into %zu run(s) in %.0f ms", static_cast<unsigned long long>(State.Positions.load()),
+			static_cast<unsigned long long>(State.Games.load()), State.Runs.size(), SortMs);
+
+		MergeStats Merged;
+		const bool bMerged = !State.bFailed && MergeRuns(Config, State.Runs, Merged);
+		for (const we::string& Run : State.Runs)
+		{
+			std::remove(Run.c_str());
+		}
+		if (!bMerged) { return 1; }
+
+		LOG("Merged %llu moves from %llu positions into %s in %.0f ms", static_cast<unsigned long long>(Merged.Records),
+			static_cast<unsigned long long>(Merged.Positions), Config.IndexPath.c_str(), ElapsedMs() - SortMs);
+		return 0;
+	}
+
+	int Probe(const char* IndexPath, const we::string& Fen)
+	{
+		we::OpeningExplorer Explorer;
+		if (!Explorer.Open(IndexPath)) { return 1; }
+
+		we::Position Pos;
+		if (!Pos.SetFromFen(Fen))
+		{
+			LOG("Invalid FEN: %s", Fen.c_str());
+			return 1;
+		}
+
+		// The first lookup may fault its pages in; the rest show the warm cost
+		we::ExplorerMove Moves[we::MaxMoves];
+		auto ColdStart = std::chrono::steady_clock::now();
+		int Count = Explorer.GetMoves(Pos, Moves, we::MaxMoves);
+		const double ColdMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - ColdStart).count();
+
+		constexpr int Lookups = 100000;
+		const auto Start = std::chrono::steady_clock::now();
+		for (int i = 0; i < Lookups; ++i)
+		{
+			Count = Explorer.GetMoves(Pos, Moves, we::MaxMoves);
+		}
+		const double Micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - Start).count() / Lookups;
+
+		for (int i = 0; i < Count; ++i)
+		{
+			const double Games = double(Moves[i].GetGames());
+			LOG("%-8s %10llu  +%.0f%% =%.0f%% -%.0f%%", we::MoveToSan(Pos, Moves[i].PlayedMove).c_str(), static_cast<unsigned long long>(Moves[i].GetGames()),
+				Moves[i].WhiteWins * 100.0 / Games, Moves[i].Draws * 100.0 / Games, Moves[i].BlackWins * 100.0 / Games);
+		}
+		LOG("%d moves, %.1f us first lookup, %.2f us per lookup over %zu records", Count, ColdMicros, Micros, Explorer.GetRecordCount());
+		return 0;
+	}
+
+	bool ParseBuildArguments(int argc, char** argv, BuildConfig& Config)
+	{
+		for (int i = 2; i < argc; ++i)
+		{
+			const we::string Option = argv[i];
+			const bool bHasValue = i + 1 < argc;
+			if (Option == "--plies" && bHasValue) { Config.MaxPlies = std::max(1, std::atoi(argv[++i])); }
+			else if (Option == "--memory" && bHasValue) { Config.MemoryMb = std::size_t(std::max(1, std::atoi(argv[++i]))); }
+			else if (Option == "--threads" && bHasValue) { Config.Threads = std::max(1, std::atoi(argv[++i])); }
+			else if (Option == "--min-games" && bHasValue) { Config.MinGames = std::max<std::uint64_t>(1, std::strtoull(argv[++i], nullptr, 10)); }
+			else if (Option[0] != '-' && Config.IndexPath.empty()) { Config.IndexPath = Option; }
+			else if (Option[0] != '-') { Config.Inputs.push_back(Option); }
+			else
+			{
+				LOG("Unknown option %s", Option.c_str());
+				return false;
+			}
+		}
+		return !Config.IndexPath.empty() && !Config.Inputs.empty();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const we::string Command = argc > 1 ? argv[1] : "";
+	if (Command == "build")
+	{
+		BuildConfig Config;
+		if (ParseBuildArguments(argc, argv, Config))
+		{
+			return Build(Config);
+		}
+	}
+	else if (Command == "probe" && argc >= 3)
+	{
+		we::string Fen = we::Position::StartFen;
+		if (argc > 3)
+		{
+			Fen.clear();
+			for (int i = 3; i < argc; ++i)
+			{
+				Fen += (i > 3 ? " " : "") + we::string(argv[i]);
+			}
+		}
+		return Probe(argv[2], Fen);
+	}
+
+	LOG("Usage: chess_explorer build <index.bin> <games.pgn>... [--plies N] [--memory MB] [--threads N] [--min-games N] | chess_explorer probe <index.bin> [fen]");
+	return 1;
+}
@@ -0,0 +1,127 @@
+#include "Engine/MateSolver.h"
+#include "IO/Epd.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Usage: chess_mate <fen | suite.epd> [options]
+//   --nodes N     node budget per position (default 10000000, 0 = none)
+//   --moves N     mate in at most N moves; an EPD "dm" operation sets it per position
+//   --hash MB     solver table (default 64)
+// Prints the mating line in SAN, or that none exists within the limits, with
+// the nodes per second and the memory the table uses. Exits with 1 when a
+// position with a "dm" operation is not solved.
+namespace
+{
+	struct SolverConfig
+	{
+		we::string Input;
+		we::MateLimits Limits;
+		std::size_t HashMb = 64;
+	};
+
+	we::string FormatLine(const we::Position& Pos, const we::List<we::Move>& Line)
+	{
+		we::Position Walk = Pos;
+		we::string Text;
+		for (we::Move Each : Line)
+		{
+			Text += (Text.empty() ? "" : " ") + we::MoveToSan(Walk, Each);
+			Walk.MakeMove(Each);
+		}
+		return Text;
+	}
+
+	// Returns false when an expected mate was not found
+	bool SolvePosition(we::MateSolver& Solver, const we::string& Fen, const we::string& Id, int ExpectedMoves, we::MateLimits Limits)
+	{
+		we::Position Pos;
+		if (!Pos.SetFromFen(Fen))
+		{
+			LOG("Invalid position %s", Fen.c_str());
+			return false;
+		}
+		if (ExpectedMoves > 0 && Limits.MaxMoves == 0)
+		{
+			Limits.MaxMoves = ExpectedMoves;
+		}
+
+		const we::MateSolution Solution = Solver.Solve(Pos, Limits);
+		const char* Verdict = Solution.Result == we::EMateResult::Mate ? "mate"
+			: Solution.Result == we::EMateResult::NoMate ? "no mate" : "unknown";
+		if (Solution.Result == we::EMateResult::Mate)
+		{
+			LOG("%s  mate in %d: %s", Id.c_str(), Solution.MovesToMate, FormatLine(Pos, Solution.Line).c_str());
+		}
+		else if (Limits.MaxMoves > 0)
+		{
+			LOG("%s  %s within %d moves", Id.c_str(), Verdict, Limits.MaxMoves);
+		}
+		else
+		{
+			LOG("%s  %s", Id.c_str(), Verdict);
+		}
+		LOG("    %llu nodes, %lld ms, %llu nodes/s, %zu MB table", static_cast<unsigned long long>(Solution.Nodes),
+			static_cast<long long>(Solution.TimeMs), static_cast<unsigned long long>(Solution.NodesPerSecond()), Solution.MemoryBytes / (1024 * 1024));
+
+		return ExpectedMoves == 0 || (Solution.Result == we::EMateResult::Mate && Solution.MovesToMate <= ExpectedMoves);
+	}
+
+	bool ParseArguments(int argc, char** argv, SolverConfig& Config)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const we::string Option = argv[i];
+			const bool bHasValue = i + 1 < argc;
+			if (Option == "--nodes" && bHasValue) { Config.Limits.Nodes = std::strtoull(argv[++i], nullptr, 10); }
+			else if (Option == "--moves" && bHasValue) { Config.Limits.MaxMoves = std::max(0, std::atoi(argv[++i])); }
+			else if (Option == "--hash" && bHasValue) { Config.HashMb = std::size_t(std::max(1, std::atoi(argv[++i]))); }
+			else if (Option[0] != '-' && Config.Input.empty()) { Config.Input = Option; }
+			else
+			{
+				LOG("Unknown option %s", Option.c_str());
+				return false;
+			}
+		}
+		if (Config.Input.empty())
+		{
+			LOG("Usage: chess_mate <fen | suite.epd> [--nodes N] [--moves N] [--hash MB]");
+			return false;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	SolverConfig Config;
+	if (!ParseArguments(argc, argv, Config)) { return 1; }
+
+	we::MateSolver Solver;
+	Solver.SetHashSize(Config.HashMb);
+
+	// A FEN has spaces in it; a suite path normally does not
+	if (Config.Input.find(' ') != we::string::npos)
+	{
+		return SolvePosition(Solver, Config.Input, "position", 0, Config.Limits) ? 0 : 1;
+	}
+
+	const we::List<we::EpdRecord> Suite = we::LoadEpdFile(Config.Input);
+	if (Suite.empty()) { return 1; }
+
+	int Failed = 0;
+	for (const we::EpdRecord& Record : Suite)
+	{
+		const we::List<we::string>* Expected = Record.FindOperation("dm");
+		const int ExpectedMoves = Expected && !Expected->empty() ? std::atoi(Expected->front().c_str()) : 0;
+
+		// Positions are unrelated, so each starts from an empty table
+		Solver.Clear();
+		if (!SolvePosition(Solver, Record.Fen, Record.GetId(), ExpectedMoves, Config.Limits))
+		{
+			++Failed;
+		}
+	}
+	LOG("%zu positions, %d failed", Suite.size(), Failed);
+	return Failed > 0 ? 1 : 0;
+}
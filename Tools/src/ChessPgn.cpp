@@ -0,0 +1,75 @@
+#include "IO/PgnReader.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+// Usage: chess_pgn <games.pgn> [options]
+//   --threads N   parts parsed at once (default: hardware threads)
+//   --errors N    malformed games listed (default 20)
+// Imports the whole file the way the replay and explorer features do and
+// reports games per second, so archive sizes can be planned against it.
+// Exits with 1 when the file cannot be read or any game is malformed.
+namespace
+{
+	struct ImportConfig
+	{
+		we::string Input;
+		int Threads = 0;
+		std::size_t ShownErrors = 20;
+	};
+
+	bool ParseArguments(int argc, char** argv, ImportConfig& Config)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const we::string Option = argv[i];
+			const bool bHasValue = i + 1 < argc;
+			if (Option == "--threads" && bHasValue) { Config.Threads = std::max(1, std::atoi(argv[++i])); }
+			else if (Option == "--errors" && bHasValue) { Config.ShownErrors = std::size_t(std::max(0, std::atoi(argv[++i]))); }
+			else if (Option[0] != '-' && Config.Input.empty()) { Config.Input = Option; }
+			else
+			{
+				LOG("Unknown option %s", Option.c_str());
+				return false;
+			}
+		}
+		if (Config.Input.empty())
+		{
+			LOG("Usage: chess_pgn <games.pgn> [--threads N] [--errors N]");
+			return false;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	ImportConfig Config;
+	if (!ParseArguments(argc, argv, Config)) { return 1; }
+
+	we::PgnReader Reader;
+	if (!Reader.Open(Config.Input)) { return 1; }
+
+	// Counted on the worker threads, as a consumer would store the games
+	std::atomic<std::uint64_t> Results[4] = {};
+	const we::PgnImportStats Stats = Reader.Read([&Results](const we::PgnGameView& Game)
+	{
+		const int Index = Game.Result == "1-0" ? 0 : Game.Result == "0-1" ? 1 : Game.Result == "1/2-1/2" ? 2 : 3;
+		Results[Index].fetch_add(1, std::memory_order_relaxed);
+	}, Config.Threads);
+
+	const std::size_t Shown = std::min(Config.ShownErrors, Reader.GetErrors().size());
+	for (std::size_t i = 0; i < Shown; ++i)
+	{
+		const we::PgnError& Error = Reader.GetErrors()[i];
+		LOG("byte %zu: %s", Error.Offset, Error.Message.c_str());
+	}
+
+	LOG("%llu games (+%llu -%llu =%llu *%llu), %llu malformed, %llu moves", static_cast<unsigned long long>(Stats.Games),
+		static_cast<unsigned long long>(Results[0].load()), static_cast<unsigned long long>(Results[1].load()),
+		static_cast<unsigned long long>(Results[2].load()), static_cast<unsigned long long>(Results[3].load()),
+		static_cast<unsigned long long>(Stats.Malformed), static_cast<unsigned long long>(Stats.Moves));
+	LOG("%.1f MB in %lld ms: %.0f games/s, %.1f MB/s", Stats.Bytes / 1e6, static_cast<long long>(Stats.TimeMs), Stats.GamesPerSecond(),
+		Stats.MegaBytesPerSecond());
+	return Stats.Malformed > 0 ? 1 : 0;
+}
@@ -0,0 +1,301 @@
+#include "Match/SelfPlay.h"
+#include "Match/MatchStats.h"
+#include "Engine/Nnue.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+// Usage: chess_selfplay [options]
+//   --games N             games to play, in pairs with colours reversed (default 100)
+//   --concurrency M       games played at once (default: hardware threads)
+//   --tc 10+0.1           seconds plus increment, or movetime=ms, nodes=N, depth=N
+//   --openings file       FEN or EPD suite, one position per line (default: random openings)
+//   --random-plies N      without --openings, random moves from the start position opening each pair (default 8)
+//   --seed N              seeds the random openings (default 1)
+//   --pgn file            appends every finished game
+//   --syzygy path         adjudicates tablebase positions
+//   --bitbases dir        bitbases both engines probe during search
+//   --sprt elo0 elo1      stops once H0 or H1 is accepted (alpha = beta = 0.05)
+//   --hash MB             per engine (default 16)
+//   --a-network file, --b-network file, --a-threads N, --b-threads N
+// Engine A and engine B are this engine with the given settings; each game
+// runs on its own thread with its own pair of engines.
+namespace
+{
+	struct PlayerConfig
+	{
+		we::string Name;
+		we::string NetworkPath;
+		int Threads = 1;
+		we::unique<we::Nnue::Network> Network;
+	};
+
+	struct MatchConfig
+	{
+		int Games = 100;
+		int Concurrency = std::max(1, int(std::thread::hardware_concurrency()));
+		we::GameSettings Settings;
+		we::string OpeningsPath;
+		int RandomPlies = 8;
+		std::uint64_t Seed = 1;
+		we::string PgnPath;
+		we::string SyzygyPath;
+		we::string BitbasePath;
+		std::size_t HashMb = 16;
+		bool bSprt = false;
+		we::SprtTest Sprt;
+		PlayerConfig Players[2];
+	};
+
+	struct MatchState
+	{
+		std::atomic<int> NextGame{ 0 };
+		std::atomic<bool> bStop{ false };
+		std::mutex Lock;
+		we::MatchScore Score;
+		std::ofstream Pgn;
+		std::chrono::steady_clock::time_point Start;
+	};
+
+	void SetUpEngine(we::Engine& Player, const PlayerConfig& Config, const MatchConfig& Match)
+	{
+		Player.SetThreadCount(Config.Threads);
+		Player.SetHashSize(Match.HashMb);
+		Player.SetBookEnabled(false);
+		Player.SetNetwork(Config.Network.get());
+		if (!Match.BitbasePath.empty())
+		{
+			Player.LoadBitbases(Match.BitbasePath);
+		}
+	}
+
+	std::uint64_t NextRandom(std::uint64_t& State)
+	{
+		std::uint64_t Z = (State += 0x9E3779B97F4A7C15ULL);
+		Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBULL;
+		return Z ^ (Z >> 31);
+	}
+
+	// One opening per pair, so both colours of a pair still start alike; a
+	// prefix that ends the game is drawn again
+	we::List<we::string> MakeRandomOpenings(int Count, int Plies, std::uint64_t Seed)
+	{
+		we::List<we::string> Openings;
+		std::uint64_t RandomState = Seed;
+		while (int(Openings.size()) < Count)
+		{
+			we::Position Pos;
+			Pos.SetFromFen(we::Position::StartFen);
+			we::MoveList Moves;
+			we::GenerateLegalMoves(Pos, Moves);
+			for (int Ply = 0; Ply < Plies && Moves.Count > 0; ++Ply)
+			{
+				Pos.MakeMove(Moves.Moves[NextRandom(RandomState) % std::uint64_t(Moves.Count)]);
+				Moves.Count = 0;
+				we::GenerateLegalMoves(Pos, Moves);
+			}
+			if (Moves.Count > 0)
+			{
+				Openings.push_back(Pos.GetFen());
+			}
+		}
+		return Openings;
+	}
+
+	void PrintStatus(const MatchConfig& Config, MatchState& State)
+	{
+		const we::MatchScore& Score = State.Score;
+		const double Hours = std::chrono::duration<double>(std::chrono::steady_clock::now() - State.Start).count() / 3600.0;
+		LOG("Games %d: +%d =%d -%d  Elo %.1f +/- %.1f  LOS %.1f%%  %.0f games/h", Score.Games(), Score.Wins, Score.Draws, Score.Losses,
+			Score.Elo(), Score.EloError95(), Score.LikelihoodOfSuperiority() * 100.0, Hours > 0.0 ? Score.Games() / Hours : 0.0);
+		if (Config.bSprt)
+		{
+			LOG("SPRT [%.1f, %.1f]: LLR %.2f (%.2f, %.2f)", Config.Sprt.Elo0, Config.Sprt.Elo1,
+				Config.Sprt.LogLikelihoodRatio(Score), Config.Sprt.LowerBound(), Config.Sprt.UpperBound());
+		}
+	}
+
+	void RunWorker(const MatchConfig& Config, const we::List<we::string>& Openings, const we::SyzygyTablebases& Tablebases, MatchState& State)
+	{
+		we::Engine Players[2];
+		SetUpEngine(Players[0], Config.Players[0], Config);
+		SetUpEngine(Players[1], Config.Players[1], Config);
+
+		we::GameSettings Settings = Config.Settings;
+		Settings.Tablebases = Tablebases.GetMaxPieces() > 0 ? &Tablebases : nullptr;
+
+		while (!State.bStop)
+		{
+			const int Index = State.NextGame++;
+			if (Index >= Config.Games) { break; }
+
+			// Each opening is played twice with the colours reversed
+			const we::string& Opening = Openings[(Index / 2) % Openings.size()];
+			const int WhiteSide = Index & 1;
+			const we::GameRecord Record = we::PlayGame(Players[WhiteSide], Players[WhiteSide ^ 1], Opening, Settings);
+			if (Record.Termination == we::ETermination::None) { continue; }
+
+			std::lock_guard<std::mutex> Guard{ State.Lock };
+			const bool bWhiteWon = Record.Result == we::EGameResult::WhiteWins;
+			if (Record.Result == we::EGameResult::Draw)
+			{
+				++State.Score.Draws;
+			}
+			else if (bWhiteWon == (WhiteSide == 0))
+			{
+				++State.Score.Wins;
+			}
+			else
+			{
+				++State.Score.Losses;
+			}
+
+			if (State.Pgn)
+			{
+				we::PgnGame Game = Record.ToPgn(Config.Players[WhiteSide].Name, Config.Players[WhiteSide ^ 1].Name);
+				Game.SetTag("Event", "chess_selfplay");
+				Game.SetTag("Site", "local");
+				Game.SetTag("Date", we::CurrentPgnDate());
+				Game.SetTag("Round", std::to_string(Index + 1));
+				Game.SetTag("TimeControl", Config.Settings.Clock.ToPgnTag());
+				State.Pgn << we::FormatPgn(Game);
+				State.Pgn.flush();
+			}
+
+			if (State.Score.Games() % 10 == 0)
+			{
+				PrintStatus(Config, State);
+			}
+			if (Config.bSprt && Config.Sprt.Evaluate(State.Score) != we::ESprtState::Running)
+			{
+				State.bStop = true;
+			}
+		}
+	}
+
+	bool ParseArguments(int argc, char** argv, MatchConfig& Config)
+	{
+		Config.Players[0].Name = "A";
+		Config.Players[1].Name = "B";
+
+		for (int i = 1; i < argc; ++i)
+		{
+			const we::string Option = argv[i];
+			const bool bHasValue = i + 1 < argc;
+			if (Option == "--games" && bHasValue) { Config.Games = std::atoi(argv[++i]); }
+			else if (Option == "--concurrency" && bHasValue) { Config.Concurrency = std::max(1, std::atoi(argv[++i])); }
+			else if (Option == "--tc" && bHasValue)
+			{
+				if (!Config.Settings.Clock.Parse(argv[++i]))
+				{
+					LOG("Bad time control %s", argv[i]);
+					return false;
+				}
+			}
+			else if (Option == "--openings" && bHasValue) { Config.OpeningsPath = argv[++i]; }
+			else if (Option == "--random-plies" && bHasValue) { Config.RandomPlies = std::max(0, std::atoi(argv[++i])); }
+			else if (Option == "--seed" && bHasValue) { Config.Seed = std::strtoull(argv[++i], nullptr, 10); }
+			else if (Option == "--pgn" && bHasValue) { Config.PgnPath = argv[++i]; }
+			else if (Option == "--syzygy" && bHasValue) { Config.SyzygyPath = argv[++i]; }
+			else if (Option == "--bitbases" && bHasValue) { Config.BitbasePath = argv[++i]; }
+			else if (Option == "--hash" && bHasValue) { Config.HashMb = std::size_t(std::atoi(argv[++i])); }
+			else if (Option == "--sprt" && i + 2 < argc)
+			{
+				Config.bSprt = true;
+				Config.Sprt.Elo0 = std::atof(argv[++i]);
+				Config.Sprt.Elo1 = std::atof(argv[++i]);
+			}
+			else if ((Option == "--a-network" || Option == "--b-network") && bHasValue) { Config.Players[Option[2] == 'b'].NetworkPath = argv[++i]; }
+			else if ((Option == "--a-threads" || Option == "--b-threads") && bHasValue) { Config.Players[Option[2] == 'b'].Threads = std::max(1, std::atoi(argv[++i])); }
+			else
+			{
+				LOG("Unknown option %s", Option.c_str());
+				return false;
+			}
+		}
+		return Config.Games > 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	MatchConfig Config;
+	if (!ParseArguments(argc, argv, Config)) { return 1; }
+
+	for (PlayerConfig& Player : Config.Players)
+	{
+		if (Player.NetworkPath.empty()) { continue; }
+
+		Player.Network = std::make_unique<we::Nnue::Network>();
+		if (!Player.Network->LoadFromFile(Player.NetworkPath)) { return 1; }
+		Player.Name += " (" + Player.NetworkPath + ")";
+	}
+
+	we::List<we::string> Openings;
+	if (!Config.OpeningsPath.empty())
+	{
+		Openings = we::LoadOpenings(Config.OpeningsPath);
+		if (Openings.empty()) { return 1; }
+	}
+	else if (Config.RandomPlies > 0)
+	{
+		Openings = MakeRandomOpenings((Config.Games + 1) / 2, Config.RandomPlies, Config.Seed);
+	}
+	else if (Config.Settings.Clock.Depth || Config.Settings.Clock.Nodes)
+	{
+		// A depth or node limit plays the same game from the same position every time
+		LOG("A fixed depth or node match needs --openings or --random-plies");
+		return 1;
+	}
+	else
+	{
+		Openings.push_back(we::Position::StartFen);
+	}
+
+	// Shared read-only by every game once the files are listed
+	we::SyzygyTablebases Tablebases;
+	if (!Config.SyzygyPath.empty())
+	{
+		LOG("Found %d tablebase files", Tablebases.Init(Config.SyzygyPath));
+	}
+
+	MatchState State;
+	if (!Config.PgnPath.empty())
+	{
+		State.Pgn.open(Config.PgnPath, std::ios::app);
+		if (!State.Pgn)
+		{
+			LOG("Cannot write %s", Config.PgnPath.c_str());
+			return 1;
+		}
+	}
+
+	LOG("Playing %d games, %d at a time, tc %s, %zu opening(s)", Config.Games, Config.Concurrency,
+		Config.Settings.Clock.ToPgnTag().c_str(), Openings.size());
+	State.Start = std::chrono::steady_clock::now();
+
+	we::List<std::thread> Workers;
+	for (int i = 0; i < std::min(Config.Concurrency, Config.Games); ++i)
+	{
+		Workers.emplace_back(RunWorker, std::cref(Config), std::cref(Openings), std::cref(Tablebases), std::ref(State));
+	}
+	for (std::thread& Worker : Workers)
+	{
+		Worker.join();
+	}
+
+	PrintStatus(Config, State);
+	if (Config.bSprt)
+	{
+		const we::ESprtState Verdict = Config.Sprt.Evaluate(State.Score);
+		LOG("SPRT: %s", Verdict == we::ESprtState::AcceptH1 ? "H1 accepted" : Verdict == we::ESprtState::AcceptH0 ? "H0 accepted" : "inconclusive");
+	}
+	return 0;
+}
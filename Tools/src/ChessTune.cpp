@@ -0,0 +1,93 @@
+#include "Tuning/TexelTuner.h"
+#include "Tuning/EvalTrace.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+// Usage:
+//   chess_tune pack <corpus.txt> <corpus.bin> [threads]
+//     corpus.txt holds one "<FEN or EPD> <result>" per line; positions are
+//     resolved through a quiescence search and stored as 32-byte records
+//   chess_tune tune <corpus.bin> <EvalParams.h> <output.h> [epochs = 200] [threads] [learning rate = 1.0]
+//     writes a copy of EvalParams.h with every tuned table replaced
+namespace
+{
+	int DefaultThreads()
+	{
+		return std::max(1, int(std::thread::hardware_concurrency()));
+	}
+
+	int Pack(const char* TextPath, const char* PackedPath, int Threads)
+	{
+		const auto Start = std::chrono::steady_clock::now();
+		const we::CorpusStats Stats = we::PackCorpus(TextPath, PackedPath, Threads);
+		const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+		LOG("Packed %llu of %llu lines (%llu skipped) in %.2f s", static_cast<unsigned long long>(Stats.Packed),
+			static_cast<unsigned long long>(Stats.Lines), static_cast<unsigned long long>(Stats.Skipped), Seconds);
+		return Stats.Packed > 0 ? 0 : 1;
+	}
+
+	int Tune(const char* PackedPath, const char* TemplatePath, const char* OutputPath, we::TunerSettings Settings)
+	{
+		std::ifstream TemplateFile{ TemplatePath };
+		if (!TemplateFile)
+		{
+			LOG("Could not open %s", TemplatePath);
+			return 1;
+		}
+		std::stringstream Template;
+		Template << TemplateFile.rdbuf();
+
+		we::TexelTuner Tuner;
+		if (!Tuner.Open(PackedPath))
+		{
+			LOG("Could not map %s", PackedPath);
+			return 1;
+		}
+		LOG("Tuning %d parameters on %zu positions with %d threads", we::EvalTuning::GetParamCount(), Tuner.GetPositionCount(), Settings.Threads);
+
+		const auto Start = std::chrono::steady_clock::now();
+		Tuner.Run(Settings, [&Tuner, Start](int Epoch, double Error)
+		{
+			if (Epoch == 1)
+			{
+				LOG("K = %.4f", Tuner.GetScalingConstant());
+			}
+			const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+			LOG("Epoch %d: error %.8f (%.1f s)", Epoch, Error, Seconds);
+		});
+
+		const we::string Header = we::EvalTuning::RegenerateEvalParams(Template.str(), Tuner.GetParams());
+		if (Header.empty()) { return 1; }
+
+		std::ofstream Output{ OutputPath, std::ios::binary };
+		Output << Header;
+		LOG("Final error %.8f, parameters written to %s", Tuner.ComputeError(Tuner.GetScalingConstant(), Settings.Threads), OutputPath);
+		return Output ? 0 : 1;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc >= 4 && std::strcmp(argv[1], "pack") == 0)
+	{
+		return Pack(argv[2], argv[3], argc > 4 ? std::atoi(argv[4]) : DefaultThreads());
+	}
+
+	if (argc >= 5 && std::strcmp(argv[1], "tune") == 0)
+	{
+		we::TunerSettings Settings;
+		Settings.Epochs = argc > 5 ? std::atoi(argv[5]) : Settings.Epochs;
+		Settings.Threads = argc > 6 ? std::atoi(argv[6]) : DefaultThreads();
+		Settings.LearningRate = argc > 7 ? std::atof(argv[7]) : Settings.LearningRate;
+		return Tune(argv[2], argv[3], argv[4], Settings);
+	}
+
+	LOG("Usage: chess_tune pack <corpus.txt> <corpus.bin> [threads]");
+	LOG("       chess_tune tune <corpus.bin> <EvalParams.h> <output.h> [epochs] [threads] [learning rate]");
+	return 1;
+}
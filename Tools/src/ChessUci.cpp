@@ -0,0 +1,352 @@
+#include "Engine/Benchmark.h"
+#include "Engine/Engine.h"
+#include "Engine/Mcts.h"
+#include "Engine/Nnue.h"
+#include "Rules/MoveGen.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+// Usage: chess_uci [command]
+// Speaks UCI on stdin / stdout, or runs a single command such as "bench 12"
+// given on the command line and exits. "setoption name UseMCTS value true"
+// switches the search to the PUCT tree search. The search runs on the engine's own threads,
+// so this loop is always waiting on the next command and "stop" reaches the
+// search within its next node-count check.
+namespace
+{
+	constexpr int MaxHashMb = 65536;
+	constexpr int MaxThreads = 512;
+	constexpr int MaxMultiPv = 64;
+
+	class UciSession
+	{
+	public:
+		UciSession()
+			: Network{}
+			, Searcher{}
+			, TreeSearcher{}
+			, bUseMcts{ false }
+			, Pos{}
+			, MultiPv{ 1 }
+			, bInfinite{ false }
+			, bStopReceived{ false }
+			, HeldBestMove{}
+			, OutputLock{}
+		{
+			Searcher.SetBookEnabled(false);
+			Searcher.OnInfo = [this](const we::SearchInfo& Info) { Send(we::FormatUciInfo(Info)); };
+			Searcher.OnBestMove = [this](const we::SearchResult& Result) { ReportBestMove(Result); };
+			TreeSearcher.OnInfo = Searcher.OnInfo;
+			TreeSearcher.OnBestMove = Searcher.OnBestMove;
+		}
+
+		~UciSession()
+		{
+			Searcher.Stop();
+			Searcher.Wait();
+			TreeSearcher.Stop();
+			TreeSearcher.Wait();
+		}
+
+		// Returns false on "quit"
+		bool Execute(const we::string& Line)
+		{
+			std::istringstream Tokens{ Line };
+			we::string Command;
+			Tokens >> Command;
+
+			if (Command == "uci") { Identify(); }
+			else if (Command == "isready") { Send("readyok"); }
+			else if (Command == "ucinewgame") { Searcher.NewGame(); TreeSearcher.NewGame(); }
+			else if (Command == "setoption") { SetOption(Tokens); }
+			else if (Command == "position") { SetPosition(Tokens); }
+			else if (Command == "go") { Go(Tokens); }
+			else if (Command == "stop") { Stop(); }
+			else if (Command == "ponderhit") { Searcher.PonderHit(); TreeSearcher.PonderHit(); }
+			else if (Command == "d") { Send("info string " + Pos.GetFen()); }
+			else if (Command == "bench") { Bench(Tokens); }
+			else if (Command == "quit") { return false; }
+			else if (!Command.empty()) { Send("info string unknown command " + Command); }
+			return true;
+		}
+
+		// Same as "stop", but waits for the search so its best move is written
+		// before the process exits
+		void Quit()
+		{
+			Stop();
+			Searcher.Wait();
+			TreeSearcher.Wait();
+		}
+
+	private:
+		void Send(const we::string& Text)
+		{
+			std::lock_guard<std::mutex> Guard{ OutputLock };
+			std::fwrite(Text.data(), 1, Text.size(), stdout);
+			std::fputc('\n', stdout);
+			std::fflush(stdout);
+		}
+
+		void Identify()
+		{
+			Send("id name Diablo Inventory Chess");
+			Send("id author WillTheWater");
+			Send("option name Hash type spin default 16 min 1 max " + std::to_string(MaxHashMb));
+			Send("option name Threads type spin default 1 min 1 max " + std::to_string(MaxThreads));
+			Send("option name MultiPV type spin default 1 min 1 max " + std::to_string(MaxMultiPv));
+			Send("option name Ponder type check default false");
+			Send("option name SyzygyPath type string default <empty>");
+			Send("option name BitbasePath type string default <empty>");
+			Send("option name EvalFile type string default <empty>");
+			Send("option name UseMCTS type check default false");
+			Send("uciok");
+		}
+
+		// "setoption name <id> [value <x>]"; names may contain spaces
+		void SetOption(std::istringstream& Tokens)
+		{
+			we::string Token, Name, Value;
+			Tokens >> Token;
+			while (Tokens >> Token && Token != "value")
+			{
+				Name += (Name.empty() ? "" : " ") + Token;
+			}
+			while (Tokens >> Token)
+			{
+				Value += (Value.empty() ? "" : " ") + Token;
+			}
+
+			std::transform(Name.begin(), Name.end(), Name.begin(), [](unsigned char C) { return char(std::tolower(C)); });
+			if (Name == "hash")
+			{
+				const std::size_t MegaBytes = std::size_t(std::clamp(std::atoi(Value.c_str()), 1, MaxHashMb));
+				Searcher.SetHashSize(MegaBytes);
+				TreeSearcher.SetTreeSize(MegaBytes);
+			}
+			else if (Name == "threads")
+			{
+				const int Threads = std::clamp(std::atoi(Value.c_str()), 1, MaxThreads);
+				Searcher.SetThreadCount(Threads);
+				TreeSearcher.SetThreadCount(Threads);
+			}
+			else if (Name == "usemcts") { bUseMcts = Value == "true"; }
+			else if (Name == "multipv") { MultiPv = std::clamp(std::atoi(Value.c_str()), 1, MaxMultiPv); }
+			else if (Name == "syzygypath")
+			{
+				const int Found = Value.empty() || Value == "<empty>" ? Searcher.SetSyzygyPath("") : Searcher.SetSyzygyPath(Value);
+				Send("info string found " + std::to_string(Found) + " tablebase files");
+			}
+			else if (Name == "bitbasepath")
+			{
+				const int Found = Searcher.LoadBitbases(Value == "<empty>" ? "" : Value);
+				Send("info string found " + std::to_string(Found) + " bitbase files");
+			}
+			else if (Name == "evalfile") { SetEvalFile(Value == "<empty>" ? "" : Value); }
+			else if (Name != "ponder") { Send("info string unknown option " + Name); }
+		}
+
+		void SetPosition(std::istringstream& Tokens)
+		{
+			we::string Token, Fen;
+			Tokens >> Token;
+			if (Token == "startpos")
+			{
+				Fen = we::Position::StartFen;
+				Tokens >> Token;
+			}
+			else if (Token == "fen")
+			{
+				while (Tokens >> Token && Token != "moves")
+				{
+					Fen += (Fen.empty() ? "" : " ") + Token;
+				}
+			}
+
+			we::Position NewPos;
+			if (!NewPos.SetFromFen(Fen))
+			{
+				Send("info string invalid position " + Fen);
+				return;
+			}
+
+			while (Tokens >> Token)
+			{
+				const we::Move Parsed = we::ParseUciMove(NewPos, Token);
+				if (Parsed.IsNull())
+				{
+					Send("info string illegal move " + Token);
+					break;
+				}
+				NewPos.MakeMove(Parsed);
+			}
+			Pos = NewPos;
+		}
+
+		void Go(std::istringstream& Tokens)
+		{
+			we::SearchLimits Limits;
+			Limits.MultiPv = MultiPv;
+
+			we::string Token;
+			while (Tokens >> Token)
+			{
+				if (Token == "wtime") { Tokens >> Limits.Time[we::White]; }
+				else if (Token == "btime") { Tokens >> Limits.Time[we::Black]; }
+				else if (Token == "winc") { Tokens >> Limits.Increment[we::White]; }
+				else if (Token == "binc") { Tokens >> Limits.Increment[we::Black]; }
+				else if (Token == "movestogo") { Tokens >> Limits.MovesToGo; }
+				else if (Token == "depth") { Tokens >> Limits.Depth; }
+				else if (Token == "nodes") { Tokens >> Limits.Nodes; }
+				else if (Token == "movetime") { Tokens >> Limits.MoveTime; }
+				else if (Token == "infinite") { Limits.bInfinite = true; }
+				else if (Token == "ponder") { Limits.bPonder = true; }
+				else if (Token == "searchmoves")
+				{
+					while (Tokens >> Token)
+					{
+						const we::Move Parsed = we::ParseUciMove(Pos, Token);
+						if (!Parsed.IsNull()) { Limits.SearchMoves.push_back(Parsed); }
+					}
+				}
+			}
+
+			// The previous search reports under the flags it was started with
+			Searcher.Stop();
+			Searcher.Wait();
+			TreeSearcher.Stop();
+			TreeSearcher.Wait();
+			{
+				std::lock_guard<std::mutex> Guard{ OutputLock };
+				bInfinite = Limits.bInfinite;
+				bStopReceived = false;
+				HeldBestMove.clear();
+			}
+			if (bUseMcts)
+			{
+				TreeSearcher.Start(Pos, Limits);
+			}
+			else
+			{
+				Searcher.Start(Pos, Limits);
+			}
+		}
+
+		// "bench [depth]": the fixed single-threaded search bench; its node total
+		// must not change unless the search itself does
+		void Bench(std::istringstream& Tokens)
+		{
+			int Depth = we::DefaultBenchDepth;
+			Tokens >> Depth;
+
+			Searcher.Stop();
+			Searcher.Wait();
+			TreeSearcher.Stop();
+			TreeSearcher.Wait();
+			Send(we::FormatSearchBenchmark(we::RunSearchBenchmark(std::max(1, Depth))));
+		}
+
+		void Stop()
+		{
+			Searcher.Stop();
+			TreeSearcher.Stop();
+
+			std::lock_guard<std::mutex> Guard{ OutputLock };
+			bStopReceived = true;
+			if (!HeldBestMove.empty())
+			{
+				std::fputs(HeldBestMove.c_str(), stdout);
+				std::fflush(stdout);
+				HeldBestMove.clear();
+			}
+		}
+
+		// Search thread. An infinite search that runs out of depth must still
+		// wait for "stop" before answering.
+		// Both searchers point at the network, so it is only swapped while they are idle
+		void SetEvalFile(const we::string& Path)
+		{
+			Searcher.Wait();
+			TreeSearcher.Wait();
+			Searcher.SetNetwork(nullptr);
+			TreeSearcher.SetNetwork(nullptr);
+			Network.reset();
+			if (!Path.empty())
+			{
+				we::unique<we::Nnue::Network> Loaded = std::make_unique<we::Nnue::Network>();
+				if (Loaded->LoadFromFile(Path))
+				{
+					Network = std::move(Loaded);
+				}
+				Send("info string " + we::string(Network ? "loaded network " : "cannot load network ") + Path);
+			}
+			Searcher.SetNetwork(Network.get());
+			TreeSearcher.SetNetwork(Network.get());
+		}
+
+		void ReportBestMove(const we::SearchResult& Result)
+		{
+			const we::SearchStats Stats = bUseMcts ? TreeSearcher.GetStatistics() : Searcher.GetStatistics();
+			we::string Text = we::FormatUciStats(Stats) + "\nbestmove " + we::MoveToUci(Result.BestMove);
+			if (!Result.PonderMove.IsNull())
+			{
+				Text += " ponder " + we::MoveToUci(Result.PonderMove);
+			}
+			Text += '\n';
+
+			std::lock_guard<std::mutex> Guard{ OutputLock };
+			if (bInfinite && !bStopReceived)
+			{
+				HeldBestMove = Text;
+				return;
+			}
+			std::fputs(Text.c_str(), stdout);
+			std::fflush(stdout);
+		}
+
+		we::unique<we::Nnue::Network> Network;		// Declared first so it outlives both searchers
+		we::Engine Searcher;
+		we::MctsEngine TreeSearcher;
+		bool bUseMcts;
+		we::Position Pos;
+		int MultiPv;
+		bool bInfinite;
+		bool bStopReceived;
+		we::string HeldBestMove;
+		std::mutex OutputLock;
+	};
+}
+
+int main(int argc, char** argv)
+{
+	std::ios::sync_with_stdio(false);
+	UciSession Session;
+
+	if (argc > 1)
+	{
+		we::string Command = argv[1];
+		for (int i = 2; i < argc; ++i)
+		{
+			Command += " " + we::string(argv[i]);
+		}
+		Session.Execute(Command);
+		Session.Quit();
+		return 0;
+	}
+
+	we::string Line;
+	while (std::getline(std::cin, Line))
+	{
+		if (!Line.empty() && Line.back() == '\r') { Line.pop_back(); }
+		if (!Session.Execute(Line)) { break; }
+	}
+
+	// End of input is a quit the GUI did not get to send
+	Session.Quit();
+	return 0;
+}
@@ -5,4 +5,5 @@ namespace we
 	class Application;
 }
 	
-extern we::Application* GetApplication();
\ No newline at end of file
+// Returns nullptr when the command line was handled without starting the game
+extern we::Application* GetApplication(int argc, char** argv);
\ No newline at end of file
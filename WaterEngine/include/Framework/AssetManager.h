@@ -12,6 +12,7 @@ namespace we
 		shared<sf::Font> LoadFont(const string& FontPath);
 		void GarbageCollectionCycle();
 		void SetAssetRootDirctory(const std::string& Directory);
+		const std::string& GetAssetRootDirectory() const { return RootDirectory; }
 
 	protected:
 		AssetManager();
@@ -2,12 +2,15 @@
 #include "EntryPoint.h"
 #include "Framework/Application.h"
 
-int main()
+int main(int argc, char** argv)
 {
+	// The game may answer a command line run (e.g. a benchmark) without a window
+	we::Application* App = GetApplication(argc, argv);
+	if (!App) { return 0; }
+
 #ifdef NDEBUG
 	FreeConsole();
 #endif
-	we::Application* App = GetApplication();
 	App->Run();
 
 	delete App;